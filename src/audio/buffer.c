@@ -38,6 +38,7 @@ struct comp_buffer *buffer_alloc(uint32_t size, uint32_t caps, uint32_t align)
 		return NULL;
 	}
 
+	buffer->align = align;
 	buffer->addr = rballoc_align(RZONE_BUFFER, caps, size, align);
 	if (!buffer->addr) {
 		rfree(buffer);
@@ -86,6 +87,29 @@ int buffer_set_size(struct comp_buffer *buffer, uint32_t size)
 	if (size == buffer->size)
 		return 0;
 
+	/* resize inside the arena slot, it can't grow beyond the slot */
+	if (buffer->arena && size <= buffer->arena_size) {
+		buffer_init(buffer, size, buffer->caps);
+		return 0;
+	}
+
+	/* too big for the arena slot, move to own allocation */
+	if (buffer->arena) {
+		new_ptr = rballoc_align(RZONE_BUFFER, buffer->caps, size,
+					buffer->align);
+		if (!new_ptr) {
+			trace_buffer_error("resize error: can't alloc %u bytes "
+					   "type %u", size, buffer->caps);
+			return -ENOMEM;
+		}
+
+		buffer->arena = false;
+		buffer->addr = new_ptr;
+		buffer_init(buffer, size, buffer->caps);
+
+		return 0;
+	}
+
 	new_ptr = rbrealloc(buffer->addr, RZONE_BUFFER, buffer->caps, size);
 
 	/* we couldn't allocate bigger chunk */
@@ -111,7 +135,8 @@ void buffer_free(struct comp_buffer *buffer)
 
 	list_item_del(&buffer->source_list);
 	list_item_del(&buffer->sink_list);
-	rfree(buffer->addr);
+	if (!buffer->arena)
+		rfree(buffer->addr);
 	rfree(buffer);
 }
 
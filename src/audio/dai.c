@@ -7,6 +7,7 @@
 
 #include <sof/audio/buffer.h>
 #include <sof/audio/component.h>
+#include <sof/audio/pcm_converter.h>
 #include <sof/audio/pipeline.h>
 #include <sof/common.h>
 #include <sof/debug/panic.h>
@@ -66,9 +67,8 @@ struct dai_data {
 	uint32_t frame_bytes;
 	int xrun;		/* true if we are doing xrun recovery */
 
-	/* processing function */
-	void (*process)(struct comp_buffer *source, struct comp_buffer *sink,
-			uint32_t bytes);
+	/* conversion between local buffer and DMA buffer formats */
+	struct pcm_converter conv;
 
 	uint32_t dai_pos_blks;	/* position in bytes (nearest block) */
 	uint64_t start_position;	/* position on start */
@@ -115,7 +115,7 @@ static void dai_dma_cb(void *data, uint32_t type, struct dma_cb_data *next)
 		local_buffer = list_first_item(&dev->bsource_list,
 					       struct comp_buffer, sink_list);
 
-		dma_buffer_copy_to(local_buffer, dd->dma_buffer, dd->process,
+		dma_buffer_copy_to(local_buffer, dd->dma_buffer, &dd->conv,
 				   bytes);
 
 		buffer_ptr = local_buffer->r_ptr;
@@ -123,7 +123,7 @@ static void dai_dma_cb(void *data, uint32_t type, struct dma_cb_data *next)
 		local_buffer = list_first_item(&dev->bsink_list,
 					       struct comp_buffer, source_list);
 
-		dma_buffer_copy_from(dd->dma_buffer, local_buffer, dd->process,
+		dma_buffer_copy_from(dd->dma_buffer, local_buffer, &dd->conv,
 				     bytes);
 
 		buffer_ptr = local_buffer->w_ptr;
@@ -333,10 +333,40 @@ static int dai_capture_params(struct comp_dev *dev, uint32_t period_bytes,
 	return 0;
 }
 
+/*
+ * Format of data in the local buffer. Components next to the DAI produce or
+ * consume the DAI format themselves, but hosts never convert, so the DAI
+ * converts between their format and its own one.
+ */
+static enum sof_ipc_frame dai_local_frame_fmt(struct comp_dev *dev)
+{
+	struct comp_buffer *local_buffer;
+	struct comp_dev *local;
+
+	if (dev->params.direction == SOF_IPC_STREAM_PLAYBACK) {
+		local_buffer = list_first_item(&dev->bsource_list,
+					       struct comp_buffer, sink_list);
+		local = local_buffer->source;
+	} else {
+		local_buffer = list_first_item(&dev->bsink_list,
+					       struct comp_buffer, source_list);
+		local = local_buffer->sink;
+	}
+
+	switch (local->comp.type) {
+	case SOF_COMP_HOST:
+	case SOF_COMP_SG_HOST:
+		return local->params.frame_fmt;
+	default:
+		return dev->params.frame_fmt;
+	}
+}
+
 static int dai_params(struct comp_dev *dev)
 {
 	struct dai_data *dd = comp_get_drvdata(dev);
 	struct sof_ipc_comp_config *dconfig = COMP_GET_CONFIG(dev);
+	enum sof_ipc_frame local_fmt;
 	uint32_t period_count;
 	uint32_t period_bytes;
 	uint32_t buffer_size;
@@ -363,11 +393,21 @@ static int dai_params(struct comp_dev *dev)
 	/* for DAI, we should configure its frame_fmt from topology */
 	dev->params.frame_fmt = dconfig->frame_fmt;
 
-	/* set processing function */
-	if (dev->params.frame_fmt == SOF_IPC_FRAME_S16_LE)
-		dd->process = buffer_copy_s16;
+	/* set conversion function */
+	local_fmt = dai_local_frame_fmt(dev);
+	if (dev->params.direction == SOF_IPC_STREAM_PLAYBACK)
+		err = pcm_converter_init(&dd->conv, local_fmt,
+					 dev->params.frame_fmt);
 	else
-		dd->process = buffer_copy_s32;
+		err = pcm_converter_init(&dd->conv, dev->params.frame_fmt,
+					 local_fmt);
+	if (err < 0) {
+		trace_dai_error_with_ids(dev, "dai_params() error: no "
+					 "conversion between local format %u "
+					 "and DAI format %u", local_fmt,
+					 dev->params.frame_fmt);
+		return err;
+	}
 
 	/* calculate period size based on config */
 	dd->frame_bytes = comp_frame_bytes(dev);
@@ -643,11 +683,15 @@ static int dai_copy(struct comp_dev *dev)
 	if (dev->params.direction == SOF_IPC_STREAM_PLAYBACK) {
 		local_buffer = list_first_item(&dev->bsource_list,
 					       struct comp_buffer, sink_list);
-		copy_bytes = MIN(local_buffer->avail, free_bytes);
+		copy_bytes = MIN(pcm_sink_bytes(&dd->conv,
+						local_buffer->avail),
+				 free_bytes);
 	} else {
 		local_buffer = list_first_item(&dev->bsink_list,
 					       struct comp_buffer, source_list);
-		copy_bytes = MIN(avail_bytes, local_buffer->free);
+		copy_bytes = MIN(avail_bytes,
+				 pcm_source_bytes(&dd->conv,
+						  local_buffer->free));
 	}
 
 	tracev_dai_with_ids(dev, "dai_copy(), copy_bytes = 0x%x", copy_bytes);
@@ -9,6 +9,7 @@
 #include <sof/audio/buffer.h>
 #include <sof/audio/component.h>
 #include <sof/audio/eq_fir/fir_config.h>
+#include <sof/audio/eq_fir/fir_fft.h>
 #include <sof/audio/pipeline.h>
 #include <sof/common.h>
 #include <sof/debug/panic.h>
@@ -16,6 +17,8 @@
 #include <sof/lib/alloc.h>
 #include <sof/lib/cache.h>
 #include <sof/list.h>
+#include <sof/math/fft.h>
+#include <sof/math/numbers.h>
 #include <sof/platform.h>
 #include <sof/string.h>
 #include <sof/trace/trace.h>
@@ -26,6 +29,7 @@
 #include <user/eq.h>
 #include <user/trace.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -49,6 +53,8 @@
 /* src component private data */
 struct comp_data {
 	struct fir_state_32x16 fir[PLATFORM_MAX_CHANNELS]; /**< filters state */
+	struct fir_fft_state fft[PLATFORM_MAX_CHANNELS]; /**< FFT mode state */
+	struct fft_plan fft_plan;	  /**< FFT mode transform */
 	struct sof_eq_fir_config *config; /**< pointer to setup blob */
 	enum sof_ipc_frame source_format; /**< source frame format */
 	enum sof_ipc_frame sink_format;   /**< sink frame format */
@@ -62,6 +68,11 @@ struct comp_data {
 			    struct comp_buffer *source,
 			    struct comp_buffer *sink,
 			    int frames, int nch);
+	void (*eq_fir_fft_func)(struct fir_fft_state fft[],
+				struct comp_buffer *source,
+				struct comp_buffer *sink,
+				int frames, int nch);
+	bool fft_mode;			  /**< long responses run in FFT */
 };
 
 /* The optimized FIR functions variants need to be updated into function
@@ -127,10 +138,37 @@ static inline void set_s32_fir(struct comp_data *cd)
 }
 #endif
 
+static inline int set_fft_func(struct comp_dev *dev)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+
+	switch (dev->params.frame_fmt) {
+	case SOF_IPC_FRAME_S16_LE:
+		trace_eq("set_fft_func(), SOF_IPC_FRAME_S16_LE");
+		cd->eq_fir_fft_func = eq_fir_fft_s16;
+		break;
+	case SOF_IPC_FRAME_S24_4LE:
+		trace_eq("set_fft_func(), SOF_IPC_FRAME_S24_4LE");
+		cd->eq_fir_fft_func = eq_fir_fft_s24;
+		break;
+	case SOF_IPC_FRAME_S32_LE:
+		trace_eq("set_fft_func(), SOF_IPC_FRAME_S32_LE");
+		cd->eq_fir_fft_func = eq_fir_fft_s32;
+		break;
+	default:
+		trace_eq_error("set_fft_func(), invalid frame_fmt");
+		return -EINVAL;
+	}
+	return 0;
+}
+
 static inline int set_fir_func(struct comp_dev *dev)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 
+	if (cd->fft_mode)
+		return set_fft_func(dev);
+
 	switch (dev->params.frame_fmt) {
 	case SOF_IPC_FRAME_S16_LE:
 		trace_eq("set_fir_func(), SOF_IPC_FRAME_S16_LE");
@@ -234,9 +272,59 @@ static void eq_fir_free_delaylines(struct comp_data *cd)
 	 * each FIR channel delay line to NULL.
 	 */
 	rfree(cd->fir_delay);
+	cd->fir_delay = NULL;
 	cd->fir_delay_size = 0;
-	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++)
+	cd->fft_mode = false;
+	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++) {
 		fir[i].delay = NULL;
+		fir_fft_reset(&cd->fft[i]);
+	}
+}
+
+/* Run all channels as partitioned FFT convolution. The FFT plan, the
+ * shared FFT buffer and the channels data are allocated in one chunk.
+ */
+static int eq_fir_setup_fft(struct comp_data *cd, int nch,
+			    struct sof_eq_fir_coef_data *channel_eq[])
+{
+	struct icomplex32 *work;
+	int32_t *fft_data;
+	size_t plan_size = fft_plan_data_size(FIR_FFT_SIZE);
+	size_t size_sum;
+	size_t s;
+	int ret;
+	int i;
+
+	size_sum = plan_size + FIR_FFT_SIZE * sizeof(struct icomplex32);
+	for (i = 0; i < nch; i++) {
+		s = fir_fft_init_coef(&cd->fft[i], channel_eq[i]);
+		if (s > 0)
+			size_sum += s;
+		else
+			return -EINVAL;
+	}
+
+	cd->fir_delay = rballoc(RZONE_RUNTIME, SOF_MEM_CAPS_RAM, size_sum);
+	if (!cd->fir_delay) {
+		trace_eq_error("eq_fir_setup_fft() error: alloc failed, "
+			       "size = %u", size_sum);
+		return -ENOMEM;
+	}
+
+	cd->fir_delay_size = size_sum;
+	ret = fft_plan_init(&cd->fft_plan, cd->fir_delay, FIR_FFT_SIZE);
+	if (ret < 0)
+		return ret;
+
+	work = (struct icomplex32 *)((uint8_t *)cd->fir_delay + plan_size);
+	fft_data = (int32_t *)(work + FIR_FFT_SIZE);
+	for (i = 0; i < nch; i++)
+		fir_fft_init_data(&cd->fft[i], channel_eq[i], &cd->fft_plan,
+				  work, &fft_data);
+
+	cd->fft_mode = true;
+	trace_eq("eq_fir_setup_fft(), size = %u", size_sum);
+	return 0;
 }
 
 static int eq_fir_setup(struct comp_data *cd, int nch)
@@ -244,10 +332,12 @@ static int eq_fir_setup(struct comp_data *cd, int nch)
 	struct fir_state_32x16 *fir = cd->fir;
 	struct sof_eq_fir_config *config = cd->config;
 	struct sof_eq_fir_coef_data *lookup[SOF_EQ_FIR_MAX_RESPONSES];
+	struct sof_eq_fir_coef_data *channel_eq[PLATFORM_MAX_CHANNELS];
 	struct sof_eq_fir_coef_data *eq;
 	int32_t *fir_delay;
 	int16_t *coef_data;
 	int16_t *assign_response;
+	int max_length = 0;
 	int resp;
 	int i;
 	int j;
@@ -274,8 +364,9 @@ static int eq_fir_setup(struct comp_data *cd, int nch)
 
 	/* Collect index of respose start positions in all_coefficients[]  */
 	j = 0;
-	assign_response = &config->data[0];
-	coef_data = &config->data[config->channels_in_config];
+	assign_response = ASSUME_ALIGNED(&config->data[0], 2);
+	coef_data = ASSUME_ALIGNED(&config->data[config->channels_in_config],
+				   2);
 	for (i = 0; i < SOF_EQ_FIR_MAX_RESPONSES; i++) {
 		if (i < config->number_of_responses) {
 			trace_eq("eq_fir_setup(), "
@@ -306,6 +397,7 @@ static int eq_fir_setup(struct comp_data *cd, int nch)
 			 * next channel response.
 			 */
 			fir_reset(&fir[i]);
+			channel_eq[i] = NULL;
 			continue;
 		}
 
@@ -314,6 +406,8 @@ static int eq_fir_setup(struct comp_data *cd, int nch)
 
 		/* Initialize EQ coefficients. */
 		eq = lookup[resp];
+		channel_eq[i] = eq;
+		max_length = MAX(max_length, eq->length);
 		s = fir_init_coef(&fir[i], eq);
 		if (s > 0)
 			size_sum += s;
@@ -332,6 +426,10 @@ static int eq_fir_setup(struct comp_data *cd, int nch)
 	if (!size_sum)
 		return 0;
 
+	/* Long responses are cheaper to run as FFT convolution */
+	if (max_length >= FIR_FFT_TAPS_MIN)
+		return eq_fir_setup_fft(cd, nch, channel_eq);
+
 	/* Allocate all FIR channels data in a big chunk and clear it */
 	cd->fir_delay = rballoc(RZONE_RUNTIME, SOF_MEM_CAPS_RAM, size_sum);
 	if (!cd->fir_delay) {
@@ -673,6 +771,14 @@ static int eq_fir_copy(struct comp_dev *dev)
 	/* Get source, sink, number of frames etc. to process. */
 	comp_get_copy_limits(dev, &cl);
 
+	if (cd->fft_mode) {
+		cd->eq_fir_fft_func(cd->fft, cl.source, cl.sink, cl.frames,
+				    nch);
+		comp_update_buffer_consume(cl.source, cl.source_bytes);
+		comp_update_buffer_produce(cl.sink, cl.sink_bytes);
+		return 0;
+	}
+
 	/* Check if number of frames to process if it is odd. The
 	 * optimized FIR function to process even number of frames
 	 * is lower load than generic version. In that case process
@@ -13,6 +13,7 @@
 #include <sof/audio/buffer.h>
 #include <sof/audio/eq_fir/fir.h>
 #include <sof/audio/format.h>
+#include <sof/common.h>
 #include <user/eq.h>
 #include <errno.h>
 #include <stddef.h>
@@ -39,7 +40,7 @@ size_t fir_init_coef(struct fir_state_32x16 *fir,
 	fir->rwi = 0;
 	fir->length = (int)config->length;
 	fir->out_shift = (int)config->out_shift;
-	fir->coef = &config->coef[0];
+	fir->coef = ASSUME_ALIGNED(&config->coef[0], 2);
 	fir->delay = NULL;
 
 	/* Check for sane FIR length. The length is constrained to be a
@@ -0,0 +1,255 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2019 Intel Corporation. All rights reserved.
+
+#include <sof/audio/buffer.h>
+#include <sof/audio/eq_fir/fir_fft.h>
+#include <sof/audio/format.h>
+#include <sof/math/fft.h>
+#include <user/eq.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Uniformly partitioned overlap-save FIR. Every FIR_FFT_BLOCK input samples
+ * the previous and the new block are transformed, the spectrum is pushed to
+ * a frequency domain delay line and multiplied with the spectra of all
+ * filter partitions. The last FIR_FFT_BLOCK samples of the inverse
+ * transform are the filtered block.
+ */
+
+#define FIR_FFT_PARTITIONS_MAX \
+	((SOF_EQ_FIR_MAX_LENGTH + FIR_FFT_BLOCK - 1) / FIR_FFT_BLOCK)
+
+/* Products are shifted before accumulation to leave headroom for summing
+ * up to 2^FIR_FFT_ACC_SHIFT partitions.
+ */
+#define FIR_FFT_ACC_SHIFT	3
+
+void fir_fft_reset(struct fir_fft_state *fft)
+{
+	fft->partitions = 0;
+	fft->out_shift = 0;
+	fft->pos = 0;
+	fft->fdl_idx = 0;
+	fft->coef = NULL;
+	fft->fdl = NULL;
+	fft->in = NULL;
+	fft->out = NULL;
+}
+
+/* Returns the size of the channel data. A NULL config sets the channel to
+ * bypass, it then only delays the samples to stay aligned with the other
+ * channels.
+ */
+size_t fir_fft_init_coef(struct fir_fft_state *fft,
+			 struct sof_eq_fir_coef_data *config)
+{
+	size_t size = 3 * FIR_FFT_BLOCK * sizeof(int32_t);
+
+	fir_fft_reset(fft);
+	if (!config)
+		return size;
+
+	if (config->length > SOF_EQ_FIR_MAX_LENGTH || config->length < 1)
+		return -EINVAL;
+
+	fft->out_shift = config->out_shift;
+	fft->partitions = (config->length + FIR_FFT_BLOCK - 1) /
+		FIR_FFT_BLOCK;
+
+	return size + 2 * fft->partitions * FIR_FFT_SIZE *
+		sizeof(struct icomplex32);
+}
+
+void fir_fft_init_data(struct fir_fft_state *fft,
+		       struct sof_eq_fir_coef_data *config,
+		       struct fft_plan *plan, struct icomplex32 *work,
+		       int32_t **data)
+{
+	struct icomplex32 *coef;
+	int n;
+	int p;
+	int i;
+
+	fft->plan = plan;
+	fft->work = work;
+	fft->in = *data;
+	fft->out = fft->in + 2 * FIR_FFT_BLOCK;
+	*data += 3 * FIR_FFT_BLOCK;
+
+	for (i = 0; i < 3 * FIR_FFT_BLOCK; i++)
+		fft->in[i] = 0;
+
+	if (!fft->partitions)
+		return;
+
+	fft->coef = (struct icomplex32 *)*data;
+	fft->fdl = fft->coef + fft->partitions * FIR_FFT_SIZE;
+	*data = (int32_t *)(fft->fdl + fft->partitions * FIR_FFT_SIZE);
+
+	for (i = 0; i < fft->partitions * FIR_FFT_SIZE; i++) {
+		fft->fdl[i].real = 0;
+		fft->fdl[i].imag = 0;
+	}
+
+	/* Partition spectra from Q1.15 taps scaled to Q1.31 */
+	for (p = 0; p < fft->partitions; p++) {
+		coef = &fft->coef[p * FIR_FFT_SIZE];
+		for (i = 0; i < FIR_FFT_SIZE; i++) {
+			n = p * FIR_FFT_BLOCK + i;
+			if (i < FIR_FFT_BLOCK && n < config->length)
+				coef[i].real = (int32_t)config->coef[n] << 16;
+			else
+				coef[i].real = 0;
+			coef[i].imag = 0;
+		}
+
+		fft_execute_32(plan, coef, false);
+	}
+}
+
+/* Filters the input block collected in fft->in into fft->out */
+void fir_fft_block(struct fir_fft_state *fft)
+{
+	struct icomplex32 *x[FIR_FFT_PARTITIONS_MAX];
+	struct icomplex32 *work = fft->work;
+	struct icomplex32 *h;
+	int64_t re;
+	int64_t im;
+	int shift;
+	int p;
+	int i;
+
+	if (!fft->partitions) {
+		for (i = 0; i < FIR_FFT_BLOCK; i++)
+			fft->out[i] = fft->in[FIR_FFT_BLOCK + i];
+		return;
+	}
+
+	for (i = 0; i < FIR_FFT_SIZE; i++) {
+		work[i].real = fft->in[i];
+		work[i].imag = 0;
+	}
+
+	fft_execute_32(fft->plan, work, false);
+
+	/* Push the spectrum to the frequency domain delay line and collect
+	 * the input spectra for every partition, newest first.
+	 */
+	if (++fft->fdl_idx == fft->partitions)
+		fft->fdl_idx = 0;
+
+	for (p = 0; p < fft->partitions; p++) {
+		i = fft->fdl_idx - p;
+		if (i < 0)
+			i += fft->partitions;
+		x[p] = &fft->fdl[i * FIR_FFT_SIZE];
+	}
+
+	for (i = 0; i < FIR_FFT_SIZE; i++)
+		x[0][i] = work[i];
+
+	/* The input spectrum is scaled by 1/N and the partition spectra by
+	 * 2^16/N. The product is shifted to 1/N scaled output spectrum
+	 * with the 2^-15 Q1.15 taps scale and out_shift applied.
+	 */
+	shift = 31 - fft->plan->len + fft->out_shift - FIR_FFT_ACC_SHIFT;
+	for (i = 0; i < FIR_FFT_SIZE; i++) {
+		re = 0;
+		im = 0;
+		for (p = 0; p < fft->partitions; p++) {
+			h = &fft->coef[p * FIR_FFT_SIZE + i];
+			re += ((int64_t)x[p][i].real * h->real -
+			       (int64_t)x[p][i].imag * h->imag) >>
+				FIR_FFT_ACC_SHIFT;
+			im += ((int64_t)x[p][i].real * h->imag +
+			       (int64_t)x[p][i].imag * h->real) >>
+				FIR_FFT_ACC_SHIFT;
+		}
+
+		work[i].real = sat_int32(Q_SHIFT_RND(re, shift, 0));
+		work[i].imag = sat_int32(Q_SHIFT_RND(im, shift, 0));
+	}
+
+	fft_execute_32(fft->plan, work, true);
+
+	/* Keep the last linear convolution block, keep new input as the
+	 * overlap for next block.
+	 */
+	for (i = 0; i < FIR_FFT_BLOCK; i++) {
+		fft->out[i] = work[FIR_FFT_BLOCK + i].real;
+		fft->in[i] = fft->in[FIR_FFT_BLOCK + i];
+	}
+}
+
+void eq_fir_fft_s16(struct fir_fft_state fft[], struct comp_buffer *source,
+		    struct comp_buffer *sink, int frames, int nch)
+{
+	struct fir_fft_state *filter;
+	int16_t *x;
+	int16_t *y;
+	int32_t z;
+	int idx;
+	int ch;
+	int i;
+
+	for (ch = 0; ch < nch; ch++) {
+		filter = &fft[ch];
+		idx = ch;
+		for (i = 0; i < frames; i++) {
+			x = buffer_read_frag_s16(source, idx);
+			y = buffer_write_frag_s16(sink, idx);
+			z = fir_fft_32x16(filter, *x << 16);
+			*y = sat_int16(Q_SHIFT_RND(z, 31, 15));
+			idx += nch;
+		}
+	}
+}
+
+void eq_fir_fft_s24(struct fir_fft_state fft[], struct comp_buffer *source,
+		    struct comp_buffer *sink, int frames, int nch)
+{
+	struct fir_fft_state *filter;
+	int32_t *x;
+	int32_t *y;
+	int32_t z;
+	int idx;
+	int ch;
+	int i;
+
+	for (ch = 0; ch < nch; ch++) {
+		filter = &fft[ch];
+		idx = ch;
+		for (i = 0; i < frames; i++) {
+			x = buffer_read_frag_s32(source, idx);
+			y = buffer_write_frag_s32(sink, idx);
+			z = fir_fft_32x16(filter, *x << 8);
+			*y = sat_int24(Q_SHIFT_RND(z, 31, 23));
+			idx += nch;
+		}
+	}
+}
+
+void eq_fir_fft_s32(struct fir_fft_state fft[], struct comp_buffer *source,
+		    struct comp_buffer *sink, int frames, int nch)
+{
+	struct fir_fft_state *filter;
+	int32_t *x;
+	int32_t *y;
+	int idx;
+	int ch;
+	int i;
+
+	for (ch = 0; ch < nch; ch++) {
+		filter = &fft[ch];
+		idx = ch;
+		for (i = 0; i < frames; i++) {
+			x = buffer_read_frag_s32(source, idx);
+			y = buffer_write_frag_s32(sink, idx);
+			*y = fir_fft_32x16(filter, *x);
+			idx += nch;
+		}
+	}
+}
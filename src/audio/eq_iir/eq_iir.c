@@ -18,6 +18,7 @@
 #include <sof/lib/alloc.h>
 #include <sof/lib/cache.h>
 #include <sof/list.h>
+#include <sof/math/numbers.h>
 #include <sof/platform.h>
 #include <sof/string.h>
 #include <sof/trace/trace.h>
@@ -35,9 +36,13 @@
 #define trace_eq_error(__e, ...) \
 	trace_error(TRACE_CLASS_EQ_IIR, __e, ##__VA_ARGS__)
 
+/* Samples gathered from the source for one multichannel IIR run */
+#define EQ_IIR_MC_BLOCK_SAMPLES	128
+
 /* IIR component private data */
 struct comp_data {
 	struct iir_state_df2t iir[PLATFORM_MAX_CHANNELS]; /**< filters state */
+	struct iir_mc_state_df2t iir_mc;    /**< lockstep filters state */
 	struct sof_eq_iir_config *config;   /**< pointer to setup blob */
 	enum sof_ipc_frame source_format;   /**< source frame format */
 	enum sof_ipc_frame sink_format;     /**< sink frame format */
@@ -196,6 +201,178 @@ static void eq_iir_s32_24_default(struct comp_dev *dev,
 	}
 }
 
+#if IIR_MULTICHANNEL
+static void eq_iir_s16_mc(struct comp_dev *dev,
+			  struct comp_buffer *source,
+			  struct comp_buffer *sink,
+			  uint32_t frames)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	int32_t block[EQ_IIR_MC_BLOCK_SAMPLES];
+	int16_t *x;
+	int16_t *y;
+	int nch = dev->params.channels;
+	int samples = frames * nch;
+	int idx = 0;
+	int n;
+	int i;
+
+	while (samples) {
+		n = MIN(samples, EQ_IIR_MC_BLOCK_SAMPLES / nch * nch);
+		for (i = 0; i < n; i++) {
+			x = buffer_read_frag_s16(source, idx + i);
+			block[i] = *x << 16;
+		}
+
+		iir_mc_df2t(&cd->iir_mc, block, n / nch);
+
+		for (i = 0; i < n; i++) {
+			y = buffer_write_frag_s16(sink, idx + i);
+			*y = sat_int16(Q_SHIFT_RND(block[i], 31, 15));
+		}
+
+		samples -= n;
+		idx += n;
+	}
+}
+
+static void eq_iir_s24_mc(struct comp_dev *dev,
+			  struct comp_buffer *source,
+			  struct comp_buffer *sink,
+			  uint32_t frames)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	int32_t block[EQ_IIR_MC_BLOCK_SAMPLES];
+	int32_t *x;
+	int32_t *y;
+	int nch = dev->params.channels;
+	int samples = frames * nch;
+	int idx = 0;
+	int n;
+	int i;
+
+	while (samples) {
+		n = MIN(samples, EQ_IIR_MC_BLOCK_SAMPLES / nch * nch);
+		for (i = 0; i < n; i++) {
+			x = buffer_read_frag_s32(source, idx + i);
+			block[i] = *x << 8;
+		}
+
+		iir_mc_df2t(&cd->iir_mc, block, n / nch);
+
+		for (i = 0; i < n; i++) {
+			y = buffer_write_frag_s32(sink, idx + i);
+			*y = sat_int24(Q_SHIFT_RND(block[i], 31, 23));
+		}
+
+		samples -= n;
+		idx += n;
+	}
+}
+
+static void eq_iir_s32_mc(struct comp_dev *dev,
+			  struct comp_buffer *source,
+			  struct comp_buffer *sink,
+			  uint32_t frames)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	int32_t block[EQ_IIR_MC_BLOCK_SAMPLES];
+	int32_t *x;
+	int32_t *y;
+	int nch = dev->params.channels;
+	int samples = frames * nch;
+	int idx = 0;
+	int n;
+	int i;
+
+	while (samples) {
+		n = MIN(samples, EQ_IIR_MC_BLOCK_SAMPLES / nch * nch);
+		for (i = 0; i < n; i++) {
+			x = buffer_read_frag_s32(source, idx + i);
+			block[i] = *x;
+		}
+
+		iir_mc_df2t(&cd->iir_mc, block, n / nch);
+
+		for (i = 0; i < n; i++) {
+			y = buffer_write_frag_s32(sink, idx + i);
+			*y = block[i];
+		}
+
+		samples -= n;
+		idx += n;
+	}
+}
+
+static void eq_iir_s32_16_mc(struct comp_dev *dev,
+			     struct comp_buffer *source,
+			     struct comp_buffer *sink,
+			     uint32_t frames)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	int32_t block[EQ_IIR_MC_BLOCK_SAMPLES];
+	int32_t *x;
+	int16_t *y;
+	int nch = dev->params.channels;
+	int samples = frames * nch;
+	int idx = 0;
+	int n;
+	int i;
+
+	while (samples) {
+		n = MIN(samples, EQ_IIR_MC_BLOCK_SAMPLES / nch * nch);
+		for (i = 0; i < n; i++) {
+			x = buffer_read_frag_s32(source, idx + i);
+			block[i] = *x;
+		}
+
+		iir_mc_df2t(&cd->iir_mc, block, n / nch);
+
+		for (i = 0; i < n; i++) {
+			y = buffer_write_frag_s16(sink, idx + i);
+			*y = sat_int16(Q_SHIFT_RND(block[i], 31, 15));
+		}
+
+		samples -= n;
+		idx += n;
+	}
+}
+
+static void eq_iir_s32_24_mc(struct comp_dev *dev,
+			     struct comp_buffer *source,
+			     struct comp_buffer *sink,
+			     uint32_t frames)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	int32_t block[EQ_IIR_MC_BLOCK_SAMPLES];
+	int32_t *x;
+	int32_t *y;
+	int nch = dev->params.channels;
+	int samples = frames * nch;
+	int idx = 0;
+	int n;
+	int i;
+
+	while (samples) {
+		n = MIN(samples, EQ_IIR_MC_BLOCK_SAMPLES / nch * nch);
+		for (i = 0; i < n; i++) {
+			x = buffer_read_frag_s32(source, idx + i);
+			block[i] = *x;
+		}
+
+		iir_mc_df2t(&cd->iir_mc, block, n / nch);
+
+		for (i = 0; i < n; i++) {
+			y = buffer_write_frag_s32(sink, idx + i);
+			*y = sat_int24(Q_SHIFT_RND(block[i], 31, 23));
+		}
+
+		samples -= n;
+		idx += n;
+	}
+}
+#endif /* IIR_MULTICHANNEL */
+
 static void eq_iir_s16_pass(struct comp_dev *dev,
 			    struct comp_buffer *source,
 			    struct comp_buffer *sink,
@@ -276,6 +453,20 @@ const struct eq_iir_func_map fm_configured[] = {
 	{SOF_IPC_FRAME_S32_LE,  SOF_IPC_FRAME_S32_LE,  eq_iir_s32_default},
 };
 
+#if IIR_MULTICHANNEL
+const struct eq_iir_func_map fm_multichannel[] = {
+	{SOF_IPC_FRAME_S16_LE,  SOF_IPC_FRAME_S16_LE,  eq_iir_s16_mc},
+	{SOF_IPC_FRAME_S16_LE,  SOF_IPC_FRAME_S24_4LE, NULL},
+	{SOF_IPC_FRAME_S16_LE,  SOF_IPC_FRAME_S32_LE,  NULL},
+	{SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S16_LE,  NULL},
+	{SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S24_4LE, eq_iir_s24_mc},
+	{SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S32_LE,  NULL},
+	{SOF_IPC_FRAME_S32_LE,  SOF_IPC_FRAME_S16_LE,  eq_iir_s32_16_mc},
+	{SOF_IPC_FRAME_S32_LE,  SOF_IPC_FRAME_S24_4LE, eq_iir_s32_24_mc},
+	{SOF_IPC_FRAME_S32_LE,  SOF_IPC_FRAME_S32_LE,  eq_iir_s32_mc},
+};
+#endif
+
 const struct eq_iir_func_map fm_passthrough[] = {
 	{SOF_IPC_FRAME_S16_LE,  SOF_IPC_FRAME_S16_LE,  eq_iir_s16_pass},
 	{SOF_IPC_FRAME_S16_LE,  SOF_IPC_FRAME_S24_4LE, NULL},
@@ -322,7 +513,10 @@ static void eq_iir_free_delaylines(struct comp_data *cd)
 	 * each IIR channel delay line to NULL.
 	 */
 	rfree(cd->iir_delay);
+	cd->iir_delay = NULL;
 	cd->iir_delay_size = 0;
+	cd->iir_mc.coef = NULL;
+	cd->iir_mc.delay = NULL;
 	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++)
 		iir[i].delay = NULL;
 }
@@ -337,6 +531,9 @@ static int eq_iir_setup(struct comp_data *cd, int nch)
 	int32_t *coef_data, *assign_response;
 	size_t s;
 	size_t size_sum = 0;
+#if IIR_MULTICHANNEL
+	int mc_size;
+#endif
 	int i;
 	int j;
 	int resp;
@@ -364,8 +561,9 @@ static int eq_iir_setup(struct comp_data *cd, int nch)
 
 	/* Collect index of response start positions in all_coefficients[]  */
 	j = 0;
-	assign_response = &config->data[0];
-	coef_data = &config->data[config->channels_in_config];
+	assign_response = ASSUME_ALIGNED(&config->data[0], 4);
+	coef_data = ASSUME_ALIGNED(&config->data[config->channels_in_config],
+				   4);
 	for (i = 0; i < SOF_EQ_IIR_MAX_RESPONSES; i++) {
 		if (i < config->number_of_responses) {
 			trace_eq("eq_iir_setup(), "
@@ -422,6 +620,26 @@ static int eq_iir_setup(struct comp_data *cd, int nch)
 	cd->iir_delay_size = size_sum;
 	if (!size_sum)
 		return 0;
+
+#if IIR_MULTICHANNEL
+	/* Run the channels in lockstep if they share the same biquads
+	 * layout. The interleaved coefficients and delay lines then use
+	 * the allocation instead of the per channel delay lines.
+	 */
+	mc_size = nch > 1 ? iir_mc_init_coef_df2t(&cd->iir_mc, iir, nch) : 0;
+	if (mc_size > 0) {
+		cd->iir_delay = rzalloc(RZONE_RUNTIME, SOF_MEM_CAPS_RAM,
+					mc_size);
+		if (!cd->iir_delay)
+			return -ENOMEM;
+
+		cd->iir_delay_size = mc_size;
+		iir_mc_init_delay_df2t(&cd->iir_mc, iir, cd->iir_delay);
+		trace_eq("eq_iir_setup(), %u channels in lockstep", nch);
+		return 0;
+	}
+#endif
+
 	/* Allocate all IIR channels data in a big chunk and clear it */
 	cd->iir_delay = rzalloc(RZONE_RUNTIME, SOF_MEM_CAPS_RAM, size_sum);
 	if (!cd->iir_delay)
@@ -802,6 +1020,12 @@ static int eq_iir_prepare(struct comp_dev *dev)
 		}
 		cd->eq_iir_func = eq_iir_find_func(cd, fm_configured,
 						   ARRAY_SIZE(fm_configured));
+#if IIR_MULTICHANNEL
+		if (cd->iir_mc.coef)
+			cd->eq_iir_func =
+				eq_iir_find_func(cd, fm_multichannel,
+						 ARRAY_SIZE(fm_multichannel));
+#endif
 		if (!cd->eq_iir_func) {
 			trace_eq_error("eq_iir_prepare() error: "
 					"No processing function available, "
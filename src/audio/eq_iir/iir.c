@@ -8,6 +8,7 @@
 
 #include <sof/audio/eq_iir/iir.h>
 #include <sof/audio/format.h>
+#include <sof/common.h>
 #include <user/eq.h>
 #include <errno.h>
 #include <stddef.h>
@@ -109,7 +110,7 @@ size_t iir_init_coef_df2t(struct iir_state_df2t *iir,
 {
 	iir->biquads = config->num_sections;
 	iir->biquads_in_series = config->num_sections_in_series;
-	iir->coef = config->biquads;
+	iir->coef = ASSUME_ALIGNED(&config->biquads[0], 4);
 	iir->delay = NULL;
 
 	if (iir->biquads > SOF_EQ_IIR_DF2T_BIQUADS_MAX ||
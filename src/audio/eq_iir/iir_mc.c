@@ -0,0 +1,209 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2019 Intel Corporation. All rights reserved.
+
+#include <sof/audio/eq_iir/iir.h>
+#include <sof/audio/format.h>
+#include <sof/platform.h>
+#include <user/eq.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if IIR_MULTICHANNEL
+
+/* Coefficients order in a biquad is {a2, a1, b2, b1, b0, shift, gain} */
+#define IIR_MC_A2	0
+#define IIR_MC_A1	1
+#define IIR_MC_B2	2
+#define IIR_MC_B1	3
+#define IIR_MC_B0	4
+#define IIR_MC_SHIFT	5
+#define IIR_MC_GAIN	6
+
+/* Unity b0 in Q2.30 and unity gain in Q2.14 */
+#define IIR_MC_B0_ONE	(1 << 30)
+#define IIR_MC_GAIN_ONE	(1 << 14)
+
+/*
+ * Checks that all filtering channels share the same biquads layout and
+ * sets up the multichannel state for it. Channels in bypass are allowed
+ * and get a pass-through response. Returns the size of the coefficients
+ * and delay lines memory to be passed to iir_mc_init_delay_df2t().
+ */
+int iir_mc_init_coef_df2t(struct iir_mc_state_df2t *mc,
+			  struct iir_state_df2t iir[], int channels)
+{
+	int ch;
+
+	mc->channels = channels;
+	mc->biquads = 0;
+	mc->biquads_in_series = 0;
+	mc->coef = NULL;
+	mc->delay = NULL;
+
+	if (channels <= 0 || channels > PLATFORM_MAX_CHANNELS)
+		return -EINVAL;
+
+	for (ch = 0; ch < channels; ch++) {
+		if (!iir[ch].biquads)
+			continue;
+
+		if (!mc->biquads) {
+			mc->biquads = iir[ch].biquads;
+			mc->biquads_in_series = iir[ch].biquads_in_series;
+		} else if (iir[ch].biquads != mc->biquads ||
+			   iir[ch].biquads_in_series !=
+			   mc->biquads_in_series) {
+			return -EINVAL;
+		}
+	}
+
+	/* All channels in bypass, nothing to run in lockstep */
+	if (!mc->biquads || !mc->biquads_in_series)
+		return -EINVAL;
+
+	return mc->biquads * channels *
+		(IIR_DF2T_NUM_DELAYS * sizeof(int64_t) +
+		 SOF_EQ_IIR_NBIQUAD_DF2T * sizeof(int32_t));
+}
+
+/*
+ * Sets the delay lines and coefficients of the multichannel state into
+ * data and interleaves the channel coefficients there. The delay lines
+ * are placed first to keep them 64 bit aligned.
+ */
+void iir_mc_init_delay_df2t(struct iir_mc_state_df2t *mc,
+			    struct iir_state_df2t iir[], void *data)
+{
+	int nch = mc->channels;
+	int32_t *coef;
+	int32_t *src;
+	int ch;
+	int i;
+	int j;
+	int k;
+	int n;
+
+	mc->delay = data;
+	mc->coef = (int32_t *)(mc->delay +
+			       mc->biquads * IIR_DF2T_NUM_DELAYS * nch);
+
+	for (i = 0; i < mc->biquads * IIR_DF2T_NUM_DELAYS * nch; i++)
+		mc->delay[i] = 0;
+
+	for (ch = 0; ch < nch; ch++) {
+		for (j = 0; j < mc->biquads; j++) {
+			n = j * SOF_EQ_IIR_NBIQUAD_DF2T;
+			coef = &mc->coef[n * nch + ch];
+			if (iir[ch].biquads) {
+				src = &iir[ch].coef[n];
+				for (k = 0; k < SOF_EQ_IIR_NBIQUAD_DF2T; k++)
+					coef[k * nch] = src[k];
+				continue;
+			}
+
+			/* Bypass: unity sections in the first parallel
+			 * branch and muted sections in the others.
+			 */
+			for (k = 0; k < SOF_EQ_IIR_NBIQUAD_DF2T; k++)
+				coef[k * nch] = 0;
+
+			if (j < mc->biquads_in_series) {
+				coef[IIR_MC_B0 * nch] = IIR_MC_B0_ONE;
+				coef[IIR_MC_GAIN * nch] = IIR_MC_GAIN_ONE;
+			}
+		}
+	}
+}
+
+/* One DF2T biquad for all channels, coefficient rows are nch apart. The
+ * arithmetic is the same as in iir_df2t() and there is no dependency
+ * between channels so the loop can be vectorized.
+ */
+static inline void iir_mc_biquad(const int32_t *c, int64_t *d, int32_t *in,
+				 int nch)
+{
+	const int32_t *a2 = c + IIR_MC_A2 * nch;
+	const int32_t *a1 = c + IIR_MC_A1 * nch;
+	const int32_t *b2 = c + IIR_MC_B2 * nch;
+	const int32_t *b1 = c + IIR_MC_B1 * nch;
+	const int32_t *b0 = c + IIR_MC_B0 * nch;
+	const int32_t *shift = c + IIR_MC_SHIFT * nch;
+	const int32_t *gain = c + IIR_MC_GAIN * nch;
+	int64_t *d1 = d + nch;
+	int32_t tmp;
+	int64_t acc;
+	int ch;
+
+	for (ch = 0; ch < nch; ch++) {
+		/* Compute output: Delay is Q3.61
+		 * Q2.30 x Q1.31 -> Q3.61
+		 * Shift Q3.61 to Q3.31 with rounding
+		 */
+		acc = (int64_t)b0[ch] * in[ch] + d[ch];
+		tmp = (int32_t)Q_SHIFT_RND(acc, 61, 31);
+
+		/* Compute 1st delay */
+		acc = d1[ch];
+		acc += (int64_t)b1[ch] * in[ch];
+		acc += (int64_t)a1[ch] * tmp;
+		d[ch] = acc;
+
+		/* Compute 2nd delay */
+		acc = (int64_t)b2[ch] * in[ch];
+		acc += (int64_t)a2[ch] * tmp;
+		d1[ch] = acc;
+
+		/* Apply gain Q2.14 x Q1.31 -> Q3.45 and output shift */
+		acc = (int64_t)gain[ch] * tmp;
+		acc = Q_SHIFT_RND(acc, 45 + shift[ch], 31);
+		in[ch] = sat_int32(acc);
+	}
+}
+
+/* Series DF2T IIR for all channels of a block of interleaved frames */
+
+/* 32 bit data, 32 bit coefficients and 64 bit state variables */
+
+void iir_mc_df2t(struct iir_mc_state_df2t *mc, int32_t *data, int frames)
+{
+	int32_t in[PLATFORM_MAX_CHANNELS];
+	int32_t out[PLATFORM_MAX_CHANNELS];
+	const int32_t *c;
+	int64_t *d;
+	int nch = mc->channels;
+	int ch;
+	int f;
+	int i;
+	int j;
+
+	for (f = 0; f < frames; f++) {
+		c = mc->coef;
+		d = mc->delay;
+
+		for (ch = 0; ch < nch; ch++) {
+			in[ch] = data[ch];
+			out[ch] = 0;
+		}
+
+		for (j = 0; j < mc->biquads; j += mc->biquads_in_series) {
+			for (i = 0; i < mc->biquads_in_series; i++) {
+				iir_mc_biquad(c, d, in, nch);
+				c += SOF_EQ_IIR_NBIQUAD_DF2T * nch;
+				d += IIR_DF2T_NUM_DELAYS * nch;
+			}
+
+			/* Output of previous section is in in[] */
+			for (ch = 0; ch < nch; ch++)
+				out[ch] = sat_int32((int64_t)out[ch] + in[ch]);
+		}
+
+		for (ch = 0; ch < nch; ch++)
+			data[ch] = out[ch];
+
+		data += nch;
+	}
+}
+
+#endif
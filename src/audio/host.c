@@ -7,6 +7,7 @@
 
 #include <sof/audio/buffer.h>
 #include <sof/audio/component.h>
+#include <sof/audio/pcm_converter.h>
 #include <sof/audio/pipeline.h>
 #include <sof/common.h>
 #include <sof/debug/panic.h>
@@ -98,9 +99,8 @@ struct host_data {
 				   *  copied by dma connected to host
 				   */
 
-	/* processing function */
-	void (*process)(struct comp_buffer *source, struct comp_buffer *sink,
-			uint32_t bytes);
+	/* conversion between DMA buffer and local buffer formats */
+	struct pcm_converter conv;
 
 	/* stream info */
 	struct sof_ipc_stream_posn posn; /* TODO: update this */
@@ -141,12 +141,12 @@ static void host_update_position(struct comp_dev *dev, uint32_t bytes)
 	if (dev->params.direction == SOF_IPC_STREAM_PLAYBACK) {
 		local_buffer = list_first_item(&dev->bsink_list,
 					       struct comp_buffer, source_list);
-		dma_buffer_copy_from(hd->dma_buffer, local_buffer, hd->process,
+		dma_buffer_copy_from(hd->dma_buffer, local_buffer, &hd->conv,
 				     bytes);
 	} else {
 		local_buffer = list_first_item(&dev->bsource_list,
 					       struct comp_buffer, sink_list);
-		dma_buffer_copy_to(local_buffer, hd->dma_buffer, hd->process,
+		dma_buffer_copy_to(local_buffer, hd->dma_buffer, &hd->conv,
 				   bytes);
 	}
 
@@ -585,11 +585,15 @@ static int host_params(struct comp_dev *dev)
 	/* set up callback */
 	dma_set_cb(hd->chan, DMA_CB_TYPE_COPY, host_dma_cb, dev);
 
-	/* set processing function */
-	if (dev->params.frame_fmt == SOF_IPC_FRAME_S16_LE)
-		hd->process = buffer_copy_s16;
-	else
-		hd->process = buffer_copy_s32;
+	/* host keeps the stream format, DAIs convert it when needed */
+	err = pcm_converter_init(&hd->conv, dev->params.frame_fmt,
+				 dev->params.frame_fmt);
+	if (err < 0) {
+		trace_host_error_with_ids(dev, "host_params() error: "
+					  "unsupported frame format %u",
+					  dev->params.frame_fmt);
+		return err;
+	}
 
 	return 0;
 }
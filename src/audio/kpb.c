@@ -73,6 +73,7 @@ static size_t kpb_allocate_history_buffer(struct comp_data *kpb);
 static void kpb_clear_history_buffer(struct hb *buff);
 static void kpb_free_history_buffer(struct hb *buff);
 static inline bool kpb_is_sample_width_supported(uint32_t sampling_width);
+static inline bool kpb_is_copy_width_supported(size_t sample_width);
 static void kpb_copy_samples(struct comp_buffer *sink,
 			     struct comp_buffer *source, size_t size,
 			     size_t sample_width);
@@ -437,7 +438,8 @@ static int kpb_prepare(struct comp_dev *dev)
 	if (!kpb->sel_sink || !kpb->host_sink) {
 		trace_kpb("kpb_prepare() error: could not find "
 			  "sinks: sel_sink %d host_sink %d",
-			  (uint32_t)kpb->sel_sink, (uint32_t)kpb->host_sink);
+			  (uint32_t)(uintptr_t)kpb->sel_sink,
+			  (uint32_t)(uintptr_t)kpb->host_sink);
 		ret = -EIO;
 	}
 
@@ -711,7 +713,8 @@ static int kpb_buffer_data(struct comp_dev *dev, struct comp_buffer *source,
 		}
 
 		/* Check how much space there is in current write buffer */
-		space_avail = (uint32_t)buff->end_addr - (uint32_t)buff->w_ptr;
+		space_avail = (uintptr_t)buff->end_addr -
+			      (uintptr_t)buff->w_ptr;
 
 		if (size_to_copy > space_avail) {
 			/* We have more data to copy than available space
@@ -918,12 +921,12 @@ static void kpb_init_draining(struct comp_dev *dev, struct kpb_client *cli)
 			local_buffered = 0;
 			buff->r_ptr = buff->start_addr;
 			if (buff->state == KPB_BUFFER_FREE) {
-				local_buffered = (uint32_t)buff->w_ptr -
-						 (uint32_t)buff->start_addr;
+				local_buffered = (uintptr_t)buff->w_ptr -
+						 (uintptr_t)buff->start_addr;
 				buffered += local_buffered;
 			} else if (buff->state == KPB_BUFFER_FULL) {
-				local_buffered = (uint32_t)buff->end_addr -
-						 (uint32_t)buff->start_addr;
+				local_buffered = (uintptr_t)buff->end_addr -
+						 (uintptr_t)buff->start_addr;
 				buffered += local_buffered;
 			} else {
 				trace_kpb_error("kpb_init_draining() error: "
@@ -943,8 +946,8 @@ static void kpb_init_draining(struct comp_dev *dev, struct kpb_client *cli)
 					 * and buffer's end address.
 					 */
 					buff = buff->prev;
-					buffered += (uint32_t)buff->end_addr -
-						    (uint32_t)buff->w_ptr;
+					buffered += (uintptr_t)buff->end_addr -
+						    (uintptr_t)buff->w_ptr;
 					buff->r_ptr = buff->w_ptr + (buffered -
 						      history_depth);
 					break;
@@ -967,11 +970,12 @@ static void kpb_init_draining(struct comp_dev *dev, struct kpb_client *cli)
 		 */
 		drain_interval = (host_period_size / bytes_per_ms) *
 				 ticks_per_ms;
-		/* In draining intervals we will fill only two periods
-		 * and give host time to read it.
+		/* In draining intervals we will fill only the configured
+		 * number of periods and give host time to read it.
 		 * This way we are safe to not overflow host buffer.
 		 */
-		period_bytes_limit = host_period_size * 2;
+		period_bytes_limit = host_period_size *
+				     CONFIG_COMP_KPB_DRAIN_PERIODS;
 
 		trace_kpb("kpb_init_draining(), schedule draining task");
 
@@ -1053,7 +1057,8 @@ static enum task_state kpb_draining_task(void *arg)
 			period_copy_start = platform_timer_get(platform_timer);
 		}
 
-		size_to_read = (uint32_t)buff->end_addr - (uint32_t)buff->r_ptr;
+		size_to_read = (uintptr_t)buff->end_addr -
+			       (uintptr_t)buff->r_ptr;
 
 		if (size_to_read > sink->free) {
 			if (sink->free >= history_depth)
@@ -1136,40 +1141,37 @@ out:
 /**
  * \brief Drain data samples safe, according to configuration.
  *
- * \param[in] dev - kpb component device pointer
+ * \param[in] source - pointer to history buffer data.
  * \param[in] sink - pointer to sink buffer.
- * \param[in] source - pointer to source buffer.
  * \param[in] size - requested copy size in bytes.
+ * \param[in] sample_width - sample size.
+ *
+ * History data is linear and already in sink format, so it is copied in
+ * blocks split only where the sink wraps.
  *
  * \return none.
  */
 static void kpb_drain_samples(void *source, struct comp_buffer *sink,
 			       size_t size, size_t sample_width)
 {
-	void *dst;
 	void *src = source;
-	size_t i;
-	size_t j = 0;
-	size_t channel;
-	size_t frames = KPB_BYTES_TO_FRAMES(size, sample_width);
-
-	for (i = 0; i < frames; i++) {
-		for (channel = 0; channel < KPB_NR_OF_CHANNELS; channel++) {
-			if (sample_width == 16) {
-				dst = buffer_write_frag_s16(sink, j);
-				*((int16_t *)dst) = *((int16_t *)src);
-				src = ((int16_t *)src) + 1;
-			} else if (sample_width == 32 || sample_width == 24) {
-				dst = buffer_write_frag_s32(sink, j);
-				*((int32_t *)dst) = *((int32_t *)src);
-				src = ((int32_t *)src) + 1;
-			} else {
-				trace_kpb_error("KPB: An attempt to copy "
-						"not supported format!");
-				return;
-			}
-			j++;
-		}
+	void *dst = sink->w_ptr;
+	size_t n;
+	int ret;
+
+	if (!kpb_is_copy_width_supported(sample_width)) {
+		trace_kpb_error("KPB: An attempt to copy "
+				"not supported format!");
+		return;
+	}
+
+	while (size) {
+		n = MIN(size, buffer_bytes_without_wrap(sink, dst));
+		ret = memcpy_s(dst, n, src, n);
+		assert(!ret);
+		size -= n;
+		src = (char *)src + n;
+		dst = buffer_wrap(sink, (char *)dst + n);
 	}
 }
 
@@ -1177,38 +1179,31 @@ static void kpb_drain_samples(void *source, struct comp_buffer *sink,
  * \brief Buffers data samples safe, according to configuration.
  * \param[in,out] source Pointer to source buffer.
  * \param[in] start Start offset of source buffer in bytes.
- * \param[in,out] sink Pointer to sink buffer.
+ * \param[in,out] sink Pointer to history buffer data.
  * \param[in] size Requested copy size in bytes.
  * \param[in] sample_width Sample size.
  */
 static void kpb_buffer_samples(struct comp_buffer *source, uint32_t start,
 			       void *sink, size_t size, size_t sample_width)
 {
-	void *src;
+	void *src = buffer_wrap(source, (char *)source->r_ptr + start);
 	void *dst = sink;
-	size_t i;
-	size_t j = start /
-		(sample_width == 16 ? sizeof(int16_t) : sizeof(int32_t));
-	size_t channel;
-	size_t frames = KPB_BYTES_TO_FRAMES(size, sample_width);
-
-	for (i = 0; i < frames; i++) {
-		for (channel = 0; channel < KPB_NR_OF_CHANNELS; channel++) {
-			if (sample_width == 16) {
-				src = buffer_read_frag_s16(source, j);
-				*((int16_t *)dst) = *((int16_t *)src);
-				dst = ((int16_t *)dst) + 1;
-			} else if (sample_width == 32 || sample_width == 24) {
-				src = buffer_read_frag_s32(source, j);
-				*((int32_t *)dst) = *((int32_t *)src);
-				dst = ((int32_t *)dst) + 1;
-			} else {
-				trace_kpb_error("KPB: An attempt to copy "
-						"not supported format!");
-				return;
-			}
-			j++;
-		}
+	size_t n;
+	int ret;
+
+	if (!kpb_is_copy_width_supported(sample_width)) {
+		trace_kpb_error("KPB: An attempt to copy "
+				"not supported format!");
+		return;
+	}
+
+	while (size) {
+		n = MIN(size, buffer_bytes_without_wrap(source, src));
+		ret = memcpy_s(dst, n, src, n);
+		assert(!ret);
+		size -= n;
+		src = buffer_wrap(source, (char *)src + n);
+		dst = (char *)dst + n;
 	}
 }
 
@@ -1228,7 +1223,7 @@ static void kpb_clear_history_buffer(struct hb *buff)
 
 	do {
 		start_addr = buff->start_addr;
-		size = (uint32_t)buff->end_addr - (uint32_t)start_addr;
+		size = (uintptr_t)buff->end_addr - (uintptr_t)start_addr;
 
 		bzero(start_addr, size);
 
@@ -1254,13 +1249,19 @@ static inline bool kpb_is_sample_width_supported(uint32_t sampling_width)
 	return ret;
 }
 
+/* sample containers the copy functions can move */
+static inline bool kpb_is_copy_width_supported(size_t sample_width)
+{
+	return sample_width == 16 || sample_width == 24 || sample_width == 32;
+}
+
 /**
  * \brief Copy data samples safe, according to configuration.
  *
- * \param[in] dev - kpb component device pointer
  * \param[in] sink - pointer to sink buffer.
  * \param[in] source - pointer to source buffer.
  * \param[in] size - requested copy size in bytes.
+ * \param[in] sample_width - sample size.
  *
  * \return none.
  */
@@ -1268,31 +1269,13 @@ static void kpb_copy_samples(struct comp_buffer *sink,
 			     struct comp_buffer *source, size_t size,
 			     size_t sample_width)
 {
-	void *dst;
-	void *src;
-	size_t i;
-	size_t j = 0;
-	size_t channel;
-	size_t frames = KPB_BYTES_TO_FRAMES(size, sample_width);
-
-	for (i = 0; i < frames; i++) {
-		for (channel = 0; channel < KPB_NR_OF_CHANNELS; channel++) {
-			if (sample_width == 16) {
-				dst = buffer_write_frag_s16(sink, j);
-				src = buffer_read_frag_s16(source, j);
-				*((int16_t *)dst) = *((int16_t *)src);
-			} else if (sample_width == 32 || sample_width == 24) {
-				dst = buffer_write_frag_s32(sink, j);
-				src = buffer_read_frag_s32(source, j);
-				*((int32_t *)dst) = *((int32_t *)src);
-			} else {
-				trace_kpb_error("KPB: An attempt to copy "
-						"not supported format!");
-				return;
-			}
-			j++;
-		}
+	if (!kpb_is_copy_width_supported(sample_width)) {
+		trace_kpb_error("KPB: An attempt to copy "
+				"not supported format!");
+		return;
 	}
+
+	buffer_copy_bytes(source, sink, size);
 }
 
 /**
@@ -1333,12 +1316,14 @@ static inline bool validate_host_params(size_t host_period_size,
 	 * The formula:
 	 *	drained_data_in_one_interval_ms > interval_break_ms
 	 * where:
-	 * drained_data_in_one_interval_ms = (host_period_size * 2) [ms]
+	 * drained_data_in_one_interval_ms =
+	 *	(host_period_size * CONFIG_COMP_KPB_DRAIN_PERIODS) [ms]
 	 * interval_break_ms = host_period_size / bytes_per_ms [ms]
 	 */
 
 	if (host_period_size < bytes_per_ms || /* Out of control */
-	    host_period_size >= (host_buffer_size / 2)) /* XRUN */
+	    host_period_size >=
+	    (host_buffer_size / CONFIG_COMP_KPB_DRAIN_PERIODS)) /* XRUN */
 		return false;
 
 	return true;
@@ -34,73 +34,234 @@
 #define trace_mixer_error(__e, ...) \
 	trace_error(TRACE_CLASS_MIXER, __e, ##__VA_ARGS__)
 
+/* source gain state, ramped a frame at a time */
+struct mixer_gain {
+	int32_t gain;		/* current Q1.16 gain */
+	int32_t target;		/* gain at end of ramp */
+	int32_t step;		/* gain change per frame */
+	uint32_t ramp;		/* frames left in ramp */
+};
+
 /* mixer component private data */
 struct mixer_data {
+	struct mixer_gain gain[PLATFORM_MAX_STREAMS]; /* by source index */
+	uint32_t ramp_frames;
 	void (*mix_func)(struct comp_dev *dev, struct comp_buffer *sink,
-		struct comp_buffer **sources, uint32_t count, uint32_t frames);
+			 struct comp_buffer **sources,
+			 struct mixer_gain **gains, uint32_t count,
+			 uint32_t frames);
 };
 
-/* Mix n 16 bit PCM source streams to one sink stream */
-static void mix_n_s16(struct comp_dev *dev, struct comp_buffer *sink,
-		      struct comp_buffer **sources, uint32_t num_sources,
-		      uint32_t frames)
+/* advance a gain ramp by one frame and return the gain for the next one */
+static inline int32_t mixer_gain_step(struct mixer_gain *g)
 {
-	int16_t *src;
-	int16_t *dest;
-	int32_t val;
-	int i;
-	int j;
-	int channel;
-	uint32_t frag = 0;
+	if (!g->ramp)
+		return g->gain;
 
-	for (i = 0; i < frames; i++) {
-		for (channel = 0; channel < dev->params.channels; channel++) {
-			val = 0;
+	g->gain = --g->ramp ? g->gain + g->step : g->target;
+	return g->gain;
+}
 
-			for (j = 0; j < num_sources; j++) {
-				src = buffer_read_frag_s16(sources[j], frag);
-				val += *src;
-			}
+/* accumulate n samples of one 16 bit source */
+static inline void mix_acc_s16(int32_t *acc, const int16_t *src,
+			       struct mixer_gain *g, uint32_t n, uint32_t nch)
+{
+	int32_t gain = g->gain;
+	uint32_t i;
+	uint32_t c;
+
+	if (g->ramp) {
+		for (i = 0; i < n; i += nch) {
+			for (c = 0; c < nch; c++)
+				acc[i + c] += (src[i + c] * gain) >>
+					MIXER_GAIN_Q;
+			gain = mixer_gain_step(g);
+		}
+	} else if (gain == MIXER_GAIN_UNITY) {
+		for (i = 0; i < n; i++)
+			acc[i] += src[i];
+	} else if (gain) {
+		/* attenuation only, so the product fits in 32 bits */
+		for (i = 0; i < n; i++)
+			acc[i] += (src[i] * gain) >> MIXER_GAIN_Q;
+	}
+}
 
-			dest = buffer_write_frag_s16(sink, frag);
+/* accumulate n samples of one 32 bit source */
+static inline void mix_acc_s32(int64_t *acc, const int32_t *src,
+			       struct mixer_gain *g, uint32_t n, uint32_t nch)
+{
+	int32_t gain = g->gain;
+	uint32_t i;
+	uint32_t c;
+
+	if (g->ramp) {
+		for (i = 0; i < n; i += nch) {
+			for (c = 0; c < nch; c++)
+				acc[i + c] += ((int64_t)src[i + c] * gain) >>
+					MIXER_GAIN_Q;
+			gain = mixer_gain_step(g);
+		}
+	} else if (gain == MIXER_GAIN_UNITY) {
+		for (i = 0; i < n; i++)
+			acc[i] += src[i];
+	} else if (gain) {
+		for (i = 0; i < n; i++)
+			acc[i] += ((int64_t)src[i] * gain) >> MIXER_GAIN_Q;
+	}
+}
 
-			/* Saturate to 16 bits */
-			*dest = sat_int16(val);
+/* mix one 16 bit frame that wraps in the sink or in any of the sources */
+static void mix_frame_wrap_s16(struct comp_buffer *sink, int16_t *dest,
+			       struct comp_buffer **sources, int16_t **src,
+			       struct mixer_gain **gains, uint32_t num_sources,
+			       uint32_t nch)
+{
+	int32_t acc[PLATFORM_MAX_CHANNELS];
+	int16_t frame[PLATFORM_MAX_CHANNELS];
+	uint32_t c;
+	uint32_t j;
+
+	for (c = 0; c < nch; c++)
+		acc[c] = 0;
+
+	for (j = 0; j < num_sources; j++) {
+		for (c = 0; c < nch; c++)
+			frame[c] = *(int16_t *)buffer_wrap(sources[j],
+							  src[j] + c);
+		mix_acc_s16(acc, frame, gains[j], nch, nch);
+	}
+
+	for (c = 0; c < nch; c++)
+		*(int16_t *)buffer_wrap(sink, dest + c) = sat_int16(acc[c]);
+}
+
+/*
+ * Mix n 16 bit PCM source streams to one sink stream. Each block is
+ * accumulated source by source over contiguous samples so the inner loops
+ * vectorize, then saturated once into the sink.
+ */
+static void mix_n_s16(struct comp_dev *dev, struct comp_buffer *sink,
+		      struct comp_buffer **sources, struct mixer_gain **gains,
+		      uint32_t num_sources, uint32_t frames)
+{
+	int32_t acc[MIXER_BLOCK_SAMPLES];
+	int16_t *src[PLATFORM_MAX_STREAMS];
+	int16_t *dest = sink->w_ptr;
+	uint32_t nch = dev->params.channels;
+	uint32_t block = MIXER_BLOCK_SAMPLES - MIXER_BLOCK_SAMPLES % nch;
+	uint32_t samples = frames * nch;
+	uint32_t n;
+	uint32_t i;
+	uint32_t j;
+
+	for (j = 0; j < num_sources; j++)
+		src[j] = sources[j]->r_ptr;
+
+	while (samples) {
+		/* largest block that doesn't wrap in any buffer */
+		n = MIN(samples, block);
+		n = MIN(n, buffer_s16_without_wrap(sink, dest));
+		for (j = 0; j < num_sources; j++)
+			n = MIN(n, buffer_s16_without_wrap(sources[j], src[j]));
+
+		/* whole frames only, gain ramps step a frame at a time */
+		n -= n % nch;
+		if (!n) {
+			mix_frame_wrap_s16(sink, dest, sources, src, gains,
+					  num_sources, nch);
+			n = nch;
+		} else {
+			for (i = 0; i < n; i++)
+				acc[i] = 0;
+
+			for (j = 0; j < num_sources; j++)
+				mix_acc_s16(acc, src[j], gains[j], n, nch);
 
-			frag++;
+			/* Saturate to 16 bits */
+			for (i = 0; i < n; i++)
+				dest[i] = sat_int16(acc[i]);
 		}
+
+		samples -= n;
+		dest = buffer_wrap(sink, dest + n);
+		for (j = 0; j < num_sources; j++)
+			src[j] = buffer_wrap(sources[j], src[j] + n);
 	}
 }
 
-/* Mix n 32 bit PCM source streams to one sink stream */
-static void mix_n_s32(struct comp_dev *dev, struct comp_buffer *sink,
-		      struct comp_buffer **sources, uint32_t num_sources,
-		      uint32_t frames)
+/* mix one 32 bit frame that wraps in the sink or in any of the sources */
+static void mix_frame_wrap_s32(struct comp_buffer *sink, int32_t *dest,
+			       struct comp_buffer **sources, int32_t **src,
+			       struct mixer_gain **gains, uint32_t num_sources,
+			       uint32_t nch)
 {
-	int32_t *src;
-	int32_t *dest;
-	int64_t val;
-	int i;
-	int j;
-	int channel;
-	uint32_t frag = 0;
-
-	for (i = 0; i < frames; i++) {
-		for (channel = 0; channel < dev->params.channels; channel++) {
-			val = 0;
+	int64_t acc[PLATFORM_MAX_CHANNELS];
+	int32_t frame[PLATFORM_MAX_CHANNELS];
+	uint32_t c;
+	uint32_t j;
+
+	for (c = 0; c < nch; c++)
+		acc[c] = 0;
+
+	for (j = 0; j < num_sources; j++) {
+		for (c = 0; c < nch; c++)
+			frame[c] = *(int32_t *)buffer_wrap(sources[j],
+							  src[j] + c);
+		mix_acc_s32(acc, frame, gains[j], nch, nch);
+	}
 
-			for (j = 0; j < num_sources; j++) {
-				src = buffer_read_frag_s32(sources[j], frag);
-				val += *src;
-			}
+	for (c = 0; c < nch; c++)
+		*(int32_t *)buffer_wrap(sink, dest + c) = sat_int32(acc[c]);
+}
 
-			dest = buffer_write_frag_s32(sink, frag);
+/* Mix n 32 bit PCM source streams to one sink stream */
+static void mix_n_s32(struct comp_dev *dev, struct comp_buffer *sink,
+		      struct comp_buffer **sources, struct mixer_gain **gains,
+		      uint32_t num_sources, uint32_t frames)
+{
+	int64_t acc[MIXER_BLOCK_SAMPLES];
+	int32_t *src[PLATFORM_MAX_STREAMS];
+	int32_t *dest = sink->w_ptr;
+	uint32_t nch = dev->params.channels;
+	uint32_t block = MIXER_BLOCK_SAMPLES - MIXER_BLOCK_SAMPLES % nch;
+	uint32_t samples = frames * nch;
+	uint32_t n;
+	uint32_t i;
+	uint32_t j;
+
+	for (j = 0; j < num_sources; j++)
+		src[j] = sources[j]->r_ptr;
+
+	while (samples) {
+		/* largest block that doesn't wrap in any buffer */
+		n = MIN(samples, block);
+		n = MIN(n, buffer_s32_without_wrap(sink, dest));
+		for (j = 0; j < num_sources; j++)
+			n = MIN(n, buffer_s32_without_wrap(sources[j], src[j]));
+
+		/* whole frames only, gain ramps step a frame at a time */
+		n -= n % nch;
+		if (!n) {
+			mix_frame_wrap_s32(sink, dest, sources, src, gains,
+					  num_sources, nch);
+			n = nch;
+		} else {
+			for (i = 0; i < n; i++)
+				acc[i] = 0;
+
+			for (j = 0; j < num_sources; j++)
+				mix_acc_s32(acc, src[j], gains[j], n, nch);
 
 			/* Saturate to 32 bits */
-			*dest = sat_int32(val);
-
-			frag++;
+			for (i = 0; i < n; i++)
+				dest[i] = sat_int32(acc[i]);
 		}
+
+		samples -= n;
+		dest = buffer_wrap(sink, dest + n);
+		for (j = 0; j < num_sources; j++)
+			src[j] = buffer_wrap(sources[j], src[j] + n);
 	}
 }
 
@@ -112,6 +273,7 @@ static struct comp_dev *mixer_new(struct sof_ipc_comp *comp)
 		(struct sof_ipc_comp_mixer *)comp;
 	struct mixer_data *md;
 	int ret;
+	int i;
 
 	trace_mixer("mixer_new()");
 
@@ -137,6 +299,11 @@ static struct comp_dev *mixer_new(struct sof_ipc_comp *comp)
 		return NULL;
 	}
 
+	for (i = 0; i < PLATFORM_MAX_STREAMS; i++) {
+		md->gain[i].gain = MIXER_GAIN_UNITY;
+		md->gain[i].target = MIXER_GAIN_UNITY;
+	}
+
 	comp_set_drvdata(dev, md);
 	dev->state = COMP_STATE_READY;
 	return dev;
@@ -180,6 +347,122 @@ static int mixer_params(struct comp_dev *dev)
 	return 0;
 }
 
+/* set source gain, ramped if the mixer is already running */
+static int mixer_set_gain(struct comp_dev *dev, uint32_t index,
+			  uint32_t value)
+{
+	struct mixer_data *md = comp_get_drvdata(dev);
+	struct mixer_gain *g;
+
+	if (index >= PLATFORM_MAX_STREAMS || value > MIXER_GAIN_UNITY) {
+		trace_mixer_error("mixer_set_gain() error: index = %u, "
+				  "value = %u", index, value);
+		return -EINVAL;
+	}
+
+	g = &md->gain[index];
+	g->target = value;
+
+	if (dev->state != COMP_STATE_ACTIVE || !md->ramp_frames) {
+		g->gain = value;
+		g->ramp = 0;
+		return 0;
+	}
+
+	g->step = ((int32_t)value - g->gain) / (int32_t)md->ramp_frames;
+	g->ramp = md->ramp_frames;
+
+	return 0;
+}
+
+/* checks that the control fits the IPC message */
+static int mixer_ctrl_check(struct sof_ipc_ctrl_data *cdata,
+			    int max_data_size)
+{
+	if (cdata->cmd != SOF_CTRL_CMD_VOLUME ||
+	    cdata->num_elems == 0 || cdata->num_elems > PLATFORM_MAX_STREAMS ||
+	    sizeof(*cdata) + cdata->num_elems * sizeof(cdata->compv[0]) >
+	    max_data_size) {
+		trace_mixer_error("mixer_ctrl_check() error: cmd = %u, "
+				  "num_elems = %u, max_data_size = %d",
+				  cdata->cmd, cdata->num_elems, max_data_size);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static int mixer_ctrl_set_cmd(struct comp_dev *dev,
+			      struct sof_ipc_ctrl_data *cdata,
+			      int max_data_size)
+{
+	int ret;
+	int j;
+
+	ret = mixer_ctrl_check(cdata, max_data_size);
+	if (ret < 0)
+		return ret;
+
+	for (j = 0; j < cdata->num_elems; j++) {
+		trace_mixer("mixer_ctrl_set_cmd(), source = %u, gain = %u",
+			    cdata->compv[j].index, cdata->compv[j].uvalue);
+		ret = mixer_set_gain(dev, cdata->compv[j].index,
+				     cdata->compv[j].uvalue);
+		if (ret < 0)
+			return ret;
+	}
+
+	return 0;
+}
+
+static int mixer_ctrl_get_cmd(struct comp_dev *dev,
+			      struct sof_ipc_ctrl_data *cdata,
+			      int max_data_size)
+{
+	struct mixer_data *md = comp_get_drvdata(dev);
+	uint32_t index;
+	int ret;
+	int j;
+
+	ret = mixer_ctrl_check(cdata, max_data_size);
+	if (ret < 0)
+		return ret;
+
+	for (j = 0; j < cdata->num_elems; j++) {
+		index = cdata->compv[j].index;
+		if (index >= PLATFORM_MAX_STREAMS) {
+			trace_mixer_error("mixer_ctrl_get_cmd() error: "
+					  "index = %u", index);
+			return -EINVAL;
+		}
+
+		cdata->compv[j].uvalue = md->gain[index].target;
+	}
+
+	return 0;
+}
+
+/*
+ * Per source gain is set with SOF_CTRL_CMD_VOLUME, compv index is the
+ * source position in the mixer source list and value the Q1.16 gain.
+ */
+static int mixer_cmd(struct comp_dev *dev, int cmd, void *data,
+		     int max_data_size)
+{
+	struct sof_ipc_ctrl_data *cdata = data;
+
+	trace_mixer("mixer_cmd()");
+
+	switch (cmd) {
+	case COMP_CMD_SET_VALUE:
+		return mixer_ctrl_set_cmd(dev, cdata, max_data_size);
+	case COMP_CMD_GET_VALUE:
+		return mixer_ctrl_get_cmd(dev, cdata, max_data_size);
+	default:
+		return -EINVAL;
+	}
+}
+
 static int mixer_source_status_count(struct comp_dev *mixer, uint32_t status)
 {
 	struct comp_buffer *source;
@@ -196,6 +479,17 @@ static int mixer_source_status_count(struct comp_dev *mixer, uint32_t status)
 	return count;
 }
 
+static int mixer_source_count(struct comp_dev *mixer)
+{
+	struct list_item *blist;
+	int count = 0;
+
+	list_for_item(blist, &mixer->bsource_list)
+		count++;
+
+	return count;
+}
+
 static inline int mixer_sink_status(struct comp_dev *mixer)
 {
 	struct comp_buffer *sink;
@@ -252,9 +546,11 @@ static int mixer_copy(struct comp_dev *dev)
 	struct mixer_data *md = comp_get_drvdata(dev);
 	struct comp_buffer *sink;
 	struct comp_buffer *sources[PLATFORM_MAX_STREAMS];
+	struct mixer_gain *gains[PLATFORM_MAX_STREAMS];
 	struct comp_buffer *source;
 	struct list_item *blist;
 	int32_t i = 0;
+	int32_t index = 0;
 	int32_t num_mix_sources = 0;
 	uint32_t frames = INT32_MAX;
 	uint32_t source_bytes;
@@ -269,15 +565,18 @@ static int mixer_copy(struct comp_dev *dev)
 	 * between input streams
 	 */
 	list_for_item(blist, &dev->bsource_list) {
+		/* sources past the gain slots are refused by prepare */
+		if (index == PLATFORM_MAX_STREAMS)
+			break;
+
 		source = container_of(blist, struct comp_buffer, sink_list);
 
 		/* only mix the sources with the same state with mixer */
-		if (source->source->state == dev->state)
+		if (source->source->state == dev->state) {
+			gains[num_mix_sources] = &md->gain[index];
 			sources[num_mix_sources++] = source;
-
-		/* too many sources ? */
-		if (num_mix_sources == PLATFORM_MAX_STREAMS - 1)
-			return 0;
+		}
+		index++;
 	}
 
 	/* don't have any work if all sources are inactive */
@@ -298,7 +597,7 @@ static int mixer_copy(struct comp_dev *dev)
 		     source_bytes, sink_bytes);
 
 	/* mix streams */
-	md->mix_func(dev, sink, sources, i, frames);
+	md->mix_func(dev, sink, sources, gains, i, frames);
 
 	/* update source buffer pointers */
 	for (i = --num_mix_sources; i >= 0; i--)
@@ -347,11 +646,19 @@ static int mixer_prepare(struct comp_dev *dev)
 
 	trace_mixer("mixer_prepare()");
 
+	/* every source needs a gain slot */
+	if (mixer_source_count(dev) > PLATFORM_MAX_STREAMS) {
+		trace_mixer_error("mixer_prepare() error: more than %u "
+				  "sources", PLATFORM_MAX_STREAMS);
+		return -EINVAL;
+	}
+
 	/* does mixer already have active source streams ? */
 	if (dev->state != COMP_STATE_ACTIVE) {
 		/* currently inactive so setup mixer */
 		md->mix_func = dev->params.frame_fmt == SOF_IPC_FRAME_S16_LE ?
 			mix_n_s16 : mix_n_s32;
+		md->ramp_frames = dev->params.rate * MIXER_GAIN_RAMP_MS / 1000;
 
 		ret = comp_set_state(dev, COMP_TRIGGER_PREPARE);
 		if (ret < 0)
@@ -408,6 +715,7 @@ struct comp_driver comp_mixer = {
 		.free		= mixer_free,
 		.params		= mixer_params,
 		.prepare	= mixer_prepare,
+		.cmd		= mixer_cmd,
 		.trigger	= mixer_trigger,
 		.copy		= mixer_copy,
 		.reset		= mixer_reset,
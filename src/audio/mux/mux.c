@@ -11,6 +11,7 @@
 
 #include <sof/audio/component.h>
 #include <sof/audio/mux.h>
+#include <sof/bit.h>
 #include <sof/common.h>
 #include <sof/drivers/ipc.h>
 #include <sof/lib/alloc.h>
@@ -153,6 +154,109 @@ static int mux_params(struct comp_dev *dev)
 	return 0;
 }
 
+/* appends taps of input channels selected by mask to the look up table */
+static void mux_look_up_add(struct comp_data *cd, uint32_t *tap,
+			    uint8_t stream, uint32_t num_ch, uint8_t mask)
+{
+	uint32_t in_ch;
+
+	for (in_ch = 0; in_ch < num_ch; in_ch++) {
+		if (mask & BIT(in_ch)) {
+			cd->taps[*tap].stream = stream;
+			cd->taps[*tap].channel = in_ch;
+			(*tap)++;
+		}
+	}
+}
+
+/* output channel ch just added to lookup, check if it is a plain copy */
+static void mux_look_up_check_copy(struct mux_look_up *lookup, uint8_t ch)
+{
+	if (lookup->first[ch + 1] - lookup->first[ch] != 1)
+		lookup->copy = 0;
+}
+
+/*
+ * Compiles routing bitmasks of all source streams into the gather list of
+ * the single mux output stream.
+ */
+static int mux_prepare_look_up_table(struct comp_dev *dev)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	struct mux_look_up *lookup = &cd->lookup[0];
+	struct mux_stream_data *stream;
+	uint32_t tap = 0;
+	uint8_t out_ch;
+	uint8_t i;
+
+	if (cd->config.num_channels > PLATFORM_MAX_CHANNELS) {
+		trace_mux_error("mux_prepare_look_up_table() error: %u output "
+				"channels exceed platform maximum = "
+				META_QUOTE(PLATFORM_MAX_CHANNELS),
+				cd->config.num_channels);
+		return -EINVAL;
+	}
+
+	lookup->num_channels = cd->config.num_channels;
+	lookup->copy = 1;
+
+	for (out_ch = 0; out_ch < lookup->num_channels; out_ch++) {
+		lookup->first[out_ch] = tap;
+		for (i = 0; i < MUX_MAX_STREAMS; i++) {
+			stream = &cd->config.streams[i];
+			mux_look_up_add(cd, &tap, i, stream->num_channels,
+					stream->mask[out_ch]);
+		}
+		lookup->first[out_ch + 1] = tap;
+		mux_look_up_check_copy(lookup, out_ch);
+	}
+
+	return 0;
+}
+
+/*
+ * Compiles routing bitmasks of each sink stream into its own gather list
+ * over the channels of the single demux source stream.
+ */
+static void demux_prepare_look_up_table(struct comp_dev *dev)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	struct mux_look_up *lookup;
+	struct mux_stream_data *stream;
+	uint32_t tap = 0;
+	uint8_t out_ch;
+	uint8_t i;
+
+	for (i = 0; i < MUX_MAX_STREAMS; i++) {
+		stream = &cd->config.streams[i];
+		lookup = &cd->lookup[i];
+		lookup->num_channels = stream->num_channels;
+		lookup->copy = 1;
+
+		for (out_ch = 0; out_ch < lookup->num_channels; out_ch++) {
+			lookup->first[out_ch] = tap;
+			mux_look_up_add(cd, &tap, 0, cd->config.num_channels,
+					stream->mask[out_ch]);
+			lookup->first[out_ch + 1] = tap;
+			mux_look_up_check_copy(lookup, out_ch);
+		}
+	}
+}
+
+/* recompiles routing of a prepared component after new bitmasks are set */
+static int mux_update_look_up_table(struct comp_dev *dev)
+{
+	if (dev->state == COMP_STATE_READY)
+		return 0;
+
+	if (dev->comp.type == SOF_COMP_DEMUX) {
+		demux_prepare_look_up_table(dev);
+		return 0;
+	}
+
+	return mux_prepare_look_up_table(dev);
+}
+
 static int mux_ctrl_set_cmd(struct comp_dev *dev,
 			    struct sof_ipc_ctrl_data *cdata)
 {
@@ -164,9 +268,12 @@ static int mux_ctrl_set_cmd(struct comp_dev *dev,
 
 	switch (cdata->cmd) {
 	case SOF_CTRL_CMD_BINARY:
-		cfg = (struct sof_mux_config *)cdata->data->data;
+		cfg = (struct sof_mux_config *)
+		      ASSUME_ALIGNED((void *)cdata->data->data, 4);
 
 		ret = mux_set_values(cd, cfg);
+		if (!ret)
+			ret = mux_update_look_up_table(dev);
 		break;
 	default:
 		trace_mux_error("mux_ctrl_set_cmd() error: invalid cdata->cmd ="
@@ -262,7 +369,7 @@ static int demux_copy(struct comp_dev *dev)
 		if (!sinks[i])
 			continue;
 
-		cd->demux(dev, sinks[i], source, frames, &cd->config.streams[i]);
+		cd->demux(dev, sinks[i], source, frames, &cd->lookup[i]);
 	}
 
 	/* update components */
@@ -328,7 +435,7 @@ static int mux_copy(struct comp_dev *dev)
 	sink_bytes = frames * comp_frame_bytes(sink->sink);
 
 	/* produce output */
-	cd->mux(dev, sink, &sources[0], frames, &cd->config.streams[0]);
+	cd->mux(dev, sink, &sources[0], frames, &cd->lookup[0]);
 
 	/* update components */
 	comp_update_buffer_produce(sink, sink_bytes);
@@ -369,6 +476,10 @@ static int mux_prepare(struct comp_dev *dev)
 		goto err;
 	}
 
+	ret = mux_prepare_look_up_table(dev);
+	if (ret < 0)
+		goto err;
+
 	return 0;
 
 err:
@@ -398,6 +509,8 @@ static int demux_prepare(struct comp_dev *dev)
 		goto err;
 	}
 
+	demux_prepare_look_up_table(dev);
+
 	return 0;
 
 err:
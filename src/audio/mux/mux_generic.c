@@ -12,346 +12,511 @@
 #include <sof/audio/component.h>
 #include <sof/audio/format.h>
 #include <sof/audio/mux.h>
-#include <sof/bit.h>
 #include <sof/common.h>
 #include <ipc/stream.h>
 #include <stddef.h>
 #include <stdint.h>
 
 /*
- * \brief Fetch 16b samples from source buffer and perform routing operations
- *	  based on mask provided.
- * \param[in,out] source Source buffer.
- * \param[in] num_ch Number of channels in source buffer.
- * \param[in] offset Offset in source buffer.
- * \param[in] mask Routing bitmask for calculating output sample.
+ * \brief Number of whole frames that can be accessed linearly from ptr.
+ * \param[in] buffer Buffer the pointer belongs to.
+ * \param[in] ptr Read or write position inside the buffer.
+ * \param[in] frame_bytes Frame size, streams without channels never wrap.
  */
-UT_STATIC inline int32_t calc_sample_s16le(struct comp_buffer *source,
-					   uint8_t num_ch, uint32_t offset,
-					   uint8_t mask)
+static inline uint32_t mux_frames_without_wrap(struct comp_buffer *buffer,
+					       void *ptr, uint32_t frame_bytes)
 {
-	int32_t sample = 0;
-	int16_t *src;
-	int8_t in_ch;
+	if (!frame_bytes)
+		return UINT32_MAX;
+
+	return buffer_bytes_without_wrap(buffer, ptr) / frame_bytes;
+}
+
+/* read position of inactive mux sources, never advanced */
+static const int32_t mux_silence[PLATFORM_MAX_CHANNELS];
 
-	if (mask == 0)
-		return 0;
+/*
+ * \brief Sets up read positions and frame strides of mux sources.
+ * \param[in] cd Mux component private data.
+ * \param[in] sources Array of source buffers, NULL for inactive streams.
+ * \param[out] src Read positions of sources.
+ * \param[out] src_ch Channels of each source, zero for inactive streams.
+ */
+static void mux_sources_init(struct comp_data *cd,
+			     struct comp_buffer **sources, void **src,
+			     uint32_t *src_ch)
+{
+	uint8_t j;
 
-	for (in_ch = 0; in_ch < num_ch; in_ch++) {
-		if (mask & BIT(in_ch)) {
-			src = buffer_read_frag_s16(source, offset + in_ch);
-			sample += *src;
+	for (j = 0; j < MUX_MAX_STREAMS; j++) {
+		if (sources[j]) {
+			src[j] = sources[j]->r_ptr;
+			src_ch[j] = cd->config.streams[j].num_channels;
+		} else {
+			src[j] = (void *)mux_silence;
+			src_ch[j] = 0;
 		}
 	}
-
-	return sample;
 }
 
 /*
- * \brief Fetch 24b samples from source buffer and perform routing operations
- *	  based on mask provided.
- * \param[in,out] source Source buffer.
- * \param[in] num_ch Number of channels in source buffer.
- * \param[in] offset Offset in source buffer.
- * \param[in] mask Routing bitmask for calculating output sample.
+ * \brief Number of frames all active mux sources can be read linearly.
+ * \param[in] sources Array of source buffers, NULL for inactive streams.
+ * \param[in] src Read positions of sources.
+ * \param[in] src_ch Channels of each source.
+ * \param[in] sample_bytes Size of single sample.
  */
-UT_STATIC inline int32_t calc_sample_s24le(struct comp_buffer *source,
-					   uint8_t num_ch, uint32_t offset,
-					   uint8_t mask)
+static uint32_t mux_sources_frames_without_wrap(struct comp_buffer **sources,
+						void **src, uint32_t *src_ch,
+						uint32_t sample_bytes)
 {
-	int32_t sample = 0;
-	int32_t *src;
-	int8_t in_ch;
+	uint32_t frames = UINT32_MAX;
+	uint8_t j;
 
-	if (mask == 0)
-		return 0;
+	for (j = 0; j < MUX_MAX_STREAMS; j++) {
+		if (!sources[j])
+			continue;
 
-	for (in_ch = 0; in_ch < num_ch; in_ch++) {
-		if (mask & BIT(in_ch)) {
-			src = buffer_read_frag_s32(source, offset + in_ch);
-			sample += sign_extend_s24(*src);
-		}
+		frames = MIN(frames,
+			     mux_frames_without_wrap(sources[j], src[j],
+						     src_ch[j] * sample_bytes));
 	}
 
-	return sample;
+	return frames;
 }
 
 /*
- * \brief Fetch 32b samples from source buffer and perform routing operations
- *	  based on mask provided.
- * \param[in,out] source Source buffer.
- * \param[in] num_ch Number of channels in source buffer.
- * \param[in] offset Offset in source buffer.
- * \param[in] mask Routing bitmask for calculating output sample.
+ * \brief Wraps read positions of active mux sources.
+ * \param[in] sources Array of source buffers, NULL for inactive streams.
+ * \param[in,out] src Read positions of sources.
  */
-UT_STATIC inline int64_t calc_sample_s32le(struct comp_buffer *source,
-					   uint8_t num_ch, uint32_t offset,
-					   uint8_t mask)
+static void mux_sources_wrap(struct comp_buffer **sources, void **src)
 {
-	int64_t sample = 0;
-	int32_t *src;
-	int8_t in_ch;
-
-	if (mask == 0)
-		return 0;
+	uint8_t j;
 
-	for (in_ch = 0; in_ch < num_ch; in_ch++) {
-		if (mask & BIT(in_ch)) {
-			src = buffer_read_frag_s32(source, offset + in_ch);
-			sample += *src;
-		}
+	for (j = 0; j < MUX_MAX_STREAMS; j++) {
+		if (sources[j])
+			src[j] = buffer_wrap(sources[j], src[j]);
 	}
-
-	return sample;
 }
 
 /* \brief Demuxing 16 bit streams.
  *
- * Source stream is routed to sink with regard to routing bitmasks from
- * mux_stream_data structure. Each bitmask describes composition of single
- * output channel.
+ * Source stream is routed to sink with regard to look up table compiled
+ * from routing bitmasks at prepare. Channels with a single tap are copied,
+ * the others are the saturated sum of their taps.
  *
  * \param[in,out] dev Demux base component device.
  * \param[in,out] sink Destination buffer.
  * \param[in,out] source Source buffer.
  * \param[in] frames Number of frames to process.
- * \param[in] data Parameters describing channel count and routing.
+ * \param[in] lookup Routing of the sink stream.
  */
 static void demux_s16le(struct comp_dev *dev, struct comp_buffer *sink,
 			struct comp_buffer *source, uint32_t frames,
-			struct mux_stream_data *data)
+			struct mux_look_up *lookup)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
+	struct mux_tap *taps = cd->taps;
+	int16_t *src = source->r_ptr;
+	int16_t *dst = sink->w_ptr;
+	uint32_t src_ch = cd->config.num_channels;
+	uint32_t dst_ch = lookup->num_channels;
+	uint32_t ch;
+	uint32_t i;
+	uint32_t n;
+	uint16_t t;
 	int32_t sample;
-	int16_t *dst;
-	uint8_t i;
-	uint8_t out_ch;
-
-	for (i = 0; i < frames; i++) {
-		for (out_ch = 0; out_ch < data->num_channels; out_ch++) {
-			sample = calc_sample_s16le(source,
-						   cd->config.num_channels,
-						   i * cd->config.num_channels,
-						   data->mask[out_ch]);
-
-			/* saturate to 16 bits */
-			dst = buffer_write_frag_s16(sink,
-				i * data->num_channels + out_ch);
-			*dst = sat_int16(sample);
+
+	while (frames) {
+		n = MIN(mux_frames_without_wrap(source, src,
+						src_ch * sizeof(int16_t)),
+			mux_frames_without_wrap(sink, dst,
+						dst_ch * sizeof(int16_t)));
+		n = MIN(n, frames);
+
+		if (lookup->copy) {
+			for (i = 0; i < n; i++) {
+				for (ch = 0; ch < dst_ch; ch++) {
+					t = lookup->first[ch];
+					dst[ch] = src[taps[t].channel];
+				}
+				src += src_ch;
+				dst += dst_ch;
+			}
+		} else {
+			for (i = 0; i < n; i++) {
+				for (ch = 0; ch < dst_ch; ch++) {
+					sample = 0;
+					for (t = lookup->first[ch];
+					     t < lookup->first[ch + 1]; t++)
+						sample += src[taps[t].channel];
+
+					/* saturate to 16 bits */
+					dst[ch] = sat_int16(sample);
+				}
+				src += src_ch;
+				dst += dst_ch;
+			}
 		}
+
+		frames -= n;
+		src = buffer_wrap(source, src);
+		dst = buffer_wrap(sink, dst);
 	}
 }
 
 /* \brief Demuxing 24 bit streams.
  *
- * Source stream is routed to sink with regard to routing bitmasks from
- * mux_stream_data structure. Each bitmask describes composition of single
- * output channel.
+ * Source stream is routed to sink with regard to look up table compiled
+ * from routing bitmasks at prepare. Channels with a single tap are copied,
+ * the others are the saturated sum of their taps.
  *
  * \param[in,out] dev Demux base component device.
  * \param[in,out] sink Destination buffer.
  * \param[in,out] source Source buffer.
  * \param[in] frames Number of frames to process.
- * \param[in] data Parameters describing channel count and routing.
+ * \param[in] lookup Routing of the sink stream.
  */
 static void demux_s24le(struct comp_dev *dev, struct comp_buffer *sink,
 			struct comp_buffer *source, uint32_t frames,
-			struct mux_stream_data *data)
+			struct mux_look_up *lookup)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
+	struct mux_tap *taps = cd->taps;
+	int32_t *src = source->r_ptr;
+	int32_t *dst = sink->w_ptr;
+	uint32_t src_ch = cd->config.num_channels;
+	uint32_t dst_ch = lookup->num_channels;
+	uint32_t ch;
+	uint32_t i;
+	uint32_t n;
+	uint16_t t;
 	int32_t sample;
-	int32_t *dst;
-	uint8_t i;
-	uint8_t out_ch;
-
-	for (i = 0; i < frames; i++) {
-		for (out_ch = 0; out_ch < data->num_channels; out_ch++) {
-			sample = calc_sample_s24le(source,
-						   cd->config.num_channels,
-						   i * cd->config.num_channels,
-						   data->mask[out_ch]);
-
-			/* saturate to 24 bits */
-			dst = buffer_write_frag_s32(sink,
-				i * data->num_channels + out_ch);
-			*dst = sat_int24(sample);
+
+	while (frames) {
+		n = MIN(mux_frames_without_wrap(source, src,
+						src_ch * sizeof(int32_t)),
+			mux_frames_without_wrap(sink, dst,
+						dst_ch * sizeof(int32_t)));
+		n = MIN(n, frames);
+
+		if (lookup->copy) {
+			for (i = 0; i < n; i++) {
+				for (ch = 0; ch < dst_ch; ch++) {
+					t = lookup->first[ch];
+					dst[ch] = sign_extend_s24
+						(src[taps[t].channel]);
+				}
+				src += src_ch;
+				dst += dst_ch;
+			}
+		} else {
+			for (i = 0; i < n; i++) {
+				for (ch = 0; ch < dst_ch; ch++) {
+					sample = 0;
+					for (t = lookup->first[ch];
+					     t < lookup->first[ch + 1]; t++)
+						sample += sign_extend_s24
+							(src[taps[t].channel]);
+
+					/* saturate to 24 bits */
+					dst[ch] = sat_int24(sample);
+				}
+				src += src_ch;
+				dst += dst_ch;
+			}
 		}
+
+		frames -= n;
+		src = buffer_wrap(source, src);
+		dst = buffer_wrap(sink, dst);
 	}
 }
 
 /* \brief Demuxing 32 bit streams.
  *
- * Source stream is routed to sink with regard to routing bitmasks from
- * mux_stream_data structure. Each bitmask describes composition of single
- * output channel.
+ * Source stream is routed to sink with regard to look up table compiled
+ * from routing bitmasks at prepare. Channels with a single tap are copied,
+ * the others are the saturated sum of their taps.
  *
  * \param[in,out] dev Demux base component device.
  * \param[in,out] sink Destination buffer.
  * \param[in,out] source Source buffer.
  * \param[in] frames Number of frames to process.
- * \param[in] data Parameters describing channel count and routing.
+ * \param[in] lookup Routing of the sink stream.
  */
 static void demux_s32le(struct comp_dev *dev, struct comp_buffer *sink,
 			struct comp_buffer *source, uint32_t frames,
-			struct mux_stream_data *data)
+			struct mux_look_up *lookup)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
+	struct mux_tap *taps = cd->taps;
+	int32_t *src = source->r_ptr;
+	int32_t *dst = sink->w_ptr;
+	uint32_t src_ch = cd->config.num_channels;
+	uint32_t dst_ch = lookup->num_channels;
+	uint32_t ch;
+	uint32_t i;
+	uint32_t n;
+	uint16_t t;
 	int64_t sample;
-	int32_t *dst;
-	uint8_t i;
-	uint8_t out_ch;
-
-	for (i = 0; i < frames; i++) {
-		for (out_ch = 0; out_ch < data->num_channels; out_ch++) {
-			sample = calc_sample_s32le(source,
-						   cd->config.num_channels,
-						   i * cd->config.num_channels,
-						   data->mask[out_ch]);
-
-			/* saturate to 32 bits */
-			dst = buffer_write_frag_s32(sink,
-				i * data->num_channels + out_ch);
-			*dst = sat_int32(sample);
+
+	while (frames) {
+		n = MIN(mux_frames_without_wrap(source, src,
+						src_ch * sizeof(int32_t)),
+			mux_frames_without_wrap(sink, dst,
+						dst_ch * sizeof(int32_t)));
+		n = MIN(n, frames);
+
+		if (lookup->copy) {
+			for (i = 0; i < n; i++) {
+				for (ch = 0; ch < dst_ch; ch++) {
+					t = lookup->first[ch];
+					dst[ch] = src[taps[t].channel];
+				}
+				src += src_ch;
+				dst += dst_ch;
+			}
+		} else {
+			for (i = 0; i < n; i++) {
+				for (ch = 0; ch < dst_ch; ch++) {
+					sample = 0;
+					for (t = lookup->first[ch];
+					     t < lookup->first[ch + 1]; t++)
+						sample += src[taps[t].channel];
+
+					/* saturate to 32 bits */
+					dst[ch] = sat_int32(sample);
+				}
+				src += src_ch;
+				dst += dst_ch;
+			}
 		}
+
+		frames -= n;
+		src = buffer_wrap(source, src);
+		dst = buffer_wrap(sink, dst);
 	}
 }
 
+/* reads the source sample of a mux tap */
+static inline int16_t mux_read_s16(int16_t **src, struct mux_tap *tap)
+{
+	return src[tap->stream][tap->channel];
+}
+
+static inline int32_t mux_read_s24(int32_t **src, struct mux_tap *tap)
+{
+	return sign_extend_s24(src[tap->stream][tap->channel]);
+}
+
+static inline int32_t mux_read_s32(int32_t **src, struct mux_tap *tap)
+{
+	return src[tap->stream][tap->channel];
+}
+
 /* \brief Muxing 16 bit streams.
  *
- * Source streams are routed to sink with regard to routing bitmasks from
- * mux_stream_data structures array. Each source stream has bitmask for each
- * of it's channels describing to which channels of output stream it
- * contributes.
+ * Source streams are routed to sink with regard to look up table compiled
+ * from routing bitmasks of all streams at prepare. Inactive source streams
+ * are read from a silent frame.
  *
- * \param[in,out] dev Demux base component device.
+ * \param[in,out] dev Mux base component device.
  * \param[in,out] sink Destination buffer.
  * \param[in,out] sources Array of source buffers.
  * \param[in] frames Number of frames to process.
- * \param[in] data Array of parameters describing channel count and routing for
- *		   each stream.
+ * \param[in] lookup Routing of the sink stream.
  */
 static void mux_s16le(struct comp_dev *dev, struct comp_buffer *sink,
 		      struct comp_buffer **sources, uint32_t frames,
-		      struct mux_stream_data *data)
+		      struct mux_look_up *lookup)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
-	struct comp_buffer *source;
-	uint8_t i;
+	struct mux_tap *taps = cd->taps;
+	int16_t *src[MUX_MAX_STREAMS];
+	int16_t *dst = sink->w_ptr;
+	uint32_t src_ch[MUX_MAX_STREAMS];
+	uint32_t dst_ch = lookup->num_channels;
+	uint32_t ch;
+	uint32_t i;
+	uint32_t n;
+	uint16_t t;
 	uint8_t j;
-	uint8_t out_ch;
-	int16_t *dst;
 	int32_t sample;
 
-	for (i = 0; i < frames; i++) {
-		for (out_ch = 0; out_ch < cd->config.num_channels; out_ch++) {
-			sample = 0;
-
-			for (j = 0; j < MUX_MAX_STREAMS; j++) {
-				source = sources[j];
-				if (!source)
-					continue;
-
-				sample += calc_sample_s16le(source,
-						data[j].num_channels,
-						i * data[j].num_channels,
-						data[j].mask[out_ch]);
+	mux_sources_init(cd, sources, (void **)src, src_ch);
+
+	while (frames) {
+		n = mux_sources_frames_without_wrap(sources, (void **)src,
+						    src_ch, sizeof(int16_t));
+		n = MIN(n, mux_frames_without_wrap(sink, dst,
+						   dst_ch * sizeof(int16_t)));
+		n = MIN(n, frames);
+
+		for (i = 0; i < n; i++) {
+			if (lookup->copy) {
+				for (ch = 0; ch < dst_ch; ch++) {
+					t = lookup->first[ch];
+					dst[ch] = mux_read_s16(src, &taps[t]);
+				}
+			} else {
+				for (ch = 0; ch < dst_ch; ch++) {
+					sample = 0;
+					for (t = lookup->first[ch];
+					     t < lookup->first[ch + 1]; t++)
+						sample += mux_read_s16(src,
+								&taps[t]);
+
+					/* saturate to 16 bits */
+					dst[ch] = sat_int16(sample);
+				}
 			}
-			dst = buffer_write_frag_s16(sink,
-				i * data->num_channels + out_ch);
-			*dst = sat_int16(sample);
+
+			for (j = 0; j < MUX_MAX_STREAMS; j++)
+				src[j] += src_ch[j];
+			dst += dst_ch;
 		}
+
+		frames -= n;
+		mux_sources_wrap(sources, (void **)src);
+		dst = buffer_wrap(sink, dst);
 	}
 }
 
 /* \brief Muxing 24 bit streams.
  *
- * Source streams are routed to sink with regard to routing bitmasks from
- * mux_stream_data structures array. Each source stream has bitmask for each
- * of it's channels describing to which channels of output stream it
- * contributes.
+ * Source streams are routed to sink with regard to look up table compiled
+ * from routing bitmasks of all streams at prepare. Inactive source streams
+ * are read from a silent frame.
  *
- * \param[in,out] dev Demux base component device.
+ * \param[in,out] dev Mux base component device.
  * \param[in,out] sink Destination buffer.
  * \param[in,out] sources Array of source buffers.
  * \param[in] frames Number of frames to process.
- * \param[in] data Array of parameters describing channel count and routing for
- *		   each stream.
+ * \param[in] lookup Routing of the sink stream.
  */
 static void mux_s24le(struct comp_dev *dev, struct comp_buffer *sink,
 		      struct comp_buffer **sources, uint32_t frames,
-		      struct mux_stream_data *data)
+		      struct mux_look_up *lookup)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
-	struct comp_buffer *source;
-	uint8_t i;
+	struct mux_tap *taps = cd->taps;
+	int32_t *src[MUX_MAX_STREAMS];
+	int32_t *dst = sink->w_ptr;
+	uint32_t src_ch[MUX_MAX_STREAMS];
+	uint32_t dst_ch = lookup->num_channels;
+	uint32_t ch;
+	uint32_t i;
+	uint32_t n;
+	uint16_t t;
 	uint8_t j;
-	uint8_t out_ch;
-	int32_t *dst;
 	int32_t sample;
 
-	for (i = 0; i < frames; i++) {
-		for (out_ch = 0; out_ch < cd->config.num_channels; out_ch++) {
-			sample = 0;
-			for (j = 0; j < MUX_MAX_STREAMS; j++) {
-				source = sources[j];
-				if (!source)
-					continue;
-
-				sample += calc_sample_s24le(source,
-						data[j].num_channels,
-						i * data[j].num_channels,
-						data[j].mask[out_ch]);
+	mux_sources_init(cd, sources, (void **)src, src_ch);
+
+	while (frames) {
+		n = mux_sources_frames_without_wrap(sources, (void **)src,
+						    src_ch, sizeof(int32_t));
+		n = MIN(n, mux_frames_without_wrap(sink, dst,
+						   dst_ch * sizeof(int32_t)));
+		n = MIN(n, frames);
+
+		for (i = 0; i < n; i++) {
+			if (lookup->copy) {
+				for (ch = 0; ch < dst_ch; ch++) {
+					t = lookup->first[ch];
+					dst[ch] = mux_read_s24(src, &taps[t]);
+				}
+			} else {
+				for (ch = 0; ch < dst_ch; ch++) {
+					sample = 0;
+					for (t = lookup->first[ch];
+					     t < lookup->first[ch + 1]; t++)
+						sample += mux_read_s24(src,
+								&taps[t]);
+
+					/* saturate to 24 bits */
+					dst[ch] = sat_int24(sample);
+				}
 			}
-			dst = buffer_write_frag_s32(sink,
-				i * data->num_channels + out_ch);
-			*dst = sat_int24(sample);
+
+			for (j = 0; j < MUX_MAX_STREAMS; j++)
+				src[j] += src_ch[j];
+			dst += dst_ch;
 		}
+
+		frames -= n;
+		mux_sources_wrap(sources, (void **)src);
+		dst = buffer_wrap(sink, dst);
 	}
 }
 
 /* \brief Muxing 32 bit streams.
  *
- * Source streams are routed to sink with regard to routing bitmasks from
- * mux_stream_data structures array. Each source stream has bitmask for each
- * of it's channels describing to which channels of output stream it
- * contributes.
+ * Source streams are routed to sink with regard to look up table compiled
+ * from routing bitmasks of all streams at prepare. Inactive source streams
+ * are read from a silent frame.
  *
- * \param[in,out] dev Demux base component device.
+ * \param[in,out] dev Mux base component device.
  * \param[in,out] sink Destination buffer.
  * \param[in,out] sources Array of source buffers.
  * \param[in] frames Number of frames to process.
- * \param[in] data Array of parameters describing channel count and routing for
- *		   each stream.
+ * \param[in] lookup Routing of the sink stream.
  */
 static void mux_s32le(struct comp_dev *dev, struct comp_buffer *sink,
 		      struct comp_buffer **sources, uint32_t frames,
-		      struct mux_stream_data *data)
+		      struct mux_look_up *lookup)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
-	struct comp_buffer *source;
-	uint8_t i;
+	struct mux_tap *taps = cd->taps;
+	int32_t *src[MUX_MAX_STREAMS];
+	int32_t *dst = sink->w_ptr;
+	uint32_t src_ch[MUX_MAX_STREAMS];
+	uint32_t dst_ch = lookup->num_channels;
+	uint32_t ch;
+	uint32_t i;
+	uint32_t n;
+	uint16_t t;
 	uint8_t j;
-	uint8_t out_ch;
-	int32_t *dst;
 	int64_t sample;
 
-	for (i = 0; i < frames; i++) {
-		for (out_ch = 0; out_ch < cd->config.num_channels; out_ch++) {
-			sample = 0;
-			for (j = 0; j < MUX_MAX_STREAMS; j++) {
-				source = sources[j];
-				if (!source)
-					continue;
-
-				sample += calc_sample_s32le(source,
-						data[j].num_channels,
-						i * data[j].num_channels,
-						data[j].mask[out_ch]);
+	mux_sources_init(cd, sources, (void **)src, src_ch);
+
+	while (frames) {
+		n = mux_sources_frames_without_wrap(sources, (void **)src,
+						    src_ch, sizeof(int32_t));
+		n = MIN(n, mux_frames_without_wrap(sink, dst,
+						   dst_ch * sizeof(int32_t)));
+		n = MIN(n, frames);
+
+		for (i = 0; i < n; i++) {
+			if (lookup->copy) {
+				for (ch = 0; ch < dst_ch; ch++) {
+					t = lookup->first[ch];
+					dst[ch] = mux_read_s32(src, &taps[t]);
+				}
+			} else {
+				for (ch = 0; ch < dst_ch; ch++) {
+					sample = 0;
+					for (t = lookup->first[ch];
+					     t < lookup->first[ch + 1]; t++)
+						sample += mux_read_s32(src,
+								&taps[t]);
+
+					/* saturate to 32 bits */
+					dst[ch] = sat_int32(sample);
+				}
 			}
-			dst = buffer_write_frag_s32(sink,
-				i * data->num_channels + out_ch);
-			*dst = sat_int32(sample);
+
+			for (j = 0; j < MUX_MAX_STREAMS; j++)
+				src[j] += src_ch[j];
+			dst += dst_ch;
 		}
+
+		frames -= n;
+		mux_sources_wrap(sources, (void **)src);
+		dst = buffer_wrap(sink, dst);
 	}
 }
 
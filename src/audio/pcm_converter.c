@@ -0,0 +1,195 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2019 Intel Corporation. All rights reserved.
+
+#include <sof/audio/buffer.h>
+#include <sof/audio/format.h>
+#include <sof/audio/pcm_converter.h>
+#include <sof/common.h>
+#include <sof/math/numbers.h>
+#include <ipc/stream.h>
+#include <errno.h>
+#include <stdint.h>
+
+/* same format, samples are copied as they are */
+static void pcm_copy_s16(struct comp_buffer *source, struct comp_buffer *sink,
+			 uint32_t samples)
+{
+	buffer_copy_bytes(source, sink, samples * sizeof(int16_t));
+}
+
+static void pcm_copy_s32(struct comp_buffer *source, struct comp_buffer *sink,
+			 uint32_t samples)
+{
+	buffer_copy_bytes(source, sink, samples * sizeof(int32_t));
+}
+
+static void pcm_convert_s16_to_s24(struct comp_buffer *source,
+				   struct comp_buffer *sink, uint32_t samples)
+{
+	int16_t *src = source->r_ptr;
+	int32_t *dst = sink->w_ptr;
+	uint32_t n;
+	uint32_t i;
+
+	while (samples) {
+		n = MIN(buffer_s16_without_wrap(source, src),
+			buffer_s32_without_wrap(sink, dst));
+		n = MIN(n, samples);
+
+		for (i = 0; i < n; i++)
+			dst[i] = (int32_t)src[i] << 8;
+
+		samples -= n;
+		src = buffer_wrap(source, src + n);
+		dst = buffer_wrap(sink, dst + n);
+	}
+}
+
+static void pcm_convert_s16_to_s32(struct comp_buffer *source,
+				   struct comp_buffer *sink, uint32_t samples)
+{
+	int16_t *src = source->r_ptr;
+	int32_t *dst = sink->w_ptr;
+	uint32_t n;
+	uint32_t i;
+
+	while (samples) {
+		n = MIN(buffer_s16_without_wrap(source, src),
+			buffer_s32_without_wrap(sink, dst));
+		n = MIN(n, samples);
+
+		for (i = 0; i < n; i++)
+			dst[i] = (int32_t)src[i] << 16;
+
+		samples -= n;
+		src = buffer_wrap(source, src + n);
+		dst = buffer_wrap(sink, dst + n);
+	}
+}
+
+static void pcm_convert_s24_to_s16(struct comp_buffer *source,
+				   struct comp_buffer *sink, uint32_t samples)
+{
+	int32_t *src = source->r_ptr;
+	int16_t *dst = sink->w_ptr;
+	uint32_t n;
+	uint32_t i;
+
+	while (samples) {
+		n = MIN(buffer_s32_without_wrap(source, src),
+			buffer_s16_without_wrap(sink, dst));
+		n = MIN(n, samples);
+
+		for (i = 0; i < n; i++)
+			dst[i] = sat_int16(Q_SHIFT_RND(sign_extend_s24(src[i]),
+						       23, 15));
+
+		samples -= n;
+		src = buffer_wrap(source, src + n);
+		dst = buffer_wrap(sink, dst + n);
+	}
+}
+
+static void pcm_convert_s24_to_s32(struct comp_buffer *source,
+				   struct comp_buffer *sink, uint32_t samples)
+{
+	int32_t *src = source->r_ptr;
+	int32_t *dst = sink->w_ptr;
+	uint32_t n;
+	uint32_t i;
+
+	while (samples) {
+		n = MIN(buffer_s32_without_wrap(source, src),
+			buffer_s32_without_wrap(sink, dst));
+		n = MIN(n, samples);
+
+		for (i = 0; i < n; i++)
+			dst[i] = src[i] << 8;
+
+		samples -= n;
+		src = buffer_wrap(source, src + n);
+		dst = buffer_wrap(sink, dst + n);
+	}
+}
+
+static void pcm_convert_s32_to_s16(struct comp_buffer *source,
+				   struct comp_buffer *sink, uint32_t samples)
+{
+	int32_t *src = source->r_ptr;
+	int16_t *dst = sink->w_ptr;
+	uint32_t n;
+	uint32_t i;
+
+	while (samples) {
+		n = MIN(buffer_s32_without_wrap(source, src),
+			buffer_s16_without_wrap(sink, dst));
+		n = MIN(n, samples);
+
+		for (i = 0; i < n; i++)
+			dst[i] = sat_int16(Q_SHIFT_RND(src[i], 31, 15));
+
+		samples -= n;
+		src = buffer_wrap(source, src + n);
+		dst = buffer_wrap(sink, dst + n);
+	}
+}
+
+static void pcm_convert_s32_to_s24(struct comp_buffer *source,
+				   struct comp_buffer *sink, uint32_t samples)
+{
+	int32_t *src = source->r_ptr;
+	int32_t *dst = sink->w_ptr;
+	uint32_t n;
+	uint32_t i;
+
+	while (samples) {
+		n = MIN(buffer_s32_without_wrap(source, src),
+			buffer_s32_without_wrap(sink, dst));
+		n = MIN(n, samples);
+
+		for (i = 0; i < n; i++)
+			dst[i] = sat_int24(Q_SHIFT_RND(src[i], 31, 23));
+
+		samples -= n;
+		src = buffer_wrap(source, src + n);
+		dst = buffer_wrap(sink, dst + n);
+	}
+}
+
+const struct pcm_func_map pcm_func_map[] = {
+	{ SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S16_LE, pcm_copy_s16 },
+	{ SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S24_4LE, pcm_convert_s16_to_s24 },
+	{ SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S32_LE, pcm_convert_s16_to_s32 },
+	{ SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S16_LE, pcm_convert_s24_to_s16 },
+	{ SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S24_4LE, pcm_copy_s32 },
+	{ SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S32_LE, pcm_convert_s24_to_s32 },
+	{ SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S16_LE, pcm_convert_s32_to_s16 },
+	{ SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S24_4LE, pcm_convert_s32_to_s24 },
+	{ SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S32_LE, pcm_copy_s32 },
+};
+
+const uint32_t pcm_func_count = ARRAY_SIZE(pcm_func_map);
+
+static uint32_t pcm_sample_bytes(enum sof_ipc_frame fmt)
+{
+	return fmt == SOF_IPC_FRAME_S16_LE ? sizeof(int16_t) : sizeof(int32_t);
+}
+
+int pcm_converter_init(struct pcm_converter *conv, enum sof_ipc_frame source,
+		       enum sof_ipc_frame sink)
+{
+	uint32_t i;
+
+	for (i = 0; i < pcm_func_count; i++) {
+		if (pcm_func_map[i].source == source &&
+		    pcm_func_map[i].sink == sink) {
+			conv->func = pcm_func_map[i].func;
+			conv->source_bytes = pcm_sample_bytes(source);
+			conv->sink_bytes = pcm_sample_bytes(sink);
+			return 0;
+		}
+	}
+
+	return -EINVAL;
+}
@@ -16,6 +16,8 @@
 #include <sof/lib/alloc.h>
 #include <sof/lib/cache.h>
 #include <sof/lib/cpu.h>
+#include <sof/lib/cpu_budget.h>
+#include <sof/lib/dvfs.h>
 #include <sof/list.h>
 #include <sof/math/numbers.h>
 #include <sof/schedule/schedule.h>
@@ -35,6 +37,10 @@ struct pipeline_data {
 	struct sof_ipc_stream_posn *posn;
 	struct pipeline *p;
 	int cmd;
+	uint32_t caps;		/* arena capabilities */
+	uint32_t align;		/* arena alignment */
+	uint32_t offset;	/* arena bytes in use */
+	uint32_t demand_hz;	/* CPU need of pipelines to start */
 };
 
 static enum task_state pipeline_task(void *arg);
@@ -63,6 +69,16 @@ struct pipeline *pipeline_new(struct sof_ipc_pipe_new *pipe_desc,
 		       pipe_desc, sizeof(*pipe_desc));
 	assert(!ret);
 
+	/* let firmware choose the core, again when pipeline starts */
+	if (p->ipc_pipe.core == SOF_IPC_PIPE_CORE_AUTO) {
+		p->core_auto = true;
+		p->ipc_pipe.core = cpu_budget_pick_core(p);
+		trace_pipe_with_ids(p, "pipeline_new() auto core %u",
+				    p->ipc_pipe.core);
+	}
+
+	cpu_budget_place(p);
+
 	return p;
 }
 
@@ -78,6 +94,7 @@ int pipeline_connect(struct comp_dev *comp, struct comp_buffer *buffer,
 	list_item_prepend(buffer_comp_list(buffer, dir),
 			  comp_buffer_list(comp, dir));
 	buffer_set_comp(buffer, comp, dir);
+	pipeline_schedule_invalidate(comp->pipeline);
 	irq_local_enable(flags);
 
 	return 0;
@@ -147,6 +164,117 @@ static int pipeline_comp_complete(struct comp_dev *current, void *data,
 	return 0;
 }
 
+/* arena setup steps run by pipeline_comp_arena() */
+#define PPL_ARENA_SIZE		0	/* lay out buffers in the arena */
+#define PPL_ARENA_PLACE		1	/* move buffers into the arena */
+
+/* Buffers connecting two components of the pipeline are placed in the
+ * arena, buffers to other pipelines keep their own memory. The arena is a
+ * single allocation, so buffers with other caps than the first placed
+ * one keep their own memory too.
+ */
+static bool pipeline_arena_buffer(struct pipeline_data *ppl_data,
+				  struct comp_buffer *buffer)
+{
+	struct pipeline *p = ppl_data->p;
+
+	if (buffer->pipeline_id != p->ipc_pipe.pipeline_id ||
+	    !buffer->source || buffer->source->pipeline != p ||
+	    !buffer->sink || buffer->sink->pipeline != p)
+		return false;
+
+	/* first buffer laid out picks the caps of the arena */
+	if (ppl_data->cmd == PPL_ARENA_SIZE && !ppl_data->offset)
+		ppl_data->caps = buffer->caps;
+
+	return buffer->caps == ppl_data->caps;
+}
+
+/* Walks downstream over the pipeline sink buffers and runs one arena setup
+ * step on them. Each buffer slot keeps the alignment the buffer was
+ * allocated with. Paths converging in the pipeline visit a buffer more
+ * than once, that only wastes arena space.
+ */
+static int pipeline_comp_arena(struct comp_dev *current, void *data,
+			       int dir)
+{
+	struct pipeline_data *ppl_data = data;
+	struct pipeline *p = ppl_data->p;
+	struct comp_buffer *buffer;
+	struct list_item *clist;
+	uint32_t offset;
+	uint32_t size;
+
+	if (current->pipeline != p)
+		return 0;
+
+	list_for_item(clist, &current->bsink_list) {
+		buffer = container_of(clist, struct comp_buffer, source_list);
+
+		if (!pipeline_arena_buffer(ppl_data, buffer))
+			continue;
+
+		offset = ALIGN_UP(ppl_data->offset, buffer->align);
+		size = ALIGN_UP(buffer->size, buffer->align);
+
+		switch (ppl_data->cmd) {
+		case PPL_ARENA_SIZE:
+			ppl_data->align = MAX(ppl_data->align, buffer->align);
+			break;
+		case PPL_ARENA_PLACE:
+			if (buffer->arena)
+				continue;
+			buffer_set_arena(buffer, p->arena + offset, size);
+			break;
+		}
+
+		ppl_data->offset = offset + size;
+	}
+
+	return pipeline_for_each_comp(current, &pipeline_comp_arena, data,
+				      NULL, dir);
+}
+
+/* Places the sample memory of the pipeline buffers contiguously in one
+ * allocation freed by pipeline_free(). The buffers release their own
+ * memory only once the arena is allocated, so if it can't be allocated
+ * they are left as they are.
+ */
+static void pipeline_arena_init(struct pipeline *p, struct comp_dev *source)
+{
+	struct pipeline_data data;
+
+	data.start = source;
+	data.p = p;
+	data.caps = 0;
+	data.align = 1;
+	data.offset = 0;
+
+	data.cmd = PPL_ARENA_SIZE;
+	pipeline_comp_arena(source, &data, PPL_DIR_DOWNSTREAM);
+	if (!data.offset)
+		return;
+
+	p->arena = rballoc_align(RZONE_BUFFER, data.caps, data.offset,
+				 data.align);
+	if (!p->arena) {
+		trace_pipe_error_with_ids(p, "pipeline_arena_init() error: "
+					  "can't alloc %u bytes caps 0x%x, "
+					  "using separate buffers",
+					  data.offset, data.caps);
+		return;
+	}
+
+	p->arena_size = data.offset;
+
+	data.cmd = PPL_ARENA_PLACE;
+	data.offset = 0;
+	pipeline_comp_arena(source, &data, PPL_DIR_DOWNSTREAM);
+
+	trace_pipe_with_ids(p, "pipeline_arena_init(), arena %u bytes",
+			    p->arena_size);
+}
+
 int pipeline_complete(struct pipeline *p, struct comp_dev *source,
 		      struct comp_dev *sink)
 {
@@ -169,9 +297,12 @@ int pipeline_complete(struct pipeline *p, struct comp_dev *source,
 	 */
 	pipeline_comp_complete(source, &data, PPL_DIR_DOWNSTREAM);
 
+	pipeline_arena_init(p, source);
+
 	p->source_comp = source;
 	p->sink_comp = sink;
 	p->status = COMP_STATE_READY;
+	pipeline_schedule_invalidate(p);
 
 	/* show heap status */
 	heap_trace_all(0);
@@ -187,6 +318,8 @@ static int pipeline_comp_free(struct comp_dev *current, void *data, int dir)
 	tracev_pipe("pipeline_comp_free(), current->comp.id = %u, dir = %u",
 		    current->comp.id, dir);
 
+	pipeline_schedule_invalidate(current->pipeline);
+
 	if (!comp_is_single_pipeline(current, ppl_data->start)) {
 		tracev_pipe("pipeline_comp_free(), "
 			    "current is from another pipeline");
@@ -236,6 +369,15 @@ int pipeline_free(struct pipeline *p)
 		rfree(p->pipe_task);
 	}
 
+	if (p->sched_list)
+		rfree(p->sched_list);
+
+	cpu_budget_unplace(p);
+
+	/* buffers in the arena don't free their memory themselves */
+	if (p->arena)
+		rfree(p->arena);
+
 	/* now free the pipeline */
 	rfree(p);
 
@@ -426,6 +568,8 @@ static int pipeline_comp_prepare(struct comp_dev *current, void *data, int dir)
 	if (err < 0)
 		return err;
 
+	pipeline_schedule_invalidate(current->pipeline);
+
 	err = comp_prepare(current);
 	if (err < 0 || err == PPL_STATUS_PATH_STOP)
 		return err;
@@ -453,6 +597,9 @@ int pipeline_prepare(struct pipeline *p, struct comp_dev *dev)
 
 	p->status = COMP_STATE_PREPARE;
 
+	/* reserve copy schedule here, not in the LL tick */
+	pipeline_schedule_build(p);
+
 	return ret;
 }
 
@@ -486,6 +633,10 @@ void pipeline_cache(struct pipeline *p, struct comp_dev *dev, int cmd)
 	if (cmd == CACHE_INVALIDATE) {
 		dcache_invalidate_region(p, sizeof(*p));
 		dcache_invalidate_region(p->pipe_task, sizeof(*p->pipe_task));
+		if (p->sched_list)
+			dcache_invalidate_region(p->sched_list,
+						 p->sched_size *
+						 sizeof(*p->sched_list));
 	}
 
 	trace_pipe_with_ids(p, "pipeline_cache()");
@@ -500,6 +651,10 @@ void pipeline_cache(struct pipeline *p, struct comp_dev *dev, int cmd)
 
 	/* pipeline needs to be flushed after usage */
 	if (cmd == CACHE_WRITEBACK_INV) {
+		if (p->sched_list)
+			dcache_writeback_invalidate_region
+				(p->sched_list,
+				 p->sched_size * sizeof(*p->sched_list));
 		dcache_writeback_invalidate_region(p->pipe_task,
 						   sizeof(*p->pipe_task));
 		dcache_writeback_invalidate_region(p, sizeof(*p));
@@ -520,10 +675,18 @@ static void pipeline_comp_trigger_sched_comp(struct pipeline *p,
 	case COMP_TRIGGER_STOP:
 	case COMP_TRIGGER_XRUN:
 		pipeline_schedule_cancel(p);
+		if (p->status == COMP_STATE_ACTIVE) {
+			cpu_budget_stop(p);
+			dvfs_pipeline_stop(&p->ipc_pipe);
+		}
 		p->status = COMP_STATE_PAUSED;
 		break;
 	case COMP_TRIGGER_RELEASE:
 	case COMP_TRIGGER_START:
+		if (p->status != COMP_STATE_ACTIVE) {
+			cpu_budget_start(p);
+			dvfs_pipeline_start(&p->ipc_pipe);
+		}
 		pipeline_schedule_copy(p, 0);
 		p->xrun_bytes = 0;
 		p->status = COMP_STATE_ACTIVE;
@@ -547,6 +710,9 @@ static int pipeline_comp_trigger(struct comp_dev *current, void *data, int dir)
 	tracev_pipe("pipeline_comp_trigger(), current->comp.id = %u, dir = %u",
 		    current->comp.id, dir);
 
+	/* component states change, connected schedules must be rebuilt */
+	pipeline_schedule_invalidate(current->pipeline);
+
 	/* trigger should propagate to the connected pipelines,
 	 * which need to be scheduled together
 	 */
@@ -568,6 +734,25 @@ static int pipeline_comp_trigger(struct comp_dev *current, void *data, int dir)
 				      NULL, dir);
 }
 
+/* sum CPU need of every pipeline the trigger walk is going to start */
+static int pipeline_comp_admit(struct comp_dev *current, void *data, int dir)
+{
+	struct pipeline_data *ppl_data = data;
+
+	/* same propagation rules as pipeline_comp_trigger() */
+	if (!comp_is_single_pipeline(current, ppl_data->start) &&
+	    !pipeline_is_same_sched_comp(current->pipeline,
+					 ppl_data->start->pipeline))
+		return 0;
+
+	/* pipeline is started by its scheduling component */
+	if (current->pipeline->sched_comp == current)
+		ppl_data->demand_hz += cpu_budget_need(current->pipeline);
+
+	return pipeline_for_each_comp(current, &pipeline_comp_admit, data,
+				      NULL, dir);
+}
+
 /* trigger pipeline on slave core */
 static int pipeline_trigger_on_core(struct pipeline *p, struct comp_dev *host,
 				    int cmd)
@@ -606,6 +791,64 @@ static int pipeline_trigger_on_core(struct pipeline *p, struct comp_dev *host,
 	return ret;
 }
 
+/* move idle pipeline to another core, called on master core */
+static int pipeline_migrate(struct pipeline *p, struct comp_dev *host,
+			    int core)
+{
+	int ret;
+
+	trace_pipe_with_ids(p, "pipeline_migrate() core %u -> %u",
+			    p->ipc_pipe.core, core);
+
+	/* task is bound to the core it was initialized on */
+	if (p->pipe_task) {
+		schedule_task_free(p->pipe_task);
+		rfree(p->pipe_task);
+		p->pipe_task = NULL;
+	}
+
+	cpu_budget_unplace(p);
+	p->ipc_pipe.core = core;
+	cpu_budget_place(p);
+
+	ret = pipeline_comp_task_init(p);
+	if (ret < 0)
+		return ret;
+
+	/* new core must see what master core has configured */
+	pipeline_cache(p, host, CACHE_WRITEBACK_INV);
+
+	return 0;
+}
+
+/*
+ * Moves pipeline with automatic core to the least loaded core before it's
+ * started, using the cost measured in its previous runs. Only prepared
+ * pipelines with host or DAI on both ends are moved, pipelines connected
+ * to others must stay with them.
+ */
+static int pipeline_balance(struct pipeline *p, struct comp_dev *host)
+{
+	int core;
+
+	if (!p->core_auto || cpu_get_id() != PLATFORM_MASTER_CORE_ID)
+		return 0;
+
+	if (host->state != COMP_STATE_PREPARE || p->xrun_bytes ||
+	    !p->source_comp || !p->sink_comp)
+		return 0;
+
+	if (comp_get_endpoint_type(p->source_comp) == COMP_ENDPOINT_NODE ||
+	    comp_get_endpoint_type(p->sink_comp) == COMP_ENDPOINT_NODE)
+		return 0;
+
+	core = cpu_budget_pick_core(p);
+	if (core == p->ipc_pipe.core)
+		return 0;
+
+	return pipeline_migrate(p, host, core);
+}
+
 /*
  * trigger handler for pipelines in xrun, used for recovery from host only.
  * return values:
@@ -657,6 +900,25 @@ int pipeline_trigger(struct pipeline *p, struct comp_dev *host, int cmd)
 
 	trace_pipe_with_ids(p, "pipeline_trigger()");
 
+	if (cmd == COMP_TRIGGER_START) {
+		ret = pipeline_balance(p, host);
+		if (ret < 0)
+			return ret;
+	}
+
+	/* refuse to start what the core has no cycles left for, connected
+	 * pipelines started by the same walk included
+	 */
+	if (cmd == COMP_TRIGGER_START || cmd == COMP_TRIGGER_RELEASE) {
+		data.start = host;
+		data.demand_hz = 0;
+		pipeline_comp_admit(host, &data, host->params.direction);
+
+		ret = cpu_budget_admit(p, data.demand_hz);
+		if (ret < 0)
+			return ret;
+	}
+
 	/* if current core is different than requested */
 	if (!pipeline_is_this_cpu(p))
 		return pipeline_trigger_on_core(p, host, cmd);
@@ -681,8 +943,13 @@ int pipeline_trigger(struct pipeline *p, struct comp_dev *host, int cmd)
 		trace_ipc_error("pipeline_trigger() error: ret = %d, host->"
 				"comp.id = %u, cmd = %d", ret, host->comp.id,
 				cmd);
+		return ret;
 	}
 
+	/* compile copy schedule now rather than on the first LL tick */
+	if (!p->sched_valid && p->status == COMP_STATE_ACTIVE)
+		pipeline_schedule_build(p);
+
 	return ret;
 }
 
@@ -696,6 +963,8 @@ static int pipeline_comp_reset(struct comp_dev *current, void *data, int dir)
 	tracev_pipe("pipeline_comp_reset(), current->comp.id = %u, dir = %u",
 		    current->comp.id, dir);
 
+	pipeline_schedule_invalidate(current->pipeline);
+
 	if (!comp_is_single_pipeline(current, p->source_comp)) {
 		/* If pipeline connected to the starting one is in improper
 		 * direction (CAPTURE towards DAI, PLAYBACK towards HOST),
@@ -781,6 +1050,228 @@ static int pipeline_comp_copy(struct comp_dev *current, void *data, int dir)
 	return err;
 }
 
+static void pipeline_copy_start(struct pipeline *p, struct comp_dev **start,
+				uint32_t *dir)
+{
+	if (p->source_comp->params.direction == SOF_IPC_STREAM_PLAYBACK) {
+		*dir = PPL_DIR_UPSTREAM;
+		*start = p->sink_comp;
+	} else {
+		*dir = PPL_DIR_DOWNSTREAM;
+		*start = p->source_comp;
+	}
+}
+
+/* returned by pipeline_comp_schedule() when it added an upstream entry */
+#define PPL_SCHED_ENTRY		1
+
+/* marks upstream entry whose path stop also skips its sink component */
+#define PPL_SCHED_NEXT_SINK	UINT32_MAX
+
+/* pipeline_comp_schedule() counts inactive components too */
+#define PPL_SCHED_RESERVE	1
+
+/* Walks the graph the same way as pipeline_comp_copy() but records the
+ * components instead of copying them. With no sched_list allocated it
+ * only counts the entries.
+ */
+static int pipeline_comp_schedule(struct comp_dev *current, void *data,
+				  int dir)
+{
+	struct pipeline_data *ppl_data = data;
+	struct pipeline *p = ppl_data->p;
+	int is_single_ppl = comp_is_single_pipeline(current, ppl_data->start);
+	int is_same_sched =
+		pipeline_is_same_sched_comp(current->pipeline, p);
+	uint32_t idx = p->sched_count;
+	int last;
+
+	if (!is_single_ppl && !is_same_sched)
+		return 0;
+
+	if (!comp_is_active(current) && ppl_data->cmd != PPL_SCHED_RESERVE)
+		return 0;
+
+	/* downstream entries can skip their subtree on path stop */
+	if (dir == PPL_DIR_DOWNSTREAM)
+		p->sched_count++;
+
+	last = pipeline_for_each_comp(current, &pipeline_comp_schedule, data,
+				      NULL, dir);
+
+	if (dir == PPL_DIR_DOWNSTREAM) {
+		if (p->sched_list) {
+			p->sched_list[idx].comp = current;
+			p->sched_list[idx].next = p->sched_count;
+		}
+		return 0;
+	}
+
+	/* Upstream walk copies sources first. As in pipeline_comp_copy()
+	 * only a path stop of the last visited source, which is the entry
+	 * right before this one, skips this component.
+	 */
+	idx = p->sched_count++;
+	if (p->sched_list) {
+		p->sched_list[idx].comp = current;
+		p->sched_list[idx].next = idx + 1;
+		if (last == PPL_SCHED_ENTRY)
+			p->sched_list[idx - 1].next = PPL_SCHED_NEXT_SINK;
+	}
+
+	return PPL_SCHED_ENTRY;
+}
+
+/* Compile the component graph reachable from the pipeline start into a
+ * flat array in copy order, so the LL tick does not need to walk it. Uses
+ * the entries reserved by pipeline_schedule_build() and never allocates,
+ * so it can run in the LL tick.
+ */
+static int pipeline_schedule_fill(struct pipeline *p)
+{
+	struct pipeline_data data;
+	struct pipeline_sched_entry *list;
+	struct comp_dev *start;
+	uint32_t dir;
+	uint32_t flags;
+	uint32_t count;
+	uint32_t i;
+
+	if (!p->source_comp || !p->sink_comp)
+		return -EINVAL;
+
+	pipeline_copy_start(p, &start, &dir);
+	data.start = start;
+	data.p = p;
+	data.cmd = 0;
+
+	irq_local_disable(flags);
+
+	/* count entries first */
+	list = p->sched_list;
+	p->sched_list = NULL;
+	p->sched_count = 0;
+	pipeline_comp_schedule(start, &data, dir);
+	count = p->sched_count;
+
+	p->sched_list = list;
+	p->sched_count = 0;
+
+	if (count > p->sched_size) {
+		irq_local_enable(flags);
+		return -ENOSPC;
+	}
+
+	if (count)
+		pipeline_comp_schedule(start, &data, dir);
+
+	/* sink entry follows the source, resolve skips from the end */
+	for (i = count; i > 0; i--) {
+		if (list[i - 1].next == PPL_SCHED_NEXT_SINK)
+			list[i - 1].next = i < count ? list[i].next : count;
+	}
+
+	p->sched_valid = true;
+
+	irq_local_enable(flags);
+
+	return 0;
+}
+
+/* Reserves schedule entries for every component reachable from the
+ * pipeline start, active or not, and compiles the schedule. Runs in IPC
+ * context on prepare and trigger, so the rebuilds the LL tick does after
+ * component state changes always fit.
+ */
+int pipeline_schedule_build(struct pipeline *p)
+{
+	struct pipeline_data data;
+	struct pipeline_sched_entry *list;
+	struct pipeline_sched_entry *old;
+	struct comp_dev *start;
+	uint32_t dir;
+	uint32_t flags;
+	uint32_t count;
+
+	tracev_pipe_with_ids(p, "pipeline_schedule_build()");
+
+	if (!p->source_comp || !p->sink_comp)
+		return -EINVAL;
+
+	pipeline_copy_start(p, &start, &dir);
+	data.start = start;
+	data.p = p;
+	data.cmd = PPL_SCHED_RESERVE;
+
+	irq_local_disable(flags);
+
+	list = p->sched_list;
+	p->sched_list = NULL;
+	p->sched_count = 0;
+	pipeline_comp_schedule(start, &data, dir);
+	count = p->sched_count;
+	p->sched_list = list;
+	p->sched_count = 0;
+	p->sched_valid = false;
+
+	irq_local_enable(flags);
+
+	/* only grow the list, rebuilds on state change don't reallocate */
+	if (count > p->sched_size) {
+		list = rzalloc(RZONE_RUNTIME, SOF_MEM_CAPS_RAM,
+			       count * sizeof(*list));
+		if (!list) {
+			trace_pipe_error_with_ids(p, "pipeline_schedule_build()"
+						  " error: alloc %u entries",
+						  count);
+			return -ENOMEM;
+		}
+
+		irq_local_disable(flags);
+		old = p->sched_list;
+		p->sched_list = list;
+		p->sched_size = count;
+		irq_local_enable(flags);
+
+		if (old)
+			rfree(old);
+	}
+
+	return pipeline_schedule_fill(p);
+}
+
+/* Run compiled copy schedule. A path stop skips the rest of the component
+ * subtree for downstream walk, and the sink components it would have fed
+ * for upstream walk. Schedule is only rebuilt if the component changed its
+ * own state during copy.
+ */
+static int pipeline_schedule_copy_list(struct pipeline *p)
+{
+	struct pipeline_sched_entry *entry;
+	uint32_t i = 0;
+	uint16_t state;
+	int err;
+
+	while (i < p->sched_count) {
+		entry = &p->sched_list[i];
+		state = entry->comp->state;
+
+		err = comp_copy(entry->comp);
+		if (err < 0)
+			return err;
+
+		if (entry->comp->state != state)
+			p->sched_valid = false;
+
+		if (err == PPL_STATUS_PATH_STOP)
+			i = entry->next;
+		else
+			i++;
+	}
+
+	return 0;
+}
+
 /* Copy data across all pipeline components.
  * For capture pipelines it always starts from source component
  * and continues downstream and for playback pipelines it first
@@ -793,18 +1284,18 @@ static int pipeline_copy(struct pipeline *p)
 	uint32_t dir;
 	int ret = 0;
 
-	if (p->source_comp->params.direction == SOF_IPC_STREAM_PLAYBACK) {
-		dir = PPL_DIR_UPSTREAM;
-		start = p->sink_comp;
+	pipeline_copy_start(p, &start, &dir);
+
+	/* run precompiled schedule, walk the graph only if it doesn't fit */
+	if (p->sched_valid || !pipeline_schedule_fill(p)) {
+		ret = pipeline_schedule_copy_list(p);
 	} else {
-		dir = PPL_DIR_DOWNSTREAM;
-		start = p->source_comp;
-	}
+		data.start = start;
+		data.p = p;
 
-	data.start = start;
-	data.p = p;
+		ret = pipeline_comp_copy(start, &data, dir);
+	}
 
-	ret = pipeline_comp_copy(start, &data, dir);
 	if (ret < 0)
 		trace_pipe_error("pipeline_copy() error: ret = %d, start"
 				 "->comp.id = %u, dir = %u", ret,
@@ -960,6 +1451,7 @@ void pipeline_schedule_cancel(struct pipeline *p)
 static enum task_state pipeline_task(void *arg)
 {
 	struct pipeline *p = arg;
+	uint64_t start;
 	int err;
 
 	tracev_pipe_with_ids(p, "pipeline_task()");
@@ -973,7 +1465,9 @@ static enum task_state pipeline_task(void *arg)
 			return SOF_TASK_STATE_COMPLETED;
 	}
 
+	start = cpu_budget_time();
 	err = pipeline_copy(p);
+	cpu_budget_account(p, start);
 	if (err < 0) {
 		/* try to recover */
 		err = pipeline_xrun_recover(p);
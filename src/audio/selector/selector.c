@@ -190,7 +190,8 @@ static int selector_ctrl_set_data(struct comp_dev *dev,
 	case SOF_CTRL_CMD_BINARY:
 		trace_selector("selector_ctrl_set_data(), SOF_CTRL_CMD_BINARY");
 
-		cfg = (struct sof_sel_config *)cdata->data->data;
+		cfg = (struct sof_sel_config *)
+		      ASSUME_ALIGNED((void *)cdata->data->data, 4);
 		/* Just copy the configuration & verify input params.*/
 		ret = sel_set_channel_values(cd, cfg->in_channels_count,
 					     cfg->out_channels_count,
@@ -14,6 +14,7 @@
 #include <sof/audio/component.h>
 #include <sof/audio/selector.h>
 #include <sof/common.h>
+#include <sof/math/numbers.h>
 #include <ipc/stream.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -29,16 +30,33 @@ static void sel_s16le_1ch(struct comp_dev *dev, struct comp_buffer *sink,
 			  struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
-	int16_t *src;
-	int16_t *dest;
-	uint32_t i;
-	uint32_t j = 0;
+	int16_t *src = source->r_ptr;
+	int16_t *dest = sink->w_ptr;
 	uint32_t nch = cd->config.in_channels_count;
+	uint32_t sel = cd->config.sel_channel;
+	uint32_t n;
+	uint32_t i;
+
+	while (frames) {
+		n = MIN(buffer_s16_without_wrap(source, src) / nch,
+			buffer_s16_without_wrap(sink, dest));
+		n = MIN(n, frames);
+
+		/* source frame wraps in the middle */
+		if (!n) {
+			*dest = *(int16_t *)buffer_wrap(source, src + sel);
+			frames--;
+			src = buffer_wrap(source, src + nch);
+			dest = buffer_wrap(sink, dest + 1);
+			continue;
+		}
 
-	for (i = cd->config.sel_channel; i < frames * nch; i += nch) {
-		src = buffer_read_frag_s16(source, i);
-		dest = buffer_write_frag_s16(sink, j++);
-		*dest = *src;
+		for (i = 0; i < n; i++)
+			dest[i] = src[i * nch + sel];
+
+		frames -= n;
+		src = buffer_wrap(source, src + n * nch);
+		dest = buffer_wrap(sink, dest + n);
 	}
 }
 
@@ -53,16 +71,33 @@ static void sel_s32le_1ch(struct comp_dev *dev, struct comp_buffer *sink,
 			  struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
-	int32_t *src;
-	int32_t *dest;
-	uint32_t i;
-	uint32_t j = 0;
+	int32_t *src = source->r_ptr;
+	int32_t *dest = sink->w_ptr;
 	uint32_t nch = cd->config.in_channels_count;
+	uint32_t sel = cd->config.sel_channel;
+	uint32_t n;
+	uint32_t i;
+
+	while (frames) {
+		n = MIN(buffer_s32_without_wrap(source, src) / nch,
+			buffer_s32_without_wrap(sink, dest));
+		n = MIN(n, frames);
+
+		/* source frame wraps in the middle */
+		if (!n) {
+			*dest = *(int32_t *)buffer_wrap(source, src + sel);
+			frames--;
+			src = buffer_wrap(source, src + nch);
+			dest = buffer_wrap(sink, dest + 1);
+			continue;
+		}
+
+		for (i = 0; i < n; i++)
+			dest[i] = src[i * nch + sel];
 
-	for (i = cd->config.sel_channel; i < frames * nch; i += nch) {
-		src = buffer_read_frag_s32(source, i);
-		dest = buffer_write_frag_s32(sink, j++);
-		*dest = *src;
+		frames -= n;
+		src = buffer_wrap(source, src + n * nch);
+		dest = buffer_wrap(sink, dest + n);
 	}
 }
 
@@ -77,21 +112,9 @@ static void sel_s16le_nch(struct comp_dev *dev, struct comp_buffer *sink,
 			  struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
-	int16_t *src;
-	int16_t *dest;
-	uint32_t i;
-	uint32_t j = 0;
-	uint32_t channel;
-
-	for (i = 0; i < frames; i++) {
-		for (channel = 0; channel < cd->config.in_channels_count;
-		     channel++) {
-			src = buffer_read_frag_s16(source, j);
-			dest = buffer_write_frag_s16(sink, j);
-			*dest = *src;
-			j++;
-		}
-	}
+
+	buffer_copy_bytes(source, sink, frames * cd->config.in_channels_count *
+			  sizeof(int16_t));
 }
 
 /**
@@ -105,21 +128,9 @@ static void sel_s32le_nch(struct comp_dev *dev, struct comp_buffer *sink,
 			  struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
-	int32_t *src;
-	int32_t *dest;
-	uint32_t i;
-	uint32_t j = 0;
-	uint32_t channel;
-
-	for (i = 0; i < frames; i++) {
-		for (channel = 0; channel < cd->config.in_channels_count;
-		     channel++) {
-			src = buffer_read_frag_s32(source, j);
-			dest = buffer_write_frag_s32(sink, j);
-			*dest = *src;
-			j++;
-		}
-	}
+
+	buffer_copy_bytes(source, sink, frames * cd->config.in_channels_count *
+			  sizeof(int32_t));
 }
 
 const struct comp_func_map func_table[] = {
@@ -0,0 +1,188 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2019 Intel Corporation. All rights reserved.
+
+#include <sof/audio/buffer.h>
+#include <sof/audio/format.h>
+#include <sof/audio/src/asrc.h>
+#include <sof/audio/coefficients/src/asrc_std_int32.h>
+#include <sof/math/numbers.h>
+#include <ipc/stream.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Asynchronous sample rate conversion. Output samples are interpolated from
+ * the input history at a fractional position that advances by fs_in / fs_out
+ * per output frame. The step is continuously adjusted by a PI controller
+ * from the source buffer fill level so that the consumed input rate tracks
+ * the actual rate of the producer clock domain.
+ */
+
+size_t asrc_hist_size(int nch)
+{
+	return nch * 2 * ASRC_TAPS * sizeof(int32_t);
+}
+
+int asrc_init(struct asrc_state *asrc, int fs_in, int fs_out, int nch,
+	      int frame_fmt, int period, int32_t *hist)
+{
+	int i;
+
+	/* The filter cutoff is fixed to input rate so down sampling would
+	 * alias, allow only up sampling and equal nominal rates.
+	 */
+	if (fs_in <= 0 || fs_out <= 0 || fs_in > fs_out || period <= 0)
+		return -EINVAL;
+
+	asrc->nch = nch;
+	asrc->frame_fmt = frame_fmt;
+	asrc->wp = 0;
+	asrc->phase = ASRC_ONE;
+	asrc->step_nominal = ((uint64_t)fs_in << 32) / fs_out;
+	asrc->step = asrc->step_nominal;
+	asrc->drift = 0;
+	asrc->integ = 0;
+	asrc->level = 0;
+	asrc->period = period;
+	asrc->target = period + period / 2;
+	asrc->hist = hist;
+
+	for (i = 0; i < nch * 2 * ASRC_TAPS; i++)
+		hist[i] = 0;
+
+	return 0;
+}
+
+/* Called once per block with the source fill level in frames before
+ * processing. The level settles to the target when the step matches the
+ * producer rate.
+ */
+void asrc_update(struct asrc_state *asrc, int level)
+{
+	int64_t err;
+	int64_t drift;
+
+	/* Level error in Q8.24 periods */
+	err = ((int64_t)(level - asrc->target) << 24) / asrc->period;
+	err = MAX(MIN(err, INT32_MAX >> 1), -(INT32_MAX >> 1));
+	asrc->level += ((int32_t)err - asrc->level) >> ASRC_SMOOTH_SHIFT;
+
+	/* Q8.24 to Q1.31 is a left shift by 7 */
+	drift = asrc->integ +
+		(((int64_t)asrc->level << 7) >> ASRC_KI_SHIFT);
+	asrc->integ = MAX(MIN(drift, ASRC_DRIFT_MAX), -ASRC_DRIFT_MAX);
+
+	drift = asrc->integ +
+		(((int64_t)asrc->level << 7) >> ASRC_KP_SHIFT);
+	asrc->drift = MAX(MIN(drift, ASRC_DRIFT_MAX), -ASRC_DRIFT_MAX);
+
+	asrc->step = asrc->step_nominal +
+		(((int64_t)asrc->step_nominal * asrc->drift) >> 31);
+}
+
+static inline int32_t asrc_read(struct asrc_state *asrc,
+				struct comp_buffer *source, int idx)
+{
+	switch (asrc->frame_fmt) {
+	case SOF_IPC_FRAME_S16_LE:
+		return *(int16_t *)buffer_read_frag_s16(source, idx) << 16;
+	case SOF_IPC_FRAME_S24_4LE:
+		return *(int32_t *)buffer_read_frag_s32(source, idx) << 8;
+	default:
+		return *(int32_t *)buffer_read_frag_s32(source, idx);
+	}
+}
+
+static inline void asrc_write(struct asrc_state *asrc,
+			      struct comp_buffer *sink, int idx, int32_t y)
+{
+	switch (asrc->frame_fmt) {
+	case SOF_IPC_FRAME_S16_LE:
+		*(int16_t *)buffer_write_frag_s16(sink, idx) =
+			sat_int16(Q_SHIFT_RND(y, 31, 15));
+		break;
+	case SOF_IPC_FRAME_S24_4LE:
+		*(int32_t *)buffer_write_frag_s32(sink, idx) =
+			sat_int24(Q_SHIFT_RND(y, 31, 23));
+		break;
+	default:
+		*(int32_t *)buffer_write_frag_s32(sink, idx) = y;
+		break;
+	}
+}
+
+/* Linear interpolation between the two closest filter phases */
+static void asrc_coef(struct asrc_state *asrc, int32_t *h)
+{
+	uint32_t pos = (uint32_t)asrc->phase;
+	int32_t frac = (pos << ASRC_PHASES_SHIFT) >> 1;
+	const int32_t *c0 = asrc_int32_fir[pos >> (32 - ASRC_PHASES_SHIFT)];
+	const int32_t *c1 = c0 + ASRC_TAPS;
+	int i;
+
+	for (i = 0; i < ASRC_TAPS; i++)
+		h[i] = c0[i] + (((int64_t)(c1[i] - c0[i]) * frac) >> 31);
+}
+
+static inline int32_t asrc_filter(struct asrc_state *asrc, int ch,
+				  const int32_t *h)
+{
+	int32_t *x = asrc->hist + ch * 2 * ASRC_TAPS + asrc->wp;
+	int64_t acc = 0;
+	int i;
+
+	/* Q2.30 x Q1.31 -> Q3.61 */
+	for (i = 0; i < ASRC_TAPS; i++)
+		acc += (int64_t)h[i] * x[i];
+
+	return sat_int32(Q_SHIFT_RND(acc, 61, 31));
+}
+
+/* Converts up to frames_in source frames into at most frames_out sink
+ * frames. The histories are mirrored so the oldest to newest window of
+ * every channel is contiguous from the write index.
+ */
+void asrc_process(struct asrc_state *asrc, struct comp_buffer *source,
+		  struct comp_buffer *sink, int frames_in, int frames_out,
+		  int *n_read, int *n_written)
+{
+	int32_t h[ASRC_TAPS];
+	int32_t *hist;
+	int32_t x;
+	int nch = asrc->nch;
+	int i = 0;
+	int j = 0;
+	int ch;
+
+	while (j < frames_out) {
+		if (asrc->phase >= ASRC_ONE) {
+			if (i == frames_in)
+				break;
+
+			for (ch = 0; ch < nch; ch++) {
+				hist = asrc->hist + ch * 2 * ASRC_TAPS;
+				x = asrc_read(asrc, source, i * nch + ch);
+				hist[asrc->wp] = x;
+				hist[asrc->wp + ASRC_TAPS] = x;
+			}
+
+			asrc->wp = (asrc->wp + 1) & (ASRC_TAPS - 1);
+			asrc->phase -= ASRC_ONE;
+			i++;
+			continue;
+		}
+
+		asrc_coef(asrc, h);
+		for (ch = 0; ch < nch; ch++)
+			asrc_write(asrc, sink, j * nch + ch,
+				   asrc_filter(asrc, ch, h));
+
+		asrc->phase += asrc->step;
+		j++;
+	}
+
+	*n_read = i;
+	*n_written = j;
+}
@@ -10,8 +10,10 @@
 #include <sof/audio/buffer.h>
 #include <sof/audio/component.h>
 #include <sof/audio/pipeline.h>
+#include <sof/audio/src/asrc.h>
 #include <sof/audio/src/src.h>
 #include <sof/audio/src/src_config.h>
+#include <sof/audio/src/src_design.h>
 #include <sof/debug/panic.h>
 #include <sof/drivers/ipc.h>
 #include <sof/lib/alloc.h>
@@ -26,16 +28,21 @@
 #include <ipc/topology.h>
 #include <user/trace.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
 #if SRC_SHORT
 #include <sof/audio/coefficients/src/src_tiny_int16_define.h>
+#if CONFIG_COMP_SRC_TABLES
 #include <sof/audio/coefficients/src/src_tiny_int16_table.h>
+#endif
 #else
 #include <sof/audio/coefficients/src/src_std_int32_define.h>
+#if CONFIG_COMP_SRC_TABLES
 #include <sof/audio/coefficients/src/src_std_int32_table.h>
 #endif
+#endif
 
 #define trace_src(__e, ...) \
 	trace_event(TRACE_CLASS_SRC, __e, ##__VA_ARGS__)
@@ -52,6 +59,8 @@
 struct comp_data {
 	struct polyphase_src src;
 	struct src_param param;
+	struct asrc_state asrc;
+	bool asrc_enable; /* asynchronous mode from switch control */
 	int32_t *delay_lines;
 	uint32_t sink_rate;
 	uint32_t source_rate;
@@ -84,6 +93,7 @@ static int src_out_delay_length(struct src_stage *s)
 	return 1 + (s->num_of_subfilters - 1) * s->odm;
 }
 
+#if CONFIG_COMP_SRC_TABLES
 /* Returns index of a matching sample rate */
 static int src_find_fs(int fs_list[], int list_length, int fs)
 {
@@ -95,6 +105,48 @@ static int src_find_fs(int fs_list[], int list_length, int fs)
 	}
 	return -EINVAL;
 }
+#endif
+
+/* Gets the conversion stages from the built-in tables, or designs them if
+ * the rates combination is missing from the tables.
+ */
+static int src_find_stages(struct src_param *a, int fs_in, int fs_out)
+{
+#if CONFIG_COMP_SRC_TABLES
+	int idx_in = src_find_fs(src_in_fs, NUM_IN_FS, fs_in);
+	int idx_out = src_find_fs(src_out_fs, NUM_OUT_FS, fs_out);
+
+	/* A deleted in/out rate combination has zero stage1 length */
+	if (idx_in >= 0 && idx_out >= 0 &&
+	    src_table1[idx_out][idx_in]->filter_length > 0) {
+		a->stage1 = src_table1[idx_out][idx_in];
+		a->stage2 = src_table2[idx_out][idx_in];
+		return 0;
+	}
+#endif
+
+#if CONFIG_COMP_SRC_DESIGN
+	a->design = src_design_get(fs_in, fs_out);
+	if (a->design) {
+		a->stage1 = a->design->stage1;
+		a->stage2 = a->design->stage2;
+		return 0;
+	}
+#endif
+
+	return -EINVAL;
+}
+
+/* Releases the stages of previous rates */
+static void src_free_stages(struct src_param *a)
+{
+#if CONFIG_COMP_SRC_DESIGN
+	src_design_put(a->design);
+#endif
+	a->design = NULL;
+	a->stage1 = NULL;
+	a->stage2 = NULL;
+}
 
 /* Calculates buffers to allocate for a SRC mode */
 int src_buffer_lengths(struct src_param *a, int fs_in, int fs_out, int nch,
@@ -111,27 +163,18 @@ int src_buffer_lengths(struct src_param *a, int fs_in, int fs_out, int nch,
 	}
 
 	a->nch = nch;
-	a->idx_in = src_find_fs(src_in_fs, NUM_IN_FS, fs_in);
-	a->idx_out = src_find_fs(src_out_fs, NUM_OUT_FS, fs_out);
+	src_free_stages(a);
 
 	/* Check that both in and out rates are supported */
-	if (a->idx_in < 0 || a->idx_out < 0) {
+	if (src_find_stages(a, fs_in, fs_out) < 0) {
 		trace_src_error("src_buffer_lengths() error: "
 				"rates not supported, "
 				"fs_in: %u, fs_out: %u", fs_in, fs_out);
 		return -EINVAL;
 	}
 
-	stage1 = src_table1[a->idx_out][a->idx_in];
-	stage2 = src_table2[a->idx_out][a->idx_in];
-
-	/* Check from stage1 parameter for a deleted in/out rate combination.*/
-	if (stage1->filter_length < 1) {
-		trace_src_error("src_buffer_lengths() error: "
-				"Non-supported combination "
-				"fs_in = %d, fs_out = %d", fs_in, fs_out);
-		return -EINVAL;
-	}
+	stage1 = a->stage1;
+	stage2 = a->stage2;
 
 	a->fir_s1 = nch * src_fir_delay_length(stage1);
 	a->out_s1 = nch * src_out_delay_length(stage1);
@@ -256,29 +299,26 @@ void src_polyphase_reset(struct polyphase_src *src)
 int src_polyphase_init(struct polyphase_src *src, struct src_param *p,
 		       int32_t *delay_lines_start)
 {
-	struct src_stage *stage1;
-	struct src_stage *stage2;
 	int n_stages;
 	int ret;
 
-	if (p->idx_in < 0 || p->idx_out < 0)
+	if (!p->stage1 || !p->stage2)
 		return -EINVAL;
 
 	/* Get setup for 2 stage conversion */
-	stage1 = src_table1[p->idx_out][p->idx_in];
-	stage2 = src_table2[p->idx_out][p->idx_in];
-	ret = init_stages(stage1, stage2, src, p, 2, delay_lines_start);
+	ret = init_stages(p->stage1, p->stage2, src, p, 2,
+			  delay_lines_start);
 	if (ret < 0)
 		return -EINVAL;
 
 	/* Get number of stages used for optimize opportunity. 2nd
 	 * stage length is one if conversion needs only one stage.
-	 * If input and output rate is the same return 0 to
-	 * use a simple copy function instead of 1 stage FIR with one
-	 * tap.
+	 * If input and output rate is the same the 1st stage is also
+	 * one tap, return 0 to use a simple copy function instead of
+	 * 1 stage FIR with one tap.
 	 */
 	n_stages = (src->stage2->filter_length == 1) ? 1 : 2;
-	if (p->idx_in == p->idx_out)
+	if (src->stage1->filter_length == 1)
 		n_stages = 0;
 
 	/* If filter length for first stage is zero this is a deleted
@@ -496,6 +536,51 @@ static void src_copy_s16(struct comp_dev *dev,
 	*n_written = frames;
 }
 
+/* Asynchronous SRC, the ratio follows the source fill level */
+static void src_asrc(struct comp_dev *dev,
+		     struct comp_buffer *source, struct comp_buffer *sink,
+		     int *n_read, int *n_written)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+
+	asrc_update(&cd->asrc, cd->param.blk_in);
+	asrc_process(&cd->asrc, source, sink, cd->param.blk_in,
+		     cd->param.blk_out, n_read, n_written);
+}
+
+/* Asynchronous mode needs only the interpolator history */
+static int src_asrc_params(struct comp_dev *dev)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	size_t size = asrc_hist_size(dev->params.channels);
+
+	if (dev->params.channels > PLATFORM_MAX_CHANNELS ||
+	    cd->source_rate > cd->sink_rate) {
+		trace_src_error("src_asrc_params() error: "
+				"fs_in = %u, fs_out = %u, nch = %u",
+				cd->source_rate, cd->sink_rate,
+				dev->params.channels);
+		return -EINVAL;
+	}
+
+	if (cd->delay_lines)
+		rfree(cd->delay_lines);
+
+	cd->delay_lines = rballoc(RZONE_BUFFER, SOF_MEM_CAPS_RAM, size);
+	if (!cd->delay_lines) {
+		trace_src_error("src_asrc_params() error: "
+				"failed to alloc cd->delay_lines, "
+				"size = %u", size);
+		return -ENOMEM;
+	}
+
+	/* Used for cache maintenance of the delay lines */
+	cd->param.total = size / sizeof(int32_t);
+	cd->src_func = src_asrc;
+
+	return 0;
+}
+
 static struct comp_dev *src_new(struct sof_ipc_comp *comp)
 {
 	struct comp_dev *dev;
@@ -558,6 +643,7 @@ static void src_free(struct comp_dev *dev)
 	if (cd->delay_lines)
 		rfree(cd->delay_lines);
 
+	src_free_stages(&cd->param);
 	rfree(cd);
 	rfree(dev);
 }
@@ -596,6 +682,9 @@ static int src_params(struct comp_dev *dev)
 		cd->sink_rate;
 	cd->sink_frames = dev->frames;
 
+	if (cd->asrc_enable)
+		return src_asrc_params(dev);
+
 	/* Allocate needed memory for delay lines */
 	trace_src("src_params(), source_rate = %u, sink_rate = %u",
 		  cd->source_rate, cd->sink_rate);
@@ -664,10 +753,50 @@ static int src_params(struct comp_dev *dev)
 	return 0;
 }
 
+/* The switch control selects the asynchronous mode from next params */
 static int src_ctrl_cmd(struct comp_dev *dev, struct sof_ipc_ctrl_data *cdata)
 {
-	trace_src_error("src_ctrl_cmd()");
-	return -EINVAL;
+	struct comp_data *cd = comp_get_drvdata(dev);
+
+	if (cdata->cmd != SOF_CTRL_CMD_SWITCH || cdata->num_elems < 1) {
+		trace_src_error("src_ctrl_cmd() error: invalid cdata->cmd");
+		return -EINVAL;
+	}
+
+	if (dev->state == COMP_STATE_ACTIVE) {
+		trace_src_error("src_ctrl_cmd() error: stream is active");
+		return -EBUSY;
+	}
+
+	cd->asrc_enable = cdata->chanv[0].value != 0;
+	trace_src("src_ctrl_cmd(), asrc_enable = %u", cd->asrc_enable);
+
+	return 0;
+}
+
+/* Returns the switch state and in the second element the drift estimate of
+ * asynchronous mode in ppm.
+ */
+static int src_ctrl_get_cmd(struct comp_dev *dev,
+			    struct sof_ipc_ctrl_data *cdata)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+
+	if (cdata->cmd != SOF_CTRL_CMD_SWITCH || cdata->num_elems < 1 ||
+	    cdata->num_elems > 2) {
+		trace_src_error("src_ctrl_get_cmd() error: invalid cdata");
+		return -EINVAL;
+	}
+
+	cdata->chanv[0].channel = 0;
+	cdata->chanv[0].value = cd->asrc_enable;
+	if (cdata->num_elems > 1) {
+		cdata->chanv[1].channel = 1;
+		cdata->chanv[1].value = cd->src_func == src_asrc ?
+			asrc_drift_ppm(&cd->asrc) : 0;
+	}
+
+	return 0;
 }
 
 /* used to pass standard and bespoke commands (with data) to component */
@@ -679,8 +808,16 @@ static int src_cmd(struct comp_dev *dev, int cmd, void *data,
 
 	trace_src("src_cmd()");
 
-	if (cmd == COMP_CMD_SET_VALUE)
+	switch (cmd) {
+	case COMP_CMD_SET_VALUE:
 		ret = src_ctrl_cmd(dev, cdata);
+		break;
+	case COMP_CMD_GET_VALUE:
+		ret = src_ctrl_get_cmd(dev, cdata);
+		break;
+	default:
+		break;
+	}
 
 	return ret;
 }
@@ -707,6 +844,14 @@ static int src_get_copy_limits(struct comp_data *cd,
 	s1 = cd->src.stage1;
 	s2 = cd->src.stage2;
 
+	/* Asynchronous mode consumes what is needed for one sink period */
+	if (cd->src_func == src_asrc) {
+		frames_snk = sink->free / comp_frame_bytes(sink->sink);
+		sp->blk_out = MIN(frames_snk, cd->sink_frames);
+		sp->blk_in = source->avail / comp_frame_bytes(source->source);
+		return sp->blk_out ? 0 : -EIO;
+	}
+
 	/* Calculate how many blocks can be processed with
 	 * available source and free sink frames amount.
 	 */
@@ -864,7 +1009,8 @@ static int src_prepare(struct comp_dev *dev)
 		 * data. Change it to 16 bit version here if source and sink
 		 * rates are equal.
 		 */
-		if (cd->source_rate == cd->sink_rate)
+		if (cd->source_rate == cd->sink_rate &&
+		    cd->src_func != src_asrc)
 			cd->src_func = src_copy_s16;
 		break;
 	case SOF_IPC_FRAME_S24_4LE:
@@ -882,6 +1028,17 @@ static int src_prepare(struct comp_dev *dev)
 		goto err;
 	}
 
+	if (cd->src_func == src_asrc) {
+		ret = asrc_init(&cd->asrc, cd->source_rate, cd->sink_rate,
+				dev->params.channels, cd->source_format,
+				cd->source_frames, cd->delay_lines);
+		if (ret < 0) {
+			trace_src_error("src_prepare() error: asrc_init() "
+					"failed");
+			goto err;
+		}
+	}
+
 	return 0;
 
 err:
@@ -954,6 +1111,9 @@ struct comp_driver comp_src = {
 
 static void sys_comp_src_init(void)
 {
+#if CONFIG_COMP_SRC_DESIGN
+	src_design_init();
+#endif
 	comp_register(&comp_src);
 }
 
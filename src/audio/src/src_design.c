@@ -0,0 +1,545 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2019 Intel Corporation. All rights reserved.
+
+/* Runtime design of polyphase SRC filters. The conversion is factored to
+ * two stages and the filters are Blackman windowed sinc low-pass filters
+ * with the pass band and gain of tools/tune/src/src_param.m. The designs
+ * are cached so that repeated prepares with the same rates are free.
+ */
+
+#include <sof/audio/format.h>
+#include <sof/audio/src/src.h>
+#include <sof/audio/src/src_design.h>
+#include <sof/debug/panic.h>
+#include <sof/lib/alloc.h>
+#include <sof/lib/cache.h>
+#include <sof/lib/memory.h>
+#include <sof/list.h>
+#include <sof/math/numbers.h>
+#include <sof/math/trig.h>
+#include <sof/spinlock.h>
+#include <sof/string.h>
+#include <sof/trace/trace.h>
+#include <ipc/topology.h>
+#include <user/trace.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <sof/audio/src/src_config.h>
+
+#if SRC_SHORT
+#include <sof/audio/coefficients/src/src_tiny_int16_define.h>
+#else
+#include <sof/audio/coefficients/src/src_std_int32_define.h>
+#endif
+
+#define trace_src(__e, ...) \
+	trace_event(TRACE_CLASS_SRC, __e, ##__VA_ARGS__)
+#define trace_src_error(__e, ...) \
+	trace_error(TRACE_CLASS_SRC, __e, ##__VA_ARGS__)
+
+/* Blackman window terms in Q1.31 */
+#define SRC_DESIGN_BLACKMAN_A0	901943132 /* 0.42 */
+#define SRC_DESIGN_BLACKMAN_A2	171798692 /* 0.08 */
+
+/* Largest scaled coefficient, 32767/32768 in Q1.31 */
+#define SRC_DESIGN_COEF_MAX	(INT32_MAX - (1 << 16) + 1)
+
+struct src_design_stage {
+	int l;			/* Interpolation factor */
+	int m;			/* Decimation factor */
+	int fs;			/* Input rate */
+	int f_pb;		/* Pass band edge in Hz */
+	int f_sb;		/* Stop band edge in Hz */
+	int idm;
+	int odm;
+	int subfilter_length;
+	int filter_length;
+};
+
+#if SRC_SHORT
+static const int16_t src_design_one = 16384;
+#else
+static const int32_t src_design_one = 1073741824;
+#endif
+
+/* Copy stage used as second stage of single stage conversions */
+static const struct src_stage src_design_copy = {
+	0, 0, 1, 1, 1, 1, 1, 0, -1, &src_design_one
+};
+
+/* Designs shared by the SRC instances of all cores */
+struct src_design_cache {
+	spinlock_t *lock;	/* protects the list and design references */
+	struct list_item list;	/* most recently used design first */
+} __aligned(PLATFORM_DCACHE_ALIGN);
+
+/* accessed through uncached addresses only */
+static struct src_design_cache _src_design_cache;
+
+static inline struct src_design_cache *src_design_cache_get(void)
+{
+	return cache_to_uncache(&_src_design_cache);
+}
+
+/* Returns round(sqrt(c)) */
+static int src_design_sqrt(int c)
+{
+	int x = 0;
+
+	while (4 * (x + 1) * (x + 1) - 4 * (x + 1) + 1 <= 4 * c)
+		x++;
+
+	return x;
+}
+
+/* Splits c to factors a * b with a near sqrt(c), this is factor2() of
+ * tools/tune/src/src_factor2_lm.m. A prime is returned as c * 1.
+ */
+static void src_design_factor2(int c, int *a, int *b)
+{
+	int x = src_design_sqrt(c);
+	int a1 = 0;
+	int a2 = 0;
+	int t;
+
+	for (t = x; t <= 2 * x; t++) {
+		if (c % t == 0) {
+			a1 = t;
+			break;
+		}
+	}
+
+	for (t = x; t >= MAX(x / 2, 1); t--) {
+		if (c % t == 0) {
+			a2 = t;
+			break;
+		}
+	}
+
+	if (a1 && (!a2 || a1 - x < x - a2))
+		*a = a1;
+	else if (a2)
+		*a = a2;
+	else
+		*a = c;
+
+	*b = c / *a;
+}
+
+/* Factors the conversion to two stages as in src_factor2_lm.m. The
+ * intermediate rate is kept above the lower of the in and out rates and
+ * as near to it as possible.
+ */
+static void src_design_factor(int fs_in, int fs_out,
+			      struct src_design_stage *s1,
+			      struct src_design_stage *s2)
+{
+	int k = gcd(fs_in, fs_out);
+	int l = fs_out / k;
+	int m = fs_in / k;
+	int fs_min = MIN(fs_in, fs_out);
+	int fs3_best = 0;
+	int fs3;
+	int lf[2];
+	int mf[2];
+	int i;
+	int j;
+
+	s1->l = l;
+	s1->m = m;
+	s2->l = 1;
+	s2->m = 1;
+
+	src_design_factor2(l, &lf[0], &lf[1]);
+	src_design_factor2(m, &mf[0], &mf[1]);
+
+	for (i = 0; i < 2; i++) {
+		for (j = 0; j < 2; j++) {
+			/* fs_in is a multiple of m so this is exact */
+			fs3 = fs_in / mf[j] * lf[i];
+			if (fs3 < fs_min || (fs3_best && fs3 >= fs3_best))
+				continue;
+
+			fs3_best = fs3;
+			s1->l = lf[i];
+			s1->m = mf[j];
+			s2->l = lf[1 - i];
+			s2->m = mf[1 - j];
+		}
+	}
+
+	if (s1->l == 1 && s1->m == 1) {
+		s1->l = s2->l;
+		s1->m = s2->m;
+		s2->l = 1;
+		s2->m = 1;
+	}
+
+	s1->fs = fs_in;
+	s2->fs = fs_in / s1->m * s1->l;
+}
+
+/* Finds the smallest idm, odm for which -idm * l + odm * m = 1, this is
+ * tools/tune/src/src_find_l0m0.m.
+ */
+static void src_design_l0m0(struct src_design_stage *s)
+{
+	int lt;
+
+	s->idm = 1;
+	s->odm = 0;
+	if (s->m == 1) {
+		s->idm = 0;
+		s->odm = 1;
+		return;
+	}
+
+	if (s->l == 1)
+		return;
+
+	/* The first solution has also the smallest sum */
+	for (lt = 1; lt <= 4 * s->l; lt++) {
+		if ((1 + lt * s->l) % s->m == 0) {
+			s->idm = lt;
+			s->odm = (1 + lt * s->l) / s->m;
+			return;
+		}
+	}
+}
+
+/* Pass band edge as in src_param.m, 20 kHz bandwidth at 44.1 kHz and
+ * 24 kHz for rates above 80 kHz.
+ */
+static int src_design_pass_band(int fs)
+{
+	if (fs > 80000)
+		return 24000;
+
+	return (int64_t)fs * 200 / 441;
+}
+
+/* Computes the filter length and checks it against the delay line limits */
+static int src_design_length(struct src_design_stage *s, int f_pb)
+{
+	int64_t fs_up = (int64_t)s->fs * s->l;
+	int64_t df;
+	int64_t n;
+	int fs_out = fs_up / s->m;
+
+	s->f_pb = f_pb;
+	s->f_sb = MIN(s->fs, fs_out) / 2;
+	df = s->f_sb - s->f_pb;
+	if (df <= 0)
+		return -EINVAL;
+
+	n = (SRC_DESIGN_TW_Q8 * fs_up + 256 * df - 1) / (256 * df);
+	s->subfilter_length = ceil_divide((int)n, 4 * s->l) * 4;
+	s->filter_length = s->subfilter_length * s->l;
+	src_design_l0m0(s);
+
+	if (s->filter_length > SRC_DESIGN_MAX_TAPS ||
+	    s->subfilter_length + (s->l - 1) * s->idm + s->m >
+	    MAX_FIR_DELAY_SIZE ||
+	    1 + (s->l - 1) * s->odm > MAX_OUT_DELAY_SIZE)
+		return -EINVAL;
+
+	return 0;
+}
+
+static int32_t src_design_cos(int64_t w)
+{
+	return sin_fixed((w + PI_DIV2_Q4_28) % PI_MUL2_Q4_28);
+}
+
+/* Returns tap n of the windowed sinc prototype filter in Q1.31 */
+static int32_t src_design_tap(struct src_design_stage *s, int n)
+{
+	int64_t fs_up = (int64_t)s->fs * s->l;
+	int64_t fc2 = s->f_pb + s->f_sb; /* Two times cutoff in Hz */
+	int64_t w;
+	int64_t h;
+	int64_t t2;
+	int64_t phase;
+	int32_t win;
+
+	/* Two times distance from the center, odd for even lengths */
+	t2 = 2 * n - (s->filter_length - 1);
+	t2 = ABS(t2);
+
+	/* sin(2 * pi * fc * t) / (pi * t) with the phase wrapped to one
+	 * period
+	 */
+	phase = (fc2 * t2) % (4 * fs_up);
+	w = phase * PI_MUL2_Q4_28 / (4 * fs_up);
+	h = ((int64_t)sin_fixed(w) << 29) / ((int64_t)PI_Q4_28 * t2);
+
+	/* 0.42 - 0.5 * cos(2 * pi * k) + 0.08 * cos(4 * pi * k) where
+	 * k = (n + 1) / (filter_length + 1)
+	 */
+	w = (int64_t)(n + 1) * PI_MUL2_Q4_28 / (s->filter_length + 1);
+	win = SRC_DESIGN_BLACKMAN_A0 - (src_design_cos(w) >> 1) +
+		(int32_t)(((int64_t)SRC_DESIGN_BLACKMAN_A2 *
+			   src_design_cos(2 * w)) >> 31);
+
+	return (h * win) >> 31;
+}
+
+/* Designs the stage filter to coefs in the polyphase order of
+ * tools/tune/src/src_export_coef.m and returns the output shift.
+ */
+static int src_design_fir(struct src_design_stage *s, void *coefs,
+			  int32_t gain)
+{
+	int64_t sum = 0;
+	int64_t k;
+	int64_t c;
+	int32_t max_abs = 0;
+	int32_t tap;
+	int shift = 0;
+	int n;
+	int i;
+
+	for (n = 0; n < s->filter_length; n++) {
+		tap = src_design_tap(s, n);
+		sum += tap;
+		max_abs = MAX(max_abs, ABS(tap));
+	}
+
+	/* Gain of each sub-filter at 0 Hz is set to gain, k is Q8.24 */
+	k = ((int64_t)s->l * gain << 20) / (sum >> 4);
+
+	/* Largest shift that keeps the coefficients in range */
+	c = ((int64_t)max_abs * k) >> 24;
+	while (c > SRC_DESIGN_COEF_MAX) {
+		c >>= 1;
+		shift--;
+	}
+
+	while (c << 1 <= SRC_DESIGN_COEF_MAX) {
+		c <<= 1;
+		shift++;
+	}
+
+	k = shift > 0 ? k << shift : k >> -shift;
+
+	for (n = 0; n < s->filter_length; n++) {
+		c = ((int64_t)src_design_tap(s, n) * k + (1 << 23)) >> 24;
+		i = (n % s->l) * s->subfilter_length + n / s->l;
+#if SRC_SHORT
+		((int16_t *)coefs)[i] = sat_int16(Q_SHIFT_RND(c, 31, 15));
+#else
+		((int32_t *)coefs)[i] = sat_int32(c);
+#endif
+	}
+
+	return shift;
+}
+
+static void src_design_set_stage(struct src_stage *stage,
+				 const struct src_stage *src)
+{
+	int ret;
+
+	ret = memcpy_s(stage, sizeof(*stage), src, sizeof(*src));
+	assert(!ret);
+}
+
+/* Designs the stage filter and sets up the stage to use it */
+static void src_design_stage_init(struct src_stage *stage,
+				  struct src_design_stage *s, void *coefs,
+				  int32_t gain)
+{
+	int shift = src_design_fir(s, coefs, gain);
+	struct src_stage tmp = {
+		s->idm, s->odm, s->l, s->subfilter_length, s->filter_length,
+		s->m, s->l, 0, shift, coefs
+	};
+
+	src_design_set_stage(stage, &tmp);
+}
+
+static void src_design_free(struct src_design *design)
+{
+	if (design->coefs)
+		rfree(design->coefs);
+
+	rfree(design);
+}
+
+static struct src_design *src_design_new(int fs_in, int fs_out)
+{
+	struct src_design *design;
+	struct src_design_stage s1;
+	struct src_design_stage s2;
+	size_t coef_size;
+	int32_t gain;
+	int f_pb;
+	int ret;
+
+	if (fs_in <= 0 || fs_out <= 0)
+		return NULL;
+
+	/* the list links and stages are used by all cores */
+	design = rzalloc(RZONE_RUNTIME | RZONE_FLAG_UNCACHED, SOF_MEM_CAPS_RAM,
+			 sizeof(*design) + 2 * sizeof(struct src_stage));
+	if (!design)
+		return NULL;
+
+	design->fs_in = fs_in;
+	design->fs_out = fs_out;
+	design->stage1 = (struct src_stage *)(design + 1);
+	design->stage2 = design->stage1 + 1;
+
+	/* Equal rates are copied */
+	if (fs_in == fs_out) {
+		src_design_set_stage(design->stage1, &src_design_copy);
+		src_design_set_stage(design->stage2, &src_design_copy);
+		return design;
+	}
+
+	/* Both stages use the pass band of the conversion, the stop band
+	 * follows the lower rate of each stage.
+	 */
+	src_design_factor(fs_in, fs_out, &s1, &s2);
+	f_pb = src_design_pass_band(MIN(fs_in, fs_out));
+	ret = src_design_length(&s1, f_pb);
+	if (!ret && (s2.l > 1 || s2.m > 1)) {
+		ret = src_design_length(&s2, f_pb);
+		gain = SRC_DESIGN_GAIN_2S;
+	} else {
+		s2.filter_length = 0;
+		gain = SRC_DESIGN_GAIN_1S;
+	}
+
+	if (ret < 0) {
+		trace_src_error("src_design_new() error: fs_in = %d, "
+				"fs_out = %d exceeds filter limits",
+				fs_in, fs_out);
+		goto err;
+	}
+
+#if SRC_SHORT
+	coef_size = sizeof(int16_t);
+#else
+	coef_size = sizeof(int32_t);
+#endif
+	design->coefs_size = (s1.filter_length + s2.filter_length) *
+		coef_size;
+	design->coefs = rballoc(RZONE_BUFFER, SOF_MEM_CAPS_RAM,
+				design->coefs_size);
+	if (!design->coefs) {
+		trace_src_error("src_design_new() error: failed to alloc "
+				"coefficients");
+		goto err;
+	}
+
+	src_design_stage_init(design->stage1, &s1, design->coefs, gain);
+	if (s2.filter_length)
+		src_design_stage_init(design->stage2, &s2,
+				      (char *)design->coefs +
+				      s1.filter_length * coef_size, gain);
+	else
+		src_design_set_stage(design->stage2, &src_design_copy);
+
+	/* other cores read the coefficients once the design is published */
+	dcache_writeback_region(design->coefs, design->coefs_size);
+
+	trace_src("src_design_new(), fs_in = %d, fs_out = %d",
+		  fs_in, fs_out);
+	trace_src("src_design_new(), stage1 taps = %d, stage2 taps = %d",
+		  s1.filter_length, s2.filter_length);
+
+	return design;
+
+err:
+	src_design_free(design);
+	return NULL;
+}
+
+/* Frees the least recently used unreferenced designs above the cache size,
+ * called with the lock held.
+ */
+static void src_design_evict(struct src_design_cache *cache)
+{
+	struct list_item *item;
+	struct list_item *tmp;
+	struct src_design *design;
+	int unused = 0;
+
+	list_for_item_safe(item, tmp, &cache->list) {
+		design = list_item(item, struct src_design, list);
+		if (design->refs || ++unused <= SRC_DESIGN_CACHE_SIZE)
+			continue;
+
+		list_item_del(&design->list);
+		src_design_free(design);
+	}
+}
+
+void src_design_init(void)
+{
+	struct src_design_cache *cache = src_design_cache_get();
+
+	/* set up by master core before slaves run */
+	dcache_writeback_invalidate_region(&_src_design_cache,
+					   sizeof(_src_design_cache));
+
+	list_init(&cache->list);
+	spinlock_init(&cache->lock);
+}
+
+struct src_design *src_design_get(int fs_in, int fs_out)
+{
+	struct src_design_cache *cache = src_design_cache_get();
+	struct list_item *item;
+	struct src_design *design;
+
+	spin_lock(cache->lock);
+
+	list_for_item(item, &cache->list) {
+		design = list_item(item, struct src_design, list);
+		if (design->fs_in == fs_in && design->fs_out == fs_out) {
+			/* Keep the most recently used first */
+			list_item_del(&design->list);
+			list_item_prepend(&design->list, &cache->list);
+			design->refs++;
+			spin_unlock(cache->lock);
+
+			/* drop stale lines, may be designed on another core */
+			if (design->coefs)
+				dcache_invalidate_region(design->coefs,
+							 design->coefs_size);
+			return design;
+		}
+	}
+
+	spin_unlock(cache->lock);
+
+	design = src_design_new(fs_in, fs_out);
+	if (!design)
+		return NULL;
+
+	spin_lock(cache->lock);
+	design->refs = 1;
+	list_item_prepend(&design->list, &cache->list);
+	src_design_evict(cache);
+	spin_unlock(cache->lock);
+
+	return design;
+}
+
+void src_design_put(struct src_design *design)
+{
+	struct src_design_cache *cache = src_design_cache_get();
+
+	if (!design)
+		return;
+
+	spin_lock(cache->lock);
+	if (--design->refs == 0)
+		src_design_evict(cache);
+	spin_unlock(cache->lock);
+}
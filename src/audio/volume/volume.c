@@ -14,20 +14,20 @@
  *          Tomasz Lauda <tomasz.lauda@linux.intel.com>
  */
 
+#include <sof/audio/buffer.h>
 #include <sof/audio/component.h>
 #include <sof/audio/format.h>
 #include <sof/audio/pipeline.h>
 #include <sof/audio/volume.h>
 #include <sof/common.h>
 #include <sof/debug/panic.h>
+#include <sof/drivers/interrupt.h>
 #include <sof/drivers/ipc.h>
 #include <sof/lib/alloc.h>
 #include <sof/lib/cache.h>
 #include <sof/list.h>
 #include <sof/math/numbers.h>
 #include <sof/platform.h>
-#include <sof/schedule/schedule.h>
-#include <sof/schedule/task.h>
 #include <sof/string.h>
 #include <sof/trace/trace.h>
 #include <ipc/control.h>
@@ -56,73 +56,224 @@ static void vol_sync_host(struct comp_data *cd, uint32_t chan)
 	}
 }
 
+/* Q2.30 cubic fits of log2(1 + x) and 2^x - 1 for x = 0 ... 1 */
+#define VOL_LOG2_C1	1528455721
+#define VOL_LOG2_C2	-631074335
+#define VOL_LOG2_C3	177767461
+#define VOL_EXP2_C1	746712298
+#define VOL_EXP2_C2	243675092
+#define VOL_EXP2_C3	83086830
+
 /**
- * \brief Update volume with target value.
- * \param[in,out] cd Volume component private data.
+ * \brief Computes log2 of a gain.
+ * \param[in] x Positive Q8.16 gain.
+ * \return log2(x) as Q8.16.
+ */
+static int32_t vol_log2(int32_t x)
+{
+	int32_t e = 0;
+	int64_t y;
+	int64_t p;
+
+	/* normalize to 1.0 ... 2.0 */
+	while (x >= 2 * VOL_ZERO_DB) {
+		x >>= 1;
+		e++;
+	}
+	while (x < VOL_ZERO_DB) {
+		x <<= 1;
+		e--;
+	}
+
+	y = x - VOL_ZERO_DB;
+	p = ((VOL_LOG2_C3 * y) >> VOL_QXY_Y) + VOL_LOG2_C2;
+	p = ((p * y) >> VOL_QXY_Y) + VOL_LOG2_C1;
+	p = (p * y) >> VOL_QXY_Y;
+
+	return (e << VOL_QXY_Y) + (int32_t)(p >> (30 - VOL_QXY_Y));
+}
+
+/**
+ * \brief Computes power of two.
+ * \param[in] x Q8.16 exponent, below log2(VOL_MAX).
+ * \return 2^x as Q8.16 gain.
+ */
+static int32_t vol_exp2(int32_t x)
+{
+	int32_t e = x >> VOL_QXY_Y;
+	int64_t f = x & (VOL_ZERO_DB - 1);
+	int64_t p;
+	int shift;
+
+	p = ((VOL_EXP2_C3 * f) >> VOL_QXY_Y) + VOL_EXP2_C2;
+	p = ((p * f) >> VOL_QXY_Y) + VOL_EXP2_C1;
+	p = ((p * f) >> VOL_QXY_Y) + BIT(30);
+
+	/* scale Q2.30 mantissa by 2^e to Q8.16 */
+	shift = 30 - VOL_QXY_Y - e;
+	if (shift >= 31)
+		return 0;
+
+	return shift >= 0 ? p >> shift : p << -shift;
+}
+
+/**
+ * \brief Computes ramp gain at a position.
+ * \param[in] dev Volume base component device.
  * \param[in] chan Channel number.
+ * \param[in] pos Frames from start of ramp.
+ * \return Channel gain at pos.
+ *
+ * SOF_VOLUME_LOG ramps are linear in dB, starting or ending at -96 dB
+ * for a muted channel. SOF_VOLUME_WINDOWS_FADE follows a smoothstep
+ * curve that approximates a raised cosine window.
  */
-static void vol_update(struct comp_data *cd, uint32_t chan)
+static int32_t vol_ramp_gain(struct comp_dev *dev, int chan, uint32_t pos)
 {
-	cd->volume[chan] = cd->tvolume[chan];
-	vol_sync_host(cd, chan);
+	struct comp_data *cd = comp_get_drvdata(dev);
+	struct sof_ipc_comp_volume *pga =
+		COMP_GET_IPC(dev, sof_ipc_comp_volume);
+	int32_t start = cd->rvolume[chan];
+	int32_t end = cd->tvolume[chan];
+	int64_t t;
+	int32_t l0;
+	int32_t l1;
+
+	if (pos >= cd->ramp_len)
+		return end;
+
+	/* ramp position as Q1.16 */
+	t = ((int64_t)pos << VOL_QXY_Y) / cd->ramp_len;
+
+	switch (pga->ramp) {
+	case SOF_VOLUME_LOG:
+		l0 = vol_log2(MAX(start, 1));
+		l1 = vol_log2(MAX(end, 1));
+		return vol_exp2(l0 + (((l1 - l0) * t) >> VOL_QXY_Y));
+	case SOF_VOLUME_WINDOWS_FADE:
+		t = (t * t * (3 * VOL_ZERO_DB - 2 * t)) >> (2 * VOL_QXY_Y);
+		break;
+	default:
+		break;
+	}
+
+	return start + (((int64_t)(end - start) * t) >> VOL_QXY_Y);
 }
 
 /**
- * \brief Ramps volume changes over time.
- * \param[in,out] data Volume base component device.
- * \param[in] delay Update time.
- * \return Time until next work.
+ * \brief Checks if the stream can be copied without scaling.
+ * \param[in,out] dev Volume base component device.
  */
-static enum task_state vol_work(void *data)
+static void volume_update_passthrough(struct comp_dev *dev)
 {
-	struct comp_dev *dev = (struct comp_dev *)data;
 	struct comp_data *cd = comp_get_drvdata(dev);
-	int32_t vol;
-	int again = 0;
 	int i;
 
-	/* inc/dec each volume if it's not at target */
-	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++) {
-		/* skip if target reached */
-		if (cd->volume[i] == cd->tvolume[i])
-			continue;
+	cd->passthrough = cd->source_format == cd->sink_format &&
+		!cd->ramp_active;
 
-		/* Update volume gain with ramp. Linear ramp increment is
-		 * in compatible Q1.16 format with volume.
-		 */
-		vol = cd->volume[i];
-		vol += cd->ramp_increment[i];
-		if (cd->volume[i] < cd->tvolume[i]) {
-			/* ramp up, check if ramp completed */
-			if (vol >= cd->tvolume[i] || vol >= cd->vol_max) {
-				vol_update(cd, i);
-			} else {
-				cd->volume[i] = vol;
-				again = 1;
-			}
-		} else {
-			/* ramp down */
-			if (vol <= 0) {
-				/* cannot ramp down below 0 */
-				vol_update(cd, i);
-			} else {
-				/* ramp completed ? */
-				if (vol <= cd->tvolume[i] ||
-				    vol <= cd->vol_min) {
-					vol_update(cd, i);
-				} else {
-					cd->volume[i] = vol;
-					again = 1;
-				}
-			}
-		}
+	for (i = 0; i < dev->params.channels; i++)
+		if (cd->volume[i] != VOL_ZERO_DB)
+			cd->passthrough = 0;
+}
+
+/**
+ * \brief Ends ramp with all channels at their target volume.
+ * \param[in,out] dev Volume base component device.
+ */
+static void volume_ramp_end(struct comp_dev *dev)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	int i;
 
-		/* sync host with new value */
+	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++) {
+		cd->volume[i] = cd->tvolume[i];
+		cd->ramp_increment[i] = 0;
 		vol_sync_host(cd, i);
 	}
 
-	/* do we need to continue ramping */
-	return again ? SOF_TASK_STATE_RESCHEDULE : SOF_TASK_STATE_COMPLETED;
+	cd->ramp_active = 0;
+	volume_update_passthrough(dev);
+}
+
+/**
+ * \brief Starts ramping all channels to their target volume.
+ * \param[in,out] dev Volume base component device.
+ *
+ * The ramp length (initial_ramp [ms]) describes the time of a full range
+ * ramp, a linear ramp over a smaller range completes sooner. Gain changes
+ * apply at once when the stream is not running.
+ */
+static void volume_ramp_start(struct comp_dev *dev)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	struct sof_ipc_comp_volume *pga =
+		COMP_GET_IPC(dev, sof_ipc_comp_volume);
+	int32_t range = cd->vol_ramp_range ? cd->vol_ramp_range : VOL_ZERO_DB;
+	int32_t delta = 0;
+	uint32_t len;
+	int i;
+
+	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++) {
+		cd->rvolume[i] = cd->volume[i];
+		delta = MAX(delta, ABS(cd->tvolume[i] - cd->volume[i]));
+	}
+
+	len = (uint64_t)dev->params.rate * pga->initial_ramp / 1000;
+	if (pga->ramp == SOF_VOLUME_LINEAR && delta < range)
+		len = (uint64_t)len * delta / range;
+
+	if (dev->state != COMP_STATE_ACTIVE || !len || !delta) {
+		volume_ramp_end(dev);
+		return;
+	}
+
+	cd->ramp_pos = 0;
+	cd->ramp_len = len;
+	cd->ramp_active = 1;
+	cd->passthrough = 0;
+}
+
+/**
+ * \brief Sets per frame gain steps for the next frames of the ramp.
+ * \param[in,out] dev Volume base component device.
+ * \param[in] frames Number of frames to be processed.
+ *
+ * The curve is evaluated once per copy and the processing functions step
+ * the gain linearly between these points a frame or a block at a time.
+ */
+static void volume_ramp_step(struct comp_dev *dev, uint32_t frames)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	uint32_t pos = MIN(cd->ramp_pos + frames, cd->ramp_len);
+	int i;
+
+	for (i = 0; i < dev->params.channels; i++)
+		cd->ramp_increment[i] = (vol_ramp_gain(dev, i, pos) -
+					 cd->volume[i]) / (int32_t)frames;
+}
+
+/**
+ * \brief Moves ramp position after processing.
+ * \param[in,out] dev Volume base component device.
+ * \param[in] frames Number of frames processed.
+ */
+static void volume_ramp_update(struct comp_dev *dev, uint32_t frames)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	int i;
+
+	cd->ramp_pos = MIN(cd->ramp_pos + frames, cd->ramp_len);
+	if (cd->ramp_pos == cd->ramp_len) {
+		volume_ramp_end(dev);
+		return;
+	}
+
+	/* remove rounding error of the per frame steps */
+	for (i = 0; i < dev->params.channels; i++) {
+		cd->volume[i] = vol_ramp_gain(dev, i, cd->ramp_pos);
+		vol_sync_host(cd, i);
+	}
 }
 
 /**
@@ -165,8 +316,6 @@ static struct comp_dev *volume_new(struct sof_ipc_comp *comp)
 	}
 
 	comp_set_drvdata(dev, cd);
-	schedule_task_init(&cd->volwork, SOF_SCHEDULE_LL_TIMER,
-			   SOF_TASK_PRI_MED, vol_work, NULL, dev, 0, 0);
 
 	/* Set the default volumes. If IPC sets min_value or max_value to
 	 * not-zero, use them. Otherwise set to internal limits and notify
@@ -209,6 +358,7 @@ static struct comp_dev *volume_new(struct sof_ipc_comp *comp)
 		cd->volume[i]  =  MAX(MIN(cd->vol_max, VOL_ZERO_DB),
 				      cd->vol_min);
 		cd->tvolume[i] =  cd->volume[i];
+		cd->pvolume[i] = cd->volume[i];
 	}
 
 	trace_volume("vol->initial_ramp = %d, vol->ramp = %d, "
@@ -230,9 +380,6 @@ static void volume_free(struct comp_dev *dev)
 
 	trace_volume("volume_free()");
 
-	/* remove scheduling */
-	schedule_task_free(&cd->volwork);
-
 	rfree(cd);
 	rfree(dev);
 }
@@ -263,10 +410,6 @@ static inline int volume_set_chan(struct comp_dev *dev, int chan, uint32_t vol)
 	struct sof_ipc_comp_volume *pga =
 		COMP_GET_IPC(dev, sof_ipc_comp_volume);
 	int32_t v = vol;
-	int32_t delta;
-	int32_t delta_abs;
-	int32_t inc;
-	int32_t t_us;
 
 	/* Limit received volume gain to MIN..MAX range before applying it.
 	 * MAX is needed for now for the generic C gain arithmetics to prevent
@@ -287,53 +430,12 @@ static inline int volume_set_chan(struct comp_dev *dev, int chan, uint32_t vol)
 		v = VOL_MAX;
 	}
 
-	cd->tvolume[chan] = v;
-
 	/* Check ramp type */
 	switch (pga->ramp) {
 	case SOF_VOLUME_LINEAR:
-
-		/* Assume the ramp length (initial_ramp [ms]) describes
-		 * time of mute to 0 dB ramp. The actual volume scale min/max
-		 * is not known. If initial_ramp is zero (or negative) use
-		 * step size that reaches 0 dB gain in one step (VOL_ZERO_DB).
-		 */
-		if (pga->initial_ramp > 0)
-			inc = MAX(VOL_RAMP_STEP_CONST / pga->initial_ramp, 1);
-		else
-			inc = VOL_ZERO_DB;
-
-		/* Scale the increment with actual volume range if it was
-		 * passed via IPC.
-		 */
-		if (cd->vol_ramp_range)
-			inc = q_multsr_32x32(inc, cd->vol_ramp_range,
-					     Q_SHIFT_BITS_32(VOL_QXY_Y,
-							     VOL_QXY_Y,
-							     VOL_QXY_Y));
-
-		delta = cd->tvolume[chan] - cd->volume[chan];
-		delta_abs = ABS(delta);
-
-		/* If the ramp completion would take longer than initial_ramp
-		 * increase the step size to make this ramp complete at
-		 * initial_ramp time. Calculate estimated ramp length [us].
-		 */
-		t_us = delta_abs * VOL_RAMP_UPDATE_US / inc;
-		if (t_us > pga->initial_ramp * 1000) {
-			inc = (int32_t)((int64_t)inc * delta_abs / VOL_ZERO_DB);
-			inc = MAX(inc, 1);
-		}
-
-		/* Invert sign for volume down ramp step */
-		if (delta < 0)
-			inc = -inc;
-
-		cd->ramp_increment[chan] = inc;
-		tracev_volume("cd->ramp_increment[%d] = %d", chan,
-			      cd->ramp_increment[chan]);
-		break;
 	case SOF_VOLUME_LOG:
+	case SOF_VOLUME_WINDOWS_FADE:
+		break;
 	case SOF_VOLUME_LINEAR_ZC:
 	case SOF_VOLUME_LOG_ZC:
 	default:
@@ -342,6 +444,8 @@ static inline int volume_set_chan(struct comp_dev *dev, int chan, uint32_t vol)
 		return -EINVAL;
 	}
 
+	cd->pvolume[chan] = v;
+
 	return 0;
 }
 
@@ -357,7 +461,7 @@ static inline void volume_set_chan_mute(struct comp_dev *dev, int chan)
 	/* Check if not muted already */
 	if (cd->volume[chan] != 0)
 		cd->mvolume[chan] = cd->volume[chan];
-	cd->tvolume[chan] = 0;
+	cd->pvolume[chan] = 0;
 }
 
 /**
@@ -371,7 +475,59 @@ static inline void volume_set_chan_unmute(struct comp_dev *dev, int chan)
 
 	/* Check if muted */
 	if (cd->volume[chan] == 0)
-		cd->tvolume[chan] = cd->mvolume[chan];
+		cd->pvolume[chan] = cd->mvolume[chan];
+}
+
+/**
+ * \brief Applies pending target volumes and starts ramping to them.
+ * \param[in,out] dev Volume base component device.
+ */
+static void volume_ramp_apply(struct comp_dev *dev)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	int i;
+
+	cd->ramp_pending = 0;
+	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++)
+		cd->tvolume[i] = cd->pvolume[i];
+
+	volume_ramp_start(dev);
+}
+
+/**
+ * \brief Hands pending target volumes over to the processing context.
+ * \param[in,out] dev Volume base component device.
+ *
+ * The ramp state is owned by volume_copy() while the stream is running,
+ * so new targets are only flagged here and picked up by the next copy.
+ */
+static void volume_ramp_request(struct comp_dev *dev)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	uint32_t flags;
+
+	if (dev->state != COMP_STATE_ACTIVE) {
+		volume_ramp_apply(dev);
+		return;
+	}
+
+	irq_local_disable(flags);
+	cd->ramp_pending = 1;
+	irq_local_enable(flags);
+}
+
+/**
+ * \brief Holds off copy from pending target volumes.
+ * \param[in,out] dev Volume base component device.
+ */
+static void volume_ramp_hold(struct comp_dev *dev)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	uint32_t flags;
+
+	irq_local_disable(flags);
+	cd->ramp_pending = 0;
+	irq_local_enable(flags);
 }
 
 /**
@@ -383,7 +539,6 @@ static inline void volume_set_chan_unmute(struct comp_dev *dev, int chan)
 static int volume_ctrl_set_cmd(struct comp_dev *dev,
 			       struct sof_ipc_ctrl_data *cdata)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
 	int i;
 	int j;
 	int ret = 0;
@@ -399,6 +554,7 @@ static int volume_ctrl_set_cmd(struct comp_dev *dev,
 	case SOF_CTRL_CMD_VOLUME:
 		trace_volume("volume_ctrl_set_cmd(), SOF_CTRL_CMD_VOLUME, "
 			     "cdata->comp_id = %u", cdata->comp_id);
+		volume_ramp_hold(dev);
 		for (j = 0; j < cdata->num_elems; j++) {
 			trace_volume("volume_ctrl_set_cmd(), "
 				     "SOF_CTRL_CMD_VOLUME, "
@@ -416,16 +572,16 @@ static int volume_ctrl_set_cmd(struct comp_dev *dev,
 						   "invalid i = %u", i);
 			}
 			if (ret)
-				return ret;
+				break;
 		}
 
-		schedule_task(&cd->volwork, VOL_RAMP_UPDATE_US,
-			      VOL_RAMP_UPDATE_US);
+		volume_ramp_request(dev);
 		break;
 
 	case SOF_CTRL_CMD_SWITCH:
 		trace_volume("volume_ctrl_set_cmd(), SOF_CTRL_CMD_SWITCH, "
 			     "cdata->comp_id = %u", cdata->comp_id);
+		volume_ramp_hold(dev);
 		for (j = 0; j < cdata->num_elems; j++) {
 			trace_volume("volume_ctrl_set_cmd(), "
 				     "SOF_CTRL_CMD_SWITCH, "
@@ -446,8 +602,7 @@ static int volume_ctrl_set_cmd(struct comp_dev *dev,
 			}
 		}
 
-		schedule_task(&cd->volwork, VOL_RAMP_UPDATE_US,
-			      VOL_RAMP_UPDATE_US);
+		volume_ramp_request(dev);
 		break;
 
 	default:
@@ -456,7 +611,7 @@ static int volume_ctrl_set_cmd(struct comp_dev *dev,
 		return -EINVAL;
 	}
 
-	return 0;
+	return ret;
 }
 
 /**
@@ -486,7 +641,7 @@ static int volume_ctrl_get_cmd(struct comp_dev *dev,
 			    cdata->comp_id);
 		for (j = 0; j < cdata->num_elems; j++) {
 			cdata->chanv[j].channel = j;
-			cdata->chanv[j].value = cd->tvolume[j];
+			cdata->chanv[j].value = cd->pvolume[j];
 			trace_volume("volume_ctrl_get_cmd(), "
 				     "channel = %u, value = %u",
 				     cdata->chanv[j].channel,
@@ -562,8 +717,20 @@ static int volume_copy(struct comp_dev *dev)
 	tracev_volume("volume_copy(), source_bytes = 0x%x, sink_bytes = 0x%x",
 		      c.source_bytes, c.sink_bytes);
 
-	/* copy and scale volume */
-	cd->scale_vol(dev, c.sink, c.source, c.frames);
+	/* start ramping to target volumes set by the host since last copy */
+	if (cd->ramp_pending)
+		volume_ramp_apply(dev);
+
+	/* copy and scale volume, ramping the gain a frame at a time */
+	if (cd->ramp_active && c.frames) {
+		volume_ramp_step(dev, c.frames);
+		cd->scale_vol(dev, c.sink, c.source, c.frames);
+		volume_ramp_update(dev, c.frames);
+	} else if (cd->passthrough) {
+		buffer_copy_bytes(c.source, c.sink, c.source_bytes);
+	} else {
+		cd->scale_vol(dev, c.sink, c.source, c.frames);
+	}
 
 	/* calculate new free and available */
 	comp_update_buffer_produce(c.sink, c.sink_bytes);
@@ -659,6 +826,8 @@ static int volume_prepare(struct comp_dev *dev)
 	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++)
 		vol_sync_host(cd, i);
 
+	volume_update_passthrough(dev);
+
 	return 0;
 
 err:
@@ -22,6 +22,7 @@
 #include <sof/audio/component.h>
 #include <sof/audio/format.h>
 #include <sof/common.h>
+#include <sof/math/numbers.h>
 #include <ipc/stream.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -34,7 +35,7 @@
  *
  * Volume multiply for 24 bit input and 16 bit bit output.
  */
-static inline int16_t vol_mult_s24_to_s16(int32_t x, int32_t vol)
+static inline int32_t vol_mult_s24_to_s16(int32_t x, int32_t vol)
 {
 	return (int16_t)q_multsr_sat_32x32_16(sign_extend_s24(x), vol,
 					      Q_SHIFT_BITS_64(23, 16, 15));
@@ -48,7 +49,7 @@ static inline int16_t vol_mult_s24_to_s16(int32_t x, int32_t vol)
  *
  * Volume multiply for 32 bit input and 16 bit bit output.
  */
-static inline int16_t vol_mult_s32_to_s16(int32_t x, int32_t vol)
+static inline int32_t vol_mult_s32_to_s16(int32_t x, int32_t vol)
 {
 	return (int16_t)q_multsr_sat_32x32_16(x, vol,
 					      Q_SHIFT_BITS_64(31, 16, 15));
@@ -62,7 +63,7 @@ static inline int16_t vol_mult_s32_to_s16(int32_t x, int32_t vol)
  *
  * Volume multiply for 16 bit input and 24 bit bit output.
  */
-static inline int32_t vol_mult_s16_to_s24(int16_t x, int32_t vol)
+static inline int32_t vol_mult_s16_to_s24(int32_t x, int32_t vol)
 {
 	return q_multsr_sat_32x32_24(x, vol, Q_SHIFT_BITS_64(15, 16, 23));
 }
@@ -94,6 +95,202 @@ static inline int32_t vol_mult_s32_to_s24(int32_t x, int32_t vol)
 	return q_multsr_sat_32x32_24(x, vol, Q_SHIFT_BITS_64(31, 16, 23));
 }
 
+/**
+ * \brief Volume s16 to s16 multiply function
+ * \param[in] x   input sample.
+ * \param[in] vol gain.
+ * \return output sample.
+ *
+ * Volume multiply for 16 bit input and 16 bit bit output.
+ */
+static inline int32_t vol_mult_s16_to_s16(int32_t x, int32_t vol)
+{
+	return (int16_t)q_multsr_sat_32x32_16(x, vol,
+					      Q_SHIFT_BITS_32(15, 16, 15));
+}
+
+/**
+ * \brief Volume s16 to s32 multiply function
+ * \param[in] x   input sample.
+ * \param[in] vol gain.
+ * \return output sample.
+ *
+ * Volume multiply for 16 bit input and 32 bit bit output.
+ */
+static inline int32_t vol_mult_s16_to_s32(int32_t x, int32_t vol)
+{
+	return q_multsr_sat_32x32(x << 8, vol, Q_SHIFT_BITS_64(23, 16, 31));
+}
+
+/**
+ * \brief Volume s24 to s32 multiply function
+ * \param[in] x   input sample.
+ * \param[in] vol gain.
+ * \return output sample.
+ *
+ * Volume multiply for 24 bit input and 32 bit bit output.
+ */
+static inline int32_t vol_mult_s24_to_s32(int32_t x, int32_t vol)
+{
+	return q_multsr_sat_32x32(sign_extend_s24(x), vol,
+				  Q_SHIFT_BITS_64(23, 16, 31));
+}
+
+/**
+ * \brief Volume s32 to s32 multiply function
+ * \param[in] x   input sample.
+ * \param[in] vol gain.
+ * \return output sample.
+ *
+ * Volume multiply for 32 bit input and 32 bit bit output.
+ */
+static inline int32_t vol_mult_s32_to_s32(int32_t x, int32_t vol)
+{
+	return q_multsr_sat_32x32(x, vol, Q_SHIFT_BITS_64(31, 16, 31));
+}
+
+/**
+ * \brief Loads one sample of given size.
+ * \param[in] ptr Sample array.
+ * \param[in] i Sample index.
+ * \param[in] bytes Sample size.
+ * \return Sample value.
+ */
+static inline int32_t vol_load(const void *ptr, uint32_t i, uint32_t bytes)
+{
+	if (bytes == sizeof(int16_t))
+		return ((const int16_t *)ptr)[i];
+
+	return ((const int32_t *)ptr)[i];
+}
+
+/**
+ * \brief Stores one sample of given size.
+ * \param[out] ptr Sample array.
+ * \param[in] i Sample index.
+ * \param[in] bytes Sample size.
+ * \param[in] y Sample value.
+ */
+static inline void vol_store(void *ptr, uint32_t i, uint32_t bytes,
+			     int32_t y)
+{
+	if (bytes == sizeof(int16_t))
+		((int16_t *)ptr)[i] = y;
+	else
+		((int32_t *)ptr)[i] = y;
+}
+
+/**
+ * \brief Scales one frame that wraps in source or sink buffer.
+ * \param[in,out] cd Volume component private data.
+ * \param[in,out] sink Destination buffer.
+ * \param[in] dest Frame write position in sink buffer.
+ * \param[in] sink_bytes Sink sample size.
+ * \param[in] source Source buffer.
+ * \param[in] src Frame read position in source buffer.
+ * \param[in] source_bytes Source sample size.
+ * \param[in] nch Number of channels.
+ * \param[in] mult Sample multiply function.
+ *
+ * Happens only when buffer size is not a multiple of the frame size, so
+ * it's done a sample at a time with wrap check on every access.
+ */
+static void vol_frame_wrap(struct comp_data *cd, struct comp_buffer *sink,
+			   void *dest, uint32_t sink_bytes,
+			   struct comp_buffer *source, void *src,
+			   uint32_t source_bytes, uint32_t nch,
+			   int32_t (*mult)(int32_t x, int32_t vol))
+{
+	uint32_t channel;
+	int32_t y;
+	void *s;
+	void *d;
+
+	for (channel = 0; channel < nch; channel++) {
+		s = buffer_wrap(source, src + channel * source_bytes);
+		d = buffer_wrap(sink, dest + channel * sink_bytes);
+
+		y = mult(vol_load(s, 0, source_bytes), cd->volume[channel]);
+		vol_store(d, 0, sink_bytes, y);
+
+		cd->volume[channel] += cd->ramp_increment[channel];
+	}
+}
+
+/**
+ * \brief Scales frames between source and sink buffers.
+ * \param[in,out] dev Volume base component device.
+ * \param[in,out] sink Destination buffer.
+ * \param[in] sink_bytes Sink sample size.
+ * \param[in,out] source Source buffer.
+ * \param[in] source_bytes Source sample size.
+ * \param[in] frames Number of frames to process.
+ * \param[in] mult Sample multiply function.
+ *
+ * Processes the longest contiguous span of both buffers at a time. Inlined
+ * into every format function, so sample sizes and multiply are constants.
+ */
+static inline void vol_span(struct comp_dev *dev, struct comp_buffer *sink,
+			    uint32_t sink_bytes, struct comp_buffer *source,
+			    uint32_t source_bytes, uint32_t frames,
+			    int32_t (*mult)(int32_t x, int32_t vol))
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	void *src = source->r_ptr;
+	void *dest = sink->w_ptr;
+	uint32_t nch = dev->params.channels;
+	uint32_t samples;
+	uint32_t channel;
+	uint32_t n;
+	uint32_t i;
+	int32_t vol;
+	int32_t inc;
+	int32_t x;
+
+	while (frames) {
+		n = MIN(buffer_bytes_without_wrap(source, src) / source_bytes,
+			buffer_bytes_without_wrap(sink, dest) / sink_bytes);
+		n = MIN(n / nch, frames);
+
+		/* frame wraps in the middle */
+		if (!n) {
+			vol_frame_wrap(cd, sink, dest, sink_bytes,
+				       source, src, source_bytes, nch, mult);
+			frames--;
+			src = buffer_wrap(source, src + nch * source_bytes);
+			dest = buffer_wrap(sink, dest + nch * sink_bytes);
+			continue;
+		}
+
+		samples = n * nch;
+
+		for (channel = 0; channel < nch; channel++) {
+			vol = cd->volume[channel];
+			inc = cd->ramp_increment[channel];
+			if (!inc) {
+				for (i = channel; i < samples; i += nch) {
+					x = vol_load(src, i, source_bytes);
+					vol_store(dest, i, sink_bytes,
+						  mult(x, vol));
+				}
+				continue;
+			}
+
+			/* ramp gain a frame at a time */
+			for (i = channel; i < samples; i += nch) {
+				x = vol_load(src, i, source_bytes);
+				vol_store(dest, i, sink_bytes, mult(x, vol));
+				vol += inc;
+			}
+			cd->volume[channel] = vol;
+		}
+
+		frames -= n;
+		src = buffer_wrap(source, src + samples * source_bytes);
+		dest = buffer_wrap(sink, dest + samples * sink_bytes);
+	}
+}
+
 /**
  * \brief Volume processing from 16 bit to 32 bit.
  * \param[in,out] dev Volume base component device.
@@ -107,25 +304,9 @@ static inline int32_t vol_mult_s32_to_s24(int32_t x, int32_t vol)
 static void vol_s16_to_s32(struct comp_dev *dev, struct comp_buffer *sink,
 			   struct comp_buffer *source, uint32_t frames)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
-	int16_t *src;
-	int32_t *dest;
-	int32_t i;
-	uint32_t channel;
-	uint32_t buff_frag = 0;
-
 	/* Samples are Q1.15 --> Q1.31 and volume is Q8.16 */
-	for (i = 0; i < frames; i++) {
-		for (channel = 0; channel < dev->params.channels; channel++) {
-			src = buffer_read_frag_s16(source, buff_frag);
-			dest = buffer_write_frag_s32(sink, buff_frag);
-			*dest = q_multsr_sat_32x32
-				(*src << 8, cd->volume[channel],
-				 Q_SHIFT_BITS_64(23, 16, 31));
-
-			buff_frag++;
-		}
-	}
+	vol_span(dev, sink, sizeof(int32_t), source, sizeof(int16_t), frames,
+		 vol_mult_s16_to_s32);
 }
 
 /**
@@ -141,24 +322,9 @@ static void vol_s16_to_s32(struct comp_dev *dev, struct comp_buffer *sink,
 static void vol_s32_to_s16(struct comp_dev *dev, struct comp_buffer *sink,
 			   struct comp_buffer *source, uint32_t frames)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
-	int32_t *src;
-	int16_t *dest;
-	int32_t i;
-	uint32_t channel;
-	uint32_t buff_frag = 0;
-
 	/* Samples are Q1.31 --> Q1.15 and volume is Q8.16 */
-	for (i = 0; i < frames; i++) {
-		for (channel = 0; channel < dev->params.channels; channel++) {
-			src = buffer_read_frag_s32(source, buff_frag);
-			dest = buffer_write_frag_s16(sink, buff_frag);
-
-			*dest = vol_mult_s32_to_s16(*src, cd->volume[channel]);
-
-			buff_frag++;
-		}
-	}
+	vol_span(dev, sink, sizeof(int16_t), source, sizeof(int32_t), frames,
+		 vol_mult_s32_to_s16);
 }
 
 /**
@@ -174,26 +340,9 @@ static void vol_s32_to_s16(struct comp_dev *dev, struct comp_buffer *sink,
 static void vol_s32_to_s32(struct comp_dev *dev, struct comp_buffer *sink,
 			   struct comp_buffer *source, uint32_t frames)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
-	int32_t *src;
-	int32_t *dest;
-	int32_t i;
-	uint32_t channel;
-	uint32_t buff_frag = 0;
-
 	/* Samples are Q1.31 --> Q1.31 and volume is Q8.16 */
-	for (i = 0; i < frames; i++) {
-		for (channel = 0; channel < dev->params.channels; channel++) {
-			src = buffer_read_frag_s32(source, buff_frag);
-			dest = buffer_write_frag_s32(sink, buff_frag);
-
-			*dest = q_multsr_sat_32x32
-				(*src, cd->volume[channel],
-				 Q_SHIFT_BITS_64(31, 16, 31));
-
-			buff_frag++;
-		}
-	}
+	vol_span(dev, sink, sizeof(int32_t), source, sizeof(int32_t), frames,
+		 vol_mult_s32_to_s32);
 }
 
 /**
@@ -209,26 +358,9 @@ static void vol_s32_to_s32(struct comp_dev *dev, struct comp_buffer *sink,
 static void vol_s16_to_s16(struct comp_dev *dev, struct comp_buffer *sink,
 			   struct comp_buffer *source, uint32_t frames)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
-	int16_t *src;
-	int16_t *dest;
-	int32_t i;
-	uint32_t channel;
-	uint32_t buff_frag = 0;
-
 	/* Samples are Q1.15 --> Q1.15 and volume is Q8.16 */
-	for (i = 0; i < frames; i++) {
-		for (channel = 0; channel < dev->params.channels; channel++) {
-			src = buffer_read_frag_s16(source, buff_frag);
-			dest = buffer_write_frag_s16(sink, buff_frag);
-
-			*dest = q_multsr_sat_32x32_16
-				(*src, cd->volume[channel],
-				 Q_SHIFT_BITS_32(15, 16, 15));
-
-			buff_frag++;
-		}
-	}
+	vol_span(dev, sink, sizeof(int16_t), source, sizeof(int16_t), frames,
+		 vol_mult_s16_to_s16);
 }
 
 /**
@@ -244,24 +376,9 @@ static void vol_s16_to_s16(struct comp_dev *dev, struct comp_buffer *sink,
 static void vol_s16_to_s24(struct comp_dev *dev, struct comp_buffer *sink,
 			   struct comp_buffer *source, uint32_t frames)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
-	int16_t *src;
-	int32_t *dest;
-	int32_t i;
-	uint32_t channel;
-	uint32_t buff_frag = 0;
-
 	/* Samples are Q1.15 and volume is Q8.16 */
-	for (i = 0; i < frames; i++) {
-		for (channel = 0; channel < dev->params.channels; channel++) {
-			src = buffer_read_frag_s16(source, buff_frag);
-			dest = buffer_write_frag_s32(sink, buff_frag);
-
-			*dest = vol_mult_s16_to_s24(*src, cd->volume[channel]);
-
-			buff_frag++;
-		}
-	}
+	vol_span(dev, sink, sizeof(int32_t), source, sizeof(int16_t), frames,
+		 vol_mult_s16_to_s24);
 }
 
 /**
@@ -277,24 +394,9 @@ static void vol_s16_to_s24(struct comp_dev *dev, struct comp_buffer *sink,
 static void vol_s24_to_s16(struct comp_dev *dev, struct comp_buffer *sink,
 			   struct comp_buffer *source, uint32_t frames)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
-	int32_t *src;
-	int16_t *dest;
-	int32_t i;
-	uint32_t channel;
-	uint32_t buff_frag = 0;
-
 	/* Samples are Q1.23 --> Q1.15 and volume is Q8.16 */
-	for (i = 0; i < frames; i++) {
-		for (channel = 0; channel < dev->params.channels; channel++) {
-			src = buffer_read_frag_s32(source, buff_frag);
-			dest = buffer_write_frag_s16(sink, buff_frag);
-
-			*dest = vol_mult_s24_to_s16(*src, cd->volume[channel]);
-
-			buff_frag++;
-		}
-	}
+	vol_span(dev, sink, sizeof(int16_t), source, sizeof(int32_t), frames,
+		 vol_mult_s24_to_s16);
 }
 
 /**
@@ -310,24 +412,9 @@ static void vol_s24_to_s16(struct comp_dev *dev, struct comp_buffer *sink,
 static void vol_s32_to_s24(struct comp_dev *dev, struct comp_buffer *sink,
 			   struct comp_buffer *source, uint32_t frames)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
-	int32_t *src;
-	int32_t *dest;
-	int32_t i;
-	uint32_t channel;
-	uint32_t buff_frag = 0;
-
 	/* Samples are Q1.31 --> Q1.23 and volume is Q8.16 */
-	for (i = 0; i < frames; i++) {
-		for (channel = 0; channel < dev->params.channels; channel++) {
-			src = buffer_read_frag_s32(source, buff_frag);
-			dest = buffer_write_frag_s32(sink, buff_frag);
-
-			*dest = vol_mult_s32_to_s24(*src, cd->volume[channel]);
-
-			buff_frag++;
-		}
-	}
+	vol_span(dev, sink, sizeof(int32_t), source, sizeof(int32_t), frames,
+		 vol_mult_s32_to_s24);
 }
 
 /**
@@ -343,26 +430,9 @@ static void vol_s32_to_s24(struct comp_dev *dev, struct comp_buffer *sink,
 static void vol_s24_to_s32(struct comp_dev *dev, struct comp_buffer *sink,
 			   struct comp_buffer *source, uint32_t frames)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
-	int32_t *src;
-	int32_t *dest;
-	int32_t i;
-	uint32_t channel;
-	uint32_t buff_frag = 0;
-
 	/* Samples are Q1.23 --> Q1.31 and volume is Q8.16 */
-	for (i = 0; i < frames; i++) {
-		for (channel = 0; channel < dev->params.channels; channel++) {
-			src = buffer_read_frag_s32(source, buff_frag);
-			dest = buffer_write_frag_s32(sink, buff_frag);
-
-			*dest = q_multsr_sat_32x32
-				(sign_extend_s24(*src), cd->volume[channel],
-				 Q_SHIFT_BITS_64(23, 16, 31));
-
-			buff_frag++;
-		}
-	}
+	vol_span(dev, sink, sizeof(int32_t), source, sizeof(int32_t), frames,
+		 vol_mult_s24_to_s32);
 }
 
 /**
@@ -378,24 +448,9 @@ static void vol_s24_to_s32(struct comp_dev *dev, struct comp_buffer *sink,
 static void vol_s24_to_s24(struct comp_dev *dev, struct comp_buffer *sink,
 			   struct comp_buffer *source, uint32_t frames)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
-	int32_t *src;
-	int32_t *dest;
-	int32_t i;
-	uint32_t channel;
-	uint32_t buff_frag = 0;
-
 	/* Samples are Q1.23 --> Q1.23 and volume is Q8.16 */
-	for (i = 0; i < frames; i++) {
-		for (channel = 0; channel < dev->params.channels; channel++) {
-			src = buffer_read_frag_s32(source, buff_frag);
-			dest = buffer_write_frag_s32(sink, buff_frag);
-
-			*dest = vol_mult_s24_to_s24(*src, cd->volume[channel]);
-
-			buff_frag++;
-		}
-	}
+	vol_span(dev, sink, sizeof(int32_t), source, sizeof(int32_t), frames,
+		 vol_mult_s24_to_s24);
 }
 
 const struct comp_func_map func_map[] = {
@@ -49,38 +49,51 @@ static void vol_s16_to_s16(struct comp_dev *dev, struct comp_buffer *sink,
 	ae_f16x4 in_sample = AE_ZERO16();
 	size_t channel;
 	int i;
+	uint32_t n;
+	uint32_t f;
 	ae_int16 *in = (ae_int16 *)source->r_ptr;
 	ae_int16 *out = (ae_int16 *)sink->w_ptr;
 
-	/* Main processing loop */
-	for (i = 0; i < frames; i++) {
-		/* Processing per channel */
-		for (channel = 0; channel < dev->params.channels; channel++) {
-			/* Set source as circular buffer */
-			vol_setup_circular(source);
-
-			/* Load the input sample */
-			AE_L16_XC(in_sample, in, sizeof(ae_int16));
-
-			/* Load volume */
-			volume = (ae_f32x2)cd->volume[channel];
-
-			/* Multiply the input sample */
-			mult = AE_MULF32X16_L0(volume, in_sample);
-
-			/* Multiply of Q1.31 x Q1.15 gives Q1.47. Multiply of
-			 * Q8.16 x Q1.15 gives Q8.32, so need to shift left
-			 * by 31 to get Q1.63. Sample is Q1.31.
-			 */
-			out_sample = AE_ROUND32F64SSYM(AE_SLAI64S(mult, 31));
-
-			/* Set sink as circular buffer */
-			vol_setup_circular(sink);
-
-			/* Round to Q1.15 and store the output sample */
-			AE_S16_0_XC(AE_ROUND16X4F32SSYM(out_sample, out_sample),
-				    out, sizeof(ae_int16));
+	/* Main processing loop, ramping gains are stepped per block */
+	for (i = 0; i < frames; i += n) {
+		n = vol_ramp_block_frames(cd, frames - i);
+		for (f = 0; f < n; f++) {
+			/* Processing per channel */
+			for (channel = 0; channel < dev->params.channels;
+			     channel++) {
+				/* Set source as circular buffer */
+				vol_setup_circular(source);
+
+				/* Load the input sample */
+				AE_L16_XC(in_sample, in, sizeof(ae_int16));
+
+				/* Load volume */
+				volume = (ae_f32x2)cd->volume[channel];
+
+				/* Multiply the input sample */
+				mult = AE_MULF32X16_L0(volume, in_sample);
+
+				/* Multiply of Q1.31 x Q1.15 gives Q1.47.
+				 * Multiply of Q8.16 x Q1.15 gives Q8.32, so
+				 * need to shift left by 31 to get Q1.63.
+				 * Sample is Q1.31.
+				 */
+				out_sample =
+					AE_ROUND32F64SSYM(AE_SLAI64S(mult, 31));
+
+				/* Set sink as circular buffer */
+				vol_setup_circular(sink);
+
+				/* Round to Q1.15 and store the output sample */
+				AE_S16_0_XC(AE_ROUND16X4F32SSYM(out_sample,
+								out_sample),
+					    out, sizeof(ae_int16));
+			}
 		}
+
+		/* step ramping gains for next block */
+		if (cd->ramp_active)
+			vol_ramp_block(cd, dev->params.channels, n);
 	}
 }
 
@@ -101,6 +114,8 @@ static void vol_s16_to_sX(struct comp_dev *dev, struct comp_buffer *sink,
 	ae_f16x4 in_sample = AE_ZERO16();
 	size_t channel;
 	int i;
+	uint32_t n;
+	uint32_t f;
 	int shift = 0;
 	ae_int16 *in = (ae_int16 *)source->r_ptr;
 	ae_int32 *out = (ae_int32 *)sink->w_ptr;
@@ -109,39 +124,48 @@ static void vol_s16_to_sX(struct comp_dev *dev, struct comp_buffer *sink,
 	if (cd->sink_format == SOF_IPC_FRAME_S24_4LE)
 		shift = 8;
 
-	/* Main processing loop */
-	for (i = 0; i < frames; i++) {
-		/* Processing per channel */
-		for (channel = 0; channel < dev->params.channels; channel++) {
-			/* Set source as circular buffer */
-			vol_setup_circular(source);
-
-			/* Load the input sample */
-			AE_L16_XC(in_sample, in, sizeof(ae_int16));
-
-			/* Load volume */
-			volume = (ae_f32x2)cd->volume[channel];
-
-			/* Multiply the input sample */
-			mult = AE_MULF32X16_L0(volume, in_sample);
-
-			/* Multiply of Q31 x Q15 gives Q47. Multiply of
-			 * Q16 x Q15 gives Q32, so need to shift left by 15
-			 * to get Q47. Out_sample is Q31.
-			 */
-			out_sample = AE_ROUND32F48SSYM(AE_SLAI64S(mult, 15));
-
-			/* Shift for S24_LE */
-			out_sample = AE_SRAA32RS(out_sample, shift);
-			out_sample = AE_SLAA32S(out_sample, shift);
-			out_sample = AE_SRAA32(out_sample, shift);
-
-			/* Set sink as circular buffer */
-			vol_setup_circular(sink);
-
-			/* Store the output sample */
-			AE_S32_L_XC(out_sample, out, sizeof(ae_int32));
+	/* Main processing loop, ramping gains are stepped per block */
+	for (i = 0; i < frames; i += n) {
+		n = vol_ramp_block_frames(cd, frames - i);
+		for (f = 0; f < n; f++) {
+			/* Processing per channel */
+			for (channel = 0; channel < dev->params.channels;
+			     channel++) {
+				/* Set source as circular buffer */
+				vol_setup_circular(source);
+
+				/* Load the input sample */
+				AE_L16_XC(in_sample, in, sizeof(ae_int16));
+
+				/* Load volume */
+				volume = (ae_f32x2)cd->volume[channel];
+
+				/* Multiply the input sample */
+				mult = AE_MULF32X16_L0(volume, in_sample);
+
+				/* Multiply of Q31 x Q15 gives Q47. Multiply of
+				 * Q16 x Q15 gives Q32, so need to shift left by
+				 * 15 to get Q47. Out_sample is Q31.
+				 */
+				out_sample =
+					AE_ROUND32F48SSYM(AE_SLAI64S(mult, 15));
+
+				/* Shift for S24_LE */
+				out_sample = AE_SRAA32RS(out_sample, shift);
+				out_sample = AE_SLAA32S(out_sample, shift);
+				out_sample = AE_SRAA32(out_sample, shift);
+
+				/* Set sink as circular buffer */
+				vol_setup_circular(sink);
+
+				/* Store the output sample */
+				AE_S32_L_XC(out_sample, out, sizeof(ae_int32));
+			}
 		}
+
+		/* step ramping gains for next block */
+		if (cd->ramp_active)
+			vol_ramp_block(cd, dev->params.channels, n);
 	}
 }
 
@@ -162,6 +186,8 @@ static void vol_sX_to_s16(struct comp_dev *dev, struct comp_buffer *sink,
 	ae_f32x2 out_sample;
 	size_t channel;
 	int i;
+	uint32_t n;
+	uint32_t f;
 	int shift_left = 0;
 	ae_int32 *in = (ae_int32 *)source->r_ptr;
 	ae_int16 *out = (ae_int16 *)sink->w_ptr;
@@ -170,39 +196,50 @@ static void vol_sX_to_s16(struct comp_dev *dev, struct comp_buffer *sink,
 	if (cd->source_format == SOF_IPC_FRAME_S24_4LE)
 		shift_left = 8;
 
-	/* Main processing loop */
-	for (i = 0; i < frames; i++) {
-		/* Processing per channel */
-		for (channel = 0; channel < dev->params.channels; channel++) {
-			/* Set source as circular buffer */
-			vol_setup_circular(source);
-
-			/* Load the input sample */
-			AE_L32_XC(in_sample, in, sizeof(ae_int32));
-
-			/* Shift left to get the right alignment */
-			in_sample = AE_SLAA32(in_sample, shift_left);
-
-			/* Load volume */
-			volume = (ae_f32x2)cd->volume[channel];
-
-			/* Multiply the input sample */
-			mult = AE_MULF32S_LL(volume, in_sample);
-
-			/* Multiplication of Q1.31 x Q1.31 gives Q1.63.
-			 * Now multiplication is Q8.16 x Q1.31, the result
-			 * is Q9.48. Need to shift left by 15 to get Q1.63
-			 * compatible format for round. Sample is Q1.31.
-			 */
-			out_sample = AE_ROUND32F64SSYM(AE_SLAI64S(mult, 15));
-
-			/* Set sink as circular buffer */
-			vol_setup_circular(sink);
-
-			/* Round to Q1.15 and store the output sample */
-			AE_S16_0_XC(AE_ROUND16X4F32SSYM(out_sample, out_sample),
-				    out, sizeof(ae_int16));
+	/* Main processing loop, ramping gains are stepped per block */
+	for (i = 0; i < frames; i += n) {
+		n = vol_ramp_block_frames(cd, frames - i);
+		for (f = 0; f < n; f++) {
+			/* Processing per channel */
+			for (channel = 0; channel < dev->params.channels;
+			     channel++) {
+				/* Set source as circular buffer */
+				vol_setup_circular(source);
+
+				/* Load the input sample */
+				AE_L32_XC(in_sample, in, sizeof(ae_int32));
+
+				/* Shift left to get the right alignment */
+				in_sample = AE_SLAA32(in_sample, shift_left);
+
+				/* Load volume */
+				volume = (ae_f32x2)cd->volume[channel];
+
+				/* Multiply the input sample */
+				mult = AE_MULF32S_LL(volume, in_sample);
+
+				/* Multiplication of Q1.31 x Q1.31 gives Q1.63.
+				 * Now multiplication is Q8.16 x Q1.31, the
+				 * result is Q9.48. Need to shift left by 15 to
+				 * get Q1.63 compatible format for round. Sample
+				 * is Q1.31.
+				 */
+				out_sample =
+					AE_ROUND32F64SSYM(AE_SLAI64S(mult, 15));
+
+				/* Set sink as circular buffer */
+				vol_setup_circular(sink);
+
+				/* Round to Q1.15 and store the output sample */
+				AE_S16_0_XC(AE_ROUND16X4F32SSYM(out_sample,
+								out_sample),
+					    out, sizeof(ae_int16));
+			}
 		}
+
+		/* step ramping gains for next block */
+		if (cd->ramp_active)
+			vol_ramp_block(cd, dev->params.channels, n);
 	}
 }
 
@@ -223,6 +260,8 @@ static void vol_s24_to_s24_s32(struct comp_dev *dev, struct comp_buffer *sink,
 	ae_f32x2 volume;
 	size_t channel;
 	int i;
+	uint32_t n;
+	uint32_t f;
 	int shift = 0;
 	ae_int32 *in = (ae_int32 *)source->r_ptr;
 	ae_int32 *out = (ae_int32 *)sink->w_ptr;
@@ -231,40 +270,50 @@ static void vol_s24_to_s24_s32(struct comp_dev *dev, struct comp_buffer *sink,
 	if (cd->sink_format == SOF_IPC_FRAME_S24_4LE)
 		shift = 8;
 
-	/* Main processing loop */
-	for (i = 0; i < frames; i++) {
-		/* Processing per channel */
-		for (channel = 0; channel < dev->params.channels; channel++) {
-			/* Set source as circular buffer */
-			vol_setup_circular(source);
-
-			/* Load the input sample */
-			AE_L32_XC(in_sample, in, sizeof(ae_int32));
-
-			/* Load volume */
-			volume = (ae_f32x2)cd->volume[channel];
-
-			/* Multiply the input sample */
-			mult = AE_MULF32S_LL(volume, AE_SLAA32(in_sample, 8));
-
-			/* Multiplication of Q1.31 x Q1.31 gives Q1.63.
-			 * Now multiplication is Q8.16 x Q1.31, the result
-			 * is Q9.48. Need to shift right by one to get Q17.47
-			 * compatible format for round.
-			 */
-			out_sample = AE_ROUND32F48SSYM(AE_SRAI64(mult, 1));
-
-			/* Shift for S24_LE */
-			out_sample = AE_SRAA32RS(out_sample, shift);
-			out_sample = AE_SLAA32S(out_sample, shift);
-			out_sample = AE_SRAA32(out_sample, shift);
-
-			/* Set sink as circular buffer */
-			vol_setup_circular(sink);
-
-			/* Store the output sample */
-			AE_S32_L_XC(out_sample, out, sizeof(ae_int32));
+	/* Main processing loop, ramping gains are stepped per block */
+	for (i = 0; i < frames; i += n) {
+		n = vol_ramp_block_frames(cd, frames - i);
+		for (f = 0; f < n; f++) {
+			/* Processing per channel */
+			for (channel = 0; channel < dev->params.channels;
+			     channel++) {
+				/* Set source as circular buffer */
+				vol_setup_circular(source);
+
+				/* Load the input sample */
+				AE_L32_XC(in_sample, in, sizeof(ae_int32));
+
+				/* Load volume */
+				volume = (ae_f32x2)cd->volume[channel];
+
+				/* Multiply the input sample */
+				mult = AE_MULF32S_LL(volume,
+						     AE_SLAA32(in_sample, 8));
+
+				/* Multiplication of Q1.31 x Q1.31 gives Q1.63.
+				 * Now multiplication is Q8.16 x Q1.31, the
+				 * result is Q9.48. Need to shift right by one
+				 * to get Q17.47 compatible format for round.
+				 */
+				out_sample =
+					AE_ROUND32F48SSYM(AE_SRAI64(mult, 1));
+
+				/* Shift for S24_LE */
+				out_sample = AE_SRAA32RS(out_sample, shift);
+				out_sample = AE_SLAA32S(out_sample, shift);
+				out_sample = AE_SRAA32(out_sample, shift);
+
+				/* Set sink as circular buffer */
+				vol_setup_circular(sink);
+
+				/* Store the output sample */
+				AE_S32_L_XC(out_sample, out, sizeof(ae_int32));
+			}
 		}
+
+		/* step ramping gains for next block */
+		if (cd->ramp_active)
+			vol_ramp_block(cd, dev->params.channels, n);
 	}
 }
 
@@ -286,6 +335,8 @@ static void vol_s32_to_s24_s32(struct comp_dev *dev, struct comp_buffer *sink,
 	size_t channel;
 	int shift = 0;
 	int i;
+	uint32_t n;
+	uint32_t f;
 	ae_int32 *in = (ae_int32 *)source->r_ptr;
 	ae_int32 *out = (ae_int32 *)sink->w_ptr;
 
@@ -293,40 +344,49 @@ static void vol_s32_to_s24_s32(struct comp_dev *dev, struct comp_buffer *sink,
 	if (cd->sink_format == SOF_IPC_FRAME_S24_4LE)
 		shift = 8;
 
-	/* Main processing loop */
-	for (i = 0; i < frames; i++) {
-		/* Processing per channel */
-		for (channel = 0; channel < dev->params.channels; channel++) {
-			/* Set source as circular buffer */
-			vol_setup_circular(source);
-
-			/* Load the input sample */
-			AE_L32_XC(in_sample, in, sizeof(ae_int32));
-
-			/* Load volume */
-			volume = (ae_f32x2)cd->volume[channel];
-
-			/* Multiply the input sample */
-			mult = AE_MULF32S_LL(volume, in_sample);
-
-			/* Multiplication of Q1.31 x Q1.31 gives Q1.63.
-			 * Now multiplication is Q8.16 x Q1.31, the result
-			 * is Q9.48. Need to shift right by one to get Q17.47
-			 * compatible format for round.
-			 */
-			out_sample = AE_ROUND32F48SSYM(AE_SRAI64(mult, 1));
-
-			/* Shift for S24_LE */
-			out_sample = AE_SRAA32RS(out_sample, shift);
-			out_sample = AE_SLAA32S(out_sample, shift);
-			out_sample = AE_SRAA32(out_sample, shift);
-
-			/* Set sink as circular buffer */
-			vol_setup_circular(sink);
-
-			/* Store the output sample */
-			AE_S32_L_XC(out_sample, out, sizeof(ae_int32));
+	/* Main processing loop, ramping gains are stepped per block */
+	for (i = 0; i < frames; i += n) {
+		n = vol_ramp_block_frames(cd, frames - i);
+		for (f = 0; f < n; f++) {
+			/* Processing per channel */
+			for (channel = 0; channel < dev->params.channels;
+			     channel++) {
+				/* Set source as circular buffer */
+				vol_setup_circular(source);
+
+				/* Load the input sample */
+				AE_L32_XC(in_sample, in, sizeof(ae_int32));
+
+				/* Load volume */
+				volume = (ae_f32x2)cd->volume[channel];
+
+				/* Multiply the input sample */
+				mult = AE_MULF32S_LL(volume, in_sample);
+
+				/* Multiplication of Q1.31 x Q1.31 gives Q1.63.
+				 * Now multiplication is Q8.16 x Q1.31, the
+				 * result is Q9.48. Need to shift right by one
+				 * to get Q17.47 compatible format for round.
+				 */
+				out_sample =
+					AE_ROUND32F48SSYM(AE_SRAI64(mult, 1));
+
+				/* Shift for S24_LE */
+				out_sample = AE_SRAA32RS(out_sample, shift);
+				out_sample = AE_SLAA32S(out_sample, shift);
+				out_sample = AE_SRAA32(out_sample, shift);
+
+				/* Set sink as circular buffer */
+				vol_setup_circular(sink);
+
+				/* Store the output sample */
+				AE_S32_L_XC(out_sample, out, sizeof(ae_int32));
+			}
 		}
+
+		/* step ramping gains for next block */
+		if (cd->ramp_active)
+			vol_ramp_block(cd, dev->params.channels, n);
 	}
 }
 
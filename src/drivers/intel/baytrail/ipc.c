@@ -29,29 +29,7 @@ struct ipc_data {
 
 static void do_notify(void)
 {
-	uint32_t flags;
-	struct ipc_msg *msg;
-
-	spin_lock_irq(_ipc->lock, flags);
-	msg = _ipc->shared_ctx->dsp_msg;
-	if (!msg)
-		goto out;
-
-	tracev_ipc("ipc: not rx -> 0x%x", msg->header);
-
-	/* copy the data returned from DSP */
-	if (msg->rx_size && msg->rx_size < SOF_IPC_MSG_MAX_SIZE)
-		mailbox_dspbox_read(msg->rx_data, SOF_IPC_MSG_MAX_SIZE,
-				    0, msg->rx_size);
-
-	/* any callback ? */
-	if (msg->cb)
-		msg->cb(msg->cb_data, msg->rx_data);
-
-	list_item_append(&msg->list, &_ipc->shared_ctx->empty_list);
-
-out:
-	spin_unlock_irq(_ipc->lock, flags);
+	tracev_ipc("ipc: not rx");
 
 	/* clear DONE bit - tell Host we have completed */
 	shim_write(SHIM_IPCDH, shim_read(SHIM_IPCDH) & ~SHIM_IPCDH_DONE);
@@ -127,35 +105,25 @@ static void ipc_platform_complete_cmd(void *data)
 
 void ipc_platform_send_msg(struct ipc *ipc)
 {
-	struct ipc_msg *msg;
+	uint32_t header;
 	uint32_t flags;
 
 	spin_lock_irq(ipc->lock, flags);
 
-	/* any messages to send ? */
-	if (list_is_empty(&ipc->shared_ctx->msg_list)) {
-		ipc->shared_ctx->dsp_pending = 0;
-		goto out;
-	}
-
 	/* can't send notification when one is in progress */
 	if (shim_read(SHIM_IPCDH) & (SHIM_IPCDH_BUSY | SHIM_IPCDH_DONE))
 		goto out;
 
-	/* now send the message */
-	msg = list_first_item(&ipc->shared_ctx->msg_list, struct ipc_msg,
-			      list);
-	mailbox_dspbox_write(0, msg->tx_data, msg->tx_size);
-	list_item_del(&msg->list);
-	ipc->shared_ctx->dsp_msg = msg;
-	tracev_ipc("ipc: msg tx -> 0x%x", msg->header);
+	/* now send the message, if any */
+	if (!ipc_msg_tx_next(ipc, &header))
+		goto out;
+
+	tracev_ipc("ipc: msg tx -> 0x%x", header);
 
 	/* now interrupt host to tell it we have message sent */
-	shim_write(SHIM_IPCDL, msg->header);
+	shim_write(SHIM_IPCDL, header);
 	shim_write(SHIM_IPCDH, SHIM_IPCDH_BUSY);
 
-	list_item_append(&msg->list, &ipc->shared_ctx->empty_list);
-
 out:
 	spin_unlock_irq(ipc->lock, flags);
 }
@@ -173,17 +173,11 @@ static void ipc_platform_complete_cmd(void *data)
 
 void ipc_platform_send_msg(struct ipc *ipc)
 {
-	struct ipc_msg *msg;
+	uint32_t header;
 	uint32_t flags;
 
 	spin_lock_irq(ipc->lock, flags);
 
-	/* any messages to send ? */
-	if (list_is_empty(&ipc->shared_ctx->msg_list)) {
-		ipc->shared_ctx->dsp_pending = 0;
-		goto out;
-	}
-
 #if CAVS_VERSION == CAVS_VERSION_1_5
 	if (ipc_read(IPC_DIPCI) & IPC_DIPCI_BUSY)
 #else
@@ -192,25 +186,21 @@ void ipc_platform_send_msg(struct ipc *ipc)
 #endif
 		goto out;
 
-	/* now send the message */
-	msg = list_first_item(&ipc->shared_ctx->msg_list, struct ipc_msg,
-			      list);
-	mailbox_dspbox_write(0, msg->tx_data, msg->tx_size);
-	list_item_del(&msg->list);
-	ipc->shared_ctx->dsp_msg = msg;
-	tracev_ipc("ipc: msg tx -> 0x%x", msg->header);
+	/* now send the message, if any */
+	if (!ipc_msg_tx_next(ipc, &header))
+		goto out;
+
+	tracev_ipc("ipc: msg tx -> 0x%x", header);
 
 	/* now interrupt host to tell it we have message sent */
 #if CAVS_VERSION == CAVS_VERSION_1_5
 	ipc_write(IPC_DIPCIE, 0);
-	ipc_write(IPC_DIPCI, IPC_DIPCI_BUSY | msg->header);
+	ipc_write(IPC_DIPCI, IPC_DIPCI_BUSY | header);
 #else
 	ipc_write(IPC_DIPCIDD, 0);
-	ipc_write(IPC_DIPCIDR, 0x80000000 | msg->header);
+	ipc_write(IPC_DIPCIDR, 0x80000000 | header);
 #endif
 
-	list_item_append(&msg->list, &ipc->shared_ctx->empty_list);
-
 out:
 	spin_unlock_irq(ipc->lock, flags);
 }
@@ -102,6 +102,7 @@
 #define SOF_IPC_PM_CLK_GET			SOF_CMD_TYPE(0x005)
 #define SOF_IPC_PM_CLK_REQ			SOF_CMD_TYPE(0x006)
 #define SOF_IPC_PM_CORE_ENABLE			SOF_CMD_TYPE(0x007)
+#define SOF_IPC_PM_CORE_LOAD			SOF_CMD_TYPE(0x008)
 
 /** \name DSP Command: Component runtime config - multiple different types
  *  @{
@@ -54,4 +54,25 @@ struct sof_ipc_pm_core_config {
 	uint32_t enable_mask;
 } __attribute__((packed));
 
+/* load of one core */
+struct sof_ipc_pm_core_load_elem {
+	uint32_t core;		/**< core id */
+	uint32_t enabled;	/**< core is powered up */
+	uint32_t freq;		/**< current CPU frequency in Hz */
+	uint32_t budget_hz;	/**< cycles per second pipelines may use */
+	uint32_t load_hz;	/**< cycles per second of active pipelines */
+	uint32_t num_pipelines;	/**< number of active pipelines */
+
+	/* reserved for future use */
+	uint32_t reserved[2];
+} __attribute__((packed));
+
+/* load of all cores - SOF_IPC_PM_CORE_LOAD */
+struct sof_ipc_pm_core_load {
+	struct sof_ipc_reply rhdr;
+	uint32_t num_elems;
+
+	struct sof_ipc_pm_core_load_elem elems[];
+} __attribute__((packed));
+
 #endif /* __IPC_PM_H__ */
@@ -132,6 +132,7 @@ enum sof_volume_ramp {
 	SOF_VOLUME_LOG,
 	SOF_VOLUME_LINEAR_ZC,
 	SOF_VOLUME_LOG_ZC,
+	SOF_VOLUME_WINDOWS_FADE,
 };
 
 /* generic volume component */
@@ -213,13 +214,16 @@ enum sof_ipc_pipe_sched_time_domain {
 	SOF_TIME_DOMAIN_TIMER,		/**< Timer interrupt */
 };
 
+/** \brief Pipeline core selected by firmware, the least loaded one */
+#define SOF_IPC_PIPE_CORE_AUTO	0xffffffff
+
 /* new pipeline - SOF_IPC_TPLG_PIPE_NEW */
 struct sof_ipc_pipe_new {
 	struct sof_ipc_cmd_hdr hdr;
 	uint32_t comp_id;	/**< component id for pipeline */
 	uint32_t pipeline_id;	/**< pipeline id */
 	uint32_t sched_id;	/**< Scheduling component id */
-	uint32_t core;		/**< core we run on */
+	uint32_t core;		/**< core we run on or SOF_IPC_PIPE_CORE_AUTO */
 	uint32_t period;	/**< execution period in us*/
 	uint32_t priority;	/**< priority level 0 (low) to 10 (max) */
 	uint32_t period_mips;	/**< worst case instruction count per period */
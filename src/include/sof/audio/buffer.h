@@ -10,12 +10,16 @@
 
 #include <sof/audio/pipeline.h>
 #include <sof/common.h>
+#include <sof/debug/panic.h>
 #include <sof/lib/alloc.h>
 #include <sof/lib/cache.h>
 #include <sof/list.h>
+#include <sof/math/numbers.h>
+#include <sof/string.h>
 #include <sof/trace/trace.h>
 #include <ipc/topology.h>
 #include <user/trace.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -52,6 +56,9 @@ struct comp_buffer {
 	uint32_t id;
 	uint32_t pipeline_id;
 	uint32_t caps;
+	uint32_t align;		/* alignment of sample memory */
+	bool arena;		/* sample memory is owned by pipeline arena */
+	uint32_t arena_size;	/* size of the arena slot */
 
 	/* connected components */
 	struct comp_dev *source;	/* source component */
@@ -214,6 +221,79 @@ static inline void *buffer_get_frag(struct comp_buffer *buffer, void *ptr,
 	return current;
 }
 
+/**
+ * \brief Wraps a pointer that has moved past the end of the buffer.
+ * \param[in] buffer Buffer the pointer belongs to.
+ * \param[in] ptr Pointer at most one buffer size past buffer start.
+ * \return Pointer inside the buffer.
+ */
+static inline void *buffer_wrap(struct comp_buffer *buffer, void *ptr)
+{
+	if (ptr >= buffer->end_addr)
+		ptr = buffer->addr + (ptr - buffer->end_addr);
+
+	return ptr;
+}
+
+/**
+ * \brief Number of bytes that can be accessed linearly from ptr.
+ * \param[in] buffer Buffer the pointer belongs to.
+ * \param[in] ptr Read or write position inside the buffer.
+ * \return Bytes until the end of buffer memory.
+ */
+static inline uint32_t buffer_bytes_without_wrap(struct comp_buffer *buffer,
+						 void *ptr)
+{
+	return buffer->end_addr - ptr;
+}
+
+/**
+ * \brief Number of 16 bit samples that can be accessed linearly from ptr.
+ * \param[in] buffer Buffer the pointer belongs to.
+ * \param[in] ptr Read or write position inside the buffer.
+ * \return Samples until the end of buffer memory.
+ */
+static inline uint32_t buffer_s16_without_wrap(struct comp_buffer *buffer,
+					       void *ptr)
+{
+	return buffer_bytes_without_wrap(buffer, ptr) >> 1;
+}
+
+/**
+ * \brief Number of 32 bit samples that can be accessed linearly from ptr.
+ * \param[in] buffer Buffer the pointer belongs to.
+ * \param[in] ptr Read or write position inside the buffer.
+ * \return Samples until the end of buffer memory.
+ */
+static inline uint32_t buffer_s32_without_wrap(struct comp_buffer *buffer,
+					       void *ptr)
+{
+	return buffer_bytes_without_wrap(buffer, ptr) >> 2;
+}
+
+/**
+ * \brief Largest linear span of bytes shared by a source and sink position.
+ * \param[in] source Source buffer.
+ * \param[in] src Read position in source buffer.
+ * \param[in] sink Sink buffer.
+ * \param[in] dst Write position in sink buffer.
+ * \param[in] bytes Maximum number of bytes requested.
+ * \return Bytes that can be accessed in both buffers without wrap check.
+ *
+ * Kernels call this once per span and run an unbranched loop over the
+ * result, then advance src and dst with buffer_wrap(). Because buffer sizes
+ * are period multiples the number of spans per copy is at most three.
+ */
+static inline uint32_t buffer_span_bytes(struct comp_buffer *source,
+					 void *src,
+					 struct comp_buffer *sink,
+					 void *dst, uint32_t bytes)
+{
+	uint32_t n = MIN(bytes, buffer_bytes_without_wrap(source, src));
+
+	return MIN(n, buffer_bytes_without_wrap(sink, dst));
+}
+
 static inline void buffer_init(struct comp_buffer *buffer, uint32_t size,
 			       uint32_t caps)
 {
@@ -228,40 +308,51 @@ static inline void buffer_init(struct comp_buffer *buffer, uint32_t size,
 	buffer_zero(buffer);
 }
 
+/* Moves the sample memory of an idle buffer to a slot of size bytes at addr
+ * inside the pipeline arena. The arena is freed with the pipeline, so the
+ * buffer no longer frees its own memory.
+ */
+static inline void buffer_set_arena(struct comp_buffer *buffer, void *addr,
+				    uint32_t size)
+{
+	if (!buffer->arena)
+		rfree(buffer->addr);
+
+	buffer->addr = addr;
+	buffer->arena = true;
+	buffer->arena_size = size;
+	buffer_init(buffer, buffer->size, buffer->caps);
+}
+
+/* copy bytes from source read position to sink write position */
+static inline void buffer_copy_bytes(struct comp_buffer *source,
+				     struct comp_buffer *sink, uint32_t bytes)
+{
+	void *src = source->r_ptr;
+	void *dst = sink->w_ptr;
+	uint32_t n;
+	int ret;
+
+	while (bytes) {
+		n = buffer_span_bytes(source, src, sink, dst, bytes);
+		ret = memcpy_s(dst, n, src, n);
+		assert(!ret);
+		bytes -= n;
+		src = buffer_wrap(source, src + n);
+		dst = buffer_wrap(sink, dst + n);
+	}
+}
+
 static inline void buffer_copy_s16(struct comp_buffer *source,
 				   struct comp_buffer *sink, uint32_t bytes)
 {
-	uint32_t frames = bytes / sizeof(int16_t);
-	uint32_t buff_frag = 0;
-	int16_t *src;
-	int16_t *dst;
-	uint32_t i;
-
-	for (i = 0; i < frames; i++) {
-		src = buffer_read_frag_s16(source, buff_frag);
-		dst = buffer_write_frag_s16(sink, buff_frag);
-		*dst = *src;
-
-		buff_frag++;
-	}
+	buffer_copy_bytes(source, sink, bytes);
 }
 
 static inline void buffer_copy_s32(struct comp_buffer *source,
 				   struct comp_buffer *sink, uint32_t bytes)
 {
-	uint32_t frames = bytes / sizeof(int32_t);
-	uint32_t buff_frag = 0;
-	int32_t *src;
-	int32_t *dst;
-	uint32_t i;
-
-	for (i = 0; i < frames; i++) {
-		src = buffer_read_frag_s32(source, buff_frag);
-		dst = buffer_write_frag_s32(sink, buff_frag);
-		*dst = *src;
-
-		buff_frag++;
-	}
+	buffer_copy_bytes(source, sink, bytes);
 }
 
 #endif /* __SOF_AUDIO_BUFFER_H__ */
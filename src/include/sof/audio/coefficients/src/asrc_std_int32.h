@@ -0,0 +1,664 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2019 Intel Corporation. All rights reserved.
+ */
+
+/* ASRC fractional delay filter, 32 taps, 64 phases, cutoff 0.45 fs_in,
+ * Kaiser window beta 7.0, Q2.30. Every phase has unity DC gain. Created
+ * with tools/tune/src/asrc_generate.m.
+ */
+
+#include <stdint.h>
+
+const int32_t asrc_int32_fir[65][32] = {
+	{
+		-423528, 925916, -1529298, 1947320,
+		-1671638, 0, 3857602, -10601495,
+		20626850, -33824645, 49461000, -66185362,
+		82188585, -95491904, 104308781, 966565455,
+		104308781, -95491904, 82188585, -66185362,
+		49461000, -33824645, 20626850, -10601495,
+		3857602, 0, -1671638, 1947320,
+		-1529298, 925916, -423528, 0,
+	},
+	{
+		-416752, 901241, -1464631, 1811990,
+		-1432249, -367778, 4351636, -11172014,
+		21154123, -34097184, 49151089, -64804208,
+		78954924, -88818395, 88598471, 966138414,
+		120297787, -102069641, 85282121, -67435453,
+		49664640, -33474299, 20048165, -10000992,
+		3349020, 372594, -1910730, 2080436,
+		-1591662, 948963, -429443, 121640,
+	},
+	{
+		-409295, 875336, -1398349, 1675410,
+		-1193613, -730062, 4831605, -11715310,
+		21636417, -34303559, 48753257, -63318382,
+		75616748, -82095076, 73216011, 965185422,
+		136586556, -108570313, 88255796, -68573153,
+		49777374, -33057585, 19425722, -9374999,
+		2828064, 749309, -2149601, 2211690,
+		-1652071, 970612, -434603, 122467,
+	},
+	{
+		-401149, 848182, -1330454, 1537666,
+		-956018, -1086194, 5296288, -12229426,
+		22070960, -34440281, 48263696, -61724582,
+		72172683, -75324684, 58162911, 963599151,
+		153148622, -114969478, 91092937, -69587462,
+		49792421, -32570811, 18757962, -8723286,
+		2295202, 1129430, -2387566, 2340556,
+		-1710184, 990678, -438927, 122980,
+	},
+	{
+		-392351, 819867, -1261117, 1399059,
+		-719932, -1435538, 5744937, -12713664,
+		22457393, -34507794, 47684314, -60027092,
+		68630682, -68520541, 43451842, 961381515,
+		169968747, -121253359, 93786260, -70475010,
+		49708734, -32014225, 18045744, -8046878,
+		1751367, 1512229, -2624124, 2466728,
+		-1765837, 1009082, -442380, 123165,
+	},
+	{
+		-382942, 790477, -1190509, 1259888,
+		-485810, -1777480, 6176847, -13167391,
+		22795457, -34506671, 47017173, -58230353,
+		64998782, -61695816, 29094912, 958535183,
+		187031229, -127408154, 96328662, -71232636,
+		49525448, -31388215, 17290020, -7346860,
+		1197529, 1896961, -2858769, 2589900,
+		-1818863, 1025745, -444929, 123007,
+	},
+	{
+		-372960, 760101, -1118803, 1120447,
+		-254099, -2111428, 6591353, -13590042,
+		23084990, -34437619, 46264486, -56338948,
+		61285093, -54863508, 15103659, 955063576,
+		204319928, -133420054, 98713235, -71857397,
+		49241884, -30693312, 16491845, -6624376,
+		634687, 2282870, -3090991, 2709768,
+		-1869103, 1040592, -446543, 122493,
+	},
+	{
+		-362446, 728826, -1046169, 981027,
+		-25235, -2436814, 6987835, -13981123,
+		23325931, -34301467, 45428611, -54357596,
+		57497776, -48036423, 1489032, 950970858,
+		221818278, -139275264, 100933281, -72346576,
+		48857558, -29930189, 15652364, -5880629,
+		63871, 2669186, -3320280, 2826028,
+		-1916398, 1053551, -447190, 121610,
+	},
+	{
+		-351440, 696741, -972776, 841913,
+		200359, -2753096, 7365714, -14340204,
+		23518313, -34099171, 44512044, -52291135,
+		53645031, -41227161, -11738616, 946261937,
+		239509316, -144960030, 102982328, -72697689,
+		48372176, -29099661, 14772822, -5116876,
+		-513862, 3055128, -3546123, 2938381,
+		-1960593, 1064552, -446844, 120347,
+	},
+	{
+		-339982, 663934, -898793, 703387,
+		422274, -3059756, 7724458, -14666928,
+		23662268, -33831808, 43517414, -50144517,
+		49735083, -34448093, -24569542, 940942450,
+		257375697, -150460654, 104854141, -72908496,
+		47785642, -28202687, 13854554, -4334431,
+		-1097425, 3439907, -3768008, 3046531,
+		-2001537, 1073526, -445476, 118690,
+	},
+	{
+		-328113, 630493, -824386, 565723,
+		640112, -3356302, 8063578, -14961005,
+		23758021, -33500570, 42447475, -47922796,
+		45776164, -27711346, -36994616, 935018760,
+		275399716, -155763522, 106542744, -72977000,
+		47098057, -27240365, 12898987, -3534658,
+		-1685710, 3822726, -3985424, 3150187,
+		-2039083, 1080410, -443062, 116632,
+	},
+	{
+		-315873, 596504, -749719, 429190,
+		853490, -3642271, 8382630, -15222213,
+		23805890, -33106766, 41305102, -45631116,
+		41776495, -21028787, -49005337, 928497946,
+		293563335, -160855124, 108042426, -72901464,
+		46309725, -26213938, 11907639, -2718971,
+		-2277586, 4202781, -4197861, 3249060,
+		-2073090, 1085144, -439579, 114160,
+	},
+	{
+		-303303, 562055, -674953, 294050,
+		1062040, -3917224, 8681218, -15450398,
+		23806286, -32651811, 40093280, -43274700,
+		37744278, -14412006, -60593835, 921387791,
+		311848204, -165722076, 109347757, -72680406,
+		45421149, -25124787, 10882114, -1888833,
+		-2871900, 4579266, -4404813, 3342871,
+		-2103421, 1087670, -435005, 111267,
+	},
+	{
+		-290442, 527231, -600248, 160558,
+		1265409, -4180753, 8958988, -15645475,
+		23759710, -32137231, 38815101, -40858844,
+		33687676, -7872300, -71752880, 913696772,
+		330235682, -170351143, 110453604, -72312615,
+		44433036, -23974431, 9824101, -1045750,
+		-3467481, 4951370, -4605778, 3431343,
+		-2129944, 1087934, -429321, 107944,
+	},
+	{
+		-277329, 492117, -525759, 28962,
+		1463260, -4432478, 9215637, -15807425,
+		23666751, -31564650, 37473755, -38388897,
+		29614799, -1420659, -82475886, 905434045,
+		348706867, -174729259, 111355142, -71797146,
+		43346294, -22764528, 8735373, -191272,
+		-4063143, 5318281, -4800261, 3514208,
+		-2152534, 1085887, -422511, 104184,
+	},
+	{
+		-264004, 456797, -451638, -100500,
+		1655270, -4672047, 9450904, -15936296,
+		23528082, -30935793, 36072523, -35870259,
+		25533690, 4932249, -92756916, 896609438,
+		367242613, -178843554, 112047867, -71133335,
+		42162039, -21496870, 7617782, 673011,
+		-4657685, 5679187, -4987771, 3591206,
+		-2171072, 1081483, -414559, 99983,
+	},
+	{
+		-250506, 421352, -378034, -227596,
+		1841137, -4899137, 9664577, -16032201,
+		23344462, -30252476, 34614770, -33308365,
+		21452312, 11176090, -102590687, 887233430,
+		385823562, -182681370, 112527607, -70320796,
+		40881587, -20173383, 6473258, 1545473,
+		-5249895, 6033278, -5167827, 3662084,
+		-2185445, 1074683, -405454, 95334,
+	},
+	{
+		-236871, 385863, -305092, -352103,
+		2020571, -5113457, 9856487, -16095318,
+		23116731, -29516606, 33103937, -30708675,
+		17378533, 17300880, -111972569, 877317139,
+		404430169, -186230289, 112790533, -69359427,
+		39506458, -18796122, 5303802, 2424454,
+		-5838549, 6379751, -5339954, 3726598,
+		-2195546, 1065447, -395186, 90234,
+	},
+	{
+		-223138, 350409, -232953, -473809,
+		2193303, -5314742, 10026514, -16125890,
+		22845808, -28730174, 31543534, -28076667,
+		13320112, 23296995, -120898588, 866872308,
+		423042721, -189478148, 112833176, -68249412,
+		38038375, -17367273, 4111490, 3308261,
+		-6422421, 6717803, -5503689, 3784516,
+		-2201279, 1053746, -383747, 84680,
+	},
+	{
+		-209342, 315067, -161752, -592510,
+		2359081, -5502759, 10174581, -16124219,
+		22532686, -27895248, 29937133, -25417820,
+		9284687, 29155181, -129365427, 855911283,
+		441641373, -192413067, 112652430, -66991229,
+		36479260, -15889142, 2898463, 4195175,
+		-7000276, 7046642, -5658579, 3835613,
+		-2202551, 1039552, -371133, 78672,
+	},
+	{
+		-195520, 279911, -91622, -708011,
+		2517669, -5677307, 10300658, -16090671,
+		22178433, -27013974, 28288358, -22737607,
+		5279762, 34866568, -137370426, 844447000,
+		460206166, -195023464, 112245566, -65585644,
+		34831237, -14364160, 1666924, 5083451,
+		-7570879, 7365484, -5804184, 3879677,
+		-2199281, 1022843, -357342, 72208,
+	},
+	{
+		-181705, 245015, -22690, -820128,
+		2668852, -5838210, 10404759, -16025671,
+		21784188, -26088565, 26600881, -20041486,
+		1312694, 40422679, -144911578, 832492965,
+		478717061, -197298081, 111610241, -64033720,
+		33096624, -12794876, 419139, 5971322,
+		-8132996, 7673555, -5940076, 3916506,
+		-2191394, 1003601, -342375, 65291,
+	},
+	{
+		-167932, 210450, 44923, -928685,
+		2812431, -5985328, 10486941, -15929701,
+		21351157, -25121301, 24878411, -17334887,
+		-2609318, 45815437, -151987528, 820063233,
+		497153959, -199226002, 110744509, -62336813,
+		31277936, -11183950, -842571, 6857003,
+		-8685393, 7970095, -6065842, 3945911,
+		-2178823, 981816, -326235, 57923,
+	},
+	{
+		-154232, 176283, 111099, -1033520,
+		2948227, -6118545, 10547306, -15803302,
+		20880610, -24114519, 23124688, -14623202,
+		-6479247, 51037178, -158597570, 807172390,
+		515496735, -200796673, 109646827, -60496578,
+		29377877, -9534155, -2115835, 7738695,
+		-9226845, 8254356, -6181084, 3967715,
+		-2161512, 957481, -308930, 50107,
+	},
+	{
+		-140638, 142581, 175728, -1134479,
+		3076079, -6237779, 10585999, -15647067,
+		20373877, -23070612, 21343477, -11911777,
+		-10290246, 56080653, -164741641, 793835531,
+		533725260, -201999922, 108316060, -58514963,
+		27399341, -7848367, -3398230, 8614586,
+		-9756133, 8525606, -6285419, 3981756,
+		-2139413, 930595, -290468, 41849,
+	},
+	{
+		-127179, 109407, 238703, -1231418,
+		3195845, -6342975, 10603204, -15461644,
+		19832349, -21992019, 19538555, -9205901,
+		-14035660, 60939040, -170420317, 780068241,
+		551819432, -202825978, 106751497, -56394213,
+		25345406, -6129565, -4687295, 9482857,
+		-10272049, 8783132, -6378484, 3987883,
+		-2112488, 901164, -270863, 33156,
+	},
+	{
+		-113885, 76821, 299923, -1324205,
+		3307401, -6434110, 10599150, -15247731,
+		19257469, -20881227, 17713711, -6510795,
+		-17709037, 65605948, -175634805, 765886569,
+		569759200, -203265492, 104952849, -54136866,
+		23219332, -4380822, -5980526, 10341685,
+		-10773398, 9026239, -6459932, 3985962,
+		-2080708, 869198, -250129, 24034,
+	},
+	{
+		-100783, 44882, 359295, -1412720,
+		3410643, -6511187, 10574104, -15006075,
+		18650730, -19740758, 15872733, -3831605,
+		-21304137, 70075421, -180386938, 751307008,
+		587524597, -203309552, 102920258, -51745756,
+		21024552, -2605303, -7275387, 11189245,
+		-11259002, 9254253, -6529437, 3975872,
+		-2044053, 834713, -228286, 14495,
+	},
+	{
+		-87901, 13644, 416728, -1496852,
+		3505484, -6574239, 10528371, -14737472,
+		18013676, -18573168, 14019400, -1173392,
+		-24814941, 74341947, -184679164, 736346471,
+		605095760, -202949703, 100654304, -49224004,
+		18764671, -806259, -8569310, 12023717,
+		-11727699, 9466523, -6586690, 3957508,
+		-2002516, 797733, -205354, 4548,
+	},
+	{
+		-75262, -16839, 472141, -1576501,
+		3591857, -6623326, 10462296, -14442761,
+		17347892, -17381038, 12157480, 1458877,
+		-28235661, 78400457, -188514540, 721022267,
+		622452963, -202177963, 98156007, -46575022,
+		16443462, 1012982, -9859706, 12843285,
+		-12178351, 9662421, -6631408, 3930781,
+		-1956097, 758285, -181359, -5793,
+	},
+	{
+		-62891, -46520, 525456, -1651580,
+		3669713, -6658537, 10376260, -14122824,
+		16655004, -16166975, 10290718, 4060338,
+		-31560747, 82246330, -191896720, 705352075,
+		639576644, -200986841, 95426830, -43802506,
+		14064856, 2849013, -11143963, 13646146,
+		-12609842, 9841346, -6663325, 3895617,
+		-1904810, 716405, -156329, -16516,
+	},
+	{
+		-50811, -75351, 576601, -1722011,
+		3739021, -6679988, 10270680, -13778585,
+		15936676, -14933601, 8422831, 6626237,
+		-34784895, 85875397, -194829944, 689353923,
+		656447429, -199369351, 92468686, -40910432,
+		11632937, 4698364, -12419455, 14430509,
+		-13021080, 10002723, -6682202, 3851959,
+		-1848675, 672132, -130294, -27605,
+	},
+	{
+		-39042, -103289, 625513, -1787727,
+		3799768, -6687821, 10146006, -13411004,
+		15194602, -13683548, 6557500, 9151939,
+		-37903053, 89283937, -197319028, 673046159,
+		673046159, -197319028, 89283937, -37903053,
+		9151939, 6557500, -13683548, 15194602,
+		-13411004, 10146006, -6687821, 3799768,
+		-1787727, 625513, -103289, -39042,
+	},
+	{
+		-27605, -130294, 672132, -1848675,
+		3851959, -6682202, 10002723, -13021080,
+		14430509, -12419455, 4698364, 11632937,
+		-40910432, 92468686, -199369351, 656447429,
+		689353923, -194829944, 85875397, -34784895,
+		6626237, 8422831, -14933601, 15936676,
+		-13778585, 10270680, -6679988, 3739021,
+		-1722011, 576601, -75351, -50811,
+	},
+	{
+		-16516, -156329, 716405, -1904810,
+		3895617, -6663325, 9841346, -12609842,
+		13646146, -11143963, 2849013, 14064856,
+		-43802506, 95426830, -200986841, 639576644,
+		705352075, -191896720, 82246330, -31560747,
+		4060338, 10290718, -16166975, 16655004,
+		-14122824, 10376260, -6658537, 3669713,
+		-1651580, 525456, -46520, -62891,
+	},
+	{
+		-5793, -181359, 758285, -1956097,
+		3930781, -6631408, 9662421, -12178351,
+		12843285, -9859706, 1012982, 16443462,
+		-46575022, 98156007, -202177963, 622452963,
+		721022267, -188514540, 78400457, -28235661,
+		1458877, 12157480, -17381038, 17347892,
+		-14442761, 10462296, -6623326, 3591857,
+		-1576501, 472141, -16839, -75262,
+	},
+	{
+		4548, -205354, 797733, -2002516,
+		3957508, -6586690, 9466523, -11727699,
+		12023717, -8569310, -806259, 18764671,
+		-49224004, 100654304, -202949703, 605095760,
+		736346471, -184679164, 74341947, -24814941,
+		-1173392, 14019400, -18573168, 18013676,
+		-14737472, 10528371, -6574239, 3505484,
+		-1496852, 416728, 13644, -87901,
+	},
+	{
+		14495, -228286, 834713, -2044053,
+		3975872, -6529437, 9254253, -11259002,
+		11189245, -7275387, -2605303, 21024552,
+		-51745756, 102920258, -203309552, 587524597,
+		751307008, -180386938, 70075421, -21304137,
+		-3831605, 15872733, -19740758, 18650730,
+		-15006075, 10574104, -6511187, 3410643,
+		-1412720, 359295, 44882, -100783,
+	},
+	{
+		24034, -250129, 869198, -2080708,
+		3985962, -6459932, 9026239, -10773398,
+		10341685, -5980526, -4380822, 23219332,
+		-54136866, 104952849, -203265492, 569759200,
+		765886569, -175634805, 65605948, -17709037,
+		-6510795, 17713711, -20881227, 19257469,
+		-15247731, 10599150, -6434110, 3307401,
+		-1324205, 299923, 76821, -113885,
+	},
+	{
+		33156, -270863, 901164, -2112488,
+		3987883, -6378484, 8783132, -10272049,
+		9482857, -4687295, -6129565, 25345406,
+		-56394213, 106751497, -202825978, 551819432,
+		780068241, -170420317, 60939040, -14035660,
+		-9205901, 19538555, -21992019, 19832349,
+		-15461644, 10603204, -6342975, 3195845,
+		-1231418, 238703, 109407, -127179,
+	},
+	{
+		41849, -290468, 930595, -2139413,
+		3981756, -6285419, 8525606, -9756133,
+		8614586, -3398230, -7848367, 27399341,
+		-58514963, 108316060, -201999922, 533725260,
+		793835531, -164741641, 56080653, -10290246,
+		-11911777, 21343477, -23070612, 20373877,
+		-15647067, 10585999, -6237779, 3076079,
+		-1134479, 175728, 142581, -140638,
+	},
+	{
+		50107, -308930, 957481, -2161512,
+		3967715, -6181084, 8254356, -9226845,
+		7738695, -2115835, -9534155, 29377877,
+		-60496578, 109646827, -200796673, 515496735,
+		807172390, -158597570, 51037178, -6479247,
+		-14623202, 23124688, -24114519, 20880610,
+		-15803302, 10547306, -6118545, 2948227,
+		-1033520, 111099, 176283, -154232,
+	},
+	{
+		57923, -326235, 981816, -2178823,
+		3945911, -6065842, 7970095, -8685393,
+		6857003, -842571, -11183950, 31277936,
+		-62336813, 110744509, -199226002, 497153959,
+		820063233, -151987528, 45815437, -2609318,
+		-17334887, 24878411, -25121301, 21351157,
+		-15929701, 10486941, -5985328, 2812431,
+		-928685, 44923, 210450, -167932,
+	},
+	{
+		65291, -342375, 1003601, -2191394,
+		3916506, -5940076, 7673555, -8132996,
+		5971322, 419139, -12794876, 33096624,
+		-64033720, 111610241, -197298081, 478717061,
+		832492965, -144911578, 40422679, 1312694,
+		-20041486, 26600881, -26088565, 21784188,
+		-16025671, 10404759, -5838210, 2668852,
+		-820128, -22690, 245015, -181705,
+	},
+	{
+		72208, -357342, 1022843, -2199281,
+		3879677, -5804184, 7365484, -7570879,
+		5083451, 1666924, -14364160, 34831237,
+		-65585644, 112245566, -195023464, 460206166,
+		844447000, -137370426, 34866568, 5279762,
+		-22737607, 28288358, -27013974, 22178433,
+		-16090671, 10300658, -5677307, 2517669,
+		-708011, -91622, 279911, -195520,
+	},
+	{
+		78672, -371133, 1039552, -2202551,
+		3835613, -5658579, 7046642, -7000276,
+		4195175, 2898463, -15889142, 36479260,
+		-66991229, 112652430, -192413067, 441641373,
+		855911283, -129365427, 29155181, 9284687,
+		-25417820, 29937133, -27895248, 22532686,
+		-16124219, 10174581, -5502759, 2359081,
+		-592510, -161752, 315067, -209342,
+	},
+	{
+		84680, -383747, 1053746, -2201279,
+		3784516, -5503689, 6717803, -6422421,
+		3308261, 4111490, -17367273, 38038375,
+		-68249412, 112833176, -189478148, 423042721,
+		866872308, -120898588, 23296995, 13320112,
+		-28076667, 31543534, -28730174, 22845808,
+		-16125890, 10026514, -5314742, 2193303,
+		-473809, -232953, 350409, -223138,
+	},
+	{
+		90234, -395186, 1065447, -2195546,
+		3726598, -5339954, 6379751, -5838549,
+		2424454, 5303802, -18796122, 39506458,
+		-69359427, 112790533, -186230289, 404430169,
+		877317139, -111972569, 17300880, 17378533,
+		-30708675, 33103937, -29516606, 23116731,
+		-16095318, 9856487, -5113457, 2020571,
+		-352103, -305092, 385863, -236871,
+	},
+	{
+		95334, -405454, 1074683, -2185445,
+		3662084, -5167827, 6033278, -5249895,
+		1545473, 6473258, -20173383, 40881587,
+		-70320796, 112527607, -182681370, 385823562,
+		887233430, -102590687, 11176090, 21452312,
+		-33308365, 34614770, -30252476, 23344462,
+		-16032201, 9664577, -4899137, 1841137,
+		-227596, -378034, 421352, -250506,
+	},
+	{
+		99983, -414559, 1081483, -2171072,
+		3591206, -4987771, 5679187, -4657685,
+		673011, 7617782, -21496870, 42162039,
+		-71133335, 112047867, -178843554, 367242613,
+		896609438, -92756916, 4932249, 25533690,
+		-35870259, 36072523, -30935793, 23528082,
+		-15936296, 9450904, -4672047, 1655270,
+		-100500, -451638, 456797, -264004,
+	},
+	{
+		104184, -422511, 1085887, -2152534,
+		3514208, -4800261, 5318281, -4063143,
+		-191272, 8735373, -22764528, 43346294,
+		-71797146, 111355142, -174729259, 348706867,
+		905434045, -82475886, -1420659, 29614799,
+		-38388897, 37473755, -31564650, 23666751,
+		-15807425, 9215637, -4432478, 1463260,
+		28962, -525759, 492117, -277329,
+	},
+	{
+		107944, -429321, 1087934, -2129944,
+		3431343, -4605778, 4951370, -3467481,
+		-1045750, 9824101, -23974431, 44433036,
+		-72312615, 110453604, -170351143, 330235682,
+		913696772, -71752880, -7872300, 33687676,
+		-40858844, 38815101, -32137231, 23759710,
+		-15645475, 8958988, -4180753, 1265409,
+		160558, -600248, 527231, -290442,
+	},
+	{
+		111267, -435005, 1087670, -2103421,
+		3342871, -4404813, 4579266, -2871900,
+		-1888833, 10882114, -25124787, 45421149,
+		-72680406, 109347757, -165722076, 311848204,
+		921387791, -60593835, -14412006, 37744278,
+		-43274700, 40093280, -32651811, 23806286,
+		-15450398, 8681218, -3917224, 1062040,
+		294050, -674953, 562055, -303303,
+	},
+	{
+		114160, -439579, 1085144, -2073090,
+		3249060, -4197861, 4202781, -2277586,
+		-2718971, 11907639, -26213938, 46309725,
+		-72901464, 108042426, -160855124, 293563335,
+		928497946, -49005337, -21028787, 41776495,
+		-45631116, 41305102, -33106766, 23805890,
+		-15222213, 8382630, -3642271, 853490,
+		429190, -749719, 596504, -315873,
+	},
+	{
+		116632, -443062, 1080410, -2039083,
+		3150187, -3985424, 3822726, -1685710,
+		-3534658, 12898987, -27240365, 47098057,
+		-72977000, 106542744, -155763522, 275399716,
+		935018760, -36994616, -27711346, 45776164,
+		-47922796, 42447475, -33500570, 23758021,
+		-14961005, 8063578, -3356302, 640112,
+		565723, -824386, 630493, -328113,
+	},
+	{
+		118690, -445476, 1073526, -2001537,
+		3046531, -3768008, 3439907, -1097425,
+		-4334431, 13854554, -28202687, 47785642,
+		-72908496, 104854141, -150460654, 257375697,
+		940942450, -24569542, -34448093, 49735083,
+		-50144517, 43517414, -33831808, 23662268,
+		-14666928, 7724458, -3059756, 422274,
+		703387, -898793, 663934, -339982,
+	},
+	{
+		120347, -446844, 1064552, -1960593,
+		2938381, -3546123, 3055128, -513862,
+		-5116876, 14772822, -29099661, 48372176,
+		-72697689, 102982328, -144960030, 239509316,
+		946261937, -11738616, -41227161, 53645031,
+		-52291135, 44512044, -34099171, 23518313,
+		-14340204, 7365714, -2753096, 200359,
+		841913, -972776, 696741, -351440,
+	},
+	{
+		121610, -447190, 1053551, -1916398,
+		2826028, -3320280, 2669186, 63871,
+		-5880629, 15652364, -29930189, 48857558,
+		-72346576, 100933281, -139275264, 221818278,
+		950970858, 1489032, -48036423, 57497776,
+		-54357596, 45428611, -34301467, 23325931,
+		-13981123, 6987835, -2436814, -25235,
+		981027, -1046169, 728826, -362446,
+	},
+	{
+		122493, -446543, 1040592, -1869103,
+		2709768, -3090991, 2282870, 634687,
+		-6624376, 16491845, -30693312, 49241884,
+		-71857397, 98713235, -133420054, 204319928,
+		955063576, 15103659, -54863508, 61285093,
+		-56338948, 46264486, -34437619, 23084990,
+		-13590042, 6591353, -2111428, -254099,
+		1120447, -1118803, 760101, -372960,
+	},
+	{
+		123007, -444929, 1025745, -1818863,
+		2589900, -2858769, 1896961, 1197529,
+		-7346860, 17290020, -31388215, 49525448,
+		-71232636, 96328662, -127408154, 187031229,
+		958535183, 29094912, -61695816, 64998782,
+		-58230353, 47017173, -34506671, 22795457,
+		-13167391, 6176847, -1777480, -485810,
+		1259888, -1190509, 790477, -382942,
+	},
+	{
+		123165, -442380, 1009082, -1765837,
+		2466728, -2624124, 1512229, 1751367,
+		-8046878, 18045744, -32014225, 49708734,
+		-70475010, 93786260, -121253359, 169968747,
+		961381515, 43451842, -68520541, 68630682,
+		-60027092, 47684314, -34507794, 22457393,
+		-12713664, 5744937, -1435538, -719932,
+		1399059, -1261117, 819867, -392351,
+	},
+	{
+		122980, -438927, 990678, -1710184,
+		2340556, -2387566, 1129430, 2295202,
+		-8723286, 18757962, -32570811, 49792421,
+		-69587462, 91092937, -114969478, 153148622,
+		963599151, 58162911, -75324684, 72172683,
+		-61724582, 48263696, -34440281, 22070960,
+		-12229426, 5296288, -1086194, -956018,
+		1537666, -1330454, 848182, -401149,
+	},
+	{
+		122467, -434603, 970612, -1652071,
+		2211690, -2149601, 749309, 2828064,
+		-9374999, 19425722, -33057585, 49777374,
+		-68573153, 88255796, -108570313, 136586556,
+		965185422, 73216011, -82095076, 75616748,
+		-63318382, 48753257, -34303559, 21636417,
+		-11715310, 4831605, -730062, -1193613,
+		1675410, -1398349, 875336, -409295,
+	},
+	{
+		121640, -429443, 948963, -1591662,
+		2080436, -1910730, 372594, 3349020,
+		-10000992, 20048165, -33474299, 49664640,
+		-67435453, 85282121, -102069641, 120297787,
+		966138414, 88598471, -88818395, 78954924,
+		-64804208, 49151089, -34097184, 21154123,
+		-11172014, 4351636, -367778, -1432249,
+		1811990, -1464631, 901241, -416752,
+	},
+	{
+		0, -423528, 925916, -1529298,
+		1947320, -1671638, 0, 3857602,
+		-10601495, 20626850, -33824645, 49461000,
+		-66185362, 82188585, -95491904, 104308781,
+		966565455, 104308781, -95491904, 82188585,
+		-66185362, 49461000, -33824645, 20626850,
+		-10601495, 3857602, 0, -1671638,
+		1947320, -1529298, 925916, -423528,
+	},
+};
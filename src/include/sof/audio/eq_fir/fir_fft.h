@@ -0,0 +1,72 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2019 Intel Corporation. All rights reserved.
+ */
+
+#ifndef __SOF_AUDIO_EQ_FIR_FIR_FFT_H__
+#define __SOF_AUDIO_EQ_FIR_FIR_FFT_H__
+
+#include <sof/math/fft.h>
+#include <stddef.h>
+#include <stdint.h>
+
+struct comp_buffer;
+struct sof_eq_fir_coef_data;
+
+/* Responses with at least this many taps are run as partitioned overlap-save
+ * FFT convolution. The filter is split into FIR_FFT_BLOCK taps partitions and
+ * the output is delayed by FIR_FFT_BLOCK samples versus direct form.
+ */
+#define FIR_FFT_TAPS_MIN	128
+#define FIR_FFT_BLOCK		64
+#define FIR_FFT_SIZE		(2 * FIR_FFT_BLOCK)
+
+struct fir_fft_state {
+	int partitions; /* Number of filter partitions, 0 for bypass */
+	int out_shift; /* Amount of right shifts at output */
+	int pos; /* Sample index in current block */
+	int fdl_idx; /* Newest input spectrum in frequency delay line */
+	int32_t *in; /* Previous and current input blocks */
+	int32_t *out; /* Output block */
+	struct icomplex32 *coef; /* Spectra of filter partitions */
+	struct icomplex32 *fdl; /* Spectra of past input blocks */
+	struct icomplex32 *work; /* FFT buffer shared by all channels */
+	struct fft_plan *plan; /* FFT plan shared by all channels */
+};
+
+void fir_fft_reset(struct fir_fft_state *fft);
+
+size_t fir_fft_init_coef(struct fir_fft_state *fft,
+			 struct sof_eq_fir_coef_data *config);
+
+void fir_fft_init_data(struct fir_fft_state *fft,
+		       struct sof_eq_fir_coef_data *config,
+		       struct fft_plan *plan, struct icomplex32 *work,
+		       int32_t **data);
+
+void fir_fft_block(struct fir_fft_state *fft);
+
+void eq_fir_fft_s16(struct fir_fft_state fft[], struct comp_buffer *source,
+		    struct comp_buffer *sink, int frames, int nch);
+
+void eq_fir_fft_s24(struct fir_fft_state fft[], struct comp_buffer *source,
+		    struct comp_buffer *sink, int frames, int nch);
+
+void eq_fir_fft_s32(struct fir_fft_state fft[], struct comp_buffer *source,
+		    struct comp_buffer *sink, int frames, int nch);
+
+/* Filters one sample, the output is FIR_FFT_BLOCK samples late */
+static inline int32_t fir_fft_32x16(struct fir_fft_state *fft, int32_t x)
+{
+	int32_t y = fft->out[fft->pos];
+
+	fft->in[FIR_FFT_BLOCK + fft->pos] = x;
+	if (++fft->pos == FIR_FFT_BLOCK) {
+		fir_fft_block(fft);
+		fft->pos = 0;
+	}
+
+	return y;
+}
+
+#endif /* __SOF_AUDIO_EQ_FIR_FIR_FFT_H__ */
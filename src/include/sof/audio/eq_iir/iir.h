@@ -50,6 +50,12 @@ struct sof_eq_iir_header_df2t;
 #endif /* __XCC__ */
 #endif /* IIR_AUTOARCH */
 
+/* Run EQ channels with identical biquad layout in lockstep with the
+ * multichannel engine. It is plain C, so only the generic variant uses it
+ * and HiFi3 builds keep the per channel iir_df2t() with intrinsics.
+ */
+#define IIR_MULTICHANNEL	IIR_GENERIC
+
 #define IIR_DF2T_NUM_DELAYS 2
 
 struct iir_state_df2t {
@@ -61,8 +67,32 @@ struct iir_state_df2t {
 	int64_t *delay; /* Pointer to IIR delay line */
 };
 
+/* Multichannel DF2T IIR. All channels run the same number of biquads and
+ * every coefficient and delay is stored interleaved by channel, e.g. b0 of
+ * biquad k for channel ch is at coef[(k * 7 + 4) * channels + ch]. A block
+ * of frames is filtered for all channels in lockstep and the output is bit
+ * exact versus iir_df2t() run per channel.
+ */
+struct iir_mc_state_df2t {
+	unsigned int channels; /* Number of interleaved channels */
+	unsigned int biquads; /* Number of IIR 2nd order sections total */
+	unsigned int biquads_in_series; /* Number of IIR 2nd order sections
+					 * in series.
+					 */
+	int32_t *coef; /* Pointer to interleaved IIR coefficients */
+	int64_t *delay; /* Pointer to interleaved IIR delay lines */
+};
+
 int32_t iir_df2t(struct iir_state_df2t *iir, int32_t x);
 
+int iir_mc_init_coef_df2t(struct iir_mc_state_df2t *mc,
+			  struct iir_state_df2t iir[], int channels);
+
+void iir_mc_init_delay_df2t(struct iir_mc_state_df2t *mc,
+			    struct iir_state_df2t iir[], void *data);
+
+void iir_mc_df2t(struct iir_mc_state_df2t *mc, int32_t *data, int frames);
+
 size_t iir_init_coef_df2t(struct iir_state_df2t *iir,
 			  struct sof_eq_iir_header_df2t *config);
 
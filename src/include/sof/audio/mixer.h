@@ -8,6 +8,18 @@
 #ifndef __SOF_AUDIO_MIXER_H__
 #define __SOF_AUDIO_MIXER_H__
 
+#include <sof/bit.h>
+
+/* per source gain is a Q1.16 attenuation, unity gain mixes unscaled */
+#define MIXER_GAIN_Q		16
+#define MIXER_GAIN_UNITY	BIT(MIXER_GAIN_Q)
+
+/* gain changes on a running mixer ramp linearly over this time */
+#define MIXER_GAIN_RAMP_MS	10
+
+/* samples accumulated per source in one pass of the mix loop */
+#define MIXER_BLOCK_SAMPLES	64
+
 #ifdef UNIT_TEST
 void sys_comp_mixer_init(void);
 #endif
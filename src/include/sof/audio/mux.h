@@ -50,12 +50,34 @@ struct mux_stream_data {
 	uint8_t reserved[(20 - PLATFORM_MAX_CHANNELS - 1) % 4]; // padding to ensure proper alignment of following instances
 };
 
+/** \brief Maximum number of input samples routed by one component. */
+#define MUX_MAX_TAPS \
+	(MUX_MAX_STREAMS * PLATFORM_MAX_CHANNELS * PLATFORM_MAX_CHANNELS)
+
+/** \brief Input sample added to an output channel. */
+struct mux_tap {
+	uint8_t stream;		/**< index of source stream */
+	uint8_t channel;	/**< channel in source frame */
+};
+
+/**
+ * \brief Routing of one output stream compiled from the bitmasks.
+ *
+ * Output channel ch is the sum of taps first[ch] up to first[ch + 1] - 1
+ * of the component tap table.
+ */
+struct mux_look_up {
+	uint16_t first[PLATFORM_MAX_CHANNELS + 1];
+	uint8_t num_channels;	/**< output channels */
+	uint8_t copy;		/**< each output channel has exactly one tap */
+};
+
 typedef void(*demux_func)(struct comp_dev *dev, struct comp_buffer *sink,
 			struct comp_buffer *source, uint32_t frames,
-			struct mux_stream_data *data);
+			struct mux_look_up *lookup);
 typedef void(*mux_func)(struct comp_dev *dev, struct comp_buffer *sink,
 			  struct comp_buffer **sources, uint32_t frames,
-			  struct mux_stream_data *data);
+			  struct mux_look_up *lookup);
 
 struct sof_mux_config {
 	uint16_t frame_format;
@@ -73,6 +95,10 @@ struct comp_data {
 		demux_func demux;
 	};
 
+	/* demux routes each sink stream, mux only uses the first entry */
+	struct mux_look_up lookup[MUX_MAX_STREAMS];
+	struct mux_tap taps[MUX_MAX_TAPS];
+
 	struct sof_mux_config config;
 };
 
@@ -89,16 +115,6 @@ demux_func demux_get_processing_function(struct comp_dev *dev);
 
 #ifdef UNIT_TEST
 void sys_comp_mux_init(void);
-
-int32_t calc_sample_s16le(struct comp_buffer *source,
-			  uint8_t num_ch, uint32_t offset,
-			  uint8_t mask);
-int32_t calc_sample_s24le(struct comp_buffer *source,
-			  uint8_t num_ch, uint32_t offset,
-			  uint8_t mask);
-int64_t calc_sample_s32le(struct comp_buffer *source,
-			  uint8_t num_ch, uint32_t offset,
-			  uint8_t mask);
 #endif /* UNIT_TEST */
 
 #endif /* CONFIG_COMP_MUX */
@@ -0,0 +1,80 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2019 Intel Corporation. All rights reserved.
+ */
+
+/**
+ * \file include/sof/audio/pcm_converter.h
+ * \brief PCM sample format converters used by endpoint DMA copies
+ */
+
+#ifndef __SOF_AUDIO_PCM_CONVERTER_H__
+#define __SOF_AUDIO_PCM_CONVERTER_H__
+
+#include <ipc/stream.h>
+#include <stdint.h>
+
+struct comp_buffer;
+
+/**
+ * \brief Converts samples from source read to sink write position.
+ * \param[in] source Source buffer, its read position is not moved.
+ * \param[in] sink Sink buffer, its write position is not moved.
+ * \param[in] samples Number of samples to convert.
+ */
+typedef void (*pcm_converter_func)(struct comp_buffer *source,
+				   struct comp_buffer *sink,
+				   uint32_t samples);
+
+/** \brief Conversion between one pair of frame formats. */
+struct pcm_func_map {
+	uint8_t source;			/**< source frame format */
+	uint8_t sink;			/**< sink frame format */
+	pcm_converter_func func;	/**< conversion function */
+};
+
+/** \brief Conversion selected for a pair of buffers. */
+struct pcm_converter {
+	pcm_converter_func func;	/**< conversion function */
+	uint32_t source_bytes;		/**< bytes of single source sample */
+	uint32_t sink_bytes;		/**< bytes of single sink sample */
+};
+
+extern const struct pcm_func_map pcm_func_map[];
+extern const uint32_t pcm_func_count;
+
+/**
+ * \brief Selects conversion between source and sink frame formats.
+ * \param[out] conv Converter to set up.
+ * \param[in] source Source frame format.
+ * \param[in] sink Sink frame format.
+ * \return Error code, -EINVAL if formats are not supported.
+ */
+int pcm_converter_init(struct pcm_converter *conv, enum sof_ipc_frame source,
+		       enum sof_ipc_frame sink);
+
+/**
+ * \brief Converts source byte count to the matching sink byte count.
+ * \param[in] conv Converter in use.
+ * \param[in] bytes Bytes of source samples.
+ * \return Bytes of sink samples.
+ */
+static inline uint32_t pcm_sink_bytes(const struct pcm_converter *conv,
+				      uint32_t bytes)
+{
+	return bytes / conv->source_bytes * conv->sink_bytes;
+}
+
+/**
+ * \brief Converts sink byte count to the matching source byte count.
+ * \param[in] conv Converter in use.
+ * \param[in] bytes Bytes of sink samples.
+ * \return Bytes of source samples.
+ */
+static inline uint32_t pcm_source_bytes(const struct pcm_converter *conv,
+					uint32_t bytes)
+{
+	return bytes / conv->sink_bytes * conv->source_bytes;
+}
+
+#endif /* __SOF_AUDIO_PCM_CONVERTER_H__ */
@@ -66,6 +66,14 @@ struct ipc;
 #define PPL_DIR_DOWNSTREAM	0
 #define PPL_DIR_UPSTREAM	1
 
+/*
+ * Entry of a compiled pipeline copy schedule.
+ */
+struct pipeline_sched_entry {
+	struct comp_dev *comp;		/* component to copy */
+	uint32_t next;			/* next entry on PPL_STATUS_PATH_STOP */
+};
+
 /*
  * Audio pipeline.
  */
@@ -79,6 +87,12 @@ struct pipeline {
 	/* scheduling */
 	struct task *pipe_task;		/* pipeline processing task */
 
+	/* flat copy schedule, rebuilt on topology or state changes */
+	struct pipeline_sched_entry *sched_list;
+	uint32_t sched_count;		/* number of valid entries */
+	uint32_t sched_size;		/* number of allocated entries */
+	bool sched_valid;		/* schedule matches current graph */
+
 	/* component that drives scheduling in this pipe */
 	struct comp_dev *sched_comp;
 	/* source component for this pipe */
@@ -88,6 +102,16 @@ struct pipeline {
 
 	/* position update */
 	uint32_t posn_offset;		/* position update array offset*/
+
+	/* cpu budget */
+	uint32_t cost_hz;		/* measured copy cycles per second */
+	uint32_t demand_hz;		/* charged to the core while active */
+	uint32_t placed_hz;		/* charged to the core placement */
+	bool core_auto;			/* core is chosen by firmware */
+
+	/* sample memory of the buffers inside this pipeline */
+	void *arena;
+	uint32_t arena_size;		/* arena size in bytes */
 };
 
 /* static pipeline */
@@ -100,6 +124,13 @@ static inline bool pipeline_is_same_sched_comp(struct pipeline *current,
 	return current->sched_comp == previous->sched_comp;
 }
 
+/* marks compiled copy schedule as stale */
+static inline void pipeline_schedule_invalidate(struct pipeline *p)
+{
+	if (p)
+		p->sched_valid = false;
+}
+
 /* checks if pipeline is scheduled with timer */
 static inline bool pipeline_is_timer_driven(struct pipeline *p)
 {
@@ -151,6 +182,9 @@ int init_static_pipeline(struct ipc *ipc);
 /* pipeline creation */
 int init_pipeline(void);
 
+/* compile flat copy schedule for this pipeline */
+int pipeline_schedule_build(struct pipeline *p);
+
 /* schedule a copy operation for this pipeline */
 void pipeline_schedule_copy(struct pipeline *p, uint64_t start);
 void pipeline_schedule_cancel(struct pipeline *p);
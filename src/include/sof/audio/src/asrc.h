@@ -0,0 +1,65 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2019 Intel Corporation. All rights reserved.
+ */
+
+#ifndef __SOF_AUDIO_SRC_ASRC_H__
+#define __SOF_AUDIO_SRC_ASRC_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct comp_buffer;
+
+/* Fractional delay filter, see tools/tune/src/asrc_generate.m */
+#define ASRC_TAPS		32
+#define ASRC_PHASES_SHIFT	6
+#define ASRC_PHASES		(1 << ASRC_PHASES_SHIFT)
+
+/* Q32.32 position of one input sample */
+#define ASRC_ONE		(1ULL << 32)
+
+/* Conversion ratio adjust limit, 2% in Q1.31 */
+#define ASRC_DRIFT_MAX		42949673
+
+/* Fill level feedback loop gains as right shifts of the level error in
+ * periods. The smoothing and the integral term are matched for critical
+ * damping, time constant is about 2^ASRC_KP_SHIFT periods.
+ */
+#define ASRC_SMOOTH_SHIFT	3
+#define ASRC_KP_SHIFT		8
+#define ASRC_KI_SHIFT		18
+
+struct asrc_state {
+	int nch;
+	int frame_fmt;
+	int wp; /* History write index */
+	uint64_t phase; /* Q32.32 time of next output from history */
+	uint64_t step_nominal; /* Q32.32 fs_in / fs_out */
+	uint64_t step; /* Q32.32 drift adjusted step */
+	int32_t drift; /* Q1.31 relative ratio adjust */
+	int32_t integ; /* Q1.31 integral term of drift */
+	int32_t level; /* Q8.24 smoothed level error in periods */
+	int period; /* Source frames per period */
+	int target; /* Source fill level set point in frames */
+	int32_t *hist; /* Per channel mirrored history, Q1.31 */
+};
+
+size_t asrc_hist_size(int nch);
+
+int asrc_init(struct asrc_state *asrc, int fs_in, int fs_out, int nch,
+	      int frame_fmt, int period, int32_t *hist);
+
+void asrc_update(struct asrc_state *asrc, int level);
+
+void asrc_process(struct asrc_state *asrc, struct comp_buffer *source,
+		  struct comp_buffer *sink, int frames_in, int frames_out,
+		  int *n_read, int *n_written);
+
+/* Returns the drift estimate in parts per million */
+static inline int32_t asrc_drift_ppm(struct asrc_state *asrc)
+{
+	return ((int64_t)asrc->integ * 1000000) >> 31;
+}
+
+#endif /* __SOF_AUDIO_SRC_ASRC_H__ */
@@ -11,6 +11,9 @@
 #include <stddef.h>
 #include <stdint.h>
 
+struct src_design;
+struct src_stage;
+
 struct src_param {
 	int fir_s1;
 	int fir_s2;
@@ -23,9 +26,10 @@ struct src_param {
 	int blk_out;
 	int stage1_times;
 	int stage2_times;
-	int idx_in;
-	int idx_out;
 	int nch;
+	struct src_stage *stage1;
+	struct src_stage *stage2;
+	struct src_design *design; /* Set if the stages are designed */
 };
 
 struct src_stage {
@@ -0,0 +1,50 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2019 Intel Corporation. All rights reserved.
+ */
+
+#ifndef __SOF_AUDIO_SRC_SRC_DESIGN_H__
+#define __SOF_AUDIO_SRC_SRC_DESIGN_H__
+
+#include <sof/audio/src/src.h>
+#include <sof/list.h>
+#include <stddef.h>
+
+/* Number of unused designs kept for the next prepare */
+#define SRC_DESIGN_CACHE_SIZE	4
+
+/* Longest designed filter per stage */
+#define SRC_DESIGN_MAX_TAPS	4096
+
+/* Blackman window transition band width times filter length relative to
+ * the interpolated rate, gives about 74 dB stop band attenuation.
+ */
+#define SRC_DESIGN_TW_Q8	1440 /* 5.625 in Q24.8 */
+
+/* Gain at 0 Hz in Q1.31, -1 dB for single stage and -0.5 dB per stage for
+ * two stages as in tools/tune/src/src_param.m.
+ */
+#define SRC_DESIGN_GAIN_1S	1913946816
+#define SRC_DESIGN_GAIN_2S	2027355295
+
+/* Conversion designed at runtime for an in/out rate pair. The stages are
+ * compatible with the built-in tables of tools/tune/src/src_generate.m.
+ */
+struct src_design {
+	struct list_item list;
+	int fs_in;
+	int fs_out;
+	int refs;
+	struct src_stage *stage1;
+	struct src_stage *stage2;
+	void *coefs;
+	size_t coefs_size;	/* coefficients size in bytes */
+};
+
+void src_design_init(void);
+
+struct src_design *src_design_get(int fs_in, int fs_out);
+
+void src_design_put(struct src_design *design);
+
+#endif /* __SOF_AUDIO_SRC_SRC_DESIGN_H__ */
@@ -18,7 +18,7 @@
 
 #include <sof/audio/component.h>
 #include <sof/bit.h>
-#include <sof/schedule/task.h>
+#include <sof/math/numbers.h>
 #include <sof/trace/trace.h>
 #include <ipc/stream.h>
 #include <user/trace.h>
@@ -57,22 +57,6 @@ struct sof_ipc_ctrl_value_chan;
 //** \brief Volume gain Qx.y fractional y number of bits. */
 #define VOL_QXY_Y 16
 
-/**
- * \brief Volume ramp update rate in microseconds.
- * Update volume gain value every 1 ms.
- */
-#define VOL_RAMP_UPDATE_US 1000
-
-/**
- * \brief Macro for volume linear gain ramp step computation
- * Volume gain ramp step as Q1.16 is computed with equation
- * step = VOL_RAMP_STEP_CONST/ SOF_TKN_VOLUME_RAMP_STEP_MS. This
- * macro defines as Q1.16 value the constant term
- * (1000 / VOL_RAMP_UPDATE) for step calculation.
- */
-#define VOL_RAMP_STEP_CONST \
-	Q_CONVERT_FLOAT(1000.0 / VOL_RAMP_UPDATE_US, VOL_QXY_Y)
-
 /**
  * \brief Volume maximum value.
  * TODO: This should be 1 << (VOL_QX_BITS + VOL_QY_BITS - 1) - 1 but
@@ -86,21 +70,30 @@ struct sof_ipc_ctrl_value_chan;
 /** \brief Volume minimum value. */
 #define VOL_MIN		0
 
+/** \brief Frames processed at one gain by block ramping functions. */
+#define VOL_RAMP_BLOCK	16
+
 /**
  * \brief Volume component private data.
  *
  * Gain amplitude value is between 0 (mute) ... 2^16 (0dB) ... 2^24 (~+48dB).
  */
 struct comp_data {
-	struct task volwork;		/**< volume scheduled work function */
 	struct sof_ipc_ctrl_value_chan *hvol;	/**< host volume readback */
 	int32_t volume[SOF_IPC_MAX_CHANNELS];	/**< current volume */
 	int32_t tvolume[SOF_IPC_MAX_CHANNELS];	/**< target volume */
+	int32_t pvolume[SOF_IPC_MAX_CHANNELS];	/**< pending target volume */
 	int32_t mvolume[SOF_IPC_MAX_CHANNELS];	/**< mute volume */
-	int32_t ramp_increment[SOF_IPC_MAX_CHANNELS]; /**< for linear ramp */
+	int32_t rvolume[SOF_IPC_MAX_CHANNELS];	/**< ramp start volume */
+	int32_t ramp_increment[SOF_IPC_MAX_CHANNELS]; /**< per frame step */
 	int32_t vol_min;			/**< minimum volume */
 	int32_t vol_max;			/**< maximum volume */
 	int32_t	vol_ramp_range;			/**< max ramp transition */
+	uint32_t ramp_pos;			/**< frames into ramp */
+	uint32_t ramp_len;			/**< ramp length in frames */
+	int ramp_active;			/**< gain is ramping */
+	int ramp_pending;			/**< new targets for copy */
+	int passthrough;			/**< unity gain, copy only */
 	enum sof_ipc_frame source_format;	/**< source frame format */
 	enum sof_ipc_frame sink_format;		/**< sink frame format */
 	/**< volume processing function */
@@ -148,4 +141,33 @@ static inline scale_vol vol_get_processing_function(struct comp_dev *dev)
 	return NULL;
 }
 
+/**
+ * \brief Gets number of frames to process at one gain.
+ * \param[in] cd Volume component private data.
+ * \param[in] frames Number of frames left to process.
+ * \return Number of frames in the next block.
+ */
+static inline uint32_t vol_ramp_block_frames(struct comp_data *cd,
+					     uint32_t frames)
+{
+	return cd->ramp_active ? MIN(frames, VOL_RAMP_BLOCK) : frames;
+}
+
+/**
+ * \brief Steps ramping channel gains over a block of frames.
+ * \param[in,out] cd Volume component private data.
+ * \param[in] channels Number of channels.
+ * \param[in] frames Number of frames in the block.
+ *
+ * Used by processing functions that hold the gain over a block of frames.
+ */
+static inline void vol_ramp_block(struct comp_data *cd, uint32_t channels,
+				  uint32_t frames)
+{
+	uint32_t i;
+
+	for (i = 0; i < channels; i++)
+		cd->volume[i] += cd->ramp_increment[i] * (int32_t)frames;
+}
+
 #endif /* __SOF_AUDIO_VOLUME_H__ */
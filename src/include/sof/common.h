@@ -30,6 +30,9 @@
 
 #define __aligned(x) __attribute__((__aligned__(x)))
 
+/* tell the compiler a pointer into a packed struct is aligned to a */
+#define ASSUME_ALIGNED(x, a) ((typeof(x))__builtin_assume_aligned((x), (a)))
+
 #define ffs(i) __builtin_ffs(i)
 #define ffsl(i) __builtin_ffsl(i)
 #define ffsll(i) __builtin_ffsll(i)
@@ -9,6 +9,7 @@
 #ifndef __SOF_DRIVERS_IPC_H__
 #define __SOF_DRIVERS_IPC_H__
 
+#include <sof/atomic.h>
 #include <sof/list.h>
 #include <sof/platform.h>
 #include <sof/schedule/task.h>
@@ -17,6 +18,7 @@
 #include <sof/trace/trace.h>
 #include <ipc/header.h>
 #include <user/trace.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 struct comp_buffer;
@@ -42,12 +44,25 @@ struct sof_ipc_stream_posn;
 #define trace_ipc_error(format, ...) \
 	trace_error(TRACE_CLASS_IPC, format, ##__VA_ARGS__)
 
-#define MSG_QUEUE_SIZE		12
+/* outbound notifications queued per core, no less than the old shared
+ * pool of 12 messages, must be power of 2
+ */
+#define IPC_MSG_RING_SIZE	16
+
+/* coalescing index entries per core, must be power of 2 */
+#define IPC_MSG_INDEX_SIZE	16
+
+/* largest notification payload, covers stream position and events */
+#define IPC_MSG_DATA_SIZE	128
 
 #define COMP_TYPE_COMPONENT	1
 #define COMP_TYPE_BUFFER	2
 #define COMP_TYPE_PIPELINE	3
 
+/* component ID and pipeline ID index sizes, must be power of 2 */
+#define IPC_COMP_HASH_SIZE	64
+#define IPC_PPL_HASH_SIZE	16
+
 /* validates internal non tail structures within IPC command structure */
 #define IPC_IS_SIZE_INVALID(object)					\
 	object.hdr.size == sizeof(object) ? 0 : 1
@@ -61,6 +76,8 @@ struct sof_ipc_stream_posn;
 struct ipc_comp_dev {
 	uint16_t type;	/* COMP_TYPE_ */
 	uint16_t state;
+	uint32_t id;		/* component, buffer or pipeline ID */
+	uint32_t ppl_id;	/* owning pipeline ID */
 
 	/* component type data */
 	union {
@@ -71,27 +88,40 @@ struct ipc_comp_dev {
 
 	/* lists */
 	struct list_item list;		/* list in components */
+	struct list_item hash;		/* list in ID index bucket */
+	struct list_item ppl_list;	/* list in pipeline ID index bucket */
 };
 
 struct ipc_msg {
 	uint32_t header;	/* specific to platform */
 	uint32_t tx_size;	/* payload size in bytes */
-	uint8_t tx_data[SOF_IPC_MSG_MAX_SIZE];	/* pointer to payload data */
-	uint32_t rx_size;	/* payload size in bytes */
-	uint8_t rx_data[SOF_IPC_MSG_MAX_SIZE];	/* pointer to payload data */
-	struct list_item list;
-	void (*cb)(void *cb_data, void *mailbox_data);
-	void *cb_data;
+	uint32_t comp_id;	/* coalescing key together with header */
+	atomic_t seq;		/* odd while the payload is rewritten */
+	atomic_t claimed;	/* set once the sender picked it up */
+	uint8_t tx_data[IPC_MSG_DATA_SIZE];	/* payload data */
+};
+
+/*
+ * Single producer single consumer ring of notifications. Only the owning
+ * core advances head and only the master core sending to host advances
+ * tail, so queueing needs no lock shared between cores.
+ */
+struct ipc_msg_ring {
+	atomic_t head;		/* next free message */
+	atomic_t tail;		/* next message to send */
+	uint32_t index[IPC_MSG_INDEX_SIZE];	/* key hash to head + 1 */
+	struct ipc_msg msg[IPC_MSG_RING_SIZE];
 };
 
 struct ipc_shared_context {
-	struct ipc_msg *dsp_msg;	/* current message to host */
-	uint32_t dsp_pending;
-	struct list_item msg_list;
-	struct list_item empty_list;
-	struct ipc_msg message[MSG_QUEUE_SIZE];
+	struct ipc_msg_ring ring[PLATFORM_CORE_COUNT];	/* to host per core */
+	uint32_t tx_core;	/* ring to look at first when sending */
 
 	struct list_item comp_list;	/* list of component devices */
+
+	/* component devices indexed by ID and by pipeline ID */
+	struct list_item comp_hash[IPC_COMP_HASH_SIZE];
+	struct list_item ppl_hash[IPC_PPL_HASH_SIZE];
 };
 
 struct ipc {
@@ -158,6 +188,9 @@ int ipc_stream_send_xrun(struct comp_dev *cdev,
 int ipc_queue_host_message(struct ipc *ipc, uint32_t header, void *tx_data,
 			   size_t tx_bytes, uint32_t replace);
 
+bool ipc_msg_pending(struct ipc *ipc);
+bool ipc_msg_tx_next(struct ipc *ipc, uint32_t *header);
+
 void ipc_platform_send_msg(struct ipc *ipc);
 
 /**
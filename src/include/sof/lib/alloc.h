@@ -71,12 +71,28 @@ struct block_map {
 	uint16_t free_count;	/* number of free blocks */
 	uint16_t first_free;	/* index of first free block */
 	struct block_hdr *block;	/* base block header */
+	uint32_t *used_mask;	/* bitmap of used blocks, bit set when used */
 	uint32_t base;		/* base address of space */
 } __aligned(PLATFORM_DCACHE_ALIGN);
 
+/* number of 32 bit words in used blocks bitmap, never zero */
+#define BLOCK_MASK_WORDS(cnt)	((cnt) / 32 + 1)
+
+/* bitmap storage in bytes, whole cache lines like the block headers */
+#define BLOCK_MASK_SIZE(cnt) \
+	ALIGN_UP(BLOCK_MASK_WORDS(cnt) * sizeof(uint32_t), \
+		 PLATFORM_DCACHE_ALIGN)
+
+/* the bitmap storage is a file scope compound literal, so it has static
+ * storage duration and starts with all blocks free. It's wrapped in a
+ * cache line aligned struct, so cache operations on it never touch
+ * other objects.
+ */
 #define BLOCK_DEF(sz, cnt, hdr) \
 	{.block_size = sz, .count = cnt, .free_count = cnt, .block = hdr, \
-	 .first_free = 0}
+	 .first_free = 0, \
+	 .used_mask = ((struct { uint32_t w[BLOCK_MASK_WORDS(cnt)]; } \
+			__aligned(PLATFORM_DCACHE_ALIGN)) { { 0 } }).w }
 
 struct mm_heap {
 	uint32_t blocks;
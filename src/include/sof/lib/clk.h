@@ -37,6 +37,21 @@ extern struct freq_table *cpu_freq;
 
 extern struct freq_table *ssp_freq;
 
+static inline uint32_t clock_get_nearest_freq_idx(const struct freq_table *tab,
+						  uint32_t size, uint32_t hz)
+{
+	uint32_t i;
+
+	/* find lowest available frequency that is >= requested hz */
+	for (i = 0; i < size; i++) {
+		if (hz <= tab[i].freq)
+			return i;
+	}
+
+	/* not found, so return max frequency */
+	return size - 1;
+}
+
 uint32_t clock_get_freq(int clock);
 
 void clock_set_freq(int clock, uint32_t hz);
@@ -0,0 +1,128 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2019 Intel Corporation. All rights reserved.
+ */
+
+/**
+ * \file include/sof/lib/cpu_budget.h
+ * \brief Per core CPU budget and pipeline admission control
+ */
+
+#ifndef __SOF_LIB_CPU_BUDGET_H__
+#define __SOF_LIB_CPU_BUDGET_H__
+
+#include <sof/lib/cpu.h>
+#include <config.h>
+#include <errno.h>
+#include <stdint.h>
+
+struct pipeline;
+struct sof_ipc_pm_core_load_elem;
+
+/** \brief Percentage of the max CPU frequency pipelines may use. */
+#define CPU_BUDGET_LIMIT	90
+
+/** \brief Decay of the measured pipeline cost per period, as shift. */
+#define CPU_BUDGET_DECAY_SHIFT	4
+
+/** \brief CPU load of one core. */
+struct cpu_budget {
+	uint32_t budget_hz;	/**< cycles per second for pipelines */
+	uint32_t load_hz;	/**< demand of active pipelines */
+	uint32_t num_pipelines;	/**< number of active pipelines */
+	uint32_t placed_hz;	/**< demand of all pipelines on the core */
+};
+
+#if CONFIG_CPU_BUDGET
+
+void cpu_budget_init(void);
+
+/**
+ * \brief Returns demand pipeline adds to its core when started.
+ * \param[in] p Pipeline to start.
+ * \return Cycles per second, 0 if pipeline is already active.
+ */
+uint32_t cpu_budget_need(struct pipeline *p);
+
+/**
+ * \brief Checks if pipelines fit the core before they're started.
+ * \param[in] p Pipeline the trigger is sent to.
+ * \param[in] demand_hz Summed need of all pipelines the trigger starts.
+ * \return 0 if they fit, -EBUSY otherwise.
+ */
+int cpu_budget_admit(struct pipeline *p, uint32_t demand_hz);
+
+/** \brief Adds pipeline demand to the load of this core. */
+void cpu_budget_start(struct pipeline *p);
+
+/** \brief Removes pipeline demand from the load of this core. */
+void cpu_budget_stop(struct pipeline *p);
+
+/** \brief Returns time stamp for measuring pipeline copy. */
+uint64_t cpu_budget_time(void);
+
+/**
+ * \brief Updates measured pipeline cost after copy.
+ * \param[in,out] p Pipeline that has been copied.
+ * \param[in] start Time stamp taken before the copy.
+ */
+void cpu_budget_account(struct pipeline *p, uint64_t start);
+
+/**
+ * \brief Reports load of selected core.
+ * \param[in] core Core id.
+ * \param[out] elem Load report to fill.
+ * \return Error code.
+ */
+int cpu_budget_get(int core, struct sof_ipc_pm_core_load_elem *elem);
+
+/** \brief Adds pipeline demand to its core placement, on master core. */
+void cpu_budget_place(struct pipeline *p);
+
+/** \brief Removes pipeline demand from its core placement. */
+void cpu_budget_unplace(struct pipeline *p);
+
+/**
+ * \brief Selects the least loaded enabled core for pipeline.
+ * \param[in] p Pipeline to place, its current core wins ties.
+ * \return Core id.
+ */
+int cpu_budget_pick_core(struct pipeline *p);
+
+#else
+
+static inline void cpu_budget_init(void) { }
+
+static inline uint32_t cpu_budget_need(struct pipeline *p) { return 0; }
+
+static inline int cpu_budget_admit(struct pipeline *p, uint32_t demand_hz)
+{
+	return 0;
+}
+
+static inline void cpu_budget_start(struct pipeline *p) { }
+
+static inline void cpu_budget_stop(struct pipeline *p) { }
+
+static inline uint64_t cpu_budget_time(void) { return 0; }
+
+static inline void cpu_budget_account(struct pipeline *p, uint64_t start) { }
+
+static inline int cpu_budget_get(int core,
+				 struct sof_ipc_pm_core_load_elem *elem)
+{
+	return -EINVAL;
+}
+
+static inline void cpu_budget_place(struct pipeline *p) { }
+
+static inline void cpu_budget_unplace(struct pipeline *p) { }
+
+static inline int cpu_budget_pick_core(struct pipeline *p)
+{
+	return PLATFORM_MASTER_CORE_ID;
+}
+
+#endif
+
+#endif /* __SOF_LIB_CPU_BUDGET_H__ */
@@ -27,6 +27,7 @@
 #include <stdint.h>
 
 struct comp_buffer;
+struct pcm_converter;
 
 /** \addtogroup sof_dma_drivers DMA Drivers
  *  DMA Drivers API specification.
@@ -508,15 +509,19 @@ static inline uint32_t dma_sg_get_size(struct dma_sg_elem_array *ea)
 	return size;
 }
 
-/* copies data from DMA buffer using provided processing function */
+/*
+ * copies bytes of data from DMA buffer, converting them to the format of
+ * sink buffer with provided converter
+ */
 void dma_buffer_copy_from(struct comp_buffer *source, struct comp_buffer *sink,
-	void (*process)(struct comp_buffer *, struct comp_buffer *, uint32_t),
-	uint32_t bytes);
+			  const struct pcm_converter *conv, uint32_t bytes);
 
-/* copies data to DMA buffer using provided processing function */
+/*
+ * fills bytes of DMA buffer, converting data from the format of source
+ * buffer with provided converter
+ */
 void dma_buffer_copy_to(struct comp_buffer *source, struct comp_buffer *sink,
-	void (*process)(struct comp_buffer *, struct comp_buffer *, uint32_t),
-	uint32_t bytes);
+			const struct pcm_converter *conv, uint32_t bytes);
 
 /* generic DMA DSP <-> Host copier */
 
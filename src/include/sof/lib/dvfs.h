@@ -0,0 +1,120 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2019 Intel Corporation. All rights reserved.
+ */
+
+/**
+ * \file include/sof/lib/dvfs.h
+ * \brief Load driven CPU frequency governor
+ */
+
+#ifndef __SOF_LIB_DVFS_H__
+#define __SOF_LIB_DVFS_H__
+
+#include <sof/lib/clk.h>
+#include <ipc/topology.h>
+#include <config.h>
+#include <stdint.h>
+
+/** \brief Percentage of the demand kept free above it. */
+#define DVFS_HEADROOM		25
+
+/** \brief Additional percentage of free cycles needed to step down. */
+#define DVFS_HYSTERESIS		15
+
+/** \brief Number of load windows the demand must stay low to step down. */
+#define DVFS_DOWN_WINDOWS	4
+
+/** \brief Length of the load measurement window in milliseconds. */
+#define DVFS_WINDOW_MS		20
+
+/** \brief Governor state of one core. */
+struct dvfs_gov {
+	const struct freq_table *tab;	/**< frequencies in ascending order */
+	uint32_t tab_size;		/**< number of table entries */
+	uint32_t idx;			/**< selected table entry */
+	uint32_t down_windows;		/**< windows spent below down target */
+	uint32_t pipe_hz;		/**< declared by active pipelines */
+	uint32_t load_hz;		/**< measured in the last window */
+	uint64_t busy;			/**< LL time in the current window */
+	uint64_t window_start;		/**< start of the current window */
+};
+
+/**
+ * \brief Converts declared pipeline work into CPU cycles per second.
+ * \param[in] pipe Pipeline descriptor.
+ * \return Cycles per second, assuming one instruction per cycle.
+ */
+static inline uint32_t dvfs_pipeline_hz(const struct sof_ipc_pipe_new *pipe)
+{
+	uint64_t hz;
+
+	if (!pipe->period)
+		return 0;
+
+	hz = (uint64_t)pipe->period_mips * 1000000 / pipe->period;
+
+	return hz > UINT32_MAX ? UINT32_MAX : hz;
+}
+
+/**
+ * \brief Initializes governor with frequency table.
+ * \param[out] gov Governor to set up.
+ * \param[in] tab Frequency table in ascending order.
+ * \param[in] size Number of table entries.
+ * \param[in] hz Current frequency.
+ */
+void dvfs_gov_init(struct dvfs_gov *gov, const struct freq_table *tab,
+		   uint32_t size, uint32_t hz);
+
+/**
+ * \brief Stores CPU load measured over one window.
+ * \param[in,out] gov Governor.
+ * \param[in] busy Time spent in LL ticks during the window.
+ * \param[in] elapsed Window length, in the same time base as busy.
+ */
+void dvfs_gov_load(struct dvfs_gov *gov, uint64_t busy, uint64_t elapsed);
+
+/**
+ * \brief Steps frequency up if the demand no longer fits.
+ * \param[in,out] gov Governor.
+ * \return Selected table entry.
+ */
+uint32_t dvfs_gov_raise(struct dvfs_gov *gov);
+
+/**
+ * \brief Selects table entry at the end of a load window.
+ *
+ * Steps up immediately, steps down only after the demand has stayed
+ * below the lower entry with extra hysteresis for DVFS_DOWN_WINDOWS.
+ *
+ * \param[in,out] gov Governor.
+ * \return Selected table entry.
+ */
+uint32_t dvfs_gov_select(struct dvfs_gov *gov);
+
+#if CONFIG_DVFS
+
+void dvfs_init(void);
+
+void dvfs_pipeline_start(const struct sof_ipc_pipe_new *pipe);
+
+void dvfs_pipeline_stop(const struct sof_ipc_pipe_new *pipe);
+
+void dvfs_ll_tick(uint64_t start, uint64_t end);
+
+#else
+
+static inline void dvfs_init(void) { }
+
+static inline void
+dvfs_pipeline_start(const struct sof_ipc_pipe_new *pipe) { }
+
+static inline void
+dvfs_pipeline_stop(const struct sof_ipc_pipe_new *pipe) { }
+
+static inline void dvfs_ll_tick(uint64_t start, uint64_t end) { }
+
+#endif
+
+#endif /* __SOF_LIB_DVFS_H__ */
@@ -18,16 +18,20 @@ struct sof;
 #define NOTIFIER_TARGET_CORE_MASK(x)	(1 << x)
 #define NOTIFIER_TARGET_CORE_ALL_MASK	0xFFFFFFFF
 
+/* largest event payload, other cores get a copy of it */
+#define NOTIFIER_DATA_MAX_SIZE	16
+
 enum notify_id {
 	NOTIFIER_ID_CPU_FREQ = 0,
 	NOTIFIER_ID_SSP_FREQ,
 	NOTIFIER_ID_KPB_CLIENT_EVT,
 	NOTIFIER_ID_DMA_DOMAIN_CHANGE,
+	NOTIFIER_ID_COUNT,
 };
 
 struct notify {
 	spinlock_t *lock;	/* notifier lock */
-	struct list_item list;	/* list of notifiers */
+	struct list_item list[NOTIFIER_ID_COUNT];	/* notifiers by ID */
 };
 
 struct notify_data {
@@ -54,7 +58,7 @@ void notifier_register(struct notifier *notifier);
 void notifier_unregister(struct notifier *notifier);
 
 void notifier_notify(void);
-void notifier_event(struct notify_data *notify_data);
+int notifier_event(struct notify_data *notify_data);
 
 void init_system_notify(struct sof *sof);
 
@@ -0,0 +1,42 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2019 Intel Corporation. All rights reserved.
+ */
+
+#ifndef __SOF_MATH_FFT_H__
+#define __SOF_MATH_FFT_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define FFT_SIZE_MIN	4
+#define FFT_SIZE_MAX	1024
+
+/* Complex number with Q1.31 real and imaginary parts */
+struct icomplex32 {
+	int32_t real;
+	int32_t imag;
+};
+
+/* Radix-2 FFT plan, the twiddles and bit reverse indices are computed
+ * once in fft_plan_init() into caller provided memory.
+ */
+struct fft_plan {
+	uint32_t size; /* Number of FFT points, power of two */
+	uint32_t len; /* log2(size) */
+	struct icomplex32 *twiddle; /* size / 2 twiddles exp(-j2pi k/size) */
+	uint16_t *bit_reverse_idx; /* Bit reversed index of every point */
+};
+
+size_t fft_plan_data_size(uint32_t size);
+
+int fft_plan_init(struct fft_plan *plan, void *data, uint32_t size);
+
+/* In place FFT of size points. The forward transform is scaled by
+ * 1 / size so it can't overflow, the inverse transform is not scaled and
+ * saturates. An inverse after a forward transform returns the input.
+ */
+void fft_execute_32(struct fft_plan *plan, struct icomplex32 *buf, bool ifft);
+
+#endif /* __SOF_MATH_FFT_H__ */
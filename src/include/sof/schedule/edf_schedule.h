@@ -28,8 +28,19 @@
 
 #define edf_sch_get_pdata(task) task->private
 
+/* heaps of queued tasks in the EDF scheduler */
+enum edf_heap_id {
+	EDF_HEAP_READY = 0,	/* by priority and deadline */
+	EDF_HEAP_LATE,		/* non idle tasks by deadline */
+	EDF_HEAP_COUNT,
+};
+
+/* task not queued in the heap */
+#define EDF_HEAP_NONE	UINT32_MAX
+
 struct edf_task_pdata {
 	uint64_t deadline;
+	uint32_t heap_idx[EDF_HEAP_COUNT];	/* position in each heap */
 	void *ctx;
 };
 
@@ -124,6 +124,12 @@ static inline bool domain_is_pending(struct ll_schedule_domain *domain,
 	return domain->ops->domain_is_pending(domain, task);
 }
 
+/* tasks of domains without is_pending are pending on their start time */
+static inline bool domain_is_timed(struct ll_schedule_domain *domain)
+{
+	return !domain->ops->domain_is_pending;
+}
+
 struct ll_schedule_domain *timer_domain_init(struct timer *timer, int clk,
 					     uint64_t timeout);
 
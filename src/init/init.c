@@ -14,6 +14,7 @@
 #include <sof/init.h>
 #include <sof/lib/alloc.h>
 #include <sof/lib/cpu.h>
+#include <sof/lib/cpu_budget.h>
 #include <sof/lib/memory.h>
 #include <sof/lib/notifier.h>
 #include <sof/lib/pm_runtime.h>
@@ -54,6 +55,8 @@ int master_core_init(struct sof *sof)
 	trace_point(TRACE_BOOT_SYS_POWER);
 	pm_runtime_init();
 
+	cpu_budget_init();
+
 	/* Turn off memory for all unused cores */
 	for (i = 0; i < PLATFORM_CORE_COUNT; i++)
 		if (i != PLATFORM_MASTER_CORE_ID)
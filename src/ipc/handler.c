@@ -12,6 +12,7 @@
  *
  */
 
+#include <sof/atomic.h>
 #include <sof/audio/buffer.h>
 #include <sof/audio/component.h>
 #include <sof/audio/pipeline.h>
@@ -25,6 +26,7 @@
 #include <sof/lib/alloc.h>
 #include <sof/lib/cache.h>
 #include <sof/lib/cpu.h>
+#include <sof/lib/cpu_budget.h>
 #include <sof/lib/dai.h>
 #include <sof/lib/dma.h>
 #include <sof/lib/mailbox.h>
@@ -413,7 +415,7 @@ int ipc_stream_send_position(struct comp_dev *cdev,
 
 	mailbox_stream_write(cdev->pipeline->posn_offset, posn, sizeof(*posn));
 	return ipc_queue_host_message(_ipc, posn->rhdr.hdr.cmd, posn,
-				      sizeof(*posn), 0);
+				      sizeof(*posn), 1);
 }
 
 /* send component notification */
@@ -665,6 +667,34 @@ static int ipc_pm_core_enable(uint32_t header)
 	return 0;
 }
 
+static int ipc_pm_core_load(uint32_t header)
+{
+	struct sof_ipc_pm_core_load reply;
+	struct sof_ipc_pm_core_load_elem elem;
+	int ret;
+	int i;
+
+	trace_ipc("ipc: pm -> core load");
+
+	/* elements follow the reply header in the outbox */
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
+		ret = cpu_budget_get(i, &elem);
+		if (ret < 0)
+			return ret;
+
+		mailbox_hostbox_write(sizeof(reply) + i * sizeof(elem), &elem,
+				      sizeof(elem));
+	}
+
+	reply.rhdr.hdr.size = sizeof(reply) + PLATFORM_CORE_COUNT *
+			      sizeof(elem);
+	reply.rhdr.hdr.cmd = header;
+	reply.rhdr.error = 0;
+	reply.num_elems = PLATFORM_CORE_COUNT;
+	mailbox_hostbox_write(0, &reply, sizeof(reply));
+	return 1;
+}
+
 static int ipc_glb_pm_message(uint32_t header)
 {
 	uint32_t cmd = iCS(header);
@@ -678,6 +708,8 @@ static int ipc_glb_pm_message(uint32_t header)
 		return ipc_pm_context_size(header);
 	case SOF_IPC_PM_CORE_ENABLE:
 		return ipc_pm_core_enable(header);
+	case SOF_IPC_PM_CORE_LOAD:
+		return ipc_pm_core_load(header);
 	case SOF_IPC_PM_CLK_SET:
 	case SOF_IPC_PM_CLK_GET:
 	case SOF_IPC_PM_CLK_REQ:
@@ -1142,155 +1174,10 @@ out:
 	}
 }
 
-/* locks held by caller */
-static inline struct ipc_msg *msg_get_empty(struct ipc *ipc)
-{
-	struct ipc_msg *msg = NULL;
-
-	if (!list_is_empty(&ipc->shared_ctx->empty_list)) {
-		msg = list_first_item(&ipc->shared_ctx->empty_list,
-				      struct ipc_msg, list);
-		list_item_del(&msg->list);
-	}
-
-	return msg;
-}
-
-static inline struct ipc_msg *ipc_glb_stream_message_find(struct ipc *ipc,
-	struct sof_ipc_stream_posn *posn)
-{
-	struct list_item *plist;
-	struct ipc_msg *msg = NULL;
-	struct sof_ipc_stream_posn *old_posn = NULL;
-	uint32_t cmd;
-
-	/* Check whether the command is expected */
-	cmd = iCS(posn->rhdr.hdr.cmd);
-
-	switch (cmd) {
-	case SOF_IPC_STREAM_TRIG_XRUN:
-	case SOF_IPC_STREAM_POSITION:
-
-		/* iterate host message list for searching */
-		list_for_item(plist, &ipc->shared_ctx->msg_list) {
-			msg = container_of(plist, struct ipc_msg, list);
-			if (msg->header == posn->rhdr.hdr.cmd) {
-				old_posn = (struct sof_ipc_stream_posn *)
-					   msg->tx_data;
-				if (old_posn->comp_id == posn->comp_id)
-					return msg;
-			}
-		}
-		break;
-	default:
-		break;
-	}
-
-	/* no match */
-	return NULL;
-}
-
-static inline struct ipc_msg *ipc_glb_trace_message_find(struct ipc *ipc,
-	struct sof_ipc_dma_trace_posn *posn)
-{
-	struct list_item *plist;
-	struct ipc_msg *msg = NULL;
-	uint32_t cmd;
-
-	/* Check whether the command is expected */
-	cmd = iCS(posn->rhdr.hdr.cmd);
-
-	switch (cmd) {
-	case SOF_IPC_TRACE_DMA_POSITION:
-		/* iterate host message list for searching */
-		list_for_item(plist, &ipc->shared_ctx->msg_list) {
-			msg = container_of(plist, struct ipc_msg, list);
-			if (msg->header == posn->rhdr.hdr.cmd)
-				return msg;
-		}
-		break;
-	default:
-		break;
-	}
-
-	/* no match */
-	return NULL;
-}
-
-static inline struct ipc_msg *msg_find(struct ipc *ipc, uint32_t header,
-	void *tx_data)
-{
-	uint32_t type;
-
-	/* use different sub function for different global message type */
-	type = iGS(header);
-
-	switch (type) {
-	case SOF_IPC_GLB_STREAM_MSG:
-		return ipc_glb_stream_message_find(ipc,
-			(struct sof_ipc_stream_posn *)tx_data);
-	case SOF_IPC_GLB_TRACE_MSG:
-		return ipc_glb_trace_message_find(ipc,
-			(struct sof_ipc_dma_trace_posn *)tx_data);
-	default:
-		/* not found */
-		return NULL;
-	}
-}
-
-int ipc_queue_host_message(struct ipc *ipc, uint32_t header, void *tx_data,
-			   size_t tx_bytes, uint32_t replace)
-{
-	struct ipc_msg *msg = NULL;
-	uint32_t flags, found = 0;
-	int ret = 0;
-
-	ipc = cache_to_uncache(ipc);
-
-	spin_lock_irq(ipc->lock, flags);
-
-	/* do we need to replace an existing message? */
-	if (replace)
-		msg = msg_find(ipc, header, tx_data);
-
-	/* do we need to use a new empty message? */
-	if (msg)
-		found = 1;
-	else
-		msg = msg_get_empty(ipc);
-
-	if (msg == NULL) {
-		trace_ipc_error("ipc: msg hdr for 0x%08x not found "
-				"replace %d", header, replace);
-		ret = -EBUSY;
-		goto out;
-	}
-
-	/* prepare the message */
-	msg->header = header;
-	msg->tx_size = tx_bytes;
-
-	/* copy mailbox data to message */
-	if (tx_bytes > 0 && tx_bytes < SOF_IPC_MSG_MAX_SIZE) {
-		ret = memcpy_s(msg->tx_data, msg->tx_size, tx_data, tx_bytes);
-		assert(!ret);
-	}
-
-	if (!found) {
-		/* now queue the message */
-		ipc->shared_ctx->dsp_pending = 1;
-		list_item_append(&msg->list, &ipc->shared_ctx->msg_list);
-	}
-
-out:
-	spin_unlock_irq(ipc->lock, flags);
-	return ret;
-}
-
 /* process current message */
 int ipc_process_msg_queue(void)
 {
-	if (_ipc->shared_ctx->dsp_pending)
+	if (ipc_msg_pending(_ipc))
 		ipc_platform_send_msg(_ipc);
 	return 0;
 }
@@ -34,33 +34,49 @@
 
 /*
  * Components, buffers and pipelines all use the same set of monotonic ID
- * numbers passed in by the host. They are stored in different lists, hence
- * more than 1 list may need to be searched for the corresponding component.
+ * numbers passed in by the host. Every container is kept on the common
+ * comp_list and additionally indexed by ID and by pipeline ID, so that
+ * lookups only have to walk a single bucket.
  */
 
+static inline struct list_item *ipc_comp_bucket(struct ipc *ipc, uint32_t id)
+{
+	return &ipc->shared_ctx->comp_hash[id & (IPC_COMP_HASH_SIZE - 1)];
+}
+
+static inline struct list_item *ipc_ppl_bucket(struct ipc *ipc,
+					       uint32_t ppl_id)
+{
+	return &ipc->shared_ctx->ppl_hash[ppl_id & (IPC_PPL_HASH_SIZE - 1)];
+}
+
+static void ipc_comp_dev_add(struct ipc *ipc, struct ipc_comp_dev *icd,
+			     uint32_t id, uint32_t ppl_id)
+{
+	icd->id = id;
+	icd->ppl_id = ppl_id;
+
+	list_item_append(&icd->list, &ipc->shared_ctx->comp_list);
+	list_item_append(&icd->hash, ipc_comp_bucket(ipc, id));
+	list_item_append(&icd->ppl_list, ipc_ppl_bucket(ipc, ppl_id));
+}
+
+static void ipc_comp_dev_del(struct ipc_comp_dev *icd)
+{
+	list_item_del(&icd->list);
+	list_item_del(&icd->hash);
+	list_item_del(&icd->ppl_list);
+}
+
 struct ipc_comp_dev *ipc_get_comp_by_id(struct ipc *ipc, uint32_t id)
 {
 	struct ipc_comp_dev *icd;
 	struct list_item *clist;
 
-	list_for_item(clist, &ipc->shared_ctx->comp_list) {
-		icd = container_of(clist, struct ipc_comp_dev, list);
-		switch (icd->type) {
-		case COMP_TYPE_COMPONENT:
-			if (icd->cd->comp.id == id)
-				return icd;
-			break;
-		case COMP_TYPE_BUFFER:
-			if (icd->cb->id == id)
-				return icd;
-			break;
-		case COMP_TYPE_PIPELINE:
-			if (icd->pipeline->ipc_pipe.comp_id == id)
-				return icd;
-			break;
-		default:
-			break;
-		}
+	list_for_item(clist, ipc_comp_bucket(ipc, id)) {
+		icd = container_of(clist, struct ipc_comp_dev, hash);
+		if (icd->id == id)
+			return icd;
 	}
 
 	return NULL;
@@ -72,25 +88,10 @@ struct ipc_comp_dev *ipc_get_comp_by_ppl_id(struct ipc *ipc, uint16_t type,
 	struct ipc_comp_dev *icd;
 	struct list_item *clist;
 
-	list_for_item(clist, &ipc->shared_ctx->comp_list) {
-		icd = container_of(clist, struct ipc_comp_dev, list);
-		if (icd->type != type)
-			continue;
-
-		switch (icd->type) {
-		case COMP_TYPE_COMPONENT:
-			if (icd->cd->comp.pipeline_id == ppl_id)
-				return icd;
-			break;
-		case COMP_TYPE_BUFFER:
-			if (icd->cb->pipeline_id == ppl_id)
-				return icd;
-			break;
-		case COMP_TYPE_PIPELINE:
-			if (icd->pipeline->ipc_pipe.pipeline_id == ppl_id)
-				return icd;
-			break;
-		}
+	list_for_item(clist, ipc_ppl_bucket(ipc, ppl_id)) {
+		icd = container_of(clist, struct ipc_comp_dev, ppl_list);
+		if (icd->type == type && icd->ppl_id == ppl_id)
+			return icd;
 	}
 
 	return NULL;
@@ -99,25 +100,26 @@ struct ipc_comp_dev *ipc_get_comp_by_ppl_id(struct ipc *ipc, uint16_t type,
 static struct ipc_comp_dev *ipc_get_ppl_comp(struct ipc *ipc,
 					     uint32_t pipeline_id, int dir)
 {
+	struct list_item *bucket = ipc_ppl_bucket(ipc, pipeline_id);
 	struct ipc_comp_dev *icd;
 	struct comp_buffer *buffer;
 	struct comp_dev *buff_comp;
 	struct list_item *clist;
 
 	/* first try to find the module in the pipeline */
-	list_for_item(clist, &ipc->shared_ctx->comp_list) {
-		icd = container_of(clist, struct ipc_comp_dev, list);
+	list_for_item(clist, bucket) {
+		icd = container_of(clist, struct ipc_comp_dev, ppl_list);
 		if (icd->type == COMP_TYPE_COMPONENT &&
-		    icd->cd->comp.pipeline_id == pipeline_id &&
+		    icd->ppl_id == pipeline_id &&
 		    list_is_empty(comp_buffer_list(icd->cd, dir)))
 			return icd;
 	}
 
 	/* it's connected pipeline, so find the connected module */
-	list_for_item(clist, &ipc->shared_ctx->comp_list) {
-		icd = container_of(clist, struct ipc_comp_dev, list);
+	list_for_item(clist, bucket) {
+		icd = container_of(clist, struct ipc_comp_dev, ppl_list);
 		if (icd->type == COMP_TYPE_COMPONENT &&
-		    icd->cd->comp.pipeline_id == pipeline_id) {
+		    icd->ppl_id == pipeline_id) {
 			buffer = buffer_from_list
 					(comp_buffer_list(icd->cd, dir)->next,
 					 struct comp_buffer, dir);
@@ -185,7 +187,7 @@ int ipc_comp_new(struct ipc *ipc, struct sof_ipc_comp *comp)
 	icd->type = COMP_TYPE_COMPONENT;
 
 	/* add new component to the list */
-	list_item_append(&icd->list, &ipc->shared_ctx->comp_list);
+	ipc_comp_dev_add(ipc, icd, comp->id, comp->pipeline_id);
 	return ret;
 }
 
@@ -213,7 +215,7 @@ int ipc_comp_free(struct ipc *ipc, uint32_t comp_id)
 
 	icd->cd = NULL;
 
-	list_item_del(&icd->list);
+	ipc_comp_dev_del(icd);
 	rfree(icd);
 
 	return 0;
@@ -252,7 +254,7 @@ int ipc_buffer_new(struct ipc *ipc, struct sof_ipc_buffer *desc)
 	ibd->type = COMP_TYPE_BUFFER;
 
 	/* add new buffer to the list */
-	list_item_append(&ibd->list, &ipc->shared_ctx->comp_list);
+	ipc_comp_dev_add(ipc, ibd, desc->comp.id, desc->comp.pipeline_id);
 	return ret;
 }
 
@@ -267,7 +269,7 @@ int ipc_buffer_free(struct ipc *ipc, uint32_t buffer_id)
 
 	/* free buffer and remove from list */
 	buffer_free(ibd->cb);
-	list_item_del(&ibd->list);
+	ipc_comp_dev_del(ibd);
 	rfree(ibd);
 
 	return 0;
@@ -375,7 +377,8 @@ int ipc_pipeline_new(struct ipc *ipc,
 	ipc_pipe->type = COMP_TYPE_PIPELINE;
 
 	/* add new pipeline to the list */
-	list_item_append(&ipc_pipe->list, &ipc->shared_ctx->comp_list);
+	ipc_comp_dev_add(ipc, ipc_pipe, pipe_desc->comp_id,
+			 pipe_desc->pipeline_id);
 	return 0;
 }
 
@@ -397,7 +400,7 @@ int ipc_pipeline_free(struct ipc *ipc, uint32_t comp_id)
 		return ret;
 	}
 	ipc_pipe->pipeline = NULL;
-	list_item_del(&ipc_pipe->list);
+	ipc_comp_dev_del(ipc_pipe);
 	rfree(ipc_pipe);
 
 	return 0;
@@ -488,14 +491,13 @@ int ipc_init(struct sof *sof)
 
 	dcache_writeback_region(sof->ipc, sizeof(*sof->ipc));
 
-	sof->ipc->shared_ctx->dsp_msg = NULL;
-	list_init(&sof->ipc->shared_ctx->empty_list);
-	list_init(&sof->ipc->shared_ctx->msg_list);
 	list_init(&sof->ipc->shared_ctx->comp_list);
 
-	for (i = 0; i < MSG_QUEUE_SIZE; i++)
-		list_item_prepend(&sof->ipc->shared_ctx->message[i].list,
-				  &sof->ipc->shared_ctx->empty_list);
+	for (i = 0; i < IPC_COMP_HASH_SIZE; i++)
+		list_init(&sof->ipc->shared_ctx->comp_hash[i]);
+
+	for (i = 0; i < IPC_PPL_HASH_SIZE; i++)
+		list_init(&sof->ipc->shared_ctx->ppl_hash[i]);
 
 	return platform_ipc_init(sof->ipc);
 }
@@ -0,0 +1,201 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2019 Intel Corporation. All rights reserved.
+
+/*
+ * Notifications to host. Every core queues them in its own ring, the
+ * master core copies them to the mailbox one at a time. Stream and trace
+ * position updates still waiting in a ring are rewritten instead of
+ * queueing another message.
+ */
+
+#include <sof/atomic.h>
+#include <sof/debug/panic.h>
+#include <sof/drivers/interrupt.h>
+#include <sof/drivers/ipc.h>
+#include <sof/lib/cache.h>
+#include <sof/lib/cpu.h>
+#include <sof/lib/mailbox.h>
+#include <sof/string.h>
+#include <ipc/header.h>
+#include <ipc/stream.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define iGS(x) ((x) & SOF_GLB_TYPE_MASK)
+
+/* stream messages are coalesced per component, others per header */
+static inline uint32_t msg_comp_id(uint32_t header, void *tx_data)
+{
+	struct sof_ipc_stream_posn *posn = tx_data;
+
+	return iGS(header) == SOF_IPC_GLB_STREAM_MSG ? posn->comp_id : 0;
+}
+
+static inline uint32_t msg_index(uint32_t header, uint32_t comp_id)
+{
+	return ((header >> 16) ^ comp_id) & (IPC_MSG_INDEX_SIZE - 1);
+}
+
+/* rewrites a still queued message with the same key, IRQs off */
+static bool msg_replace(struct ipc_msg_ring *ring, uint32_t header,
+			uint32_t comp_id, void *tx_data, size_t tx_bytes)
+{
+	struct ipc_msg *msg;
+	uint32_t pos = ring->index[msg_index(header, comp_id)];
+	uint32_t tail = atomic_read(&ring->tail);
+	bool done = false;
+	int ret;
+
+	/* nothing indexed for this key */
+	if (!pos--)
+		return false;
+
+	/* already sent to host */
+	if (pos - tail >= (uint32_t)atomic_read(&ring->head) - tail)
+		return false;
+
+	msg = &ring->msg[pos & (IPC_MSG_RING_SIZE - 1)];
+	if (msg->header != header || msg->comp_id != comp_id)
+		return false;
+
+	/*
+	 * Mark the rewrite before checking the claim. The sender claims
+	 * before reading the sequence, so either we see the claim and queue
+	 * a new message or the sender sees the rewrite and copies again.
+	 */
+	atomic_add(&msg->seq, 1);
+	if (!atomic_read(&msg->claimed)) {
+		msg->tx_size = tx_bytes;
+		if (tx_bytes) {
+			ret = memcpy_s(msg->tx_data, sizeof(msg->tx_data),
+				       tx_data, tx_bytes);
+			assert(!ret);
+		}
+		done = true;
+	}
+	atomic_add(&msg->seq, 1);
+
+	return done;
+}
+
+int ipc_queue_host_message(struct ipc *ipc, uint32_t header, void *tx_data,
+			   size_t tx_bytes, uint32_t replace)
+{
+	struct ipc_msg_ring *ring;
+	struct ipc_msg *msg;
+	uint32_t comp_id = 0;
+	uint32_t flags;
+	uint32_t head;
+	int ret = 0;
+
+	if (tx_bytes > IPC_MSG_DATA_SIZE) {
+		trace_ipc_error("ipc: msg hdr 0x%08x size %d too big",
+				header, tx_bytes);
+		return -EINVAL;
+	}
+
+	ipc = cache_to_uncache(ipc);
+
+	/* ring of this core has no other producer */
+	irq_local_disable(flags);
+
+	ring = &ipc->shared_ctx->ring[cpu_get_id()];
+
+	/* do we need to replace an existing message? */
+	if (replace) {
+		comp_id = msg_comp_id(header, tx_data);
+		if (msg_replace(ring, header, comp_id, tx_data, tx_bytes))
+			goto out;
+	}
+
+	head = atomic_read(&ring->head);
+	if (head - atomic_read(&ring->tail) == IPC_MSG_RING_SIZE) {
+		trace_ipc_error("ipc: msg hdr for 0x%08x not queued, "
+				"replace %d", header, replace);
+		ret = -EBUSY;
+		goto out;
+	}
+
+	/* prepare the message */
+	msg = &ring->msg[head & (IPC_MSG_RING_SIZE - 1)];
+	msg->header = header;
+	msg->tx_size = tx_bytes;
+	msg->comp_id = comp_id;
+	atomic_set(&msg->claimed, 0);
+
+	/* copy mailbox data to message */
+	if (tx_bytes) {
+		ret = memcpy_s(msg->tx_data, sizeof(msg->tx_data), tx_data,
+			       tx_bytes);
+		assert(!ret);
+	}
+
+	if (replace)
+		ring->index[msg_index(header, comp_id)] = head + 1;
+
+	/* now queue the message */
+	atomic_add(&ring->head, 1);
+
+out:
+	irq_local_enable(flags);
+	return ret;
+}
+
+static inline bool ipc_msg_ring_pending(struct ipc_msg_ring *ring)
+{
+	return atomic_read(&ring->head) != atomic_read(&ring->tail);
+}
+
+bool ipc_msg_pending(struct ipc *ipc)
+{
+	int i;
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++)
+		if (ipc_msg_ring_pending(&ipc->shared_ctx->ring[i]))
+			return true;
+
+	return false;
+}
+
+/* copies next message to DSP mailbox, locks held by caller */
+bool ipc_msg_tx_next(struct ipc *ipc, uint32_t *header)
+{
+	struct ipc_shared_context *ctx = ipc->shared_ctx;
+	struct ipc_msg_ring *ring = NULL;
+	struct ipc_msg *msg;
+	uint32_t core = 0;
+	uint32_t seq;
+	int i;
+
+	/* take turns so one busy core can't hold back the others */
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
+		core = (ctx->tx_core + i) % PLATFORM_CORE_COUNT;
+		if (ipc_msg_ring_pending(&ctx->ring[core])) {
+			ring = &ctx->ring[core];
+			break;
+		}
+	}
+
+	if (!ring)
+		return false;
+
+	msg = &ring->msg[atomic_read(&ring->tail) & (IPC_MSG_RING_SIZE - 1)];
+	atomic_add(&msg->claimed, 1);
+
+	/* copy again if the producer rewrote the payload meanwhile */
+	do {
+		do {
+			seq = atomic_read(&msg->seq);
+		} while (seq & 1);
+
+		mailbox_dspbox_write(0, msg->tx_data, msg->tx_size);
+		*header = msg->header;
+	} while (atomic_read(&msg->seq) != seq);
+
+	atomic_add(&ring->tail, 1);
+	ctx->tx_core = (core + 1) % PLATFORM_CORE_COUNT;
+
+	return true;
+}
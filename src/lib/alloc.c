@@ -11,6 +11,7 @@
 #include <sof/lib/cpu.h>
 #include <sof/lib/dma.h>
 #include <sof/lib/memory.h>
+#include <sof/math/numbers.h>
 #include <sof/spinlock.h>
 #include <sof/string.h>
 #include <sof/trace/trace.h>
@@ -19,6 +20,7 @@
 #include <user/trace.h>
 #include <config.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -78,6 +80,8 @@ static void validate_memory(void *ptr, size_t size)
 static inline void writeback_block_map(struct block_map *map)
 {
 	dcache_writeback_region(map->block, sizeof(*map->block) * map->count);
+	dcache_writeback_region(map->used_mask,
+				BLOCK_MASK_SIZE(map->count));
 	dcache_writeback_region(map, sizeof(*map));
 }
 
@@ -85,6 +89,76 @@ static inline void writeback_block_map(struct block_map *map)
 static inline void invalidate_blocks(struct block_map *map)
 {
 	dcache_invalidate_region(map->block, sizeof(*map->block) * map->count);
+	dcache_invalidate_region(map->used_mask,
+				 BLOCK_MASK_SIZE(map->count));
+}
+
+/* Used blocks bitmap search. Bits past the last block are never set, so
+ * the searches clamp their result to map->count.
+ */
+
+/* index of first free block at or after start, map->count if none */
+static int block_map_find_free(struct block_map *map, int start)
+{
+	int last = (map->count - 1) >> 5;
+	int word = start >> 5;
+	uint32_t free_bits;
+
+	if (start >= map->count)
+		return map->count;
+
+	/* ignore the blocks before start in the first word */
+	free_bits = ~map->used_mask[word] & (~0U << (start & 31));
+
+	while (!free_bits) {
+		if (++word > last)
+			return map->count;
+		free_bits = ~map->used_mask[word];
+	}
+
+	return MIN((word << 5) + ffs(free_bits) - 1, map->count);
+}
+
+/* index of first used block at or after start, map->count if none */
+static int block_map_find_used(struct block_map *map, int start)
+{
+	int last = (map->count - 1) >> 5;
+	int word = start >> 5;
+	uint32_t used_bits;
+
+	if (start >= map->count)
+		return map->count;
+
+	used_bits = map->used_mask[word] & (~0U << (start & 31));
+
+	while (!used_bits) {
+		if (++word > last)
+			return map->count;
+		used_bits = map->used_mask[word];
+	}
+
+	return (word << 5) + ffs(used_bits) - 1;
+}
+
+/* set or clear count bits from start, a word at a time */
+static void block_map_mark(struct block_map *map, int start, int count,
+			   bool used)
+{
+	int end = start + count;
+	uint32_t bits;
+	int n;
+
+	while (start < end) {
+		n = MIN(32 - (start & 31), end - start);
+		bits = (n == 32 ? ~0U : (1U << n) - 1) << (start & 31);
+
+		if (used)
+			map->used_mask[start >> 5] |= bits;
+		else
+			map->used_mask[start >> 5] &= ~bits;
+
+		start += n;
+	}
 }
 
 /* total size of block */
@@ -229,7 +303,6 @@ static void *alloc_block(struct mm_heap *heap, int level,
 	struct block_map *map = &heap->map[level];
 	struct block_hdr *hdr;
 	void *ptr;
-	int i;
 
 	invalidate_blocks(map);
 
@@ -241,19 +314,13 @@ static void *alloc_block(struct mm_heap *heap, int level,
 
 	hdr->size = 1;
 	hdr->used = 1;
+	block_map_mark(map, map->first_free, 1, true);
 
 	heap->info.used += map->block_size;
 	heap->info.free -= map->block_size;
 
 	/* find next free */
-	for (i = map->first_free; i < map->count; ++i) {
-		hdr = &map->block[i];
-
-		if (hdr->used == 0) {
-			map->first_free = i;
-			break;
-		}
-	}
+	map->first_free = block_map_find_free(map, map->first_free + 1);
 
 	writeback_block_map(map);
 	dcache_writeback_region(heap, sizeof(*heap));
@@ -268,7 +335,7 @@ static void *alloc_cont_blocks(struct mm_heap *heap, int level,
 	struct block_map *map = &heap->map[level];
 	struct block_hdr *hdr;
 	void *ptr, *unaligned_ptr;
-	unsigned int start = map->first_free;
+	unsigned int start;
 	unsigned int current;
 	unsigned int count = bytes / map->block_size;
 	unsigned int remaining = 0;
@@ -279,16 +346,15 @@ static void *alloc_cont_blocks(struct mm_heap *heap, int level,
 	invalidate_blocks(map);
 
 	/* check if we have enough consecutive blocks for requested
-	 * allocation size.
+	 * allocation size, jumping from one free run to the next.
 	 */
-	for (current = map->first_free; current < map->count &&
-	     remaining < count; current++) {
-		hdr = &map->block[current];
-
-		if (hdr->used)
-			remaining = 0;/* used, not suitable, reset */
-		else if (!remaining++)
-			start = current;/* new start */
+	for (start = block_map_find_free(map, map->first_free);
+	     start + count <= map->count;
+	     start = block_map_find_free(map, current)) {
+		current = block_map_find_used(map, start);
+		remaining = current - start;
+		if (remaining >= count)
+			break;
 	}
 
 	if (count > map->count || remaining < count) {
@@ -310,23 +376,17 @@ static void *alloc_cont_blocks(struct mm_heap *heap, int level,
 
 	heap->info.used += count * map->block_size;
 	heap->info.free -= count * map->block_size;
-	/* update first_free if needed */
-	if (map->first_free == start)
-		/* find first available free block */
-		for (map->first_free += count; map->first_free < map->count;
-			map->first_free++) {
-			hdr = &map->block[map->first_free];
-
-			if (!hdr->used)
-				break;
-		}
-
 	/* update each block */
 	for (current = start; current < start + count; current++) {
 		hdr = &map->block[current];
 		hdr->used = 1;
 		hdr->unaligned_ptr = unaligned_ptr;
 	}
+	block_map_mark(map, start, count, true);
+
+	/* update first_free if needed */
+	if (map->first_free == start)
+		map->first_free = block_map_find_free(map, start + count);
 
 	writeback_block_map(map);
 	dcache_writeback_region(heap, sizeof(*heap));
@@ -334,6 +394,12 @@ static void *alloc_cont_blocks(struct mm_heap *heap, int level,
 	return ptr;
 }
 
+static inline bool heap_contains(struct mm_heap *heap, void *ptr)
+{
+	return (uint32_t)ptr >= heap->heap &&
+		(uint32_t)ptr < heap->heap + heap->size;
+}
+
 static struct mm_heap *get_heap_from_ptr(void *ptr)
 {
 	struct mm_heap *heap;
@@ -341,28 +407,28 @@ static struct mm_heap *get_heap_from_ptr(void *ptr)
 
 	/* find mm_heap that ptr belongs to */
 	heap = memmap.system_runtime + cpu_get_id();
-	if ((uint32_t)ptr >= heap->heap &&
-	    (uint32_t)ptr < heap->heap + heap->size)
+	if (heap_contains(heap, ptr))
 		return heap;
 
+	/* heap ranges don't change after init, so only the matching
+	 * heap needs to be invalidated for its usage info
+	 */
 	for (i = 0; i < PLATFORM_HEAP_RUNTIME; i++) {
 		heap = &memmap.runtime[i];
 
-		dcache_invalidate_region(heap, sizeof(*heap));
-
-		if ((uint32_t)ptr >= heap->heap &&
-		    (uint32_t)ptr < heap->heap + heap->size)
+		if (heap_contains(heap, ptr)) {
+			dcache_invalidate_region(heap, sizeof(*heap));
 			return heap;
+		}
 	}
 
 	for (i = 0; i < PLATFORM_HEAP_BUFFER; i++) {
 		heap = &memmap.buffer[i];
 
-		dcache_invalidate_region(heap, sizeof(*heap));
-
-		if ((uint32_t)ptr >= heap->heap &&
-		    (uint32_t)ptr < heap->heap + heap->size)
+		if (heap_contains(heap, ptr)) {
+			dcache_invalidate_region(heap, sizeof(*heap));
 			return heap;
+		}
 	}
 
 	return NULL;
@@ -506,6 +572,7 @@ static void free_block(void *ptr)
 		heap->info.used -= block_map->block_size;
 		heap->info.free += block_map->block_size;
 	}
+	block_map_mark(block_map, block, used_blocks - block, false);
 
 	/* set first free block */
 	if (block < block_map->first_free)
@@ -11,6 +11,7 @@
 #include <sof/lib/alloc.h>
 #include <sof/lib/clk.h>
 #include <sof/lib/cpu.h>
+#include <sof/lib/dvfs.h>
 #include <sof/lib/notifier.h>
 #include <sof/platform.h>
 #include <sof/spinlock.h>
@@ -43,21 +44,6 @@ struct clk_pdata {
 
 static struct clk_pdata *clk_pdata;
 
-static inline uint32_t clock_get_nearest_freq_idx(const struct freq_table *tab,
-						  uint32_t size, uint32_t hz)
-{
-	uint32_t i;
-
-	/* find lowest available frequency that is >= requested hz */
-	for (i = 0; i < size; i++) {
-		if (hz <= tab[i].freq)
-			return i;
-	}
-
-	/* not found, so return max frequency */
-	return size - 1;
-}
-
 uint32_t clock_get_freq(int clock)
 {
 	return clk_pdata->clk[clock].freq;
@@ -160,4 +146,6 @@ void clock_init(void)
 	clk_pdata->clk[CLK_SSP].ticks_per_msec =
 			ssp_freq[SSP_DEFAULT_IDX].ticks_per_msec;
 	spinlock_init(&clk_pdata->clk[CLK_SSP].lock);
+
+	dvfs_init();
 }
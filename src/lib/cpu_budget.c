@@ -0,0 +1,243 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2019 Intel Corporation. All rights reserved.
+
+/*
+ * CPU budget of each core. Every active pipeline is charged its measured
+ * copy cost in cycles per second at any frequency. The budget is
+ * CPU_BUDGET_LIMIT percent of the highest frequency in the table, the rest
+ * is left to the scheduler, IPC and other tasks. Load of a core is only
+ * changed by that core, the master core reads it when admitting pipelines
+ * and reporting load to the host. Placement counts all pipelines created
+ * on a core, running or not, and is only changed by the master core while
+ * handling IPC. The period_mips declared by topology is advisory, it's
+ * only used by placement until the pipeline has been measured.
+ */
+
+#include <sof/audio/component.h>
+#include <sof/audio/pipeline.h>
+#include <sof/drivers/interrupt.h>
+#include <sof/drivers/timer.h>
+#include <sof/lib/cache.h>
+#include <sof/lib/clk.h>
+#include <sof/lib/cpu.h>
+#include <sof/lib/cpu_budget.h>
+#include <sof/lib/dvfs.h>
+#include <sof/lib/memory.h>
+#include <sof/math/numbers.h>
+#include <sof/platform.h>
+#include <ipc/pm.h>
+#include <ipc/topology.h>
+#include <errno.h>
+#include <stdint.h>
+
+/* accessed through uncached addresses only */
+static struct cpu_budget _cpu_budget[PLATFORM_CORE_COUNT];
+
+static inline struct cpu_budget *cpu_budget_get_core(int core)
+{
+	return cache_to_uncache(&_cpu_budget[core]);
+}
+
+/* cycles per second pipeline is charged for */
+static uint32_t cpu_budget_demand(struct pipeline *p)
+{
+	return p->cost_hz;
+}
+
+/* cycles per second pipeline is expected to take on its core */
+static uint32_t cpu_budget_hint(struct pipeline *p)
+{
+	return MAX(dvfs_pipeline_hz(&p->ipc_pipe), p->cost_hz);
+}
+
+void cpu_budget_init(void)
+{
+	uint64_t hz = (uint64_t)cpu_freq[NUM_CPU_FREQ - 1].freq *
+		      CPU_BUDGET_LIMIT / 100;
+	int i;
+
+	/* master core sets up all budgets before slaves run */
+	dcache_writeback_invalidate_region(_cpu_budget, sizeof(_cpu_budget));
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
+		cpu_budget_get_core(i)->budget_hz = hz;
+		cpu_budget_get_core(i)->load_hz = 0;
+		cpu_budget_get_core(i)->num_pipelines = 0;
+		cpu_budget_get_core(i)->placed_hz = 0;
+	}
+}
+
+uint32_t cpu_budget_need(struct pipeline *p)
+{
+	/* already charged */
+	if (p->status == COMP_STATE_ACTIVE)
+		return 0;
+
+	return cpu_budget_demand(p);
+}
+
+int cpu_budget_admit(struct pipeline *p, uint32_t demand_hz)
+{
+	struct cpu_budget *budget = cpu_budget_get_core(p->ipc_pipe.core);
+	uint64_t load;
+
+	load = (uint64_t)budget->load_hz + demand_hz;
+	if (load > budget->budget_hz) {
+		trace_pipe_error_with_ids(p, "cpu_budget_admit() error: core "
+					  "%u load %u Hz, pipelines need %u Hz",
+					  p->ipc_pipe.core, budget->load_hz,
+					  demand_hz);
+		return -EBUSY;
+	}
+
+	return 0;
+}
+
+void cpu_budget_start(struct pipeline *p)
+{
+	struct cpu_budget *budget = cpu_budget_get_core(cpu_get_id());
+	uint32_t flags;
+
+	irq_local_disable(flags);
+
+	p->demand_hz = cpu_budget_demand(p);
+	budget->load_hz += p->demand_hz;
+	budget->num_pipelines++;
+
+	irq_local_enable(flags);
+}
+
+void cpu_budget_stop(struct pipeline *p)
+{
+	struct cpu_budget *budget = cpu_budget_get_core(cpu_get_id());
+	uint32_t flags;
+
+	irq_local_disable(flags);
+
+	budget->load_hz -= MIN(p->demand_hz, budget->load_hz);
+	budget->num_pipelines--;
+	p->demand_hz = 0;
+
+	irq_local_enable(flags);
+}
+
+uint64_t cpu_budget_time(void)
+{
+	return platform_timer_get(platform_timer);
+}
+
+void cpu_budget_account(struct pipeline *p, uint64_t start)
+{
+	struct cpu_budget *budget = cpu_budget_get_core(cpu_get_id());
+	uint64_t ticks = cpu_budget_time() - start;
+	uint64_t cost;
+
+	if (!p->ipc_pipe.period)
+		return;
+
+	/* cycles of this copy scaled to one second */
+	cost = ticks * clock_get_freq(CLK_CPU(cpu_get_id())) /
+		clock_ms_to_ticks(PLATFORM_DEFAULT_CLOCK, 1) * 1000 /
+		p->ipc_pipe.period;
+	cost = MIN(cost, (uint64_t)UINT32_MAX);
+
+	/* follow peaks at once, decay slowly */
+	if (cost >= p->cost_hz)
+		p->cost_hz = cost;
+	else
+		p->cost_hz -= (p->cost_hz - cost) >> CPU_BUDGET_DECAY_SHIFT;
+
+	/* recharge the core if pipeline is counted in its load */
+	if (p->status != COMP_STATE_ACTIVE)
+		return;
+
+	budget->load_hz -= MIN(p->demand_hz, budget->load_hz);
+	p->demand_hz = cpu_budget_demand(p);
+	budget->load_hz += p->demand_hz;
+}
+
+int cpu_budget_get(int core, struct sof_ipc_pm_core_load_elem *elem)
+{
+	struct cpu_budget *budget;
+
+	if (core < 0 || core >= PLATFORM_CORE_COUNT)
+		return -EINVAL;
+
+	budget = cpu_budget_get_core(core);
+
+	elem->core = core;
+	elem->enabled = cpu_is_core_enabled(core);
+	elem->freq = clock_get_freq(CLK_CPU(core));
+	elem->budget_hz = budget->budget_hz;
+	elem->load_hz = budget->load_hz;
+	elem->num_pipelines = budget->num_pipelines;
+
+	return 0;
+}
+
+void cpu_budget_place(struct pipeline *p)
+{
+	struct cpu_budget *budget;
+
+	if (p->ipc_pipe.core >= PLATFORM_CORE_COUNT)
+		return;
+
+	budget = cpu_budget_get_core(p->ipc_pipe.core);
+
+	p->placed_hz = cpu_budget_hint(p);
+	budget->placed_hz += p->placed_hz;
+}
+
+void cpu_budget_unplace(struct pipeline *p)
+{
+	struct cpu_budget *budget;
+
+	if (p->ipc_pipe.core >= PLATFORM_CORE_COUNT)
+		return;
+
+	budget = cpu_budget_get_core(p->ipc_pipe.core);
+
+	budget->placed_hz -= MIN(p->placed_hz, budget->placed_hz);
+	p->placed_hz = 0;
+}
+
+/* load of core as seen by pipeline, without its own placement */
+static uint32_t cpu_budget_core_load(struct pipeline *p, int core)
+{
+	struct cpu_budget *budget = cpu_budget_get_core(core);
+	uint32_t placed = budget->placed_hz;
+
+	if (core == p->ipc_pipe.core)
+		placed -= MIN(p->placed_hz, placed);
+
+	return MAX(placed, budget->load_hz);
+}
+
+int cpu_budget_pick_core(struct pipeline *p)
+{
+	int best = PLATFORM_MASTER_CORE_ID;
+	uint32_t best_load;
+	uint32_t load;
+	int i;
+
+	/* stay on current core unless another one is less loaded */
+	if (p->ipc_pipe.core < PLATFORM_CORE_COUNT &&
+	    cpu_is_core_enabled(p->ipc_pipe.core))
+		best = p->ipc_pipe.core;
+
+	best_load = cpu_budget_core_load(p, best);
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
+		if (!cpu_is_core_enabled(i))
+			continue;
+
+		load = cpu_budget_core_load(p, i);
+		if (load < best_load) {
+			best = i;
+			best_load = load;
+		}
+	}
+
+	return best;
+}
@@ -6,6 +6,7 @@
 
 #include <sof/atomic.h>
 #include <sof/audio/buffer.h>
+#include <sof/audio/pcm_converter.h>
 #include <sof/lib/alloc.h>
 #include <sof/lib/cache.h>
 #include <sof/lib/dma.h>
@@ -190,8 +191,7 @@ void dma_sg_free(struct dma_sg_elem_array *elem_array)
 }
 
 void dma_buffer_copy_from(struct comp_buffer *source, struct comp_buffer *sink,
-	void (*process)(struct comp_buffer *, struct comp_buffer *, uint32_t),
-	uint32_t bytes)
+			  const struct pcm_converter *conv, uint32_t bytes)
 {
 	uint32_t head = bytes;
 	uint32_t tail = 0;
@@ -206,8 +206,8 @@ void dma_buffer_copy_from(struct comp_buffer *source, struct comp_buffer *sink,
 	if (tail)
 		dcache_invalidate_region(source->addr, tail);
 
-	/* process data */
-	process(source, sink, bytes);
+	/* convert data while copying it to the sink */
+	conv->func(source, sink, bytes / conv->source_bytes);
 
 	source->r_ptr += bytes;
 
@@ -216,18 +216,17 @@ void dma_buffer_copy_from(struct comp_buffer *source, struct comp_buffer *sink,
 		source->r_ptr = source->addr +
 			(source->r_ptr - source->end_addr);
 
-	comp_update_buffer_produce(sink, bytes);
+	comp_update_buffer_produce(sink, pcm_sink_bytes(conv, bytes));
 }
 
 void dma_buffer_copy_to(struct comp_buffer *source, struct comp_buffer *sink,
-	void (*process)(struct comp_buffer *, struct comp_buffer *, uint32_t),
-	uint32_t bytes)
+			const struct pcm_converter *conv, uint32_t bytes)
 {
 	uint32_t head = bytes;
 	uint32_t tail = 0;
 
-	/* process data */
-	process(source, sink, bytes);
+	/* convert data while copying it to the sink */
+	conv->func(source, sink, bytes / conv->sink_bytes);
 
 	/* sink buffer contains data meant to copied to DMA */
 	if (sink->w_ptr + bytes > sink->end_addr) {
@@ -246,5 +245,5 @@ void dma_buffer_copy_to(struct comp_buffer *source, struct comp_buffer *sink,
 		sink->w_ptr = sink->addr +
 			(sink->w_ptr - sink->end_addr);
 
-	comp_update_buffer_consume(source, bytes);
+	comp_update_buffer_consume(source, pcm_source_bytes(conv, bytes));
 }
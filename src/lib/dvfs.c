@@ -0,0 +1,206 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2019 Intel Corporation. All rights reserved.
+
+/*
+ * CPU frequency governor. Each core keeps the lowest entry of the frequency
+ * table that leaves DVFS_HEADROOM percent of free cycles above its demand.
+ * The demand is the larger of the work declared by active pipelines in
+ * period_mips and the cycles measured in LL ticks over the last window.
+ * Measured time already contains the work of running pipelines, so the
+ * declared value only serves as a floor, e.g. right after pipeline start.
+ */
+
+#include <sof/drivers/interrupt.h>
+#include <sof/lib/cache.h>
+#include <sof/lib/clk.h>
+#include <sof/lib/cpu.h>
+#include <sof/lib/dvfs.h>
+#include <sof/lib/memory.h>
+#include <sof/math/numbers.h>
+#include <sof/platform.h>
+#include <sof/trace/trace.h>
+#include <ipc/topology.h>
+#include <user/trace.h>
+#include <config.h>
+#include <stdint.h>
+
+/* governor tracing */
+#define trace_dvfs(__e, ...) \
+	trace_event(TRACE_CLASS_CLK, __e, ##__VA_ARGS__)
+
+void dvfs_gov_init(struct dvfs_gov *gov, const struct freq_table *tab,
+		   uint32_t size, uint32_t hz)
+{
+	gov->tab = tab;
+	gov->tab_size = size;
+	gov->idx = clock_get_nearest_freq_idx(tab, size, hz);
+	gov->down_windows = 0;
+	gov->pipe_hz = 0;
+	gov->load_hz = 0;
+	gov->busy = 0;
+	gov->window_start = 0;
+}
+
+void dvfs_gov_load(struct dvfs_gov *gov, uint64_t busy, uint64_t elapsed)
+{
+	uint64_t hz;
+
+	if (!elapsed)
+		return;
+
+	/* cycles used at the running frequency scaled to one second */
+	hz = (uint64_t)gov->tab[gov->idx].freq * busy / elapsed;
+	gov->load_hz = MIN(hz, (uint64_t)UINT32_MAX);
+}
+
+/* table entry keeping given percentage of headroom above the demand */
+static uint32_t dvfs_gov_target(struct dvfs_gov *gov, uint32_t headroom)
+{
+	uint64_t hz = MAX(gov->pipe_hz, gov->load_hz);
+
+	hz = hz * (100 + headroom) / 100;
+
+	return clock_get_nearest_freq_idx(gov->tab, gov->tab_size,
+					  MIN(hz, (uint64_t)UINT32_MAX));
+}
+
+uint32_t dvfs_gov_raise(struct dvfs_gov *gov)
+{
+	uint32_t idx = dvfs_gov_target(gov, DVFS_HEADROOM);
+
+	if (idx > gov->idx) {
+		gov->idx = idx;
+		gov->down_windows = 0;
+	}
+
+	return gov->idx;
+}
+
+uint32_t dvfs_gov_select(struct dvfs_gov *gov)
+{
+	uint32_t idx = dvfs_gov_target(gov, DVFS_HEADROOM);
+
+	/* demand doesn't fit or fits just right */
+	if (idx >= gov->idx) {
+		gov->idx = idx;
+		gov->down_windows = 0;
+		return gov->idx;
+	}
+
+	/* lower entry must also fit with hysteresis added */
+	idx = dvfs_gov_target(gov, DVFS_HEADROOM + DVFS_HYSTERESIS);
+	if (idx >= gov->idx) {
+		gov->down_windows = 0;
+		return gov->idx;
+	}
+
+	/* and keep fitting for a while */
+	if (++gov->down_windows < DVFS_DOWN_WINDOWS)
+		return gov->idx;
+
+	gov->idx = idx;
+	gov->down_windows = 0;
+
+	return gov->idx;
+}
+
+#if CONFIG_DVFS
+
+/* accessed through uncached addresses only */
+static struct dvfs_gov _dvfs_gov[PLATFORM_CORE_COUNT];
+
+static inline struct dvfs_gov *dvfs_gov_get(int core)
+{
+	return cache_to_uncache(&_dvfs_gov[core]);
+}
+
+/* follows frequency changes made outside of the governor */
+static uint32_t dvfs_sync(struct dvfs_gov *gov)
+{
+	uint32_t hz = clock_get_freq(CLK_CPU(cpu_get_id()));
+
+	gov->idx = clock_get_nearest_freq_idx(gov->tab, gov->tab_size, hz);
+
+	return gov->idx;
+}
+
+static void dvfs_apply(struct dvfs_gov *gov, uint32_t old)
+{
+	if (gov->idx == old)
+		return;
+
+	trace_dvfs("dvfs: core %d freq %u pipe_hz %u load_hz %u",
+		   cpu_get_id(), gov->tab[gov->idx].freq, gov->pipe_hz,
+		   gov->load_hz);
+
+	clock_set_freq(CLK_CPU(cpu_get_id()), gov->tab[gov->idx].freq);
+}
+
+void dvfs_init(void)
+{
+	int i;
+
+	/* master core sets up all governors before slaves run */
+	dcache_writeback_invalidate_region(_dvfs_gov, sizeof(_dvfs_gov));
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++)
+		dvfs_gov_init(dvfs_gov_get(i), cpu_freq, NUM_CPU_FREQ,
+			      clock_get_freq(CLK_CPU(i)));
+}
+
+void dvfs_pipeline_start(const struct sof_ipc_pipe_new *pipe)
+{
+	struct dvfs_gov *gov = dvfs_gov_get(cpu_get_id());
+	uint32_t flags;
+	uint32_t old;
+
+	irq_local_disable(flags);
+
+	old = dvfs_sync(gov);
+	gov->pipe_hz += dvfs_pipeline_hz(pipe);
+
+	/* raise before the first copy rather than after a window */
+	dvfs_gov_raise(gov);
+	dvfs_apply(gov, old);
+
+	irq_local_enable(flags);
+}
+
+void dvfs_pipeline_stop(const struct sof_ipc_pipe_new *pipe)
+{
+	struct dvfs_gov *gov = dvfs_gov_get(cpu_get_id());
+	uint32_t hz = dvfs_pipeline_hz(pipe);
+	uint32_t flags;
+
+	/* frequency is lowered by the following windows */
+	irq_local_disable(flags);
+	gov->pipe_hz -= MIN(hz, gov->pipe_hz);
+	irq_local_enable(flags);
+}
+
+void dvfs_ll_tick(uint64_t start, uint64_t end)
+{
+	struct dvfs_gov *gov = dvfs_gov_get(cpu_get_id());
+	uint64_t elapsed;
+	uint32_t old;
+
+	if (!gov->window_start)
+		gov->window_start = start;
+
+	gov->busy += end - start;
+
+	elapsed = end - gov->window_start;
+	if (elapsed < clock_ms_to_ticks(PLATFORM_DEFAULT_CLOCK, DVFS_WINDOW_MS))
+		return;
+
+	old = dvfs_sync(gov);
+	dvfs_gov_load(gov, gov->busy, elapsed);
+	gov->busy = 0;
+	gov->window_start = end;
+
+	dvfs_gov_select(gov);
+	dvfs_apply(gov, old);
+}
+
+#endif
@@ -4,24 +4,62 @@
 //
 // Author: Liam Girdwood <liam.r.girdwood@linux.intel.com>
 
+#include <sof/atomic.h>
 #include <sof/common.h>
+#include <sof/debug/panic.h>
 #include <sof/drivers/idc.h>
 #include <sof/lib/alloc.h>
 #include <sof/lib/cache.h>
 #include <sof/lib/cpu.h>
+#include <sof/lib/memory.h>
 #include <sof/lib/notifier.h>
 #include <sof/list.h>
 #include <sof/spinlock.h>
+#include <sof/string.h>
+#include <sof/trace/trace.h>
 #include <ipc/topology.h>
-
-static struct notify_data _notify_data __aligned(PLATFORM_DCACHE_ALIGN);
+#include <errno.h>
+#include <stdint.h>
+
+/* events waiting for delivery on one core, must be power of 2 */
+#define NOTIFY_QUEUE_SIZE	8
+
+/* queued event with its own copy of the payload, the sender's copy may be
+ * gone by the time the target core delivers it
+ */
+struct notify_entry {
+	struct notify_data data;
+	uint32_t payload[NOTIFIER_DATA_MAX_SIZE / sizeof(uint32_t)];
+};
+
+/*
+ * Events sent to a core by the other cores. Any core may add events under
+ * the lock, only the target core removes them, so nothing is overwritten
+ * before it has been delivered.
+ */
+struct notify_queue {
+	spinlock_t *lock;	/* serializes sending cores */
+	atomic_t head;		/* next free entry */
+	atomic_t tail;		/* next entry to deliver */
+	struct notify_entry entry[NOTIFY_QUEUE_SIZE];
+} __aligned(PLATFORM_DCACHE_ALIGN);
+
+/* accessed through uncached addresses only */
+static struct notify_queue _notify_queue[PLATFORM_CORE_COUNT];
+
+static inline struct notify_queue *notify_queue_get(int core)
+{
+	return cache_to_uncache(&_notify_queue[core]);
+}
 
 void notifier_register(struct notifier *notifier)
 {
 	struct notify *notify = *arch_notify_get();
 
+	assert(notifier->id < NOTIFIER_ID_COUNT);
+
 	spin_lock(notify->lock);
-	list_item_prepend(&notifier->list, &notify->list);
+	list_item_prepend(&notifier->list, &notify->list[notifier->id]);
 	spin_unlock(notify->lock);
 }
 
@@ -34,63 +72,125 @@ void notifier_unregister(struct notifier *notifier)
 	spin_unlock(notify->lock);
 }
 
-void notifier_notify(void)
+/* sends event to clients registered for its ID on this core */
+static void notifier_deliver(struct notify_data *notify_data)
 {
 	struct notify *notify = *arch_notify_get();
 	struct list_item *wlist;
 	struct notifier *n;
 
-	if (!list_is_empty(&notify->list)) {
-		dcache_invalidate_region(&_notify_data, sizeof(_notify_data));
-		dcache_invalidate_region(_notify_data.data,
-					 _notify_data.data_size);
-
-		/* iterate through notifiers and send event to
-		 * interested clients
-		 */
-		list_for_item(wlist, &notify->list) {
-			n = container_of(wlist, struct notifier, list);
-			if (n->id == _notify_data.id)
-				n->cb(_notify_data.message, n->cb_data,
-				      _notify_data.data);
-		}
+	list_for_item(wlist, &notify->list[notify_data->id]) {
+		n = container_of(wlist, struct notifier, list);
+		n->cb(notify_data->message, n->cb_data, notify_data->data);
 	}
 }
 
-void notifier_event(struct notify_data *notify_data)
+void notifier_notify(void)
+{
+	struct notify_queue *queue = notify_queue_get(cpu_get_id());
+	struct notify_entry entry;
+	uint32_t tail;
+
+	/* deliver all events sent to this core in the order they came */
+	while ((tail = atomic_read(&queue->tail)) !=
+	       atomic_read(&queue->head)) {
+		entry = queue->entry[tail & (NOTIFY_QUEUE_SIZE - 1)];
+		atomic_add(&queue->tail, 1);
+
+		entry.data.data = entry.payload;
+		notifier_deliver(&entry.data);
+	}
+}
+
+static int notifier_queue(int core, struct notify_data *notify_data)
+{
+	struct notify_queue *queue = notify_queue_get(core);
+	struct notify_entry *entry;
+	uint32_t flags;
+	uint32_t head;
+	int ret = 0;
+
+	spin_lock_irq(queue->lock, flags);
+
+	head = atomic_read(&queue->head);
+	if (head - atomic_read(&queue->tail) == NOTIFY_QUEUE_SIZE) {
+		ret = -EBUSY;
+		goto out;
+	}
+
+	entry = &queue->entry[head & (NOTIFY_QUEUE_SIZE - 1)];
+	entry->data = *notify_data;
+	if (notify_data->data_size) {
+		ret = memcpy_s(entry->payload, sizeof(entry->payload),
+			       notify_data->data, notify_data->data_size);
+		assert(!ret);
+	}
+	atomic_add(&queue->head, 1);
+
+out:
+	spin_unlock_irq(queue->lock, flags);
+	return ret;
+}
+
+int notifier_event(struct notify_data *notify_data)
 {
-	struct notify *notify = *arch_notify_get();
 	struct idc_msg notify_msg = { IDC_MSG_NOTIFY, IDC_MSG_NOTIFY_EXT };
 	int i;
 
-	spin_lock(notify->lock);
+	assert(notify_data->id < NOTIFIER_ID_COUNT);
 
-	_notify_data = *notify_data;
-	dcache_writeback_region(_notify_data.data, _notify_data.data_size);
-	dcache_writeback_region(&_notify_data, sizeof(_notify_data));
+	/* other cores get a copy of the payload, which has to fit the queue */
+	if (notify_data->target_core_mask & ~(1 << cpu_get_id()) &&
+	    notify_data->data_size > NOTIFIER_DATA_MAX_SIZE) {
+		trace_error(TRACE_CLASS_IDC, "notifier_event() error: "
+			    "id %u data_size %u over %u", notify_data->id,
+			    notify_data->data_size, NOTIFIER_DATA_MAX_SIZE);
+		return -EINVAL;
+	}
 
 	/* notify selected targets */
 	for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
-		if (_notify_data.target_core_mask & (1 << i)) {
-			if (i == cpu_get_id()) {
-				notifier_notify();
-			} else if (cpu_is_core_enabled(i)) {
-				notify_msg.core = i;
-				idc_send_msg(&notify_msg, IDC_NON_BLOCKING);
+		if (!(notify_data->target_core_mask & (1 << i)))
+			continue;
+
+		if (i == cpu_get_id()) {
+			notifier_deliver(notify_data);
+		} else if (cpu_is_core_enabled(i)) {
+			notify_msg.core = i;
+
+			/* queue full, wait for the target to drain it */
+			while (notifier_queue(i, notify_data) < 0) {
+				if (idc_send_msg(&notify_msg, IDC_BLOCKING) < 0)
+					break;
 			}
+
+			idc_send_msg(&notify_msg, IDC_NON_BLOCKING);
 		}
 	}
 
-	spin_unlock(notify->lock);
+	return 0;
 }
 
 void init_system_notify(struct sof *sof)
 {
 	struct notify **notify = arch_notify_get();
+	int i;
+
 	*notify = rzalloc(RZONE_SYS, SOF_MEM_CAPS_RAM, sizeof(**notify));
 
-	list_init(&(*notify)->list);
+	for (i = 0; i < NOTIFIER_ID_COUNT; i++)
+		list_init(&(*notify)->list[i]);
+
 	spinlock_init(&(*notify)->lock);
+
+	/* queues are shared, master core sets them up before slaves run */
+	if (cpu_get_id() == PLATFORM_MASTER_CORE_ID) {
+		dcache_writeback_invalidate_region(_notify_queue,
+						   sizeof(_notify_queue));
+
+		for (i = 0; i < PLATFORM_CORE_COUNT; i++)
+			spinlock_init(&notify_queue_get(i)->lock);
+	}
 }
 
 void free_system_notify(void)
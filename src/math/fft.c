@@ -0,0 +1,120 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2019 Intel Corporation. All rights reserved.
+
+/* Fixed point radix-2 decimation in time FFT for 32 bit complex data */
+
+#include <sof/audio/format.h>
+#include <sof/math/fft.h>
+#include <sof/math/trig.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+size_t fft_plan_data_size(uint32_t size)
+{
+	return size / 2 * sizeof(struct icomplex32) +
+		size * sizeof(uint16_t);
+}
+
+int fft_plan_init(struct fft_plan *plan, void *data, uint32_t size)
+{
+	int32_t w;
+	uint32_t i;
+	uint32_t j;
+
+	if (size < FFT_SIZE_MIN || size > FFT_SIZE_MAX || (size & (size - 1)))
+		return -EINVAL;
+
+	plan->size = size;
+	plan->len = 0;
+	while ((1 << plan->len) < size)
+		plan->len++;
+
+	plan->twiddle = data;
+	plan->bit_reverse_idx = (uint16_t *)(plan->twiddle + size / 2);
+
+	/* exp(-j w) = cos(w) - j sin(w), w = 2pi k / size in Q4.28 */
+	for (i = 0; i < size / 2; i++) {
+		w = (int32_t)(((int64_t)PI_MUL2_Q4_28 * i) >> plan->len);
+		plan->twiddle[i].real = sin_fixed(w + PI_DIV2_Q4_28);
+		plan->twiddle[i].imag = -sin_fixed(w);
+	}
+
+	for (i = 0; i < size; i++) {
+		plan->bit_reverse_idx[i] = 0;
+		for (j = 0; j < plan->len; j++)
+			if (i & (1 << j))
+				plan->bit_reverse_idx[i] |=
+					1 << (plan->len - 1 - j);
+	}
+
+	return 0;
+}
+
+static inline void fft_bit_reverse(struct fft_plan *plan,
+				   struct icomplex32 *buf)
+{
+	struct icomplex32 tmp;
+	uint32_t i;
+	uint32_t j;
+
+	for (i = 0; i < plan->size; i++) {
+		j = plan->bit_reverse_idx[i];
+		if (j > i) {
+			tmp = buf[i];
+			buf[i] = buf[j];
+			buf[j] = tmp;
+		}
+	}
+}
+
+/* Radix-2 butterfly, the inverse transform uses conjugate twiddles */
+static inline void fft_butterfly(struct icomplex32 *top,
+				 struct icomplex32 *bottom,
+				 const struct icomplex32 *w, bool ifft)
+{
+	int32_t wi = ifft ? -w->imag : w->imag;
+	int64_t re = top->real;
+	int64_t im = top->imag;
+	int64_t tr;
+	int64_t ti;
+
+	/* Q1.31 x Q1.31 -> Q2.62 -> Q1.31 */
+	tr = (int64_t)bottom->real * w->real - (int64_t)bottom->imag * wi;
+	ti = (int64_t)bottom->real * wi + (int64_t)bottom->imag * w->real;
+	tr = Q_SHIFT_RND(tr, 62, 31);
+	ti = Q_SHIFT_RND(ti, 62, 31);
+
+	if (ifft) {
+		top->real = sat_int32(re + tr);
+		top->imag = sat_int32(im + ti);
+		bottom->real = sat_int32(re - tr);
+		bottom->imag = sat_int32(im - ti);
+	} else {
+		/* Scale by 1/2 in every stage */
+		top->real = Q_SHIFT_RND(re + tr, 1, 0);
+		top->imag = Q_SHIFT_RND(im + ti, 1, 0);
+		bottom->real = Q_SHIFT_RND(re - tr, 1, 0);
+		bottom->imag = Q_SHIFT_RND(im - ti, 1, 0);
+	}
+}
+
+void fft_execute_32(struct fft_plan *plan, struct icomplex32 *buf, bool ifft)
+{
+	uint32_t half;
+	uint32_t step;
+	uint32_t k;
+	uint32_t j;
+
+	fft_bit_reverse(plan, buf);
+
+	for (half = 1; half < plan->size; half <<= 1) {
+		step = plan->size / (2 * half);
+		for (k = 0; k < plan->size; k += 2 * half)
+			for (j = 0; j < half; j++)
+				fft_butterfly(&buf[k + j], &buf[k + j + half],
+					      &plan->twiddle[j * step], ifft);
+	}
+}
@@ -25,6 +25,10 @@
 #define PLATFORM_HEAP_RUNTIME		1
 #define PLATFORM_HEAP_BUFFER		3
 
+#define uncache_to_cache(address)	address
+#define cache_to_uncache(address)	address
+#define is_uncached(address)		0
+
 #endif /* __PLATFORM_LIB_MEMORY_H__ */
 
 #else
@@ -104,8 +104,8 @@ static void dma_domain_notify_change(struct dma_chan_data *channel)
 	notify_data.id = NOTIFIER_ID_DMA_DOMAIN_CHANGE;
 	notify_data.target_core_mask =
 		NOTIFIER_TARGET_CORE_ALL_MASK & ~BIT(cpu_get_id());
-	notify_data.data_size = sizeof(*channel);
-	notify_data.data = channel;
+	notify_data.data_size = sizeof(channel);
+	notify_data.data = &channel;
 
 	notifier_event(&notify_data);
 }
@@ -430,18 +430,6 @@ static void dma_single_chan_domain_clear(struct ll_schedule_domain *domain)
 	dma_interrupt(data->channel, DMA_IRQ_CLEAR);
 }
 
-/**
- * \brief Checks if given task should be executed.
- * \param[in,out] domain Pointer to schedule domain.
- * \param[in,out] task Task to be checked.
- * \return True is task should be executed, false otherwise.
- */
-static bool dma_single_chan_domain_is_pending(struct ll_schedule_domain *domain,
-					      struct task *task)
-{
-	return task->start <= platform_timer_get(platform_timer);
-}
-
 /**
  * \brief Scheduling DMA channel change notification handling.
  * \param[in] message Id of the notification.
@@ -454,6 +442,7 @@ static void dma_domain_changed(int message, void *data, void *event_data)
 	struct dma_domain *dma_domain = ll_sch_domain_get_pdata(domain);
 	int core = cpu_get_id();
 	struct dma_domain_data *domain_data = &dma_domain->data[core];
+	struct dma_chan_data *channel = *(struct dma_chan_data **)event_data;
 
 	trace_ll("dma_domain_changed()");
 
@@ -466,7 +455,7 @@ static void dma_domain_changed(int message, void *data, void *event_data)
 	}
 
 	/* register to the new DMA channel */
-	if (dma_single_chan_domain_irq_register(event_data, domain_data,
+	if (dma_single_chan_domain_irq_register(channel, domain_data,
 						domain_data->handler,
 						domain_data->arg) < 0)
 		return;
@@ -520,5 +509,4 @@ struct ll_schedule_domain_ops dma_single_chan_domain_ops = {
 	.domain_disable		= dma_single_chan_domain_disable,
 	.domain_set		= dma_single_chan_domain_set,
 	.domain_clear		= dma_single_chan_domain_clear,
-	.domain_is_pending	= dma_single_chan_domain_is_pending,
 };
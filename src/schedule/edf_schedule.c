@@ -17,13 +17,30 @@
 #include <sof/schedule/schedule.h>
 #include <sof/schedule/task.h>
 #include <sof/sof.h>
+#include <sof/string.h>
 #include <ipc/topology.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
+/* initial number of tasks in a heap, doubled when full */
+#define EDF_HEAP_INIT_SIZE	8
+
+/* Binary min-heap of queued tasks, the index of each task in the heap is
+ * kept in its private data for removal.
+ */
+struct edf_heap {
+	struct task **tasks;
+	uint32_t count;
+	uint32_t size;
+	enum edf_heap_id id;
+	bool (*before)(struct task *a, struct task *b);
+};
+
 struct edf_schedule_data {
-	struct list_item list;	/* list of tasks in priority queue */
+	struct edf_heap ready;	/* tasks by priority and deadline */
+	struct edf_heap late;	/* non idle tasks by deadline */
 	uint32_t clock;
 	int irq;
 };
@@ -48,60 +65,177 @@ static void schedule_edf_task_run(struct task *task, void *data)
 	}
 }
 
-static void edf_scheduler_run(void *data)
+static uint64_t edf_task_deadline(struct task *task)
 {
-	struct edf_schedule_data *edf_sch = data;
-	uint64_t current = platform_timer_get(platform_timer);
-	int priority_next = SOF_TASK_PRI_IDLE;
-	uint64_t delta_next = UINT64_MAX;
-	struct edf_task_pdata *edf_pdata;
-	struct task *task_next = NULL;
-	struct list_item *tlist;
-	struct task *task;
-	uint64_t deadline;
-	uint64_t delta;
-	uint32_t flags;
+	struct edf_task_pdata *edf_pdata = edf_sch_get_pdata(task);
 
-	tracev_edf_sch("edf_scheduler_run()");
+	return edf_pdata->deadline;
+}
 
-	irq_local_disable(flags);
+static bool edf_ready_before(struct task *a, struct task *b)
+{
+	if (a->priority != b->priority)
+		return a->priority < b->priority;
 
-	/* find next task to run */
-	list_for_item(tlist, &edf_sch->list) {
-		task = container_of(tlist, struct task, list);
+	return edf_task_deadline(a) < edf_task_deadline(b);
+}
 
-		if (task->state != SOF_TASK_STATE_QUEUED &&
-		    task->state != SOF_TASK_STATE_RUNNING &&
-		    task->state != SOF_TASK_STATE_RESCHEDULE)
-			continue;
+static bool edf_late_before(struct task *a, struct task *b)
+{
+	return edf_task_deadline(a) < edf_task_deadline(b);
+}
+
+static void edf_heap_set(struct edf_heap *heap, uint32_t i, struct task *task)
+{
+	struct edf_task_pdata *edf_pdata = edf_sch_get_pdata(task);
 
-		edf_pdata = edf_sch_get_pdata(task);
+	heap->tasks[i] = task;
+	edf_pdata->heap_idx[heap->id] = i;
+}
 
-		deadline = edf_pdata->deadline;
+static void edf_heap_sift_up(struct edf_heap *heap, uint32_t i)
+{
+	struct task *task = heap->tasks[i];
+	uint32_t parent;
 
-		if (current >= deadline &&
-		    !(task->flags & SOF_SCHEDULE_FLAG_IDLE)) {
-			/* task needs to be scheduled ASAP */
-			task_next = task;
+	while (i) {
+		parent = (i - 1) >> 1;
+		if (!heap->before(task, heap->tasks[parent]))
 			break;
-		}
 
-		delta = deadline - current;
-
-		/* get highest priority */
-		if (task->priority < priority_next) {
-			priority_next = task->priority;
-			delta_next = delta;
-			task_next = task;
-		} else if (task->priority == priority_next) {
-			/* get earliest deadline */
-			if (delta <= delta_next) {
-				delta_next = delta;
-				task_next = task;
-			}
+		edf_heap_set(heap, i, heap->tasks[parent]);
+		i = parent;
+	}
+
+	edf_heap_set(heap, i, task);
+}
+
+static void edf_heap_sift_down(struct edf_heap *heap, uint32_t i)
+{
+	struct task *task = heap->tasks[i];
+	uint32_t child;
+
+	while ((child = 2 * i + 1) < heap->count) {
+		/* pick the earlier child */
+		if (child + 1 < heap->count &&
+		    heap->before(heap->tasks[child + 1], heap->tasks[child]))
+			child++;
+
+		if (!heap->before(heap->tasks[child], task))
+			break;
+
+		edf_heap_set(heap, i, heap->tasks[child]);
+		i = child;
+	}
+
+	edf_heap_set(heap, i, task);
+}
+
+static int edf_heap_insert(struct edf_heap *heap, struct task *task)
+{
+	struct task **tasks;
+	uint32_t size;
+	int ret;
+
+	if (heap->count == heap->size) {
+		size = heap->size ? heap->size * 2 : EDF_HEAP_INIT_SIZE;
+		tasks = rzalloc(RZONE_SYS_RUNTIME, SOF_MEM_CAPS_RAM,
+				size * sizeof(*tasks));
+		if (!tasks)
+			return -ENOMEM;
+
+		if (heap->tasks) {
+			ret = memcpy_s(tasks, size * sizeof(*tasks),
+				       heap->tasks,
+				       heap->count * sizeof(*tasks));
+			assert(!ret);
+			rfree(heap->tasks);
 		}
+
+		heap->tasks = tasks;
+		heap->size = size;
 	}
 
+	heap->tasks[heap->count] = task;
+	edf_heap_sift_up(heap, heap->count++);
+
+	return 0;
+}
+
+static void edf_heap_remove(struct edf_heap *heap, struct task *task)
+{
+	struct edf_task_pdata *edf_pdata = edf_sch_get_pdata(task);
+	uint32_t i = edf_pdata->heap_idx[heap->id];
+
+	if (i == EDF_HEAP_NONE)
+		return;
+
+	edf_pdata->heap_idx[heap->id] = EDF_HEAP_NONE;
+
+	/* move the last task into the hole */
+	if (i == --heap->count)
+		return;
+
+	heap->tasks[i] = heap->tasks[heap->count];
+	if (i && heap->before(heap->tasks[i], heap->tasks[(i - 1) >> 1]))
+		edf_heap_sift_up(heap, i);
+	else
+		edf_heap_sift_down(heap, i);
+}
+
+static void edf_heap_free(struct edf_heap *heap)
+{
+	rfree(heap->tasks);
+	heap->tasks = NULL;
+	heap->count = 0;
+	heap->size = 0;
+}
+
+static struct task *edf_heap_first(struct edf_heap *heap)
+{
+	return heap->count ? heap->tasks[0] : NULL;
+}
+
+static int edf_task_queue(struct edf_schedule_data *edf_sch, struct task *task)
+{
+	int ret;
+
+	ret = edf_heap_insert(&edf_sch->ready, task);
+	if (ret < 0 || task->flags & SOF_SCHEDULE_FLAG_IDLE)
+		return ret;
+
+	ret = edf_heap_insert(&edf_sch->late, task);
+	if (ret < 0)
+		edf_heap_remove(&edf_sch->ready, task);
+
+	return ret;
+}
+
+static void edf_task_dequeue(struct edf_schedule_data *edf_sch,
+			     struct task *task)
+{
+	edf_heap_remove(&edf_sch->ready, task);
+	edf_heap_remove(&edf_sch->late, task);
+}
+
+static void edf_scheduler_run(void *data)
+{
+	struct edf_schedule_data *edf_sch = data;
+	uint64_t current = platform_timer_get(platform_timer);
+	struct task *task_next;
+	uint32_t flags;
+
+	tracev_edf_sch("edf_scheduler_run()");
+
+	irq_local_disable(flags);
+
+	/* task past its deadline needs to be scheduled ASAP, otherwise
+	 * run the highest priority task with the earliest deadline
+	 */
+	task_next = edf_heap_first(&edf_sch->late);
+	if (!task_next || edf_task_deadline(task_next) > current)
+		task_next = edf_heap_first(&edf_sch->ready);
+
 	irq_local_enable(flags);
 
 	/* having next task is mandatory */
@@ -143,8 +277,12 @@ static void schedule_edf_task(void *data, struct task *task, uint64_t start,
 	/* calculate deadline */
 	edf_pdata->deadline = task->start + ticks_per_ms * period / 1000;
 
-	/* add task to the list */
-	list_item_append(&task->list, &edf_sch->list);
+	/* add task to the queues */
+	if (edf_task_queue(edf_sch, task) < 0) {
+		trace_edf_sch_error("schedule_edf_task() error: queue full");
+		irq_local_enable(flags);
+		return;
+	}
 
 	task->state = SOF_TASK_STATE_QUEUED;
 
@@ -168,6 +306,9 @@ static int schedule_edf_task_init(void *data, struct task *task)
 		return -ENOMEM;
 	}
 
+	edf_pdata->heap_idx[EDF_HEAP_READY] = EDF_HEAP_NONE;
+	edf_pdata->heap_idx[EDF_HEAP_LATE] = EDF_HEAP_NONE;
+
 	edf_sch_set_pdata(task, edf_pdata);
 
 	if (task_context_alloc(&edf_pdata->ctx) < 0)
@@ -209,6 +350,7 @@ static void schedule_edf_task_running(void *data, struct task *task)
 
 static void schedule_edf_task_complete(void *data, struct task *task)
 {
+	struct edf_schedule_data *edf_sch = data;
 	uint32_t flags;
 
 	tracev_edf_sch("schedule_edf_task_complete()");
@@ -220,13 +362,14 @@ static void schedule_edf_task_complete(void *data, struct task *task)
 		task->complete(task->data);
 
 	task->state = SOF_TASK_STATE_COMPLETED;
-	list_item_del(&task->list);
+	edf_task_dequeue(edf_sch, task);
 
 	irq_local_enable(flags);
 }
 
 static void schedule_edf_task_cancel(void *data, struct task *task)
 {
+	struct edf_schedule_data *edf_sch = data;
 	uint32_t flags;
 
 	tracev_edf_sch("schedule_edf_task_cancel()");
@@ -236,7 +379,7 @@ static void schedule_edf_task_cancel(void *data, struct task *task)
 	/* cancel and delete only if queued */
 	if (task->state == SOF_TASK_STATE_QUEUED) {
 		task->state = SOF_TASK_STATE_CANCEL;
-		list_item_del(&task->list);
+		edf_task_dequeue(edf_sch, task);
 	}
 
 	irq_local_enable(flags);
@@ -244,11 +387,14 @@ static void schedule_edf_task_cancel(void *data, struct task *task)
 
 static void schedule_edf_task_free(void *data, struct task *task)
 {
+	struct edf_schedule_data *edf_sch = data;
 	struct edf_task_pdata *edf_pdata = edf_sch_get_pdata(task);
 	uint32_t flags;
 
 	irq_local_disable(flags);
 
+	/* freed task must not be picked to run */
+	edf_task_dequeue(edf_sch, task);
 	task->state = SOF_TASK_STATE_FREE;
 
 	task_context_free(edf_pdata->ctx);
@@ -266,7 +412,10 @@ int scheduler_init_edf(void)
 	trace_edf_sch("edf_scheduler_init()");
 
 	edf_sch = rzalloc(RZONE_SYS, SOF_MEM_CAPS_RAM, sizeof(*edf_sch));
-	list_init(&edf_sch->list);
+	edf_sch->ready.id = EDF_HEAP_READY;
+	edf_sch->ready.before = edf_ready_before;
+	edf_sch->late.id = EDF_HEAP_LATE;
+	edf_sch->late.before = edf_late_before;
 	edf_sch->clock = PLATFORM_DEFAULT_CLOCK;
 
 	scheduler_init(SOF_SCHEDULE_EDF, &schedule_edf_ops, edf_sch);
@@ -300,7 +449,8 @@ static void scheduler_free_edf(void *data)
 	/* free main task context */
 	task_main_free();
 
-	list_item_del(&edf_sch->list);
+	edf_heap_free(&edf_sch->ready);
+	edf_heap_free(&edf_sch->late);
 
 	irq_local_enable(flags);
 }
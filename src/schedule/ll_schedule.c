@@ -7,6 +7,7 @@
 //         Tomasz Lauda <tomasz.lauda@linux.intel.com>
 
 #include <sof/atomic.h>
+#include <sof/bit.h>
 #include <sof/common.h>
 #include <sof/drivers/interrupt.h>
 #include <sof/drivers/timer.h>
@@ -14,8 +15,10 @@
 #include <sof/lib/cache.h>
 #include <sof/lib/clk.h>
 #include <sof/lib/cpu.h>
+#include <sof/lib/dvfs.h>
 #include <sof/lib/notifier.h>
 #include <sof/list.h>
+#include <sof/math/numbers.h>
 #include <sof/platform.h>
 #include <sof/schedule/ll_schedule.h>
 #include <sof/schedule/ll_schedule_domain.h>
@@ -23,37 +26,229 @@
 #include <sof/schedule/task.h>
 #include <sof/spinlock.h>
 #include <ipc/topology.h>
+#include <config.h>
 #include <errno.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
+/* Timer wheel, tasks are queued in the slot of their start time modulo the
+ * wheel length. A tick only looks at the slots that expired since the
+ * previous tick. Tasks of domains without time base are all in slot 0.
+ */
+#define LL_WHEEL_SLOTS		16
+#define LL_WHEEL_SLOT_US	CONFIG_SYSTICK_PERIOD
+
+#if CONFIG_DEBUG_LL_STATS || CONFIG_DVFS
+#define ll_stats_time() platform_timer_get(platform_timer)
+#else
+#define ll_stats_time() 0
+#endif
+
+#if CONFIG_DEBUG_LL_STATS
+/* statistics are traced once per 2^LL_STATS_WINDOW_SHIFT ticks */
+#define LL_STATS_WINDOW_SHIFT	10
+
+struct ll_schedule_stats {
+	uint32_t ticks;			/* ticks in the window */
+	uint32_t checked;		/* tasks checked for pending */
+	uint32_t run;			/* tasks run */
+	uint32_t tasks_time;		/* time in tasks on this tick */
+	uint32_t overhead;		/* scheduler time without tasks */
+	uint32_t overhead_max;		/* longest scheduler time of a tick */
+};
+#endif
+
 struct ll_schedule_data {
-	struct list_item tasks;			/* list of ll tasks */
+	struct list_item wheel[LL_WHEEL_SLOTS];	/* ll tasks by start slot */
+	uint32_t wheel_busy;			/* slots that may have tasks */
+	uint64_t wheel_pos;			/* oldest slot not expired */
+	uint64_t slot_ticks;			/* timer ticks per slot */
+	struct list_item pending;		/* tasks to run on this tick */
 	atomic_t num_tasks;			/* number of ll tasks */
 	struct notifier notifier;		/* notify frequency changes */
 	struct ll_schedule_domain *domain;	/* scheduling domain */
+#if CONFIG_DEBUG_LL_STATS
+	struct ll_schedule_stats stats;		/* per tick overhead */
+#endif
 };
 
 struct scheduler_ops schedule_ll_ops;
 
-static bool schedule_ll_is_pending(struct ll_schedule_data *sch)
+#if CONFIG_DEBUG_LL_STATS
+static void schedule_ll_stats_checked(struct ll_schedule_data *sch,
+				      uint32_t checked)
+{
+	sch->stats.checked += checked;
+}
+
+static void schedule_ll_stats_task(struct ll_schedule_data *sch,
+				   uint64_t start)
+{
+	sch->stats.run++;
+	sch->stats.tasks_time += ll_stats_time() - start;
+}
+
+static void schedule_ll_stats_tick(struct ll_schedule_data *sch,
+				   uint64_t start)
+{
+	struct ll_schedule_stats *stats = &sch->stats;
+	uint32_t overhead = ll_stats_time() - start - stats->tasks_time;
+
+	stats->tasks_time = 0;
+	stats->overhead += overhead;
+	stats->overhead_max = MAX(stats->overhead_max, overhead);
+
+	if (++stats->ticks < BIT(LL_STATS_WINDOW_SHIFT))
+		return;
+
+	trace_ll("ll stats: per tick checked %u run %u overhead avg %u max %u",
+		 stats->checked >> LL_STATS_WINDOW_SHIFT,
+		 stats->run >> LL_STATS_WINDOW_SHIFT,
+		 stats->overhead >> LL_STATS_WINDOW_SHIFT,
+		 stats->overhead_max);
+
+	stats->ticks = 0;
+	stats->checked = 0;
+	stats->run = 0;
+	stats->overhead = 0;
+	stats->overhead_max = 0;
+}
+#else
+static inline void schedule_ll_stats_checked(struct ll_schedule_data *sch,
+					     uint32_t checked)
+{
+}
+
+static inline void schedule_ll_stats_task(struct ll_schedule_data *sch,
+					  uint64_t start)
+{
+}
+
+static inline void schedule_ll_stats_tick(struct ll_schedule_data *sch,
+					  uint64_t start)
+{
+}
+#endif
+
+static uint32_t schedule_ll_task_slot(struct ll_schedule_data *sch,
+				      struct task *task)
+{
+	uint64_t pos;
+
+	if (!domain_is_timed(sch->domain))
+		return 0;
+
+	/* tasks already due go to the oldest slot checked on next tick */
+	pos = MAX(task->start / sch->slot_ticks, sch->wheel_pos);
+
+	return pos & (LL_WHEEL_SLOTS - 1);
+}
+
+/* Adds the task to the pending list in priority order. Slots are not
+ * sorted, the pending list only holds the few tasks due on this tick.
+ */
+static void schedule_ll_pending_add(struct ll_schedule_data *sch,
+				    struct task *task)
+{
+	struct list_item *tlist;
+	struct task *curr_task;
+
+	list_for_item_prev(tlist, &sch->pending) {
+		curr_task = container_of(tlist, struct task, list);
+		if (curr_task->priority <= task->priority)
+			break;
+	}
+
+	list_item_prepend(&task->list, tlist);
+	task->state = SOF_TASK_STATE_PENDING;
+}
+
+/* Moves the due tasks of the slot to the pending list, returns number of
+ * tasks checked.
+ */
+static uint32_t schedule_ll_slot_expire(struct ll_schedule_data *sch,
+					uint32_t slot, uint64_t now)
+{
+	struct list_item *wlist;
+	struct list_item *tlist;
+	struct task *task;
+	uint32_t checked = 0;
+
+	list_for_item_safe(wlist, tlist, &sch->wheel[slot]) {
+		task = container_of(wlist, struct task, list);
+		checked++;
+
+		/* task of a later wheel round */
+		if (task->start > now)
+			continue;
+
+		list_item_del(&task->list);
+		schedule_ll_pending_add(sch, task);
+	}
+
+	if (list_is_empty(&sch->wheel[slot]))
+		sch->wheel_busy &= ~BIT(slot);
+
+	return checked;
+}
+
+static uint32_t schedule_ll_is_pending_untimed(struct ll_schedule_data *sch)
 {
+	struct list_item *wlist;
 	struct list_item *tlist;
 	struct task *task;
-	uint32_t pending_count = 0;
+	uint32_t checked = 0;
 
 	/* mark each valid task as pending */
-	list_for_item(tlist, &sch->tasks) {
-		task = container_of(tlist, struct task, list);
+	list_for_item_safe(wlist, tlist, &sch->wheel[0]) {
+		task = container_of(wlist, struct task, list);
+		checked++;
 
 		if (domain_is_pending(sch->domain, task)) {
-			task->state = SOF_TASK_STATE_PENDING;
-			pending_count++;
+			list_item_del(&task->list);
+			schedule_ll_pending_add(sch, task);
 		}
 	}
 
-	return pending_count > 0;
+	return checked;
+}
+
+/* Collects the tasks due on this tick to the pending list */
+static bool schedule_ll_is_pending(struct ll_schedule_data *sch)
+{
+	uint64_t now;
+	uint64_t last;
+	uint64_t pos;
+	uint32_t checked = 0;
+	uint32_t slot;
+
+	if (!domain_is_timed(sch->domain)) {
+		checked = schedule_ll_is_pending_untimed(sch);
+		goto out;
+	}
+
+	now = platform_timer_get(platform_timer);
+	last = now / sch->slot_ticks;
+
+	/* after a long delay each slot is checked only once */
+	pos = sch->wheel_pos;
+	if (last >= pos + LL_WHEEL_SLOTS)
+		pos = last - LL_WHEEL_SLOTS + 1;
+
+	for (; pos <= last; pos++) {
+		slot = pos & (LL_WHEEL_SLOTS - 1);
+		if (sch->wheel_busy & BIT(slot))
+			checked += schedule_ll_slot_expire(sch, slot, now);
+	}
+
+	/* the current slot can still have tasks due later */
+	sch->wheel_pos = last;
+
+out:
+	schedule_ll_stats_checked(sch, checked);
+
+	return !list_is_empty(&sch->pending);
 }
 
 static void schedule_ll_task_update_start(struct ll_schedule_data *sch,
@@ -70,35 +265,50 @@ static void schedule_ll_task_update_start(struct ll_schedule_data *sch,
 		task->start = next + last_tick;
 }
 
+/* Queues the task at the end of the slot of its start, priority order is
+ * only applied when the task becomes pending.
+ */
+static void schedule_ll_task_insert(struct ll_schedule_data *sch,
+				    struct task *task)
+{
+	uint32_t slot = schedule_ll_task_slot(sch, task);
+
+	sch->wheel_busy |= BIT(slot);
+	list_item_append(&task->list, &sch->wheel[slot]);
+}
+
 static void schedule_ll_tasks_execute(struct ll_schedule_data *sch,
 				      uint64_t last_tick)
 {
-	struct list_item *wlist;
-	struct list_item *tlist;
 	struct task *task;
+	uint64_t start;
 	int cpu = cpu_get_id();
 
-	/* check each task in the list for pending */
-	list_for_item_safe(wlist, tlist, &sch->tasks) {
-		task = container_of(wlist, struct task, list);
+	/* run pending tasks in priority order */
+	while (!list_is_empty(&sch->pending)) {
+		task = list_first_item(&sch->pending, struct task, list);
+
+		start = ll_stats_time();
+		task->state = task->run(task->data);
+		schedule_ll_stats_task(sch, start);
+
+		/* task was cancelled while running */
+		if (list_is_empty(&task->list))
+			continue;
 
-		/* run task if its pending and remove from the list */
-		if (task->state == SOF_TASK_STATE_PENDING) {
-			task->state = task->run(task->data);
-
-			/* do we need to reschedule this task */
-			if (task->state == SOF_TASK_STATE_COMPLETED) {
-				list_item_del(&task->list);
-				atomic_sub(&sch->domain->total_num_tasks, 1);
-
-				/* don't enable irq, if no more tasks to do */
-				if (!atomic_sub(&sch->num_tasks, 1))
-					sch->domain->registered[cpu] = false;
-			} else {
-				/* update task's start time */
-				schedule_ll_task_update_start(sch, task,
-							      last_tick);
-			}
+		list_item_del(&task->list);
+
+		/* do we need to reschedule this task */
+		if (task->state == SOF_TASK_STATE_COMPLETED) {
+			atomic_sub(&sch->domain->total_num_tasks, 1);
+
+			/* don't enable irq, if no more tasks to do */
+			if (!atomic_sub(&sch->num_tasks, 1))
+				sch->domain->registered[cpu] = false;
+		} else {
+			/* update task's start time and queue it again */
+			schedule_ll_task_update_start(sch, task, last_tick);
+			schedule_ll_task_insert(sch, task);
 		}
 	}
 }
@@ -129,6 +339,7 @@ static void schedule_ll_tasks_run(void *data)
 	struct ll_schedule_data *sch = data;
 	uint32_t num_clients;
 	uint64_t last_tick;
+	uint64_t start = ll_stats_time();
 	uint32_t flags;
 
 	domain_disable(sch->domain, cpu_get_id());
@@ -158,6 +369,11 @@ static void schedule_ll_tasks_run(void *data)
 
 	spin_unlock(sch->domain->lock);
 
+	schedule_ll_stats_tick(sch, start);
+
+	/* tick time is the load seen by the frequency governor */
+	dvfs_ll_tick(start, ll_stats_time());
+
 	irq_local_enable(flags);
 }
 
@@ -215,24 +431,12 @@ static void schedule_ll_domain_clear(struct ll_schedule_data *sch)
 	domain_unregister(sch->domain, atomic_read(&sch->num_tasks));
 }
 
-static void schedule_ll_task_insert(struct task *task, struct list_item *tasks)
+/* Task list item is initialized empty and emptied when the task leaves the
+ * scheduler, so a queued task is found without searching the lists.
+ */
+static bool schedule_ll_task_is_queued(struct task *task)
 {
-	struct list_item *tlist;
-	struct task *curr_task;
-
-	/* tasks are added into the list in order */
-	list_for_item(tlist, tasks) {
-		curr_task = container_of(tlist, struct task, list);
-		if (task->priority <= curr_task->priority) {
-			list_item_append(&task->list, &curr_task->list);
-			return;
-		}
-	}
-
-	/* if task has not been added, means that it has the lowest
-	 * priority and should be added at the end of the list
-	 */
-	list_item_append(&task->list, tasks);
+	return !list_is_empty(&task->list);
 }
 
 static void schedule_ll_task(void *data, struct task *task, uint64_t start,
@@ -240,20 +444,13 @@ static void schedule_ll_task(void *data, struct task *task, uint64_t start,
 {
 	struct ll_schedule_data *sch = data;
 	struct ll_task_pdata *pdata;
-	struct list_item *tlist;
-	struct task *curr_task;
 	uint32_t flags;
 
 	irq_local_disable(flags);
 
-	/* check if task is already scheduled */
-	list_for_item(tlist, &sch->tasks) {
-		curr_task = container_of(tlist, struct task, list);
-
-		/* keep original start */
-		if (curr_task == task)
-			goto out;
-	}
+	/* check if task is already scheduled, keep original start */
+	if (schedule_ll_task_is_queued(task))
+		goto out;
 
 	pdata = ll_sch_get_pdata(task);
 
@@ -263,14 +460,9 @@ static void schedule_ll_task(void *data, struct task *task, uint64_t start,
 
 	pdata->period = period;
 
-	/* insert task into the list */
-	schedule_ll_task_insert(task, &sch->tasks);
-
 	/* set schedule domain */
-	if (schedule_ll_domain_set(sch, task, period) < 0) {
-		list_item_del(&task->list);
+	if (schedule_ll_domain_set(sch, task, period) < 0)
 		goto out;
-	}
 
 	task->start = sch->domain->ticks_per_ms * start / 1000;
 
@@ -279,6 +471,9 @@ static void schedule_ll_task(void *data, struct task *task, uint64_t start,
 	else
 		task->start += sch->domain->last_tick;
 
+	/* insert task into the wheel slot of its start */
+	schedule_ll_task_insert(sch, task);
+
 out:
 	irq_local_enable(flags);
 }
@@ -304,6 +499,7 @@ static int schedule_ll_task_init(void *data, struct task *task)
 						   sizeof(*ll_pdata));
 
 	ll_sch_set_pdata(task, ll_pdata);
+	list_init(&task->list);
 
 	return 0;
 }
@@ -327,22 +523,13 @@ static void schedule_ll_task_free(void *data, struct task *task)
 static void schedule_ll_task_cancel(void *data, struct task *task)
 {
 	struct ll_schedule_data *sch = data;
-	struct list_item *tlist;
-	struct task *curr_task;
 	uint32_t flags;
 
 	irq_local_disable(flags);
 
 	/* check to see if we are scheduled */
-	list_for_item(tlist, &sch->tasks) {
-		curr_task = container_of(tlist, struct task, list);
-
-		/* found it */
-		if (curr_task == task) {
-			schedule_ll_domain_clear(sch);
-			break;
-		}
-	}
+	if (schedule_ll_task_is_queued(task))
+		schedule_ll_domain_clear(sch);
 
 	/* remove work from list */
 	task->state = SOF_TASK_STATE_CANCEL;
@@ -354,8 +541,6 @@ static void schedule_ll_task_cancel(void *data, struct task *task)
 static void reschedule_ll_task(void *data, struct task *task, uint64_t start)
 {
 	struct ll_schedule_data *sch = data;
-	struct list_item *tlist;
-	struct task *curr_task;
 	uint32_t flags;
 	uint64_t time;
 
@@ -369,17 +554,19 @@ static void reschedule_ll_task(void *data, struct task *task, uint64_t start)
 	irq_local_disable(flags);
 
 	/* check to see if we are already scheduled */
-	list_for_item(tlist, &sch->tasks) {
-		curr_task = container_of(tlist, struct task, list);
-		/* found it */
-		if (curr_task == task) {
-			/* set start time */
-			task->start = time;
-			goto out;
-		}
+	if (!schedule_ll_task_is_queued(task)) {
+		trace_ll_error("reschedule_ll_task() error: task not found");
+		goto out;
 	}
 
-	trace_ll_error("reschedule_ll_task() error: task not found");
+	/* set start time */
+	task->start = time;
+
+	/* pending task is queued again after it has run */
+	if (task->state != SOF_TASK_STATE_PENDING) {
+		list_item_del(&task->list);
+		schedule_ll_task_insert(sch, task);
+	}
 
 out:
 	irq_local_enable(flags);
@@ -389,32 +576,64 @@ static void scheduler_free_ll(void *data)
 {
 	struct ll_schedule_data *sch = data;
 	uint32_t flags;
+	int i;
 
 	irq_local_disable(flags);
 
 	notifier_unregister(&sch->notifier);
 
-	list_item_del(&sch->tasks);
+	for (i = 0; i < LL_WHEEL_SLOTS; i++)
+		list_item_del(&sch->wheel[i]);
+	list_item_del(&sch->pending);
 
 	irq_local_enable(flags);
 }
 
+static void ll_scheduler_recalculate_task(struct ll_schedule_data *sch,
+					  struct clock_notify_data *clk_data,
+					  uint64_t current, struct task *task)
+{
+	uint64_t delta_ms = (task->start - current) /
+			    clk_data->old_ticks_per_msec;
+
+	task->start = delta_ms ?
+		current + sch->domain->ticks_per_ms * delta_ms :
+		current + (sch->domain->ticks_per_ms >> 3);
+}
+
 static void ll_scheduler_recalculate_tasks(struct ll_schedule_data *sch,
 					   struct clock_notify_data *clk_data)
 {
 	uint64_t current = platform_timer_get(platform_timer);
+	struct list_item *wlist;
 	struct list_item *tlist;
+	struct list_item tasks;
 	struct task *task;
-	uint64_t delta_ms;
+	int i;
 
-	list_for_item(tlist, &sch->tasks) {
+	/* slots change with the timer rate, take all tasks off the wheel */
+	list_init(&tasks);
+	for (i = 0; i < LL_WHEEL_SLOTS; i++) {
+		list_for_item_safe(wlist, tlist, &sch->wheel[i]) {
+			list_item_del(wlist);
+			list_item_append(wlist, &tasks);
+		}
+	}
+
+	sch->wheel_busy = 0;
+	sch->slot_ticks = sch->domain->ticks_per_ms * LL_WHEEL_SLOT_US / 1000;
+	sch->wheel_pos = current / sch->slot_ticks;
+
+	list_for_item(tlist, &sch->pending) {
 		task = container_of(tlist, struct task, list);
-		delta_ms = (task->start - current) /
-			clk_data->old_ticks_per_msec;
+		ll_scheduler_recalculate_task(sch, clk_data, current, task);
+	}
 
-		task->start = delta_ms ?
-			current + sch->domain->ticks_per_ms * delta_ms :
-			current + (sch->domain->ticks_per_ms >> 3);
+	list_for_item_safe(wlist, tlist, &tasks) {
+		task = container_of(wlist, struct task, list);
+		ll_scheduler_recalculate_task(sch, clk_data, current, task);
+		list_item_del(&task->list);
+		schedule_ll_task_insert(sch, task);
 	}
 }
 
@@ -439,10 +658,14 @@ static void ll_scheduler_notify(int message, void *data, void *event_data)
 int scheduler_init_ll(struct ll_schedule_domain *domain)
 {
 	struct ll_schedule_data *sch;
+	int i;
 
 	/* initialize scheduler private data */
 	sch = rzalloc(RZONE_SYS, SOF_MEM_CAPS_RAM, sizeof(*sch));
-	list_init(&sch->tasks);
+	for (i = 0; i < LL_WHEEL_SLOTS; i++)
+		list_init(&sch->wheel[i]);
+	list_init(&sch->pending);
+	sch->slot_ticks = domain->ticks_per_ms * LL_WHEEL_SLOT_US / 1000;
 	atomic_init(&sch->num_tasks, 0);
 	sch->domain = domain;
 
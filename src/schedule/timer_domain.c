@@ -112,12 +112,6 @@ static void timer_domain_clear(struct ll_schedule_domain *domain)
 	platform_timer_clear(timer_domain->timer);
 }
 
-static bool timer_domain_is_pending(struct ll_schedule_domain *domain,
-				    struct task *task)
-{
-	return task->start <= platform_timer_get(platform_timer);
-}
-
 struct ll_schedule_domain *timer_domain_init(struct timer *timer, int clk,
 					     uint64_t timeout)
 {
@@ -145,5 +139,4 @@ struct ll_schedule_domain_ops timer_domain_ops = {
 	.domain_disable		= timer_domain_disable,
 	.domain_set		= timer_domain_set,
 	.domain_clear		= timer_domain_clear,
-	.domain_is_pending	= timer_domain_is_pending
 };
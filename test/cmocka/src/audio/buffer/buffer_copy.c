@@ -137,6 +137,76 @@ static void test_audio_buffer_copy_fit_no_space_constraint(void **state)
 	buffer_free(snk);
 }
 
+static void test_audio_buffer_copy_span_bytes(void **state)
+{
+	(void)state;
+
+	struct sof_ipc_buffer test_buf_desc = {
+		.size = 256
+	};
+
+	struct comp_buffer *src = buffer_new(&test_buf_desc);
+	struct comp_buffer *snk = buffer_new(&test_buf_desc);
+
+	assert_non_null(src);
+	assert_non_null(snk);
+
+	comp_update_buffer_produce(src, 200);
+	comp_update_buffer_consume(src, 200);
+	comp_update_buffer_produce(snk, 100);
+
+	assert_int_equal(buffer_bytes_without_wrap(src, src->r_ptr), 56);
+	assert_int_equal(buffer_s16_without_wrap(src, src->r_ptr), 28);
+	assert_int_equal(buffer_s32_without_wrap(src, src->r_ptr), 14);
+	assert_int_equal(buffer_span_bytes(src, src->r_ptr, snk, snk->w_ptr,
+					   128), 56);
+	assert_int_equal(buffer_span_bytes(src, src->r_ptr, snk, snk->w_ptr,
+					   16), 16);
+	assert_ptr_equal(buffer_wrap(src, src->r_ptr + 60), src->addr + 4);
+
+	buffer_free(src);
+	buffer_free(snk);
+}
+
+static void test_audio_buffer_copy_wrap(void **state)
+{
+	(void)state;
+
+	struct sof_ipc_buffer test_buf_desc = {
+		.size = 64
+	};
+
+	struct comp_buffer *src = buffer_new(&test_buf_desc);
+	struct comp_buffer *snk = buffer_new(&test_buf_desc);
+	int16_t *sample;
+	int i;
+
+	assert_non_null(src);
+	assert_non_null(snk);
+
+	/* move source read and sink write positions close to the end */
+	comp_update_buffer_produce(src, 48);
+	comp_update_buffer_consume(src, 48);
+	comp_update_buffer_produce(snk, 56);
+	comp_update_buffer_consume(snk, 56);
+
+	for (i = 0; i < 16; i++) {
+		sample = buffer_write_frag_s16(src, i);
+		*sample = i + 1;
+	}
+	comp_update_buffer_produce(src, 32);
+
+	buffer_copy_s16(src, snk, 32);
+
+	for (i = 0; i < 16; i++) {
+		sample = buffer_write_frag_s16(snk, i);
+		assert_int_equal(*sample, i + 1);
+	}
+
+	buffer_free(src);
+	buffer_free(snk);
+}
+
 int main(void)
 {
 	const struct CMUnitTest tests[] = {
@@ -144,6 +214,8 @@ int main(void)
 		cmocka_unit_test(test_audio_buffer_copy_overrun),
 		cmocka_unit_test(test_audio_buffer_copy_success),
 		cmocka_unit_test(test_audio_buffer_copy_fit_space_constraint),
+		cmocka_unit_test(test_audio_buffer_copy_span_bytes),
+		cmocka_unit_test(test_audio_buffer_copy_wrap),
 		cmocka_unit_test(test_audio_buffer_copy_fit_no_space_constraint)
 	};
 
@@ -14,6 +14,7 @@
 #include <setjmp.h>
 #include <math.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <cmocka.h>
 
 static void test_audio_buffer_new(void **state)
@@ -34,10 +35,55 @@ static void test_audio_buffer_new(void **state)
 	buffer_free(buf);
 }
 
+static void test_audio_buffer_arena(void **state)
+{
+	(void)state;
+
+	struct sof_ipc_buffer test_buf_desc = {
+		.size = 256
+	};
+
+	struct comp_buffer *buf = buffer_new(&test_buf_desc);
+	void *arena = malloc(512);
+
+	assert_non_null(buf);
+	assert_false(buf->arena);
+
+	buffer_set_arena(buf, arena + 64, 256);
+
+	assert_true(buf->arena);
+	assert_ptr_equal(buf->addr, arena + 64);
+	assert_ptr_equal(buf->end_addr, arena + 64 + 256);
+	assert_int_equal(buf->free, 256);
+
+	/* smaller size stays in the arena slot */
+	assert_int_equal(buffer_set_size(buf, 128), 0);
+	assert_true(buf->arena);
+	assert_ptr_equal(buf->addr, arena + 64);
+	assert_ptr_equal(buf->end_addr, arena + 64 + 128);
+	assert_int_equal(buf->size, 128);
+
+	/* slot size can be used again */
+	assert_int_equal(buffer_set_size(buf, 256), 0);
+	assert_true(buf->arena);
+	assert_ptr_equal(buf->addr, arena + 64);
+	assert_int_equal(buf->size, 256);
+
+	/* growing beyond the slot moves to own memory */
+	assert_int_equal(buffer_set_size(buf, 384), 0);
+	assert_false(buf->arena);
+	assert_true(buf->addr < arena || buf->addr >= arena + 512);
+	assert_int_equal(buf->size, 384);
+
+	buffer_free(buf);
+	free(arena);
+}
+
 int main(void)
 {
 	const struct CMUnitTest tests[] = {
-		cmocka_unit_test(test_audio_buffer_new)
+		cmocka_unit_test(test_audio_buffer_new),
+		cmocka_unit_test(test_audio_buffer_arena),
 	};
 
 	cmocka_set_message_output(CM_OUTPUT_TAP);
@@ -0,0 +1,170 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2019 Intel Corporation. All rights reserved.
+
+#include <stdint.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <math.h>
+#include <cmocka.h>
+
+#include <sof/audio/eq_fir/fir_fft.h>
+#include <sof/math/fft.h>
+#include <user/eq.h>
+
+#define TEST_FRAMES	2048
+
+/* Max error relative to full scale versus direct form */
+#define FFT_TOLERANCE	0.000001
+
+struct fir_fft_test_state {
+	union {
+		struct sof_eq_fir_coef_data config;
+		int16_t words[SOF_EQ_FIR_COEF_NHEADER + SOF_EQ_FIR_MAX_LENGTH];
+	} blob;
+	struct fir_fft_state fft;
+	struct fft_plan plan;
+	uint8_t plan_data[FFT_SIZE_MAX * 8];
+	struct icomplex32 work[FIR_FFT_SIZE];
+	int32_t data[3 * FIR_FFT_BLOCK +
+		     2 * 3 * FIR_FFT_SIZE * 2];
+	int32_t x[TEST_FRAMES];
+	int32_t ref[TEST_FRAMES];
+};
+
+static struct fir_fft_test_state st;
+
+/* Windowed sinc low-pass with gain, Q1.15 taps */
+static void set_lowpass(int length, double gain, int out_shift)
+{
+	double n;
+	double h;
+	int i;
+
+	st.blob.config.length = length;
+	st.blob.config.out_shift = out_shift;
+	for (i = 0; i < length; i++) {
+		n = i - (length - 1) / 2.0;
+		h = n ? sin(0.2 * M_PI * n) / (M_PI * n) : 0.2;
+		h *= 0.54 - 0.46 * cos(2 * M_PI * i / (length - 1));
+		st.blob.config.coef[i] = (int16_t)lrint(h * gain * 32767);
+	}
+}
+
+static void fill_noise(int32_t *x, int n, int shift)
+{
+	uint32_t seed = 7;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		seed = seed * 1664525 + 1013904223;
+		x[i] = (int32_t)seed >> shift;
+	}
+}
+
+/* Direct form reference with the arithmetic of the generic fir_32x16(),
+ * Q1.31 input times Q1.15 taps accumulated and shifted back to Q1.31.
+ */
+static void ref_fir(void)
+{
+	struct sof_eq_fir_coef_data *config = &st.blob.config;
+	int64_t y;
+	int i;
+	int k;
+
+	for (i = 0; i < TEST_FRAMES; i++) {
+		y = 0;
+		for (k = 0; k < config->length && k <= i; k++)
+			y += (int64_t)config->coef[k] * st.x[i - k];
+
+		y >>= 15 + config->out_shift;
+		if (y > INT32_MAX)
+			y = INT32_MAX;
+		else if (y < INT32_MIN)
+			y = INT32_MIN;
+
+		st.ref[i] = y;
+	}
+}
+
+static void run_and_compare(void)
+{
+	int32_t *data = st.data;
+	int32_t y;
+	int i;
+
+	assert_int_equal(fft_plan_init(&st.plan, st.plan_data, FIR_FFT_SIZE),
+			 0);
+
+	assert_true(fir_fft_init_coef(&st.fft, &st.blob.config) <=
+		    sizeof(st.data));
+	fir_fft_init_data(&st.fft, &st.blob.config, &st.plan, st.work,
+			  &data);
+
+	ref_fir();
+
+	/* FFT output is FIR_FFT_BLOCK samples late */
+	for (i = 0; i < TEST_FRAMES; i++) {
+		y = fir_fft_32x16(&st.fft, st.x[i]);
+		if (i < FIR_FFT_BLOCK) {
+			assert_int_equal(y, 0);
+			continue;
+		}
+
+		assert_true(fabs((double)y - st.ref[i - FIR_FFT_BLOCK]) <
+			    FFT_TOLERANCE * 2147483648.0);
+	}
+}
+
+static void test_fir_fft_lowpass(void **state)
+{
+	(void)state;
+
+	set_lowpass(FIR_FFT_TAPS_MIN, 1.0, 0);
+	fill_noise(st.x, TEST_FRAMES, 1);
+	run_and_compare();
+}
+
+static void test_fir_fft_max_length_shift(void **state)
+{
+	(void)state;
+
+	/* Partial last partition and output shift */
+	set_lowpass(SOF_EQ_FIR_MAX_LENGTH - 4, 3.5, 2);
+	fill_noise(st.x, TEST_FRAMES, 0);
+	run_and_compare();
+}
+
+static void test_fir_fft_bypass(void **state)
+{
+	int32_t *data = st.data;
+	int i;
+
+	(void)state;
+
+	assert_int_equal(fft_plan_init(&st.plan, st.plan_data, FIR_FFT_SIZE),
+			 0);
+	assert_true(fir_fft_init_coef(&st.fft, NULL) > 0);
+	fir_fft_init_data(&st.fft, NULL, &st.plan, st.work, &data);
+
+	/* Bypass channels are delayed to stay aligned with filtered ones */
+	fill_noise(st.x, TEST_FRAMES, 0);
+	for (i = 0; i < TEST_FRAMES; i++)
+		assert_int_equal(fir_fft_32x16(&st.fft, st.x[i]),
+				 i < FIR_FFT_BLOCK ? 0 :
+				 st.x[i - FIR_FFT_BLOCK]);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_fir_fft_lowpass),
+		cmocka_unit_test(test_fir_fft_max_length_shift),
+		cmocka_unit_test(test_fir_fft_bypass),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,222 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2019 Intel Corporation. All rights reserved.
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+
+#include <sof/audio/eq_iir/iir.h>
+#include <user/eq.h>
+#include <errno.h>
+
+#define TEST_CHANNELS		4
+#define TEST_FRAMES		509
+#define TEST_RESPONSE_WORDS	(SOF_EQ_IIR_NHEADER_DF2T + \
+				 4 * SOF_EQ_IIR_NBIQUAD_DF2T)
+
+#if IIR_MULTICHANNEL
+
+/* Biquads as {a2, a1, b2, b1, b0, shift, gain}, a in Q2.30, b in Q2.30 and
+ * gain in Q2.14. The feedback coefficients are stored with negated sign.
+ */
+static const int32_t lowpass[SOF_EQ_IIR_NBIQUAD_DF2T] = {
+	-322122547, 966367642, 214748365, 429496730, 214748365, 0, 13107
+};
+
+static const int32_t highpass[SOF_EQ_IIR_NBIQUAD_DF2T] = {
+	-429496730, 644245094, 751619277, -1503238554, 751619277, 1, 16384
+};
+
+static const int32_t peak[SOF_EQ_IIR_NBIQUAD_DF2T] = {
+	-858993459, 1717986918, 966367642, -1717986918, 1181116006, 0, 19661
+};
+
+struct iir_mc_test_state {
+	int32_t response[TEST_CHANNELS][TEST_RESPONSE_WORDS];
+	struct iir_state_df2t iir[TEST_CHANNELS];
+	int64_t delay[TEST_CHANNELS * 2 * 4];
+	struct iir_mc_state_df2t mc;
+	int32_t *mc_data;
+	int32_t ref[TEST_FRAMES * TEST_CHANNELS];
+	int32_t out[TEST_FRAMES * TEST_CHANNELS];
+};
+
+static void set_response(struct iir_mc_test_state *st, int ch, int biquads,
+			 int in_series, const int32_t *biquad[])
+{
+	struct sof_eq_iir_header_df2t *eq =
+		(struct sof_eq_iir_header_df2t *)st->response[ch];
+	int i;
+	int k;
+
+	eq->num_sections = biquads;
+	eq->num_sections_in_series = in_series;
+	for (i = 0; i < biquads; i++)
+		for (k = 0; k < SOF_EQ_IIR_NBIQUAD_DF2T; k++)
+			eq->biquads[i * SOF_EQ_IIR_NBIQUAD_DF2T + k] =
+				biquad[i][k];
+
+	assert_true(iir_init_coef_df2t(&st->iir[ch], eq) > 0);
+}
+
+static int setup(void **state)
+{
+	struct iir_mc_test_state *st = test_calloc(1, sizeof(*st));
+	int ch;
+
+	for (ch = 0; ch < TEST_CHANNELS; ch++)
+		iir_reset_df2t(&st->iir[ch]);
+
+	*state = st;
+
+	return 0;
+}
+
+static int teardown(void **state)
+{
+	struct iir_mc_test_state *st = *state;
+
+	test_free(st->mc_data);
+	test_free(st);
+
+	return 0;
+}
+
+/* Full scale noise with runs of extreme values to hit saturation */
+static void fill_input(int32_t *x, int n)
+{
+	uint32_t seed = 0x12345678;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		seed = seed * 1664525 + 1013904223;
+		if ((i / 64) % 5 == 3)
+			x[i] = seed & 0x100 ? INT32_MAX : INT32_MIN;
+		else
+			x[i] = (int32_t)seed;
+	}
+}
+
+static void run_and_compare(struct iir_mc_test_state *st)
+{
+	int64_t *delay = st->delay;
+	int size;
+	int ch;
+	int i;
+	int n;
+
+	for (ch = 0; ch < TEST_CHANNELS; ch++)
+		if (st->iir[ch].biquads)
+			iir_init_delay_df2t(&st->iir[ch], &delay);
+
+	size = iir_mc_init_coef_df2t(&st->mc, st->iir, TEST_CHANNELS);
+	assert_true(size > 0);
+
+	st->mc_data = test_malloc(size);
+	iir_mc_init_delay_df2t(&st->mc, st->iir, st->mc_data);
+
+	fill_input(st->ref, TEST_FRAMES * TEST_CHANNELS);
+	fill_input(st->out, TEST_FRAMES * TEST_CHANNELS);
+
+	for (i = 0; i < TEST_FRAMES * TEST_CHANNELS; i++)
+		st->ref[i] = iir_df2t(&st->iir[i % TEST_CHANNELS], st->ref[i]);
+
+	/* Uneven block sizes to check the state carries over blocks */
+	for (i = 0; i < TEST_FRAMES; i += n) {
+		n = 1 + i % 37;
+		if (i + n > TEST_FRAMES)
+			n = TEST_FRAMES - i;
+		iir_mc_df2t(&st->mc, &st->out[i * TEST_CHANNELS], n);
+	}
+
+	for (i = 0; i < TEST_FRAMES * TEST_CHANNELS; i++)
+		assert_int_equal(st->out[i], st->ref[i]);
+}
+
+static void test_iir_mc_series(void **state)
+{
+	struct iir_mc_test_state *st = *state;
+	const int32_t *a[] = { lowpass, peak };
+	const int32_t *b[] = { highpass, lowpass };
+
+	set_response(st, 0, 2, 2, a);
+	set_response(st, 1, 2, 2, b);
+	set_response(st, 3, 2, 2, a);
+
+	/* Channel 2 is in bypass */
+	run_and_compare(st);
+}
+
+static void test_iir_mc_parallel(void **state)
+{
+	struct iir_mc_test_state *st = *state;
+	const int32_t *a[] = { lowpass, peak, highpass, peak };
+	const int32_t *b[] = { peak, highpass, lowpass, lowpass };
+
+	set_response(st, 0, 4, 2, a);
+	set_response(st, 2, 4, 2, b);
+	set_response(st, 3, 4, 2, b);
+
+	/* Channel 1 is in bypass */
+	run_and_compare(st);
+}
+
+static void test_iir_mc_layout_mismatch(void **state)
+{
+	struct iir_mc_test_state *st = *state;
+	const int32_t *a[] = { lowpass, peak, highpass, peak };
+
+	set_response(st, 0, 2, 2, a);
+	set_response(st, 1, 2, 1, a);
+
+	assert_int_equal(iir_mc_init_coef_df2t(&st->mc, st->iir,
+					       TEST_CHANNELS), -EINVAL);
+
+	set_response(st, 1, 4, 4, a);
+
+	assert_int_equal(iir_mc_init_coef_df2t(&st->mc, st->iir,
+					       TEST_CHANNELS), -EINVAL);
+}
+
+static void test_iir_mc_all_bypass(void **state)
+{
+	struct iir_mc_test_state *st = *state;
+
+	assert_int_equal(iir_mc_init_coef_df2t(&st->mc, st->iir,
+					       TEST_CHANNELS), -EINVAL);
+}
+
+#else
+
+/* The multichannel engine is only built with the generic IIR variant */
+static void test_iir_mc_disabled(void **state)
+{
+	skip();
+}
+
+#endif /* IIR_MULTICHANNEL */
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+#if IIR_MULTICHANNEL
+		cmocka_unit_test_setup_teardown(test_iir_mc_series,
+						setup, teardown),
+		cmocka_unit_test_setup_teardown(test_iir_mc_parallel,
+						setup, teardown),
+		cmocka_unit_test_setup_teardown(test_iir_mc_layout_mismatch,
+						setup, teardown),
+		cmocka_unit_test_setup_teardown(test_iir_mc_all_bypass,
+						setup, teardown),
+#else
+		cmocka_unit_test(test_iir_mc_disabled),
+#endif
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
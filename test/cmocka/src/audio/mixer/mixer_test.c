@@ -10,6 +10,7 @@
 #include <setjmp.h>
 #include <stdint.h>
 #include <malloc.h>
+#include <stdlib.h>
 #include <cmocka.h>
 
 #include <sof/list.h>
@@ -18,6 +19,7 @@
 #include <sof/audio/component.h>
 #include <sof/audio/format.h>
 #include <sof/audio/mixer.h>
+#include <ipc/control.h>
 
 #include "comp_mock.h"
 
@@ -293,9 +295,166 @@ static void test_audio_mixer_copy(void **state)
 	}
 }
 
+static struct mix_test_case mix_gain_test_case = {
+	.num_sources = 3,
+	.num_chans = 2,
+	.name = "test_audio_mixer_copy_gain",
+	.sources = NULL
+};
+
+/* set Q1.16 gain of each source, sources are listed in reverse order */
+static void set_source_gains(struct mix_test_case *tc, const int32_t *gain)
+{
+	struct sof_ipc_ctrl_data *cdata;
+	size_t size = sizeof(*cdata) + tc->num_sources *
+		sizeof(struct sof_ipc_ctrl_value_comp);
+	int src_idx;
+	int ret;
+
+	cdata = calloc(1, size);
+	assert_non_null(cdata);
+
+	cdata->cmd = SOF_CTRL_CMD_VOLUME;
+	cdata->num_elems = tc->num_sources;
+	for (src_idx = 0; src_idx < tc->num_sources; ++src_idx) {
+		cdata->compv[src_idx].index = tc->num_sources - 1 - src_idx;
+		cdata->compv[src_idx].uvalue = gain[src_idx];
+	}
+
+	ret = mixer_drv_mock.ops.cmd(mixer_dev_mock, COMP_CMD_SET_VALUE,
+				     cdata, size);
+	assert_int_equal(ret, 0);
+
+	free(cdata);
+}
+
+static void test_audio_mixer_get_gain(void **state)
+{
+	struct mix_test_case *tc = *((struct mix_test_case **)state);
+	const int32_t gain[] = { MIXER_GAIN_UNITY, MIXER_GAIN_UNITY / 2, 0 };
+	struct sof_ipc_ctrl_data *cdata;
+	size_t size = sizeof(*cdata) +
+		2 * sizeof(struct sof_ipc_ctrl_value_comp);
+	int ret;
+
+	set_source_gains(tc, gain);
+
+	cdata = calloc(1, size);
+	assert_non_null(cdata);
+
+	/* requested sources in any order, gains listed in reverse */
+	cdata->cmd = SOF_CTRL_CMD_VOLUME;
+	cdata->num_elems = 2;
+	cdata->compv[0].index = 1;
+	cdata->compv[1].index = 0;
+
+	ret = mixer_drv_mock.ops.cmd(mixer_dev_mock, COMP_CMD_GET_VALUE,
+				     cdata, size);
+	assert_int_equal(ret, 0);
+	assert_int_equal(cdata->compv[0].uvalue, gain[1]);
+	assert_int_equal(cdata->compv[1].uvalue, gain[2]);
+
+	/* elements past the message are refused */
+	ret = mixer_drv_mock.ops.cmd(mixer_dev_mock, COMP_CMD_GET_VALUE,
+				     cdata, size - 1);
+	assert_int_equal(ret, -EINVAL);
+
+	free(cdata);
+}
+
+static void fill_sources(struct mix_test_case *tc)
+{
+	int32_t *samples;
+	int src_idx;
+	int smp;
+
+	for (src_idx = 0; src_idx < tc->num_sources; ++src_idx) {
+		samples = tc->sources[src_idx].buf->addr;
+
+		for (smp = 0; smp < MIX_TEST_SAMPLES * tc->num_chans; ++smp)
+			samples[smp] = (smp & 1 ? -1 : 1) *
+				(INT32_MAX / (src_idx + 2) - smp * 1000);
+
+		tc->sources[src_idx].buf->avail =
+			tc->sources[src_idx].buf->size;
+	}
+}
+
+static void test_audio_mixer_copy_gain(void **state)
+{
+	struct mix_test_case *tc = *((struct mix_test_case **)state);
+	const int32_t gain[] = { MIXER_GAIN_UNITY, MIXER_GAIN_UNITY / 2, 0 };
+	int32_t *out_samples = post_mixer_buf->addr;
+	int32_t *samples;
+	int64_t sum;
+	int src_idx;
+	int smp;
+
+	mixer_dev_mock->params.channels = tc->num_chans;
+	set_source_gains(tc, gain);
+	fill_sources(tc);
+
+	mixer_drv_mock.ops.copy(mixer_dev_mock);
+
+	for (smp = 0; smp < MIX_TEST_SAMPLES * tc->num_chans; ++smp) {
+		sum = 0;
+		for (src_idx = 0; src_idx < tc->num_sources; ++src_idx) {
+			samples = tc->sources[src_idx].buf->addr;
+			sum += ((int64_t)samples[smp] * gain[src_idx]) >>
+				MIXER_GAIN_Q;
+		}
+
+		assert_int_equal(out_samples[smp], sat_int32(sum));
+	}
+}
+
+static void test_audio_mixer_copy_gain_ramp(void **state)
+{
+	struct mix_test_case *tc = *((struct mix_test_case **)state);
+	const int32_t unity[] = { MIXER_GAIN_UNITY, MIXER_GAIN_UNITY,
+				  MIXER_GAIN_UNITY };
+	const int32_t mute[] = { 0, MIXER_GAIN_UNITY, MIXER_GAIN_UNITY };
+	int32_t *out_samples = post_mixer_buf->addr;
+	uint32_t ramp_frames;
+	int32_t *samples;
+	int32_t gain;
+	int64_t sum;
+	int frame;
+	int smp;
+
+	/* prepare again with a rate giving a ramp shorter than the copy */
+	mixer_dev_mock->params.channels = tc->num_chans;
+	mixer_dev_mock->params.rate = 1600;
+	ramp_frames = 1600 * MIXER_GAIN_RAMP_MS / 1000;
+	mixer_dev_mock->state = COMP_STATE_READY;
+	mixer_drv_mock.ops.prepare(mixer_dev_mock);
+	mixer_dev_mock->state = COMP_STATE_ACTIVE;
+
+	set_source_gains(tc, unity);
+	set_source_gains(tc, mute);
+	fill_sources(tc);
+
+	mixer_drv_mock.ops.copy(mixer_dev_mock);
+
+	for (smp = 0; smp < MIX_TEST_SAMPLES * tc->num_chans; ++smp) {
+		frame = smp / tc->num_chans;
+		gain = frame < ramp_frames ? MIXER_GAIN_UNITY -
+			frame * (MIXER_GAIN_UNITY / ramp_frames) : 0;
+
+		samples = tc->sources[0].buf->addr;
+		sum = ((int64_t)samples[smp] * gain) >> MIXER_GAIN_Q;
+		samples = tc->sources[1].buf->addr;
+		sum += samples[smp];
+		samples = tc->sources[2].buf->addr;
+		sum += samples[smp];
+
+		assert_int_equal(out_samples[smp], sat_int32(sum));
+	}
+}
+
 int main(void)
 {
-	struct CMUnitTest tests[ARRAY_SIZE(mix_test_cases) + 2];
+	struct CMUnitTest tests[ARRAY_SIZE(mix_test_cases) + 5];
 
 	int i;
 	int cur_test_case = 0;
@@ -312,7 +471,25 @@ int main(void)
 	tests[1].teardown_func = test_teardown;
 	tests[1].name = "test_audio_mixer_prepare_no_sources";
 
-	for (i = 2; i < ARRAY_SIZE(tests); (++i, ++cur_test_case)) {
+	tests[2].test_func = test_audio_mixer_copy_gain;
+	tests[2].initial_state = &mix_gain_test_case;
+	tests[2].setup_func = test_setup;
+	tests[2].teardown_func = test_teardown;
+	tests[2].name = "test_audio_mixer_copy_gain";
+
+	tests[3].test_func = test_audio_mixer_copy_gain_ramp;
+	tests[3].initial_state = &mix_gain_test_case;
+	tests[3].setup_func = test_setup;
+	tests[3].teardown_func = test_teardown;
+	tests[3].name = "test_audio_mixer_copy_gain_ramp";
+
+	tests[4].test_func = test_audio_mixer_get_gain;
+	tests[4].initial_state = &mix_gain_test_case;
+	tests[4].setup_func = test_setup;
+	tests[4].teardown_func = test_teardown;
+	tests[4].name = "test_audio_mixer_get_gain";
+
+	for (i = 5; i < ARRAY_SIZE(tests); (++i, ++cur_test_case)) {
 		tests[i].test_func = test_audio_mixer_copy;
 		tests[i].initial_state = &mix_test_cases[cur_test_case];
 		tests[i].setup_func = test_setup;
@@ -78,6 +78,10 @@ static uint8_t masks[][MUX_MAX_STREAMS][PLATFORM_MAX_CHANNELS] = {
 	  { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, },
 	  { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, },
 	  { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, }, },
+	{ { 0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01, },
+	  { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, },
+	  { 0x02, 0x01, 0x08, 0x04, 0x20, 0x10, 0x80, 0x40, },
+	  { 0x10, 0x20, 0x40, 0x80, 0x01, 0x02, 0x04, 0x08, }, },
 };
 
 static int setup_group(void **state)
@@ -128,6 +132,8 @@ static void prepare_sinks(struct test_data *td, size_t sample_size)
 		td->sinks[i]->free = sample_size * PLATFORM_MAX_CHANNELS;
 		td->outputs[i] = malloc(sample_size * PLATFORM_MAX_CHANNELS);
 		td->sinks[i]->w_ptr = td->outputs[i];
+		td->sinks[i]->addr = td->outputs[i];
+		td->sinks[i]->end_addr = td->outputs[i] + td->sinks[i]->free;
 	}
 }
 
@@ -143,6 +149,9 @@ static void prepare_source(struct test_data *td, size_t sample_size)
 		td->source->r_ptr = input_16b;
 	else
 		td->source->r_ptr = input_32b;
+
+	td->source->addr = td->source->r_ptr;
+	td->source->end_addr = td->source->r_ptr + td->source->avail;
 }
 
 static int setup_test_case(void **state)
@@ -90,6 +90,10 @@ static uint8_t masks[][MUX_MAX_STREAMS][PLATFORM_MAX_CHANNELS] = {
 	  { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, },
 	  { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, },
 	  { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, }, },
+	{ { 0x02, 0x01, },
+	  { 0x00, 0x00, 0x01, 0x80, },
+	  { 0x00, 0x00, 0x00, 0x00, 0x04, 0x08, },
+	  { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x40, }, },
 };
 
 static int setup_group(void **state)
@@ -137,6 +141,8 @@ static void prepare_sink(struct test_data *td, size_t sample_size)
 	td->sink->free = sample_size * PLATFORM_MAX_CHANNELS;
 	td->output = malloc(sample_size * PLATFORM_MAX_CHANNELS);
 	td->sink->w_ptr = td->output;
+	td->sink->addr = td->output;
+	td->sink->end_addr = td->output + td->sink->free;
 }
 
 static void prepare_sources(struct test_data *td, size_t sample_size)
@@ -154,6 +160,10 @@ static void prepare_sources(struct test_data *td, size_t sample_size)
 			td->sources[i]->r_ptr = input_16b[i];
 		else
 			td->sources[i]->r_ptr = input_32b[i];
+
+		td->sources[i]->addr = td->sources[i]->r_ptr;
+		td->sources[i]->end_addr = td->sources[i]->r_ptr +
+					   td->sources[i]->avail;
 	}
 }
 
@@ -0,0 +1,235 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2019 Intel Corporation. All rights reserved.
+
+#include <sof/audio/buffer.h>
+#include <sof/audio/pcm_converter.h>
+#include <ipc/stream.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+
+/* samples converted by each test */
+#define TEST_SAMPLES		8
+
+/* buffer length in samples, conversions starting near the end wrap */
+#define TEST_BUFFER_SAMPLES	12
+
+struct pcm_test_parameters {
+	uint32_t source_format;
+	uint32_t sink_format;
+	uint32_t source_offset;	/* read position in samples */
+	uint32_t sink_offset;	/* write position in samples */
+};
+
+static const int32_t input_s16[TEST_SAMPLES] = {
+	0, 1, -1, 0x1234, -0x1234, 0x7fff, -0x8000, 0x4000,
+};
+
+/* containers with both clear and sign extended upper bytes */
+static const int32_t input_s24[TEST_SAMPLES] = {
+	0, 1, 0x00ffffff, 0x123456, 0xff876543, 0x7fffff, 0x800000, 0x7fff80,
+};
+
+static const int32_t input_s32[TEST_SAMPLES] = {
+	0, 1, -1, 0x12345678, -0x12345678, INT32_MAX, INT32_MIN, 0x7fff8000,
+};
+
+void __panic(uint32_t p, char *filename, uint32_t linenum)
+{
+	(void)p;
+	(void)filename;
+	(void)linenum;
+
+	fail();
+}
+
+static uint32_t sample_bytes(uint32_t format)
+{
+	return format == SOF_IPC_FRAME_S16_LE ? 2 : 4;
+}
+
+static uint32_t sample_bits(uint32_t format)
+{
+	switch (format) {
+	case SOF_IPC_FRAME_S16_LE:
+		return 16;
+	case SOF_IPC_FRAME_S24_4LE:
+		return 24;
+	default:
+		return 32;
+	}
+}
+
+static const int32_t *test_input(uint32_t format)
+{
+	switch (format) {
+	case SOF_IPC_FRAME_S16_LE:
+		return input_s16;
+	case SOF_IPC_FRAME_S24_4LE:
+		return input_s24;
+	default:
+		return input_s32;
+	}
+}
+
+/* reference conversion with rounding and saturation done in 64 bits */
+static int32_t expected_sample(int32_t raw, uint32_t source_format,
+			       uint32_t sink_format)
+{
+	uint32_t in_bits = sample_bits(source_format);
+	uint32_t out_bits = sample_bits(sink_format);
+	int64_t max = ((int64_t)1 << (out_bits - 1)) - 1;
+	int64_t min = -((int64_t)1 << (out_bits - 1));
+	int64_t x = raw;
+
+	/* same format is copied as it is */
+	if (source_format == sink_format)
+		return raw;
+
+	if (in_bits == 24)
+		x = (int32_t)((uint32_t)raw << 8) >> 8;
+
+	if (out_bits > in_bits)
+		return x * ((int64_t)1 << (out_bits - in_bits));
+
+	x = (x + ((int64_t)1 << (in_bits - out_bits - 1))) >>
+		(in_bits - out_bits);
+
+	return x > max ? max : x < min ? min : x;
+}
+
+static void write_sample(struct comp_buffer *buffer, uint32_t format,
+			 uint32_t idx, int32_t sample)
+{
+	if (format == SOF_IPC_FRAME_S16_LE)
+		((int16_t *)buffer->addr)[idx] = sample;
+	else
+		((int32_t *)buffer->addr)[idx] = sample;
+}
+
+static int32_t read_sample(struct comp_buffer *buffer, uint32_t format,
+			   uint32_t idx)
+{
+	if (format == SOF_IPC_FRAME_S16_LE)
+		return ((int16_t *)buffer->addr)[idx];
+
+	return ((int32_t *)buffer->addr)[idx];
+}
+
+static struct comp_buffer *create_buffer(uint32_t format, uint32_t offset)
+{
+	struct comp_buffer *buffer = test_calloc(1, sizeof(*buffer));
+	uint32_t bytes = sample_bytes(format);
+
+	buffer->size = TEST_BUFFER_SAMPLES * bytes;
+	buffer->addr = test_calloc(TEST_BUFFER_SAMPLES, bytes);
+	buffer->end_addr = buffer->addr + buffer->size;
+	buffer->r_ptr = buffer->addr + offset * bytes;
+	buffer->w_ptr = buffer->r_ptr;
+
+	return buffer;
+}
+
+static void free_buffer(struct comp_buffer *buffer)
+{
+	test_free(buffer->addr);
+	test_free(buffer);
+}
+
+static void test_pcm_convert(void **state)
+{
+	struct pcm_test_parameters *p = *state;
+	const int32_t *input = test_input(p->source_format);
+	struct pcm_converter conv;
+	struct comp_buffer *source;
+	struct comp_buffer *sink;
+	uint32_t idx;
+	int i;
+
+	assert_int_equal(pcm_converter_init(&conv, p->source_format,
+					    p->sink_format), 0);
+	assert_int_equal(conv.source_bytes, sample_bytes(p->source_format));
+	assert_int_equal(conv.sink_bytes, sample_bytes(p->sink_format));
+
+	source = create_buffer(p->source_format, p->source_offset);
+	sink = create_buffer(p->sink_format, p->sink_offset);
+
+	for (i = 0; i < TEST_SAMPLES; i++) {
+		idx = (p->source_offset + i) % TEST_BUFFER_SAMPLES;
+		write_sample(source, p->source_format, idx, input[i]);
+	}
+
+	conv.func(source, sink, TEST_SAMPLES);
+
+	for (i = 0; i < TEST_SAMPLES; i++) {
+		idx = (p->sink_offset + i) % TEST_BUFFER_SAMPLES;
+		assert_int_equal(read_sample(sink, p->sink_format, idx),
+				 expected_sample(input[i], p->source_format,
+						 p->sink_format));
+	}
+
+	free_buffer(source);
+	free_buffer(sink);
+}
+
+static void test_pcm_convert_unsupported(void **state)
+{
+	struct pcm_converter conv;
+
+	(void)state;
+
+	assert_int_equal(pcm_converter_init(&conv, SOF_IPC_FRAME_FLOAT,
+					    SOF_IPC_FRAME_S16_LE), -EINVAL);
+	assert_int_equal(pcm_converter_init(&conv, SOF_IPC_FRAME_S32_LE,
+					    SOF_IPC_FRAME_FLOAT), -EINVAL);
+}
+
+/* second case of each pair wraps source and sink at different samples */
+static struct pcm_test_parameters parameters[] = {
+	{ SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S16_LE, 0, 0 },
+	{ SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S16_LE, 10, 6 },
+	{ SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S24_4LE, 0, 0 },
+	{ SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S24_4LE, 10, 6 },
+	{ SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S32_LE, 0, 0 },
+	{ SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S32_LE, 10, 6 },
+	{ SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S16_LE, 0, 0 },
+	{ SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S16_LE, 10, 6 },
+	{ SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S24_4LE, 0, 0 },
+	{ SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S24_4LE, 10, 6 },
+	{ SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S32_LE, 0, 0 },
+	{ SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S32_LE, 10, 6 },
+	{ SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S16_LE, 0, 0 },
+	{ SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S16_LE, 10, 6 },
+	{ SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S24_4LE, 0, 0 },
+	{ SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S24_4LE, 10, 6 },
+	{ SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S32_LE, 0, 0 },
+	{ SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S32_LE, 10, 6 },
+};
+
+int main(void)
+{
+	struct CMUnitTest tests[ARRAY_SIZE(parameters) + 1];
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(parameters); i++) {
+		tests[i].name = "test_pcm_convert";
+		tests[i].test_func = test_pcm_convert;
+		tests[i].setup_func = NULL;
+		tests[i].teardown_func = NULL;
+		tests[i].initial_state = &parameters[i];
+	}
+
+	tests[i].name = "test_pcm_convert_unsupported";
+	tests[i].test_func = test_pcm_convert_unsupported;
+	tests[i].setup_func = NULL;
+	tests[i].teardown_func = NULL;
+	tests[i].initial_state = NULL;
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,220 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2019 Intel Corporation. All rights reserved.
+
+#include <sof/audio/buffer.h>
+#include <sof/audio/component.h>
+#include <sof/audio/pipeline.h>
+#include "pipeline_mocks.h"
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <cmocka.h>
+
+#define PIPELINE_COMPS 4
+
+static const uint32_t buffer_sizes[PIPELINE_COMPS - 1] = { 100, 384, 1000 };
+
+struct pipeline_arena_data {
+	struct pipeline p;
+	struct comp_dev *comps[PIPELINE_COMPS];
+	struct comp_buffer *buffers[PIPELINE_COMPS - 1];
+	void *buffer_mem[PIPELINE_COMPS - 1];
+};
+
+static struct comp_dev *test_comp_new(uint32_t id)
+{
+	struct comp_dev *cd = calloc(1, sizeof(*cd));
+
+	cd->comp.id = id;
+	cd->comp.pipeline_id = 1;
+	list_init(&cd->bsink_list);
+	list_init(&cd->bsource_list);
+
+	return cd;
+}
+
+/* comps[0] -> buffers[0] -> comps[1] -> buffers[1] -> comps[2] ->
+ * buffers[2] -> comps[3], the last component is in another pipeline
+ */
+static int setup(void **state)
+{
+	struct pipeline_arena_data *data = calloc(1, sizeof(*data));
+	struct comp_buffer *buffer;
+	int i;
+
+	for (i = 0; i < PIPELINE_COMPS; i++)
+		data->comps[i] = test_comp_new(i);
+
+	data->comps[PIPELINE_COMPS - 1]->comp.pipeline_id = 2;
+
+	for (i = 0; i < PIPELINE_COMPS - 1; i++) {
+		buffer = calloc(1, sizeof(*buffer));
+		list_init(&buffer->source_list);
+		list_init(&buffer->sink_list);
+		buffer->pipeline_id = 1;
+		buffer->caps = SOF_MEM_CAPS_RAM;
+		buffer->align = PLATFORM_DCACHE_ALIGN;
+		buffer->addr = calloc(buffer_sizes[i], 1);
+		buffer_init(buffer, buffer_sizes[i], buffer->caps);
+		pipeline_connect(data->comps[i], buffer,
+				 PPL_CONN_DIR_COMP_TO_BUFFER);
+		pipeline_connect(data->comps[i + 1], buffer,
+				 PPL_CONN_DIR_BUFFER_TO_COMP);
+		data->buffers[i] = buffer;
+		data->buffer_mem[i] = buffer->addr;
+	}
+
+	balloc_fail = false;
+
+	data->p.ipc_pipe.pipeline_id = 1;
+	data->p.status = COMP_STATE_INIT;
+	data->p.sched_comp = data->comps[PIPELINE_COMPS - 2];
+
+	*state = data;
+
+	return 0;
+}
+
+static int teardown(void **state)
+{
+	struct pipeline_arena_data *data = *state;
+	int i;
+
+	for (i = 0; i < PIPELINE_COMPS; i++)
+		free(data->comps[i]);
+
+	for (i = 0; i < PIPELINE_COMPS - 1; i++) {
+		free(data->buffer_mem[i]);
+		free(data->buffers[i]);
+	}
+
+	free(data->p.arena);
+	free(data);
+
+	return 0;
+}
+
+static void test_audio_pipeline_arena_placement(void **state)
+{
+	struct pipeline_arena_data *data = *state;
+	struct pipeline *p = &data->p;
+	struct comp_buffer *buffer;
+	uint32_t offset = 0;
+	int i;
+
+	assert_int_equal(pipeline_complete(p, data->comps[0],
+					   data->comps[PIPELINE_COMPS - 2]), 0);
+
+	assert_non_null(p->arena);
+	assert_int_equal(p->arena_size,
+			 ALIGN_UP(buffer_sizes[0], PLATFORM_DCACHE_ALIGN) +
+			 ALIGN_UP(buffer_sizes[1], PLATFORM_DCACHE_ALIGN));
+
+	/* buffers inside the pipeline are contiguous in the arena */
+	for (i = 0; i < PIPELINE_COMPS - 2; i++) {
+		buffer = data->buffers[i];
+		assert_true(buffer->arena);
+		assert_ptr_equal(buffer->addr, p->arena + offset);
+		assert_ptr_equal(buffer->r_ptr, buffer->addr);
+		assert_ptr_equal(buffer->w_ptr, buffer->addr);
+		assert_ptr_equal(buffer->end_addr,
+				 buffer->addr + buffer_sizes[i]);
+		assert_int_equal(buffer->size, buffer_sizes[i]);
+		assert_int_equal(buffer->free, buffer_sizes[i]);
+		offset += ALIGN_UP(buffer_sizes[i], PLATFORM_DCACHE_ALIGN);
+	}
+}
+
+static void test_audio_pipeline_arena_other_pipeline(void **state)
+{
+	struct pipeline_arena_data *data = *state;
+	struct comp_buffer *buffer = data->buffers[PIPELINE_COMPS - 2];
+
+	assert_int_equal(pipeline_complete(&data->p, data->comps[0],
+					   data->comps[PIPELINE_COMPS - 2]), 0);
+
+	/* buffer to the next pipeline keeps its own memory */
+	assert_false(buffer->arena);
+	assert_ptr_equal(buffer->addr, data->buffer_mem[PIPELINE_COMPS - 2]);
+}
+
+static void test_audio_pipeline_arena_no_memory(void **state)
+{
+	struct pipeline_arena_data *data = *state;
+	int i;
+
+	/* buffers keep their own memory when the arena can't be allocated */
+	balloc_fail = true;
+
+	assert_int_equal(pipeline_complete(&data->p, data->comps[0],
+					   data->comps[PIPELINE_COMPS - 2]), 0);
+
+	assert_null(data->p.arena);
+	assert_int_equal(data->p.arena_size, 0);
+
+	for (i = 0; i < PIPELINE_COMPS - 1; i++) {
+		assert_false(data->buffers[i]->arena);
+		assert_ptr_equal(data->buffers[i]->addr, data->buffer_mem[i]);
+	}
+}
+
+static void test_audio_pipeline_arena_other_caps(void **state)
+{
+	struct pipeline_arena_data *data = *state;
+	struct comp_buffer *buffer = data->buffers[1];
+
+	/* arena takes the caps of the first buffer only */
+	buffer->caps = SOF_MEM_CAPS_DMA;
+
+	assert_int_equal(pipeline_complete(&data->p, data->comps[0],
+					   data->comps[PIPELINE_COMPS - 2]), 0);
+
+	assert_int_equal(data->p.arena_size,
+			 ALIGN_UP(buffer_sizes[0], PLATFORM_DCACHE_ALIGN));
+	assert_true(data->buffers[0]->arena);
+	assert_false(buffer->arena);
+	assert_ptr_equal(buffer->addr, data->buffer_mem[1]);
+}
+
+static void test_audio_pipeline_arena_empty(void **state)
+{
+	struct pipeline_arena_data *data = *state;
+	int i;
+
+	/* buffers of another pipeline id are not placed */
+	for (i = 0; i < PIPELINE_COMPS - 1; i++)
+		data->buffers[i]->pipeline_id = 2;
+
+	assert_int_equal(pipeline_complete(&data->p, data->comps[0],
+					   data->comps[PIPELINE_COMPS - 2]), 0);
+
+	assert_null(data->p.arena);
+	assert_int_equal(data->p.arena_size, 0);
+
+	for (i = 0; i < PIPELINE_COMPS - 1; i++)
+		assert_ptr_equal(data->buffers[i]->addr, data->buffer_mem[i]);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown(
+			test_audio_pipeline_arena_placement, setup, teardown),
+		cmocka_unit_test_setup_teardown(
+			test_audio_pipeline_arena_other_pipeline, setup,
+			teardown),
+		cmocka_unit_test_setup_teardown(
+			test_audio_pipeline_arena_no_memory, setup, teardown),
+		cmocka_unit_test_setup_teardown(
+			test_audio_pipeline_arena_other_caps, setup, teardown),
+		cmocka_unit_test_setup_teardown(
+			test_audio_pipeline_arena_empty, setup, teardown),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -72,6 +72,7 @@ struct pipeline_connect_data *get_standard_connect_objects(void)
 
 	buffer->source = first;
 	buffer->sink = second;
+	buffer->align = PLATFORM_DCACHE_ALIGN;
 	list_init(&buffer->sink_list);
 	list_init(&buffer->source_list);
 	pipeline_connect_data->b1 = buffer;
@@ -79,6 +80,7 @@ struct pipeline_connect_data *get_standard_connect_objects(void)
 	struct comp_buffer *buffer_2 = calloc(sizeof(struct comp_buffer), 1);
 
 	buffer_2->source = second;
+	buffer_2->align = PLATFORM_DCACHE_ALIGN;
 	list_init(&buffer_2->sink_list);
 	list_init(&buffer_2->source_list);
 	pipeline_connect_data->b2 = buffer_2;
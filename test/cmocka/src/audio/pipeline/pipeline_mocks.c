@@ -5,6 +5,8 @@
 // Author: Jakub Dabek <jakub.dabek@linux.intel.com>
 
 #include "pipeline_mocks.h"
+#include <sof/lib/cpu_budget.h>
+#include <stdlib.h>
 
 #include <mock_trace.h>
 
@@ -48,6 +50,20 @@ void rfree(void *ptr)
 	(void)ptr;
 }
 
+bool balloc_fail;
+
+void *_balloc(int zone, uint32_t caps, size_t bytes, uint32_t alignment)
+{
+	(void)zone;
+	(void)caps;
+	(void)alignment;
+
+	if (balloc_fail)
+		return NULL;
+
+	return calloc(bytes, 1);
+}
+
 void platform_host_timestamp(struct comp_dev *host,
 	struct sof_ipc_stream_posn *posn)
 {
@@ -109,3 +125,58 @@ uint64_t clock_ms_to_ticks(int clock, uint64_t ms)
 
 	return 0;
 }
+
+#if CONFIG_CPU_BUDGET
+uint32_t cpu_budget_need(struct pipeline *p)
+{
+	(void)p;
+
+	return 0;
+}
+
+int cpu_budget_admit(struct pipeline *p, uint32_t demand_hz)
+{
+	(void)p;
+	(void)demand_hz;
+
+	return 0;
+}
+
+void cpu_budget_start(struct pipeline *p)
+{
+	(void)p;
+}
+
+void cpu_budget_stop(struct pipeline *p)
+{
+	(void)p;
+}
+
+uint64_t cpu_budget_time(void)
+{
+	return 0;
+}
+
+void cpu_budget_account(struct pipeline *p, uint64_t start)
+{
+	(void)p;
+	(void)start;
+}
+
+void cpu_budget_place(struct pipeline *p)
+{
+	(void)p;
+}
+
+void cpu_budget_unplace(struct pipeline *p)
+{
+	(void)p;
+}
+
+int cpu_budget_pick_core(struct pipeline *p)
+{
+	(void)p;
+
+	return 0;
+}
+#endif
@@ -11,6 +11,7 @@
 #include <sof/schedule/edf_schedule.h>
 #include <sof/schedule/schedule.h>
 #include <stdarg.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <setjmp.h>
 #include <stdint.h>
@@ -38,6 +39,9 @@ void platform_host_timestamp(struct comp_dev *host,
 
 uint64_t platform_timer_get(struct timer *timer);
 
+/* makes buffer allocations fail */
+extern bool balloc_fail;
+
 struct pipeline_new_setup_data {
 	struct sof_ipc_pipe_new ipc_data;
 	struct comp_dev *comp_data;
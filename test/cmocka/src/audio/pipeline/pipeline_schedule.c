@@ -0,0 +1,250 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2019 Intel Corporation. All rights reserved.
+
+#include <sof/audio/buffer.h>
+#include <sof/audio/component.h>
+#include <sof/audio/pipeline.h>
+#include "pipeline_mocks.h"
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <cmocka.h>
+
+#define PIPELINE_COMPS 3
+
+struct pipeline_schedule_data {
+	struct pipeline p;
+	struct comp_dev *comps[PIPELINE_COMPS];
+	struct comp_buffer *buffers[PIPELINE_COMPS - 1];
+};
+
+static struct comp_dev *test_comp_new(uint32_t id, uint32_t direction)
+{
+	struct comp_dev *cd = calloc(1, sizeof(*cd));
+
+	cd->comp.id = id;
+	cd->comp.pipeline_id = 1;
+	cd->state = COMP_STATE_ACTIVE;
+	cd->params.direction = direction;
+	list_init(&cd->bsink_list);
+	list_init(&cd->bsource_list);
+
+	return cd;
+}
+
+/* comps[0] -> buffers[0] -> comps[1] -> buffers[1] -> comps[2] */
+static struct pipeline_schedule_data *test_pipeline_new(uint32_t direction)
+{
+	struct pipeline_schedule_data *data = calloc(1, sizeof(*data));
+	int i;
+
+	for (i = 0; i < PIPELINE_COMPS; i++)
+		data->comps[i] = test_comp_new(i, direction);
+
+	for (i = 0; i < PIPELINE_COMPS - 1; i++) {
+		data->buffers[i] = calloc(1, sizeof(struct comp_buffer));
+		data->buffers[i]->align = PLATFORM_DCACHE_ALIGN;
+		list_init(&data->buffers[i]->source_list);
+		list_init(&data->buffers[i]->sink_list);
+		pipeline_connect(data->comps[i], data->buffers[i],
+				 PPL_CONN_DIR_COMP_TO_BUFFER);
+		pipeline_connect(data->comps[i + 1], data->buffers[i],
+				 PPL_CONN_DIR_BUFFER_TO_COMP);
+	}
+
+	data->p.status = COMP_STATE_INIT;
+	data->p.sched_comp = data->comps[PIPELINE_COMPS - 1];
+	pipeline_complete(&data->p, data->comps[0],
+			  data->comps[PIPELINE_COMPS - 1]);
+
+	return data;
+}
+
+static void test_pipeline_free(struct pipeline_schedule_data *data)
+{
+	int i;
+
+	for (i = 0; i < PIPELINE_COMPS; i++)
+		free(data->comps[i]);
+
+	for (i = 0; i < PIPELINE_COMPS - 1; i++)
+		free(data->buffers[i]);
+
+	free(data->p.sched_list);
+	free(data);
+}
+
+static void test_audio_pipeline_schedule_capture(void **state)
+{
+	struct pipeline_schedule_data *data =
+		test_pipeline_new(SOF_IPC_STREAM_CAPTURE);
+	struct pipeline *p = &data->p;
+
+	(void)state;
+
+	assert_false(p->sched_valid);
+	assert_int_equal(pipeline_schedule_build(p), 0);
+	assert_true(p->sched_valid);
+	assert_int_equal(p->sched_count, 3);
+
+	/* downstream order, path stop skips the rest of the path */
+	assert_ptr_equal(p->sched_list[0].comp, data->comps[0]);
+	assert_ptr_equal(p->sched_list[1].comp, data->comps[1]);
+	assert_ptr_equal(p->sched_list[2].comp, data->comps[2]);
+	assert_int_equal(p->sched_list[0].next, 3);
+	assert_int_equal(p->sched_list[1].next, 3);
+	assert_int_equal(p->sched_list[2].next, 3);
+
+	test_pipeline_free(data);
+}
+
+static void test_audio_pipeline_schedule_playback(void **state)
+{
+	struct pipeline_schedule_data *data =
+		test_pipeline_new(SOF_IPC_STREAM_PLAYBACK);
+	struct pipeline *p = &data->p;
+
+	(void)state;
+
+	assert_int_equal(pipeline_schedule_build(p), 0);
+	assert_int_equal(p->sched_count, 3);
+
+	/* walked upstream from sink, copied from source first */
+	assert_ptr_equal(p->sched_list[0].comp, data->comps[0]);
+	assert_ptr_equal(p->sched_list[1].comp, data->comps[1]);
+	assert_ptr_equal(p->sched_list[2].comp, data->comps[2]);
+
+	/* path stop of single source skips what it feeds */
+	assert_int_equal(p->sched_list[0].next, 3);
+	assert_int_equal(p->sched_list[1].next, 3);
+	assert_int_equal(p->sched_list[2].next, 3);
+
+	test_pipeline_free(data);
+}
+
+/* comps[0] and comps[1] -> comps[2] -> comps[3] */
+static void test_audio_pipeline_schedule_playback_mix(void **state)
+{
+	struct pipeline p = { 0 };
+	struct comp_buffer *buffers[3];
+	struct comp_dev *comps[4];
+	int i;
+
+	(void)state;
+
+	for (i = 0; i < 4; i++)
+		comps[i] = test_comp_new(i, SOF_IPC_STREAM_PLAYBACK);
+
+	for (i = 0; i < 3; i++) {
+		buffers[i] = calloc(1, sizeof(struct comp_buffer));
+		buffers[i]->align = PLATFORM_DCACHE_ALIGN;
+		list_init(&buffers[i]->source_list);
+		list_init(&buffers[i]->sink_list);
+	}
+
+	pipeline_connect(comps[0], buffers[0], PPL_CONN_DIR_COMP_TO_BUFFER);
+	pipeline_connect(comps[1], buffers[1], PPL_CONN_DIR_COMP_TO_BUFFER);
+	pipeline_connect(comps[2], buffers[0], PPL_CONN_DIR_BUFFER_TO_COMP);
+	pipeline_connect(comps[2], buffers[1], PPL_CONN_DIR_BUFFER_TO_COMP);
+	pipeline_connect(comps[2], buffers[2], PPL_CONN_DIR_COMP_TO_BUFFER);
+	pipeline_connect(comps[3], buffers[2], PPL_CONN_DIR_BUFFER_TO_COMP);
+
+	p.sched_comp = comps[3];
+	pipeline_complete(&p, comps[0], comps[3]);
+
+	/* second source isn't reached from the pipeline source */
+	comps[1]->pipeline = &p;
+
+	assert_int_equal(pipeline_schedule_build(&p), 0);
+	assert_int_equal(p.sched_count, 4);
+	assert_ptr_equal(p.sched_list[2].comp, comps[2]);
+	assert_ptr_equal(p.sched_list[3].comp, comps[3]);
+
+	/* only the last mixed source ends the period, as in the graph walk */
+	assert_int_equal(p.sched_list[0].next, 1);
+	assert_int_equal(p.sched_list[1].next, 4);
+	assert_int_equal(p.sched_list[2].next, 4);
+	assert_int_equal(p.sched_list[3].next, 4);
+
+	for (i = 0; i < 4; i++)
+		free(comps[i]);
+
+	for (i = 0; i < 3; i++)
+		free(buffers[i]);
+
+	free(p.sched_list);
+}
+
+static void test_audio_pipeline_schedule_inactive(void **state)
+{
+	struct pipeline_schedule_data *data =
+		test_pipeline_new(SOF_IPC_STREAM_CAPTURE);
+	struct pipeline *p = &data->p;
+
+	(void)state;
+
+	assert_int_equal(pipeline_schedule_build(p), 0);
+	assert_int_equal(p->sched_count, 3);
+
+	/* inactive component ends the path */
+	data->comps[1]->state = COMP_STATE_PAUSED;
+	pipeline_schedule_invalidate(p);
+	assert_false(p->sched_valid);
+
+	assert_int_equal(pipeline_schedule_build(p), 0);
+	assert_int_equal(p->sched_count, 1);
+	assert_int_equal(p->sched_size, 3);
+	assert_ptr_equal(p->sched_list[0].comp, data->comps[0]);
+
+	test_pipeline_free(data);
+}
+
+static void test_audio_pipeline_schedule_reserve(void **state)
+{
+	struct pipeline_schedule_data *data =
+		test_pipeline_new(SOF_IPC_STREAM_CAPTURE);
+	struct pipeline *p = &data->p;
+	struct pipeline_sched_entry *list;
+	int i;
+
+	(void)state;
+
+	/* prepared pipeline reserves entries for components not yet active */
+	for (i = 0; i < PIPELINE_COMPS; i++)
+		data->comps[i]->state = COMP_STATE_PREPARE;
+
+	assert_int_equal(pipeline_schedule_build(p), 0);
+	assert_int_equal(p->sched_count, 0);
+	assert_int_equal(p->sched_size, 3);
+	list = p->sched_list;
+	assert_non_null(list);
+
+	/* start fills the reserved list without reallocating it */
+	for (i = 0; i < PIPELINE_COMPS; i++)
+		data->comps[i]->state = COMP_STATE_ACTIVE;
+	pipeline_schedule_invalidate(p);
+
+	assert_int_equal(pipeline_schedule_build(p), 0);
+	assert_int_equal(p->sched_count, 3);
+	assert_ptr_equal(p->sched_list, list);
+
+	test_pipeline_free(data);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_audio_pipeline_schedule_capture),
+		cmocka_unit_test(test_audio_pipeline_schedule_playback),
+		cmocka_unit_test(test_audio_pipeline_schedule_playback_mix),
+		cmocka_unit_test(test_audio_pipeline_schedule_inactive),
+		cmocka_unit_test(test_audio_pipeline_schedule_reserve),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -71,6 +71,9 @@ static int setup(void **state)
 	sel_state->sink->w_ptr = test_calloc(parameters->buffer_size_ms,
 					     size);
 	sel_state->sink->size = parameters->buffer_size_ms * size;
+	sel_state->sink->addr = sel_state->sink->w_ptr;
+	sel_state->sink->end_addr = sel_state->sink->addr +
+				    sel_state->sink->size;
 
 	/* allocate new source buffer */
 	sel_state->source = test_malloc(sizeof(*sel_state->source));
@@ -79,6 +82,9 @@ static int setup(void **state)
 	sel_state->source->r_ptr = test_calloc(parameters->buffer_size_ms,
 					       size);
 	sel_state->source->size = parameters->buffer_size_ms * size;
+	sel_state->source->addr = sel_state->source->r_ptr;
+	sel_state->source->end_addr = sel_state->source->addr +
+				      sel_state->source->size;
 
 	/* assigns verification function */
 	sel_state->verify = parameters->verify;
@@ -268,6 +274,45 @@ static void test_audio_sel(void **state)
 	sel_state->verify(sel_state->dev, sel_state->sink, sel_state->source);
 }
 
+/* buffer size is not a frame multiple, third frame wraps in the middle */
+static void test_audio_sel_frame_wrap(void **state)
+{
+	int16_t src_data[9] = { 0, 1, 2, 3, 4, 5, 6, 7, 8 };
+	int16_t dst_data[8] = { 0 };
+	const int16_t expected[4] = { 5, 7, 0, 2 };
+	struct comp_buffer source = { 0 };
+	struct comp_buffer sink = { 0 };
+	struct comp_dev *dev;
+	struct comp_data *cd;
+	int i;
+
+	(void)state;
+
+	dev = test_malloc(COMP_SIZE(struct sof_ipc_comp_volume));
+	cd = test_calloc(1, sizeof(*cd));
+	comp_set_drvdata(dev, cd);
+	cd->source_format = SOF_IPC_FRAME_S16_LE;
+	cd->config.in_channels_count = 2;
+	cd->config.out_channels_count = SEL_SINK_1CH;
+	cd->config.sel_channel = 1;
+	cd->sel_func = sel_get_processing_function(dev);
+
+	source.addr = src_data;
+	source.end_addr = src_data + ARRAY_SIZE(src_data);
+	source.r_ptr = src_data + 4;
+
+	sink.addr = dst_data;
+	sink.end_addr = dst_data + ARRAY_SIZE(dst_data);
+	sink.w_ptr = dst_data;
+
+	cd->sel_func(dev, &sink, &source, ARRAY_SIZE(expected));
+
+	for (i = 0; i < ARRAY_SIZE(expected); i++)
+		assert_int_equal(dst_data[i], expected[i]);
+
+	test_free(cd);
+	test_free(dev);
+}
 
 static struct sel_test_parameters parameters[] = {
 	{ 2, 1, 0, 16, 1, SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S16_LE, verify_s16le_Xch_to_1ch },
@@ -294,6 +339,9 @@ int main(void)
 	int i;
 
 	struct CMUnitTest tests[ARRAY_SIZE(parameters)];
+	const struct CMUnitTest wrap_tests[] = {
+		cmocka_unit_test(test_audio_sel_frame_wrap),
+	};
 
 	for (i = 0; i < ARRAY_SIZE(parameters); i++) {
 		tests[i].name = "test_audio_sel";
@@ -305,5 +353,6 @@ int main(void)
 
 	cmocka_set_message_output(CM_OUTPUT_TAP);
 
-	return cmocka_run_group_tests(tests, NULL, NULL);
+	return cmocka_run_group_tests(tests, NULL, NULL) +
+	       cmocka_run_group_tests(wrap_tests, NULL, NULL);
 }
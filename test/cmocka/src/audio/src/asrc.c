@@ -0,0 +1,204 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2019 Intel Corporation. All rights reserved.
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <cmocka.h>
+
+#include <sof/audio/buffer.h>
+#include <sof/audio/src/asrc.h>
+#include <ipc/stream.h>
+#include <errno.h>
+
+#define TEST_CHANNELS		2
+#define TEST_PERIOD		48
+#define TEST_RING_FRAMES	(8 * TEST_PERIOD)
+#define TEST_FRAMES		4800
+
+/* Simulated drift and run length for the feedback loop test */
+#define TEST_DRIFT_PPM		500
+#define TEST_DRIFT_PERIODS	20000
+
+struct asrc_test_state {
+	struct asrc_state asrc;
+	int32_t hist[TEST_CHANNELS * 2 * ASRC_TAPS];
+	struct comp_buffer source;
+	struct comp_buffer sink;
+	int32_t in[TEST_RING_FRAMES * TEST_CHANNELS];
+	int32_t out[TEST_FRAMES * 2 * TEST_CHANNELS];
+};
+
+static void test_buffer_init(struct comp_buffer *buffer, void *addr,
+			     size_t size)
+{
+	buffer->addr = addr;
+	buffer->size = size;
+	buffer->end_addr = buffer->addr + size;
+	buffer->r_ptr = addr;
+	buffer->w_ptr = addr;
+}
+
+/* Moves the read pointer of a ring buffer by frames */
+static void test_buffer_consume(struct comp_buffer *buffer, int frames)
+{
+	buffer->r_ptr = buffer_get_frag(buffer, buffer->r_ptr,
+					frames * TEST_CHANNELS,
+					sizeof(int32_t));
+}
+
+static int setup(void **state)
+{
+	struct asrc_test_state *st = test_calloc(1, sizeof(*st));
+
+	test_buffer_init(&st->source, st->in, sizeof(st->in));
+	test_buffer_init(&st->sink, st->out, sizeof(st->out));
+	*state = st;
+
+	return 0;
+}
+
+static int teardown(void **state)
+{
+	test_free(*state);
+
+	return 0;
+}
+
+static void test_audio_asrc_init_invalid(void **state)
+{
+	struct asrc_test_state *st = *state;
+
+	/* down sampling is not supported */
+	assert_int_equal(asrc_init(&st->asrc, 48000, 44100, TEST_CHANNELS,
+				   SOF_IPC_FRAME_S32_LE, TEST_PERIOD,
+				   st->hist), -EINVAL);
+	assert_int_equal(asrc_init(&st->asrc, 48000, 48000, TEST_CHANNELS,
+				   SOF_IPC_FRAME_S32_LE, 0, st->hist),
+			 -EINVAL);
+	assert_int_equal(asrc_init(&st->asrc, 44100, 48000, TEST_CHANNELS,
+				   SOF_IPC_FRAME_S32_LE, TEST_PERIOD,
+				   st->hist), 0);
+}
+
+/* DC passes with unity gain once the history is filled */
+static void test_audio_asrc_dc(void **state)
+{
+	struct asrc_test_state *st = *state;
+	int32_t dc = 1 << 29;
+	int n_read;
+	int n_written;
+	int i;
+
+	assert_int_equal(asrc_init(&st->asrc, 44100, 48000, TEST_CHANNELS,
+				   SOF_IPC_FRAME_S32_LE, TEST_PERIOD,
+				   st->hist), 0);
+
+	for (i = 0; i < TEST_RING_FRAMES * TEST_CHANNELS; i++)
+		st->in[i] = dc;
+
+	asrc_process(&st->asrc, &st->source, &st->sink, TEST_RING_FRAMES,
+		     TEST_FRAMES, &n_read, &n_written);
+
+	assert_int_equal(n_read, TEST_RING_FRAMES);
+	assert_true(n_written > ASRC_TAPS * 2);
+	for (i = ASRC_TAPS * 2 * TEST_CHANNELS; i < n_written * TEST_CHANNELS;
+	     i++)
+		assert_true(abs(st->out[i] - dc) < (dc >> 12));
+}
+
+/* Output count follows the nominal ratio */
+static void test_audio_asrc_ratio(void **state)
+{
+	struct asrc_test_state *st = *state;
+	int frames_in = 0;
+	int frames_out = 0;
+	int n_read;
+	int n_written;
+	int expected;
+	int i;
+
+	assert_int_equal(asrc_init(&st->asrc, 44100, 48000, TEST_CHANNELS,
+				   SOF_IPC_FRAME_S32_LE, TEST_PERIOD,
+				   st->hist), 0);
+
+	for (i = 0; i < 100; i++) {
+		asrc_process(&st->asrc, &st->source, &st->sink, 44,
+			     TEST_FRAMES, &n_read, &n_written);
+		test_buffer_consume(&st->source, n_read);
+		frames_in += n_read;
+		frames_out += n_written;
+	}
+
+	assert_int_equal(frames_in, 4400);
+	expected = (int64_t)frames_in * 48000 / 44100;
+	assert_true(abs(frames_out - expected) <= 1);
+}
+
+/* The producer runs TEST_DRIFT_PPM fast, the drift estimate must converge
+ * and the fill level stay bounded without sink underruns.
+ */
+static void test_audio_asrc_drift(void **state)
+{
+	struct asrc_test_state *st = *state;
+	int64_t produced = 0;
+	int level = TEST_PERIOD;
+	int level_min = INT32_MAX;
+	int level_max = 0;
+	int n_read;
+	int n_written;
+	int i;
+
+	assert_int_equal(asrc_init(&st->asrc, 48000, 48000, TEST_CHANNELS,
+				   SOF_IPC_FRAME_S32_LE, TEST_PERIOD,
+				   st->hist), 0);
+
+	for (i = 0; i < TEST_DRIFT_PERIODS; i++) {
+		/* Q32 fractional frames of the fast producer */
+		produced += ((int64_t)TEST_PERIOD << 32) +
+			((int64_t)TEST_PERIOD << 32) / 1000000 * TEST_DRIFT_PPM;
+		level += produced >> 32;
+		produced &= 0xffffffff;
+		assert_true(level <= TEST_RING_FRAMES);
+
+		asrc_update(&st->asrc, level);
+		st->sink.w_ptr = st->sink.addr;
+		asrc_process(&st->asrc, &st->source, &st->sink, level,
+			     TEST_PERIOD, &n_read, &n_written);
+		test_buffer_consume(&st->source, n_read);
+		level -= n_read;
+
+		if (i < TEST_DRIFT_PERIODS / 2)
+			continue;
+
+		assert_int_equal(n_written, TEST_PERIOD);
+		if (level < level_min)
+			level_min = level;
+		if (level > level_max)
+			level_max = level;
+	}
+
+	assert_true(abs(asrc_drift_ppm(&st->asrc) - TEST_DRIFT_PPM) <= 5);
+	assert_true(level_max - level_min <= 4);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown(test_audio_asrc_init_invalid,
+						setup, teardown),
+		cmocka_unit_test_setup_teardown(test_audio_asrc_dc,
+						setup, teardown),
+		cmocka_unit_test_setup_teardown(test_audio_asrc_ratio,
+						setup, teardown),
+		cmocka_unit_test_setup_teardown(test_audio_asrc_drift,
+						setup, teardown),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
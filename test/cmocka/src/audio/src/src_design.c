@@ -0,0 +1,273 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2019 Intel Corporation. All rights reserved.
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+#include <cmocka.h>
+
+#include <sof/audio/src/src.h>
+#include <sof/audio/src/src_config.h>
+#include <sof/audio/src/src_design.h>
+#include <sof/lib/alloc.h>
+
+#include <mock_trace.h>
+
+TRACE_IMPL()
+
+/* Required stop band attenuation in dB */
+#define TEST_STOP_BAND_DB	70.0
+
+static int test_allocs;
+
+void *_zalloc(int zone, uint32_t caps, size_t bytes)
+{
+	(void)zone;
+	(void)caps;
+
+	test_allocs++;
+	return calloc(bytes, 1);
+}
+
+void *_balloc(int zone, uint32_t caps, size_t bytes, uint32_t alignment)
+{
+	(void)zone;
+	(void)caps;
+	(void)alignment;
+
+	test_allocs++;
+	return malloc(bytes);
+}
+
+void rfree(void *ptr)
+{
+	test_allocs--;
+	free(ptr);
+}
+
+void __panic(uint32_t p, char *filename, uint32_t linenum)
+{
+	(void)p;
+	(void)filename;
+	(void)linenum;
+
+	fail();
+}
+
+static double test_coef(struct src_stage *stage, int i)
+{
+#if SRC_SHORT
+	return ((const int16_t *)stage->coefs)[i] / 32768.0;
+#else
+	return ((const int32_t *)stage->coefs)[i] / 2147483648.0;
+#endif
+}
+
+/* Returns the gain in dB at frequency f relative to the interpolated rate
+ * of the stage. The prototype filter tap n is in sub-filter n % L.
+ */
+static double test_response_db(struct src_stage *stage, double f)
+{
+	int l = stage->num_of_subfilters;
+	double re = 0;
+	double im = 0;
+	double b;
+	int n;
+
+	for (n = 0; n < stage->filter_length; n++) {
+		b = test_coef(stage, (n % l) * stage->subfilter_length + n / l);
+		re += b * cos(2 * M_PI * f * n);
+		im -= b * sin(2 * M_PI * f * n);
+	}
+
+	return 20 * log10(sqrt(re * re + im * im) / l) +
+		20 * log10(2) * -stage->shift;
+}
+
+static void test_stage(struct src_stage *stage, int fs_in, int32_t gain)
+{
+	int l = stage->num_of_subfilters;
+	int sublen = stage->subfilter_length;
+	int fs_out = fs_in / stage->blk_in * l;
+	double fs_up = (double)fs_in * l;
+	double g = gain / 2147483648.0;
+	double sum;
+	double f;
+	int i;
+	int j;
+
+	assert_int_equal(stage->blk_out, l);
+	assert_int_equal(stage->filter_length, l * sublen);
+	assert_int_equal(sublen & 0x3, 0);
+	assert_int_equal(stage->halfband, 0);
+	if (l > 1 && stage->blk_in > 1)
+		assert_int_equal(-stage->idm * l + stage->odm * stage->blk_in,
+				 1);
+
+	/* Each sub-filter has the requested gain at 0 Hz */
+	for (i = 0; i < l; i++) {
+		sum = 0;
+		for (j = 0; j < sublen; j++)
+			sum += test_coef(stage, i * sublen + j);
+
+		sum /= pow(2, stage->shift);
+		assert_true(fabs(sum - g) < 1e-3);
+	}
+
+	/* Images and aliases above the lower Nyquist rate are attenuated */
+	for (f = (fs_in < fs_out ? fs_in : fs_out) / 2.0; f < fs_up / 2;
+	     f += fs_up / 97)
+		assert_true(test_response_db(stage, f / fs_up) <
+			    20 * log10(g) - TEST_STOP_BAND_DB);
+}
+
+static void test_audio_src_design_rates(int fs_in, int fs_out)
+{
+	struct src_design *design = src_design_get(fs_in, fs_out);
+	struct src_stage *s1;
+	struct src_stage *s2;
+	int fs3;
+
+	assert_non_null(design);
+	s1 = design->stage1;
+	s2 = design->stage2;
+	fs3 = fs_in / s1->blk_in * s1->blk_out;
+
+	/* Total ratio and the intermediate rate are exact */
+	assert_int_equal(fs_in / s1->blk_in * s1->blk_out,
+			 (int64_t)fs_in * s1->blk_out / s1->blk_in);
+	assert_int_equal((int64_t)fs3 * s2->blk_out / s2->blk_in, fs_out);
+
+	if (s2->filter_length == 1) {
+		test_stage(s1, fs_in, SRC_DESIGN_GAIN_1S);
+	} else {
+		test_stage(s1, fs_in, SRC_DESIGN_GAIN_2S);
+		test_stage(s2, fs3, SRC_DESIGN_GAIN_2S);
+	}
+
+	src_design_put(design);
+}
+
+static void test_audio_src_design_44100_48000(void **state)
+{
+	(void)state;
+
+	test_audio_src_design_rates(44100, 48000);
+}
+
+static void test_audio_src_design_48000_44100(void **state)
+{
+	(void)state;
+
+	test_audio_src_design_rates(48000, 44100);
+}
+
+static void test_audio_src_design_12000_44100(void **state)
+{
+	(void)state;
+
+	test_audio_src_design_rates(12000, 44100);
+}
+
+static void test_audio_src_design_96000_16000(void **state)
+{
+	(void)state;
+
+	test_audio_src_design_rates(96000, 16000);
+}
+
+static void test_audio_src_design_equal(void **state)
+{
+	struct src_design *design = src_design_get(32000, 32000);
+
+	(void)state;
+
+	assert_non_null(design);
+	assert_int_equal(design->stage1->filter_length, 1);
+	assert_int_equal(design->stage2->filter_length, 1);
+	src_design_put(design);
+}
+
+static void test_audio_src_design_invalid(void **state)
+{
+	(void)state;
+
+	/* Prime factors too large for the delay lines */
+	assert_null(src_design_get(12347, 48000));
+	assert_null(src_design_get(0, 48000));
+}
+
+/* Repeated gets of the same rates don't allocate and at most
+ * SRC_DESIGN_CACHE_SIZE unused designs are kept.
+ */
+static void test_audio_src_design_cache(void **state)
+{
+	struct src_design *design;
+	struct src_design *again;
+	int allocs;
+	int i;
+
+	(void)state;
+
+	design = src_design_get(11025, 24000);
+	assert_non_null(design);
+	allocs = test_allocs;
+	again = src_design_get(11025, 24000);
+	assert_ptr_equal(again, design);
+	assert_int_equal(test_allocs, allocs);
+
+	/* Unused designs stay in the cache */
+	src_design_put(again);
+	src_design_put(design);
+	allocs = test_allocs;
+	again = src_design_get(11025, 24000);
+	assert_ptr_equal(again, design);
+	assert_int_equal(test_allocs, allocs);
+	src_design_put(again);
+
+	for (i = 0; i < SRC_DESIGN_CACHE_SIZE + 2; i++) {
+		design = src_design_get(8000, 16000 * (i + 1));
+		assert_non_null(design);
+		src_design_put(design);
+	}
+
+	/* The first design was evicted, each design has two allocations */
+	allocs = test_allocs;
+	design = src_design_get(11025, 24000);
+	assert_non_null(design);
+	assert_int_equal(test_allocs, allocs + 2);
+
+	/* Putting it back evicts the least recently used design */
+	src_design_put(design);
+	assert_int_equal(test_allocs, allocs);
+}
+
+static int setup(void **state)
+{
+	(void)state;
+
+	src_design_init();
+
+	return 0;
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_audio_src_design_44100_48000),
+		cmocka_unit_test(test_audio_src_design_48000_44100),
+		cmocka_unit_test(test_audio_src_design_12000_44100),
+		cmocka_unit_test(test_audio_src_design_96000_16000),
+		cmocka_unit_test(test_audio_src_design_equal),
+		cmocka_unit_test(test_audio_src_design_invalid),
+		cmocka_unit_test(test_audio_src_design_cache),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, setup, NULL);
+}
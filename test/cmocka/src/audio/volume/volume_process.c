@@ -10,6 +10,7 @@
 #include <stdint.h>
 #include <cmocka.h>
 #include <sof/audio/component.h>
+#include <sof/audio/format.h>
 #include <sof/audio/volume.h>
 
 /* Add macro for a volume test level. The levels to test with this code
@@ -70,7 +71,7 @@ static int setup(void **state)
 	vol_state->dev->frames = parameters->frames;
 
 	/* allocate and set new data */
-	cd = test_malloc(sizeof(*cd));
+	cd = test_calloc(1, sizeof(*cd));
 	comp_set_drvdata(vol_state->dev, cd);
 	cd->source_format = parameters->source_format;
 	cd->sink_format = parameters->sink_format;
@@ -84,6 +85,9 @@ static int setup(void **state)
 	vol_state->sink->w_ptr = test_calloc(parameters->buffer_size_ms,
 					     size);
 	vol_state->sink->size = parameters->buffer_size_ms * size;
+	vol_state->sink->addr = vol_state->sink->w_ptr;
+	vol_state->sink->end_addr = vol_state->sink->addr +
+				    vol_state->sink->size;
 
 	/* allocate new source buffer */
 	vol_state->source = test_malloc(sizeof(*vol_state->source));
@@ -92,6 +96,9 @@ static int setup(void **state)
 	vol_state->source->r_ptr = test_calloc(parameters->buffer_size_ms,
 					       size);
 	vol_state->source->size = parameters->buffer_size_ms * size;
+	vol_state->source->addr = vol_state->source->r_ptr;
+	vol_state->source->end_addr = vol_state->source->addr +
+				      vol_state->source->size;
 
 	/* assigns verification function */
 	vol_state->verify = parameters->verify;
@@ -391,6 +398,51 @@ static void test_audio_vol(void **state)
 	vol_state->verify(vol_state->dev, vol_state->sink, vol_state->source);
 }
 
+static void test_audio_vol_ramp(void **state)
+{
+	struct vol_test_state *vol_state = *state;
+	struct comp_dev *dev = vol_state->dev;
+	struct comp_data *cd = comp_get_drvdata(dev);
+	const int16_t *src = (int16_t *)vol_state->source->r_ptr;
+	const int16_t *dst = (int16_t *)vol_state->sink->w_ptr;
+	uint32_t channels = dev->params.channels;
+	uint32_t channel;
+	uint32_t frame;
+	uint32_t i;
+	int32_t vol;
+	int32_t inc;
+	int delta;
+	int16_t sample;
+
+	fill_source_s16(vol_state);
+
+	/* ramp channels in opposite directions over the period */
+	for (channel = 0; channel < channels; channel++) {
+		inc = VOL_ZERO_DB / (int32_t)dev->frames;
+		cd->ramp_increment[channel] = channel & 1 ? inc : -inc;
+	}
+	cd->ramp_active = 1;
+
+	cd->scale_vol(dev, vol_state->sink, vol_state->source, dev->frames);
+
+	/* gain must move by one increment every frame */
+	for (channel = 0; channel < channels; channel++) {
+		vol = VOL_ZERO_DB;
+		inc = cd->ramp_increment[channel];
+		for (frame = 0; frame < dev->frames; frame++) {
+			i = frame * channels + channel;
+			sample = q_multsr_sat_32x32_16
+				(src[i], vol, Q_SHIFT_BITS_32(15, 16, 15));
+			delta = dst[i] - sample;
+			if (delta > 1 || delta < -1)
+				assert_int_equal(dst[i], sample);
+			vol += inc;
+		}
+
+		assert_int_equal(cd->volume[channel], vol);
+	}
+}
+
 static struct vol_test_parameters parameters[] = {
 	{ VOL_MAX,        2, 48, 1, SOF_IPC_FRAME_S16_LE,
 		SOF_IPC_FRAME_S16_LE,   verify_s16_to_s16 }, /* 1 */
@@ -450,11 +502,15 @@ static struct vol_test_parameters parameters[] = {
 		SOF_IPC_FRAME_S32_LE,   verify_s32_to_s24_s32 }, /* 27 */
 };
 
+static struct vol_test_parameters ramp_parameters = {
+	VOL_ZERO_DB, 2, 48, 1, SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S16_LE, NULL
+};
+
 int main(void)
 {
 	int i;
 
-	struct CMUnitTest tests[ARRAY_SIZE(parameters)];
+	struct CMUnitTest tests[ARRAY_SIZE(parameters) + 1];
 
 	for (i = 0; i < ARRAY_SIZE(parameters); i++) {
 		tests[i].name = "test_audio_vol";
@@ -464,6 +520,12 @@ int main(void)
 		tests[i].initial_state = &parameters[i];
 	}
 
+	tests[i].name = "test_audio_vol_ramp";
+	tests[i].test_func = test_audio_vol_ramp;
+	tests[i].setup_func = setup;
+	tests[i].teardown_func = teardown;
+	tests[i].initial_state = &ramp_parameters;
+
 	cmocka_set_message_output(CM_OUTPUT_TAP);
 
 	return cmocka_run_group_tests(tests, NULL, NULL);
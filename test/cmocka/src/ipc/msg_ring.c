@@ -0,0 +1,296 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2019 Intel Corporation. All rights reserved.
+
+#include <sof/drivers/ipc.h>
+#include <sof/lib/memory.h>
+#include <ipc/header.h>
+#include <ipc/stream.h>
+#include <ipc/trace.h>
+#include <mock_trace.h>
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <string.h>
+#include <cmocka.h>
+
+TRACE_IMPL()
+
+#define POSN_HDR	(SOF_IPC_GLB_STREAM_MSG | SOF_IPC_STREAM_POSITION)
+#define XRUN_HDR	(SOF_IPC_GLB_STREAM_MSG | SOF_IPC_STREAM_TRIG_XRUN)
+
+static struct ipc_shared_context test_ctx;
+static struct ipc test_ipc;
+
+/* host side of the DSP mailbox */
+static uint8_t mailbox[MAILBOX_DSPBOX_SIZE];
+static int mailbox_writes;
+
+/* rewrites the message being sent on its first mailbox copy */
+static struct ipc_msg *rewrite_msg;
+static uint64_t rewrite_posn;
+
+static void rewrite(void)
+{
+	struct sof_ipc_stream_posn *posn = (void *)rewrite_msg->tx_data;
+
+	atomic_add(&rewrite_msg->seq, 1);
+	posn->host_posn = rewrite_posn;
+	atomic_add(&rewrite_msg->seq, 1);
+	rewrite_msg = NULL;
+}
+
+int memcpy_s(void *dest, size_t dest_size, const void *src, size_t src_size)
+{
+	const uint8_t *s = src;
+	uint8_t *d = dest;
+	bool to_mailbox;
+	size_t i;
+
+	if (src_size > dest_size)
+		return -EINVAL;
+
+	/* library platform has its DSP mailbox at address 0 */
+	to_mailbox = dest == (void *)MAILBOX_DSPBOX_BASE;
+	if (to_mailbox)
+		d = mailbox;
+
+	for (i = 0; i < src_size; i++)
+		d[i] = s[i];
+
+	if (to_mailbox) {
+		mailbox_writes++;
+		if (rewrite_msg)
+			rewrite();
+	}
+
+	return 0;
+}
+
+void __panic(uint32_t p, char *filename, uint32_t linenum)
+{
+	(void)p;
+	(void)filename;
+	(void)linenum;
+
+	fail();
+}
+
+static int setup(void **state)
+{
+	(void)state;
+
+	memset(&test_ctx, 0, sizeof(test_ctx));
+	memset(mailbox, 0, sizeof(mailbox));
+	mailbox_writes = 0;
+	rewrite_msg = NULL;
+	test_ipc.shared_ctx = &test_ctx;
+
+	return 0;
+}
+
+static int queue_posn(uint32_t comp_id, uint64_t host_posn)
+{
+	struct sof_ipc_stream_posn posn;
+
+	memset(&posn, 0, sizeof(posn));
+	posn.rhdr.hdr.cmd = POSN_HDR;
+	posn.rhdr.hdr.size = sizeof(posn);
+	posn.comp_id = comp_id;
+	posn.host_posn = host_posn;
+
+	return ipc_queue_host_message(&test_ipc, POSN_HDR, &posn,
+				      sizeof(posn), 1);
+}
+
+static int queue_xrun(uint32_t comp_id)
+{
+	struct sof_ipc_stream_posn posn;
+
+	memset(&posn, 0, sizeof(posn));
+	posn.comp_id = comp_id;
+
+	return ipc_queue_host_message(&test_ipc, XRUN_HDR, &posn,
+				      sizeof(posn), 0);
+}
+
+/* sends next message, gets its header and the position it carried */
+static void send_next(uint32_t *header, uint64_t *host_posn)
+{
+	struct sof_ipc_stream_posn *posn = (void *)mailbox;
+
+	assert_true(ipc_msg_tx_next(&test_ipc, header));
+	*host_posn = posn->host_posn;
+}
+
+static void test_ipc_msg_ring_order(void **state)
+{
+	uint32_t header;
+	uint64_t host_posn;
+
+	(void)state;
+
+	assert_false(ipc_msg_pending(&test_ipc));
+
+	assert_int_equal(queue_xrun(1), 0);
+	assert_int_equal(queue_posn(2, 100), 0);
+	assert_true(ipc_msg_pending(&test_ipc));
+
+	send_next(&header, &host_posn);
+	assert_int_equal(header, XRUN_HDR);
+	send_next(&header, &host_posn);
+	assert_int_equal(header, POSN_HDR);
+	assert_int_equal(host_posn, 100);
+
+	assert_false(ipc_msg_pending(&test_ipc));
+	assert_false(ipc_msg_tx_next(&test_ipc, &header));
+}
+
+static void test_ipc_msg_ring_replace(void **state)
+{
+	uint32_t header;
+	uint64_t host_posn;
+
+	(void)state;
+
+	/* same stream is rewritten in place */
+	assert_int_equal(queue_posn(2, 100), 0);
+	assert_int_equal(queue_posn(2, 200), 0);
+	assert_int_equal(queue_posn(2, 300), 0);
+
+	send_next(&header, &host_posn);
+	assert_int_equal(header, POSN_HDR);
+	assert_int_equal(host_posn, 300);
+	assert_false(ipc_msg_pending(&test_ipc));
+}
+
+static void test_ipc_msg_ring_replace_other_comp(void **state)
+{
+	uint32_t header;
+	uint64_t host_posn;
+
+	(void)state;
+
+	assert_int_equal(queue_posn(2, 100), 0);
+	assert_int_equal(queue_posn(3, 200), 0);
+
+	send_next(&header, &host_posn);
+	assert_int_equal(host_posn, 100);
+	send_next(&header, &host_posn);
+	assert_int_equal(host_posn, 200);
+	assert_false(ipc_msg_pending(&test_ipc));
+}
+
+static void test_ipc_msg_ring_replace_sent(void **state)
+{
+	uint32_t header;
+	uint64_t host_posn;
+
+	(void)state;
+
+	/* message already sent to host can't be rewritten */
+	assert_int_equal(queue_posn(2, 100), 0);
+	send_next(&header, &host_posn);
+
+	assert_int_equal(queue_posn(2, 200), 0);
+	assert_true(ipc_msg_pending(&test_ipc));
+	send_next(&header, &host_posn);
+	assert_int_equal(host_posn, 200);
+}
+
+static void test_ipc_msg_ring_replace_claimed(void **state)
+{
+	struct ipc_msg *msg = &test_ctx.ring[0].msg[0];
+	uint32_t header;
+	uint64_t host_posn;
+
+	(void)state;
+
+	/* sender has claimed the message, rewrite must queue a new one */
+	assert_int_equal(queue_posn(2, 100), 0);
+	atomic_add(&msg->claimed, 1);
+
+	assert_int_equal(queue_posn(2, 200), 0);
+	assert_int_equal(atomic_read(&msg->seq) & 1, 0);
+
+	send_next(&header, &host_posn);
+	assert_int_equal(host_posn, 100);
+	send_next(&header, &host_posn);
+	assert_int_equal(host_posn, 200);
+	assert_false(ipc_msg_pending(&test_ipc));
+}
+
+static void test_ipc_msg_ring_rewrite_during_send(void **state)
+{
+	uint32_t header;
+	uint64_t host_posn;
+
+	(void)state;
+
+	/* producer rewrites the payload while it's copied to the mailbox */
+	assert_int_equal(queue_posn(2, 100), 0);
+	rewrite_msg = &test_ctx.ring[0].msg[0];
+	rewrite_posn = 200;
+
+	send_next(&header, &host_posn);
+	assert_int_equal(mailbox_writes, 2);
+	assert_int_equal(host_posn, 200);
+}
+
+static void test_ipc_msg_ring_full(void **state)
+{
+	uint32_t header;
+	uint64_t host_posn;
+	int i;
+
+	(void)state;
+
+	for (i = 0; i < IPC_MSG_RING_SIZE; i++)
+		assert_int_equal(queue_xrun(i), 0);
+
+	assert_int_equal(queue_xrun(i), -EBUSY);
+
+	/* coalescing needs no free entry, new stream does */
+	assert_int_equal(queue_posn(2, 100), -EBUSY);
+
+	send_next(&header, &host_posn);
+	assert_int_equal(header, XRUN_HDR);
+	assert_int_equal(queue_xrun(i), 0);
+}
+
+static void test_ipc_msg_ring_too_big(void **state)
+{
+	uint8_t data[IPC_MSG_DATA_SIZE + 1];
+
+	(void)state;
+
+	memset(data, 0, sizeof(data));
+	assert_int_equal(ipc_queue_host_message(&test_ipc, XRUN_HDR, data,
+						sizeof(data), 0), -EINVAL);
+	assert_false(ipc_msg_pending(&test_ipc));
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup(test_ipc_msg_ring_order, setup),
+		cmocka_unit_test_setup(test_ipc_msg_ring_replace, setup),
+		cmocka_unit_test_setup(test_ipc_msg_ring_replace_other_comp,
+				       setup),
+		cmocka_unit_test_setup(test_ipc_msg_ring_replace_sent, setup),
+		cmocka_unit_test_setup(test_ipc_msg_ring_replace_claimed,
+				       setup),
+		cmocka_unit_test_setup(test_ipc_msg_ring_rewrite_during_send,
+				       setup),
+		cmocka_unit_test_setup(test_ipc_msg_ring_full, setup),
+		cmocka_unit_test_setup(test_ipc_msg_ring_too_big, setup),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
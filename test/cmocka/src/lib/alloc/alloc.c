@@ -23,7 +23,8 @@ static struct sof *sof;
 enum test_type {
 	TEST_BULK = 0,
 	TEST_ZERO,
-	TEST_IMMEDIATE_FREE
+	TEST_IMMEDIATE_FREE,
+	TEST_REUSE
 };
 
 struct test_case {
@@ -192,6 +193,20 @@ static struct test_case test_cases[] = {
 		  TEST_BULK, "rballoc_dma"),
 	TEST_CASE(2048, RZONE_BUFFER, SOF_MEM_CAPS_RAM | SOF_MEM_CAPS_DMA, 100,
 		  TEST_IMMEDIATE_FREE, "rballoc_dma"),
+
+	/*
+	 * free block search tests, the counts make the searches cross
+	 * the 32 block words of the used blocks bitmap
+	 */
+
+	TEST_CASE(4,    RZONE_RUNTIME, SOF_MEM_CAPS_RAM, 100, TEST_REUSE,
+		  "rmalloc_reuse"),
+	TEST_CASE(100,  RZONE_RUNTIME, SOF_MEM_CAPS_RAM, 60, TEST_REUSE,
+		  "rmalloc_reuse"),
+	TEST_CASE(1000, RZONE_BUFFER, SOF_MEM_CAPS_RAM, 40, TEST_REUSE,
+		  "rballoc_reuse"),
+	TEST_CASE(3000, RZONE_BUFFER, SOF_MEM_CAPS_RAM, 16, TEST_REUSE,
+		  "rballoc_reuse"),
 };
 
 static int setup(void **state)
@@ -297,6 +312,35 @@ static void test_lib_alloc_zero(struct test_case *tc)
 	free(all_mem);
 }
 
+static void test_lib_alloc_reuse(struct test_case *tc)
+{
+	void **all_mem = malloc(sizeof(void *) * tc->alloc_num);
+	void *mem;
+	int i;
+
+	for (i = 0; i < tc->alloc_num; ++i) {
+		mem = alloc(tc);
+
+		assert_non_null(mem);
+		all_mem[i] = mem;
+	}
+
+	/* leave equally sized holes between the allocations */
+	for (i = 0; i < tc->alloc_num; i += 2)
+		rfree(all_mem[i]);
+
+	/* first fit search must hand the holes back in address order */
+	for (i = 0; i < tc->alloc_num; i += 2) {
+		mem = alloc(tc);
+
+		assert_ptr_equal(mem, all_mem[i]);
+	}
+
+	alloc_free(all_mem, tc);
+
+	free(all_mem);
+}
+
 static void test_lib_alloc(void **state)
 {
 	struct test_case *tc = *((struct test_case **)state);
@@ -313,6 +357,10 @@ static void test_lib_alloc(void **state)
 	case TEST_IMMEDIATE_FREE:
 		test_lib_alloc_immediate_free(tc);
 		break;
+
+	case TEST_REUSE:
+		test_lib_alloc_reuse(tc);
+		break;
 	}
 }
 
@@ -0,0 +1,170 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2019 Intel Corporation. All rights reserved.
+
+/*
+ * Host microbenchmark of the block map allocator. Mimics topology load and
+ * pipeline reconfiguration: many small runtime objects and multi block
+ * buffers are allocated, a part of them is freed in pseudo random order and
+ * allocated again. Reports the average time of rmalloc/rballoc and rfree.
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <time.h>
+#include <cmocka.h>
+
+#include <sof/sof.h>
+#include <sof/lib/alloc.h>
+#include <ipc/header.h>
+#include <ipc/topology.h>
+
+#define BENCH_ROUNDS		200
+#define BENCH_RT_OBJECTS	80
+#define BENCH_BUF_OBJECTS	12
+
+static struct sof *sof;
+
+static const size_t rt_sizes[] = { 24, 48, 60, 100, 200 };
+static const size_t buf_sizes[] = { 700, 1536, 2304 };
+
+struct bench_state {
+	void *rt[BENCH_RT_OBJECTS];
+	void *buf[BENCH_BUF_OBJECTS];
+	uint32_t seed;
+	uint64_t alloc_ns;
+	uint64_t free_ns;
+	unsigned int allocs;
+	unsigned int frees;
+};
+
+static uint64_t bench_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint32_t bench_rand(struct bench_state *st)
+{
+	st->seed = st->seed * 1664525 + 1013904223;
+
+	return st->seed >> 8;
+}
+
+static void *bench_alloc(struct bench_state *st, int zone, size_t bytes)
+{
+	uint64_t t = bench_now();
+	void *ptr;
+
+	if (zone == RZONE_BUFFER)
+		ptr = rballoc(zone, SOF_MEM_CAPS_RAM, bytes);
+	else
+		ptr = rmalloc(zone, SOF_MEM_CAPS_RAM, bytes);
+
+	st->alloc_ns += bench_now() - t;
+	st->allocs++;
+
+	assert_non_null(ptr);
+
+	return ptr;
+}
+
+static void bench_free(struct bench_state *st, void **ptr)
+{
+	uint64_t t = bench_now();
+
+	rfree(*ptr);
+
+	st->free_ns += bench_now() - t;
+	st->frees++;
+	*ptr = NULL;
+}
+
+static void bench_fill(struct bench_state *st)
+{
+	size_t bytes;
+	int i;
+
+	for (i = 0; i < BENCH_RT_OBJECTS; i++) {
+		bytes = rt_sizes[i % ARRAY_SIZE(rt_sizes)];
+		if (!st->rt[i])
+			st->rt[i] = bench_alloc(st, RZONE_RUNTIME, bytes);
+	}
+
+	for (i = 0; i < BENCH_BUF_OBJECTS; i++) {
+		bytes = buf_sizes[i % ARRAY_SIZE(buf_sizes)];
+		if (!st->buf[i])
+			st->buf[i] = bench_alloc(st, RZONE_BUFFER, bytes);
+	}
+}
+
+static void test_lib_alloc_bench(void **state)
+{
+	struct bench_state *st = calloc(1, sizeof(*st));
+	int round;
+	int i;
+
+	assert_non_null(st);
+	st->seed = 0xcafe;
+
+	for (round = 0; round < BENCH_ROUNDS; round++) {
+		bench_fill(st);
+
+		/* free about half of the objects to fragment the maps */
+		for (i = 0; i < BENCH_RT_OBJECTS; i++)
+			if (bench_rand(st) & 1)
+				bench_free(st, &st->rt[i]);
+
+		for (i = 0; i < BENCH_BUF_OBJECTS; i++)
+			if (bench_rand(st) & 1)
+				bench_free(st, &st->buf[i]);
+	}
+
+	for (i = 0; i < BENCH_RT_OBJECTS; i++)
+		if (st->rt[i])
+			bench_free(st, &st->rt[i]);
+
+	for (i = 0; i < BENCH_BUF_OBJECTS; i++)
+		if (st->buf[i])
+			bench_free(st, &st->buf[i]);
+
+	print_message("alloc: %u calls, %llu ns/call\n", st->allocs,
+		      (unsigned long long)(st->alloc_ns / st->allocs));
+	print_message("free: %u calls, %llu ns/call\n", st->frees,
+		      (unsigned long long)(st->free_ns / st->frees));
+
+	free(st);
+}
+
+static int setup(void **state)
+{
+	sof = malloc(sizeof(struct sof));
+	platform_init_memmap();
+	init_heap(sof);
+
+	return 0;
+}
+
+static int teardown(void **state)
+{
+	free(sof);
+
+	return 0;
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_lib_alloc_bench),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, setup, teardown);
+}
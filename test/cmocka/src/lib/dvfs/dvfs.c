@@ -0,0 +1,223 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2019 Intel Corporation. All rights reserved.
+
+#include <sof/common.h>
+#include <sof/lib/clk.h>
+#include <sof/lib/dvfs.h>
+#include <ipc/topology.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+
+#define MHZ(x)	((x) * 1000000)
+
+/* simulated CPU clock table */
+static const struct freq_table test_freq[] = {
+	{ MHZ(100), 100000, 0 },
+	{ MHZ(200), 200000, 1 },
+	{ MHZ(300), 300000, 2 },
+	{ MHZ(400), 400000, 3 },
+};
+
+#define TEST_FREQ_COUNT	ARRAY_SIZE(test_freq)
+
+/* measurement window in arbitrary time units */
+#define TEST_WINDOW	1000
+
+static void test_init(struct dvfs_gov *gov, uint32_t hz)
+{
+	dvfs_gov_init(gov, test_freq, TEST_FREQ_COUNT, hz);
+}
+
+/* feeds one window with load given in Hz at the current frequency */
+static uint32_t test_window(struct dvfs_gov *gov, uint32_t hz)
+{
+	uint64_t busy = (uint64_t)hz * TEST_WINDOW /
+			test_freq[gov->idx].freq;
+
+	dvfs_gov_load(gov, busy, TEST_WINDOW);
+
+	return dvfs_gov_select(gov);
+}
+
+static void test_lib_dvfs_init(void **state)
+{
+	struct dvfs_gov gov;
+
+	(void)state;
+
+	test_init(&gov, MHZ(100));
+	assert_int_equal(gov.idx, 0);
+
+	test_init(&gov, MHZ(250));
+	assert_int_equal(gov.idx, 2);
+
+	test_init(&gov, MHZ(1000));
+	assert_int_equal(gov.idx, TEST_FREQ_COUNT - 1);
+}
+
+static void test_lib_dvfs_pipeline_hz(void **state)
+{
+	struct sof_ipc_pipe_new pipe = { .period = 1000, .period_mips = 50000 };
+
+	(void)state;
+
+	assert_int_equal(dvfs_pipeline_hz(&pipe), MHZ(50));
+
+	pipe.period = 0;
+	assert_int_equal(dvfs_pipeline_hz(&pipe), 0);
+}
+
+static void test_lib_dvfs_load(void **state)
+{
+	struct dvfs_gov gov;
+
+	(void)state;
+
+	/* quarter of the time busy at 400 MHz */
+	test_init(&gov, MHZ(400));
+	dvfs_gov_load(&gov, TEST_WINDOW / 4, TEST_WINDOW);
+	assert_int_equal(gov.load_hz, MHZ(100));
+
+	/* empty window keeps previous value */
+	dvfs_gov_load(&gov, 0, 0);
+	assert_int_equal(gov.load_hz, MHZ(100));
+}
+
+static void test_lib_dvfs_raise_headroom(void **state)
+{
+	struct dvfs_gov gov;
+
+	(void)state;
+
+	/* 150 MHz with headroom doesn't fit 100 MHz but does 200 MHz */
+	test_init(&gov, MHZ(100));
+	gov.pipe_hz = MHZ(150);
+	assert_int_equal(dvfs_gov_raise(&gov), 1);
+
+	/* 170 MHz with headroom needs 300 MHz */
+	gov.pipe_hz = MHZ(170);
+	assert_int_equal(dvfs_gov_raise(&gov), 2);
+
+	/* demand above the table runs at max */
+	gov.pipe_hz = MHZ(600);
+	assert_int_equal(dvfs_gov_raise(&gov), TEST_FREQ_COUNT - 1);
+}
+
+static void test_lib_dvfs_raise_never_lowers(void **state)
+{
+	struct dvfs_gov gov;
+
+	(void)state;
+
+	test_init(&gov, MHZ(400));
+	assert_int_equal(dvfs_gov_raise(&gov), TEST_FREQ_COUNT - 1);
+}
+
+static void test_lib_dvfs_select_up_at_once(void **state)
+{
+	struct dvfs_gov gov;
+
+	(void)state;
+
+	/* measured load close to the limit */
+	test_init(&gov, MHZ(100));
+	assert_int_equal(test_window(&gov, MHZ(90)), 1);
+
+	/* declared demand larger than measured one wins */
+	gov.pipe_hz = MHZ(250);
+	assert_int_equal(test_window(&gov, MHZ(90)), 3);
+}
+
+static void test_lib_dvfs_select_down_delayed(void **state)
+{
+	struct dvfs_gov gov;
+	int i;
+
+	(void)state;
+
+	test_init(&gov, MHZ(400));
+
+	for (i = 1; i < DVFS_DOWN_WINDOWS; i++)
+		assert_int_equal(test_window(&gov, MHZ(100)), 3);
+
+	assert_int_equal(test_window(&gov, MHZ(100)), 1);
+}
+
+static void test_lib_dvfs_select_down_restart(void **state)
+{
+	struct dvfs_gov gov;
+	int i;
+
+	(void)state;
+
+	test_init(&gov, MHZ(400));
+
+	for (i = 1; i < DVFS_DOWN_WINDOWS; i++)
+		assert_int_equal(test_window(&gov, MHZ(100)), 3);
+
+	/* single busy window restarts the count */
+	assert_int_equal(test_window(&gov, MHZ(300)), 3);
+
+	for (i = 1; i < DVFS_DOWN_WINDOWS; i++)
+		assert_int_equal(test_window(&gov, MHZ(100)), 3);
+
+	assert_int_equal(test_window(&gov, MHZ(100)), 1);
+}
+
+static void test_lib_dvfs_select_hysteresis(void **state)
+{
+	struct dvfs_gov gov;
+	int i;
+
+	(void)state;
+
+	/* 165 MHz needs 300 MHz */
+	test_init(&gov, MHZ(200));
+	assert_int_equal(test_window(&gov, MHZ(165)), 2);
+
+	/* 155 MHz fits 200 MHz with headroom, but not with hysteresis */
+	for (i = 0; i < 2 * DVFS_DOWN_WINDOWS; i++)
+		assert_int_equal(test_window(&gov, MHZ(155)), 2);
+}
+
+static void test_lib_dvfs_select_pipeline_floor(void **state)
+{
+	struct dvfs_gov gov;
+	int i;
+
+	(void)state;
+
+	/* idle core with active pipeline stays at its declared demand */
+	test_init(&gov, MHZ(400));
+	gov.pipe_hz = MHZ(120);
+
+	for (i = 0; i < 2 * DVFS_DOWN_WINDOWS; i++)
+		test_window(&gov, 0);
+
+	assert_int_equal(gov.idx, 1);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_lib_dvfs_init),
+		cmocka_unit_test(test_lib_dvfs_pipeline_hz),
+		cmocka_unit_test(test_lib_dvfs_load),
+		cmocka_unit_test(test_lib_dvfs_raise_headroom),
+		cmocka_unit_test(test_lib_dvfs_raise_never_lowers),
+		cmocka_unit_test(test_lib_dvfs_select_up_at_once),
+		cmocka_unit_test(test_lib_dvfs_select_down_delayed),
+		cmocka_unit_test(test_lib_dvfs_select_down_restart),
+		cmocka_unit_test(test_lib_dvfs_select_hysteresis),
+		cmocka_unit_test(test_lib_dvfs_select_pipeline_floor),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
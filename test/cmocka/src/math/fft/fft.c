@@ -0,0 +1,130 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2019 Intel Corporation. All rights reserved.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <math.h>
+#include <cmocka.h>
+
+#include <sof/math/fft.h>
+#include <errno.h>
+
+#define TEST_SIZE	256
+#define Q31_SCALE	2147483648.0
+
+/* Max errors relative to full scale */
+#define DFT_TOLERANCE		0.000005
+#define ROUNDTRIP_TOLERANCE	0.00005
+
+static struct fft_plan plan;
+static uint8_t plan_data[FFT_SIZE_MAX * 8];
+static struct icomplex32 buf[TEST_SIZE];
+static int32_t input[TEST_SIZE];
+
+static void fill_noise(int32_t *x, int n)
+{
+	uint32_t seed = 1;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		seed = seed * 1664525 + 1013904223;
+		x[i] = (int32_t)seed;
+	}
+}
+
+static void test_math_fft_dft(void **state)
+{
+	double re;
+	double im;
+	double w;
+	int i;
+	int k;
+
+	(void)state;
+
+	assert_int_equal(fft_plan_init(&plan, plan_data, TEST_SIZE), 0);
+
+	fill_noise(input, TEST_SIZE);
+	for (i = 0; i < TEST_SIZE; i++) {
+		buf[i].real = input[i];
+		buf[i].imag = 0;
+	}
+
+	fft_execute_32(&plan, buf, false);
+
+	/* Forward transform is the DFT scaled by 1 / size */
+	for (k = 0; k < TEST_SIZE; k++) {
+		re = 0;
+		im = 0;
+		for (i = 0; i < TEST_SIZE; i++) {
+			w = 2 * M_PI * i * k / TEST_SIZE;
+			re += input[i] * cos(w);
+			im -= input[i] * sin(w);
+		}
+
+		re /= TEST_SIZE * Q31_SCALE;
+		im /= TEST_SIZE * Q31_SCALE;
+		assert_true(fabs(buf[k].real / Q31_SCALE - re) <
+			    DFT_TOLERANCE);
+		assert_true(fabs(buf[k].imag / Q31_SCALE - im) <
+			    DFT_TOLERANCE);
+	}
+}
+
+static void test_math_fft_roundtrip(void **state)
+{
+	int size;
+	int i;
+
+	(void)state;
+
+	for (size = FFT_SIZE_MIN; size <= FFT_SIZE_MAX; size <<= 1) {
+		struct icomplex32 data[size];
+
+		assert_int_equal(fft_plan_init(&plan, plan_data, size), 0);
+		fill_noise(input, TEST_SIZE);
+		for (i = 0; i < size; i++) {
+			data[i].real = input[i % TEST_SIZE] / 2;
+			data[i].imag = input[(i + 1) % TEST_SIZE] / 2;
+		}
+
+		fft_execute_32(&plan, data, false);
+		fft_execute_32(&plan, data, true);
+
+		for (i = 0; i < size; i++) {
+			assert_true(fabs((data[i].real -
+					  input[i % TEST_SIZE] / 2) /
+					 Q31_SCALE) < ROUNDTRIP_TOLERANCE);
+			assert_true(fabs((data[i].imag -
+					  input[(i + 1) % TEST_SIZE] / 2) /
+					 Q31_SCALE) < ROUNDTRIP_TOLERANCE);
+		}
+	}
+}
+
+static void test_math_fft_invalid_size(void **state)
+{
+	(void)state;
+
+	assert_int_equal(fft_plan_init(&plan, plan_data, 0), -EINVAL);
+	assert_int_equal(fft_plan_init(&plan, plan_data, 96), -EINVAL);
+	assert_int_equal(fft_plan_init(&plan, plan_data, 2 * FFT_SIZE_MAX),
+			 -EINVAL);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_math_fft_dft),
+		cmocka_unit_test(test_math_fft_roundtrip),
+		cmocka_unit_test(test_math_fft_invalid_size),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
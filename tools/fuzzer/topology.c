@@ -38,8 +38,6 @@ enum sof_ipc_dai_type find_dai(const char *name)
 	return SOF_DAI_INTEL_NONE;
 }
 
-void register_comp(int comp_type) {}
-
 int find_widget(struct comp_info *temp_comp_list, int count, char *name)
 {
 	int i;
@@ -312,6 +310,73 @@ int load_mixer(void *dev, int comp_id, int pipeline_id, int size)
 	return ret;
 }
 
+/* load tone dapm widget */
+int load_tone(void *dev, int comp_id, int pipeline_id, int size)
+{
+	struct fuzz *fuzzer = (struct fuzz *)dev;
+	struct sof_ipc_comp_tone tone = {0};
+	struct sof_ipc_comp_reply r;
+	int ret = 0;
+
+	ret = tplg_load_tone(comp_id, pipeline_id, size, &tone,
+			     fuzzer->tplg_file);
+	if (ret < 0)
+		return ret;
+
+	/* configure fuzzer msg */
+	fuzzer->msg.header = tone.comp.hdr.cmd;
+	*(struct sof_ipc_comp_tone *)fuzzer->msg.msg_data = tone;
+	fuzzer->msg.msg_size = sizeof(tone);
+	fuzzer->msg.reply_size = sizeof(r);
+
+	/* load tone component */
+	ret = fuzzer_send_msg(fuzzer);
+	if (ret < 0)
+		fprintf(stderr, "error: message tx failed\n");
+
+	return ret;
+}
+
+/* load effect dapm widget */
+int load_process(void *dev, int comp_id, int pipeline_id, int size,
+		 int num_kcontrols)
+{
+	struct fuzz *fuzzer = (struct fuzz *)dev;
+	struct sof_ipc_comp_process *process = NULL;
+	struct sof_ipc_comp_reply r;
+	void *msg_data = fuzzer->msg.msg_data;
+	int ret = 0;
+
+	ret = tplg_load_process(comp_id, pipeline_id, size, num_kcontrols,
+				&process, fuzzer->tplg_file);
+	if (ret < 0)
+		return ret;
+
+	/* configuration must fit in one message */
+	if (process->comp.hdr.size > SOF_IPC_MSG_MAX_SIZE) {
+		fprintf(stderr, "error: process data %u too big\n",
+			process->size);
+		free(process);
+		return -EINVAL;
+	}
+
+	/* configure fuzzer msg, the loaded process is sent as is */
+	fuzzer->msg.header = process->comp.hdr.cmd;
+	fuzzer->msg.msg_data = process;
+	fuzzer->msg.msg_size = process->comp.hdr.size;
+	fuzzer->msg.reply_size = sizeof(r);
+
+	/* load process component */
+	ret = fuzzer_send_msg(fuzzer);
+	if (ret < 0)
+		fprintf(stderr, "error: message tx failed\n");
+
+	fuzzer->msg.msg_data = msg_data;
+
+	free(process);
+	return ret;
+}
+
 /* parse topology file and set up pipeline */
 int parse_tplg(struct fuzz *fuzzer, char *tplg_filename)
 {
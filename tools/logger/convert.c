@@ -11,6 +11,9 @@
 #include <errno.h>
 #include <unistd.h>
 #include <math.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <kernel/abi.h>
 #include <user/trace.h>
 #include "convert.h"
@@ -22,6 +25,7 @@
 #define TRACE_MAX_FILENAME_LEN		128
 #define TRACE_MAX_IDS_STR		10
 #define TRACE_IDS_MASK			((1 << TRACE_ID_LENGTH) - 1)
+#define TRACE_INPUT_BUFFER_SIZE		(1024 * 1024)
 
 struct ldc_entry_header {
 	uint32_t level;
@@ -33,11 +37,30 @@ struct ldc_entry_header {
 	uint32_t text_len;
 };
 
+/* decoded entry, strings point into the mapped ldc file */
 struct ldc_entry {
 	struct ldc_entry_header header;
-	char *file_name;
-	char *text;
-	uint32_t *params;
+	const char *file_name;
+	const char *text;
+};
+
+/* mapped ldc file with entries indexed by their DWORD offset */
+struct ldc_dict {
+	uint8_t *map;
+	size_t map_size;
+	const uint8_t *data;
+	uint32_t base_address;
+	uint32_t data_length;
+	struct ldc_entry *index;
+	int full_name;
+};
+
+/* bulk reader for the trace input */
+struct input_buffer {
+	uint8_t *data;
+	size_t pos;
+	size_t len;
+	int error;
 };
 
 static double to_usecs(uint64_t time, double clk)
@@ -105,9 +128,9 @@ static const char * get_component_name(uint32_t component_id) {
 }
 
 /* remove superfluous leading file path and shrink to last 20 chars */
-static char *format_file_name(char *file_name_raw, int full_name)
+static const char *format_file_name(const char *file_name_raw, int full_name)
 {
-		char *name;
+		const char *name;
 		int len;
 
 		/* most/all string should have "src" */
@@ -126,7 +149,8 @@ static char *format_file_name(char *file_name_raw, int full_name)
 
 static void print_entry_params(FILE *out_fd,
 	const struct log_entry_header *dma_log, const struct ldc_entry *entry,
-	uint64_t last_timestamp, double clock, int use_colors, int raw_output)
+	const uint32_t *params, uint64_t last_timestamp, double clock,
+	int use_colors, int raw_output)
 {	
 	char ids[TRACE_MAX_IDS_STR];
 	float dt = to_usecs(dma_log->timestamp - last_timestamp, clock);
@@ -150,7 +174,7 @@ static void print_entry_params(FILE *out_fd,
 		entry->header.has_ids ? ids : "",
 		to_usecs(dma_log->timestamp, clock),
 		dt,
-		format_file_name(entry->file_name, raw_output),
+		entry->file_name,
 		entry->header.line_idx);
 
 	switch (entry->header.params_num) {
@@ -158,154 +182,197 @@ static void print_entry_params(FILE *out_fd,
 		fprintf(out_fd, "%s", entry->text);
 		break;
 	case 1:
-		fprintf(out_fd, entry->text, entry->params[0]);
+		fprintf(out_fd, entry->text, params[0]);
 		break;
 	case 2:
-		fprintf(out_fd, entry->text, entry->params[0], entry->params[1]);
+		fprintf(out_fd, entry->text, params[0], params[1]);
 		break;
 	case 3:
-		fprintf(out_fd, entry->text, entry->params[0], entry->params[1],
-			entry->params[2]);
+		fprintf(out_fd, entry->text, params[0], params[1],
+			params[2]);
 		break;
 	case 4:
-		fprintf(out_fd, entry->text, entry->params[0], entry->params[1],
-			entry->params[2], entry->params[3]);
+		fprintf(out_fd, entry->text, params[0], params[1],
+			params[2], params[3]);
 		break;
 	}
 	fprintf(out_fd, "%s\n", use_colors ? KNRM : "");
-	fflush(out_fd);
 }
 
-static int fetch_entry(const struct convert_config *config,
-	uint32_t base_address, uint32_t data_offset,
-	const struct log_entry_header *dma_log, uint64_t *last_timestamp)
+/* decodes the entry at offset, returns its size in the ldc file */
+static int ldc_decode_entry(const struct ldc_dict *dict, uint32_t offset,
+			    struct ldc_entry *entry)
 {
-	struct ldc_entry entry;
-	uint32_t entry_offset;
+	const struct ldc_entry_header *header;
+	const char *file_name;
+	const char *text;
+	uint32_t size;
 
-	int ret;
+	if (dict->data_length - offset < sizeof(*header))
+		return -EINVAL;
 
-	entry.file_name = NULL;
-	entry.text = NULL;
-	entry.params = NULL;
+	header = (const struct ldc_entry_header *)(dict->data + offset);
+	if (header->file_name_len > TRACE_MAX_FILENAME_LEN ||
+	    header->text_len > TRACE_MAX_TEXT_LEN ||
+	    header->params_num > TRACE_MAX_PARAMS_COUNT ||
+	    !header->file_name_len || !header->text_len)
+		return -EINVAL;
 
-	/* evaluate entry offset in input file */
-	entry_offset = dma_log->log_entry_address - base_address;
+	size = sizeof(*header) + header->file_name_len + header->text_len;
+	if (dict->data_length - offset < size)
+		return -EINVAL;
 
-	/* set file position to beginning of processed entry */
-	fseek(config->ldc_fd, entry_offset + data_offset, SEEK_SET);
+	/* strings are used in place so they must be terminated */
+	file_name = (const char *)(header + 1);
+	text = file_name + header->file_name_len;
+	if (file_name[header->file_name_len - 1] ||
+	    text[header->text_len - 1])
+		return -EINVAL;
 
-	/* fetching elf header params */
-	ret = fread(&entry.header, sizeof(entry.header), 1, config->ldc_fd);
-	if (!ret) {
-		ret = -ferror(config->ldc_fd);
-		goto out;
-	}
-	if (entry.header.file_name_len > TRACE_MAX_FILENAME_LEN) {
-		fprintf(stderr, "Error: Invalid filename length or ldc file does not match firmware\n");
-		ret = -EINVAL;
-		goto out;
-	}
-	entry.file_name = (char *)malloc(entry.header.file_name_len);
+	entry->header = *header;
+	entry->file_name = format_file_name(file_name, dict->full_name);
+	entry->text = text;
 
-	if (!entry.file_name) {
-		fprintf(stderr, "error: can't allocate %d byte for "
-			"entry.file_name\n", entry.header.file_name_len);
-		ret = -ENOMEM;
-		goto out;
-	}
+	return size;
+}
 
-	ret = fread(entry.file_name, sizeof(char), entry.header.file_name_len,
-		config->ldc_fd);
-	if (ret != entry.header.file_name_len) {
-		ret = -ferror(config->ldc_fd);
-		goto out;
+static const struct ldc_entry *ldc_get_entry(struct ldc_dict *dict,
+					     uint32_t address)
+{
+	uint32_t offset = address - dict->base_address;
+	struct ldc_entry *entry;
+
+	if (offset >= dict->data_length || offset % sizeof(uint32_t)) {
+		fprintf(stderr, "Error: Invalid entry address 0x%x\n",
+			address);
+		return NULL;
 	}
 
-	/* fetching text */
-	if (entry.header.text_len > TRACE_MAX_TEXT_LEN) {
-		fprintf(stderr, "Error: Invalid text length. \n");
-		ret = -EINVAL;
-		goto out;
+	/* entries not reached by the initial walk are decoded on first use */
+	entry = &dict->index[offset / sizeof(uint32_t)];
+	if (!entry->text && ldc_decode_entry(dict, offset, entry) < 0) {
+		fprintf(stderr, "Error: Invalid entry at 0x%x or ldc file "
+			"does not match firmware\n", address);
+		return NULL;
 	}
-	entry.text = (char *)malloc(entry.header.text_len);
-	if (entry.text == NULL) {
-		fprintf(stderr, "error: can't allocate %d byte for "
-			"entry.text\n", entry.header.text_len);
-		ret = -ENOMEM;
-		goto out;
+
+	return entry;
+}
+
+static int ldc_map(const struct convert_config *config,
+		   const struct snd_sof_logs_header *snd,
+		   struct ldc_dict *dict)
+{
+	struct ldc_entry *entry;
+	struct stat st;
+	uint32_t offset;
+	int size;
+
+	if (fstat(fileno(config->ldc_fd), &st) < 0)
+		return -errno;
+
+	if ((uint64_t)snd->data_offset + snd->data_length > st.st_size) {
+		fprintf(stderr, "Error: %s is truncated\n", config->ldc_file);
+		return -EINVAL;
 	}
-	ret = fread(entry.text, sizeof(char), entry.header.text_len, config->ldc_fd);
-	if (ret != entry.header.text_len) {
-		ret = -ferror(config->ldc_fd);
-		goto out;
+
+	dict->map_size = st.st_size;
+	dict->map = mmap(NULL, dict->map_size, PROT_READ, MAP_PRIVATE,
+			 fileno(config->ldc_fd), 0);
+	if (dict->map == MAP_FAILED) {
+		fprintf(stderr, "Error: can't map %s\n", config->ldc_file);
+		dict->map = NULL;
+		return -errno;
 	}
 
-	/* fetching entry params from dma dump */
-	if (entry.header.params_num > TRACE_MAX_PARAMS_COUNT) {
-		fprintf(stderr, "Error: Invalid number of parameters. \n");
-		ret = -EINVAL;
-		goto out;
+	dict->data = dict->map + snd->data_offset;
+	dict->base_address = snd->base_address;
+	dict->data_length = snd->data_length;
+	dict->full_name = config->raw_output;
+
+	/* one slot for every DWORD an entry can start at */
+	dict->index = calloc(dict->data_length / sizeof(uint32_t) + 1,
+			     sizeof(*dict->index));
+	if (!dict->index) {
+		fprintf(stderr, "error: can't allocate ldc index\n");
+		return -ENOMEM;
 	}
-	entry.params = (uint32_t *)malloc(sizeof(uint32_t) *
-		entry.header.params_num);
-	if (entry.params == NULL) {
-		fprintf(stderr, "error: can't allocate %d byte for "
-			"entry.params\n", (int)(sizeof(uint32_t) *
-			entry.header.params_num));
-		ret = -ENOMEM;
-		goto out;
+
+	/* entries are laid out back to back, index them up front */
+	for (offset = 0; offset < dict->data_length;
+	     offset += CEIL(size, sizeof(uint32_t)) * sizeof(uint32_t)) {
+		entry = &dict->index[offset / sizeof(uint32_t)];
+		size = ldc_decode_entry(dict, offset, entry);
+		if (size < 0)
+			break;
 	}
 
-	if (config->serial_fd < 0) {
-		ret = fread(entry.params, sizeof(uint32_t),
-			    entry.header.params_num, config->in_fd);
-		if (ret != entry.header.params_num) {
-			ret = -ferror(config->in_fd);
-			goto out;
-		}
-	} else {
-		size_t size = sizeof(uint32_t) * entry.header.params_num;
-		uint8_t *n;
-
-		for (n = (uint8_t *)entry.params; size;
-		     n += ret, size -= ret) {
-			ret = read(config->serial_fd, n, size);
-			if (ret < 0) {
-				ret = -errno;
-				goto out;
-			}
-			if (ret != size)
-				fprintf(stderr,
-					"Partial read of %u bytes of %lu.\n",
-					ret, size);
+	return 0;
+}
+
+static void ldc_unmap(struct ldc_dict *dict)
+{
+	free(dict->index);
+	if (dict->map)
+		munmap(dict->map, dict->map_size);
+}
+
+/*
+ * Returns a pointer to the next bytes of input, refilling the buffer in
+ * bulk when needed. The previously returned bytes stay in the buffer so
+ * the caller can step back over them with input_unget().
+ */
+static const void *input_get(const struct convert_config *config,
+			     struct input_buffer *in, size_t bytes)
+{
+	const void *data;
+	ssize_t count;
+
+	while (in->len - in->pos < bytes) {
+		memmove(in->data, in->data + in->pos, in->len - in->pos);
+		in->len -= in->pos;
+		in->pos = 0;
+
+		count = read(fileno(config->in_fd), in->data + in->len,
+			     TRACE_INPUT_BUFFER_SIZE - in->len);
+		if (count < 0) {
+			if (errno == EINTR)
+				continue;
+			in->error = -errno;
+			return NULL;
 		}
-	}
 
-	/* printing entry content */
-	print_entry_params(config->out_fd, dma_log, &entry, *last_timestamp,
-			   config->clock, config->use_colors, config->raw_output);
-	*last_timestamp = dma_log->timestamp;
+		if (!count) {
+			if (!config->trace)
+				return NULL;
 
-	/* set f_ldc file position to the beginning */
-	rewind(config->ldc_fd);
+			/* live trace, wait for more data */
+			freopen(NULL, "r", config->in_fd);
+			continue;
+		}
 
-	ret = 0;
-out:
-	/* free alocated memory */
-	free(entry.params);
-	free(entry.text);
-	free(entry.file_name);
+		in->len += count;
+	}
 
-	return ret;
+	data = in->data + in->pos;
+	in->pos += bytes;
+	return data;
+}
+
+static inline void input_unget(struct input_buffer *in, size_t bytes)
+{
+	in->pos -= bytes;
 }
 
 static int serial_read(const struct convert_config *config,
-	struct snd_sof_logs_header *snd, uint64_t *last_timestamp)
+	struct ldc_dict *dict, uint64_t *last_timestamp)
 {
+	uint32_t params[TRACE_MAX_PARAMS_COUNT];
+	const struct ldc_entry *entry;
 	struct log_entry_header dma_log;
 	size_t len;
 	uint32_t *n;
+	uint8_t *p;
 	int ret;
 
 	for (len = 0, n = (uint32_t *)&dma_log; len < sizeof(dma_log); n++) {
@@ -321,8 +388,9 @@ static int serial_read(const struct convert_config *config,
 	}
 
 	/* Skip all trace_point() values, although this test isn't 100% reliable */
-	while ((dma_log.log_entry_address < snd->base_address) ||
-	       dma_log.log_entry_address > snd->base_address + snd->data_length) {
+	while ((dma_log.log_entry_address < dict->base_address) ||
+	       dma_log.log_entry_address > dict->base_address +
+					   dict->data_length) {
 		/*
 		 * 8 characters and a '\n' come from the serial port, append a
 		 * '\0'
@@ -348,16 +416,61 @@ static int serial_read(const struct convert_config *config,
 	}
 
 	/* fetching entry from elf dump */
-	return fetch_entry(config, snd->base_address, snd->data_offset,
-			   &dma_log, last_timestamp);
+	entry = ldc_get_entry(dict, dma_log.log_entry_address);
+	if (!entry)
+		return -EINVAL;
+
+	/* fetching entry params from the serial port */
+	len = sizeof(uint32_t) * entry->header.params_num;
+	for (p = (uint8_t *)params; len; p += ret, len -= ret) {
+		ret = read(config->serial_fd, p, len);
+		if (ret < 0)
+			return -errno;
+		if (ret != len)
+			fprintf(stderr, "Partial read of %u bytes of %lu.\n",
+				ret, len);
+	}
+
+	print_entry_params(config->out_fd, &dma_log, entry, params,
+			   *last_timestamp, config->clock, config->use_colors,
+			   config->raw_output);
+	fflush(config->out_fd);
+	*last_timestamp = dma_log.timestamp;
+
+	return 0;
+}
+
+static void print_benchmark(const struct timespec *start, uint64_t records,
+			    uint64_t bytes)
+{
+	struct timespec end;
+	double secs;
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	secs = (end.tv_sec - start->tv_sec) +
+		(end.tv_nsec - start->tv_nsec) / 1e9;
+	if (secs <= 0)
+		secs = 1e-9;
+
+	fprintf(stderr, "%llu records, %llu bytes in %.3f s: "
+		"%.0f records/s, %.1f MB/s\n",
+		(unsigned long long)records, (unsigned long long)bytes, secs,
+		records / secs, bytes / secs / (1024 * 1024));
 }
 
 static int logger_read(const struct convert_config *config,
-	struct snd_sof_logs_header *snd)
+	struct ldc_dict *dict)
 {
-	struct log_entry_header dma_log;
-	int ret = 0;
+	const struct log_entry_header *dma_log;
+	const struct ldc_entry *entry;
+	const uint32_t *params;
+	struct input_buffer in = { 0 };
 	uint64_t last_timestamp = 0;
+	uint64_t records = 0;
+	uint64_t bytes = 0;
+	struct timespec start;
+	size_t params_size;
+	int ret = 0;
 
 	if (!config->raw_output)
 		print_table_header(config->out_fd);
@@ -365,47 +478,83 @@ static int logger_read(const struct convert_config *config,
 	if (config->serial_fd >= 0)
 		/* Wait for CTRL-C */
 		for (;;) {
-			ret = serial_read(config, snd, &last_timestamp);
+			ret = serial_read(config, dict, &last_timestamp);
 			if (ret < 0)
 				return ret;
 		}
 
-	while (!ferror(config->in_fd)) {
-		/* getting entry parameters from dma dump */
-		ret = fread(&dma_log, sizeof(dma_log), 1, config->in_fd);
-		if (!ret) {
-			if (config->trace && !ferror(config->in_fd)) {
-				freopen(NULL, "r", config->in_fd);
-				continue;
-			}
+	in.data = malloc(TRACE_INPUT_BUFFER_SIZE);
+	if (!in.data) {
+		fprintf(stderr, "error: can't allocate input buffer\n");
+		return -ENOMEM;
+	}
 
-			return -ferror(config->in_fd);
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	for (;;) {
+		/* getting entry parameters from dma dump */
+		dma_log = input_get(config, &in, sizeof(*dma_log));
+		if (!dma_log) {
+			ret = in.error;
+			break;
 		}
 
 		/* checking if received trace address is located in
 		 * entry section in elf file.
 		 */
-		if ((dma_log.log_entry_address < snd->base_address) ||
-			dma_log.log_entry_address > snd->base_address + snd->data_length) {
-			/* in case the address is not correct input fd should be
-			 * move forward by one DWORD, not entire struct dma_log
+		if ((dma_log->log_entry_address < dict->base_address) ||
+		    dma_log->log_entry_address > dict->base_address +
+						 dict->data_length) {
+			/* in case the address is not correct input should be
+			 * moved forward by one DWORD, not entire struct dma_log
 			 */
-			fseek(config->in_fd, -(sizeof(dma_log) - sizeof(uint32_t)), SEEK_CUR);
+			input_unget(&in, sizeof(*dma_log) - sizeof(uint32_t));
 			continue;
 		}
 
 		/* fetching entry from elf dump */
-		ret = fetch_entry(config, snd->base_address, snd->data_offset,
-				  &dma_log, &last_timestamp);
-		if (ret)
+		entry = ldc_get_entry(dict, dma_log->log_entry_address);
+		if (!entry) {
+			ret = -EINVAL;
+			break;
+		}
+
+		/* header and params are contiguous in the input buffer */
+		input_unget(&in, sizeof(*dma_log));
+		params_size = sizeof(uint32_t) * entry->header.params_num;
+		dma_log = input_get(config, &in,
+				    sizeof(*dma_log) + params_size);
+		if (!dma_log) {
+			ret = in.error;
 			break;
+		}
+		params = (const uint32_t *)(dma_log + 1);
+
+		print_entry_params(config->out_fd, dma_log, entry, params,
+				   last_timestamp, config->clock,
+				   config->use_colors, config->raw_output);
+		last_timestamp = dma_log->timestamp;
+
+		/* keep live output flowing */
+		if (config->trace || config->input_std)
+			fflush(config->out_fd);
+
+		records++;
+		bytes += sizeof(*dma_log) + params_size;
 	}
 
+	fflush(config->out_fd);
+
+	if (config->benchmark)
+		print_benchmark(&start, records, bytes);
+
+	free(in.data);
 	return ret;
 }
 
 int convert(const struct convert_config *config) {
 	struct snd_sof_logs_header snd;
+	struct ldc_dict dict = { 0 };
 	int count, ret = 0;
 
 	count = fread(&snd, sizeof(snd), 1, config->ldc_fd);
@@ -470,5 +619,11 @@ int convert(const struct convert_config *config) {
 				SOF_ABI_VERSION_PATCH(snd.version.abi_version));
 		return -EINVAL;
 	}
-	return logger_read(config, &snd);
+
+	ret = ldc_map(config, &snd, &dict);
+	if (!ret)
+		ret = logger_read(config, &dict);
+
+	ldc_unmap(&dict);
+	return ret;
 }
@@ -33,6 +33,7 @@ struct convert_config {
 	int use_colors;
 	int serial_fd;
 	int raw_output;
+	int benchmark;
 };
 
 int convert(const struct convert_config *config);
@@ -43,6 +43,7 @@ static void usage(void)
 	fprintf(stdout, "%s:\t -t\t\t\tDisplay trace data\n", APP_NAME);
 	fprintf(stdout, "%s:\t -u baud\t\tInput data from a UART\n", APP_NAME);
 	fprintf(stdout, "%s:\t -r less formatted output for chained log processors\n", APP_NAME);
+	fprintf(stdout, "%s:\t -b\t\t\tReport records/s\n", APP_NAME);
 	exit(0);
 }
 
@@ -147,8 +148,9 @@ int main(int argc, char *argv[])
 	config.use_colors = 1;
 	config.serial_fd = -EINVAL;
 	config.raw_output = 0;
+	config.benchmark = 0;
 
-	while ((opt = getopt(argc, argv, "ho:i:l:ps:c:u:tev:r")) != -1) {
+	while ((opt = getopt(argc, argv, "ho:i:l:ps:c:u:tev:rb")) != -1) {
 		switch (opt) {
 		case 'o':
 			config.out_file = optarg;
@@ -184,6 +186,9 @@ int main(int argc, char *argv[])
 		case 'r':
 			config.raw_output = 1;
 			break;
+		case 'b':
+			config.benchmark = 1;
+			break;
 		case 'v':
 			/* enabling checking fw version with ver_file file */
 			config.version_fw = 1;
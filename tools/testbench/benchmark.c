@@ -0,0 +1,356 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2019 Intel Corporation. All rights reserved.
+
+/*
+ * Benchmark mode: runs the pipelines for a fixed number of periods and
+ * times every component copy() and every scheduled period.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <sof/audio/component.h>
+#include <sof/audio/pipeline.h>
+#include <sof/drivers/ipc.h>
+#include <sof/list.h>
+#include <ipc/topology.h>
+#include "testbench/benchmark.h"
+
+/* original copy() of a timed component driver */
+struct tb_drv_hook {
+	struct comp_driver *drv;
+	int (*copy)(struct comp_dev *dev);
+};
+
+/* period latency summary */
+struct tb_bench_stats {
+	double wall_s;
+	double audio_s;
+	double min_us;
+	double p50_us;
+	double p90_us;
+	double p99_us;
+	double p999_us;
+	double max_us;
+};
+
+static struct tb_bench {
+	struct tb_comp_perf comp[TB_BENCH_MAX_COMPS];
+	int num_comps;
+	struct tb_drv_hook hook[TB_BENCH_MAX_DRIVERS];
+	int num_hooks;
+	uint64_t *period_ns;
+	uint32_t num_periods;
+	uint32_t max_periods;
+} bench;
+
+static inline uint64_t tb_bench_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static const char *tb_comp_name(uint32_t type)
+{
+	switch (type) {
+	case SOF_COMP_HOST:
+	case SOF_COMP_SG_HOST:
+		return "host";
+	case SOF_COMP_DAI:
+	case SOF_COMP_SG_DAI:
+		return "dai";
+	case SOF_COMP_VOLUME:
+		return "volume";
+	case SOF_COMP_MIXER:
+		return "mixer";
+	case SOF_COMP_MUX:
+		return "mux";
+	case SOF_COMP_DEMUX:
+		return "demux";
+	case SOF_COMP_SRC:
+		return "src";
+	case SOF_COMP_TONE:
+		return "tone";
+	case SOF_COMP_SWITCH:
+		return "switch";
+	case SOF_COMP_EQ_IIR:
+		return "eq_iir";
+	case SOF_COMP_EQ_FIR:
+		return "eq_fir";
+	case SOF_COMP_KEYWORD_DETECT:
+		return "detect";
+	case SOF_COMP_KPB:
+		return "kpb";
+	case SOF_COMP_SELECTOR:
+		return "selector";
+	case SOF_COMP_FILEREAD:
+	case SOF_COMP_FILEWRITE:
+		return "file";
+	default:
+		return "unknown";
+	}
+}
+
+/* replaces the driver copy() of every component while benchmarking */
+static int tb_bench_copy(struct comp_dev *dev)
+{
+	struct tb_comp_perf *perf = NULL;
+	int (*copy)(struct comp_dev *dev) = NULL;
+	uint64_t start;
+	uint64_t ns;
+	int ret;
+	int i;
+
+	for (i = 0; i < bench.num_hooks; i++) {
+		if (bench.hook[i].drv == dev->drv) {
+			copy = bench.hook[i].copy;
+			break;
+		}
+	}
+
+	for (i = 0; i < bench.num_comps; i++) {
+		if (bench.comp[i].dev == dev) {
+			perf = &bench.comp[i];
+			break;
+		}
+	}
+
+	start = tb_bench_ns();
+	ret = copy(dev);
+	ns = tb_bench_ns() - start;
+
+	if (perf) {
+		perf->copies++;
+		perf->ns_total += ns;
+		if (ns > perf->ns_peak)
+			perf->ns_peak = ns;
+	}
+
+	return ret;
+}
+
+static int tb_bench_hook(struct comp_driver *drv)
+{
+	int i;
+
+	for (i = 0; i < bench.num_hooks; i++)
+		if (bench.hook[i].drv == drv)
+			return 0;
+
+	if (bench.num_hooks == TB_BENCH_MAX_DRIVERS)
+		return -ENOMEM;
+
+	bench.hook[i].drv = drv;
+	bench.hook[i].copy = drv->ops.copy;
+	drv->ops.copy = tb_bench_copy;
+	bench.num_hooks++;
+
+	return 0;
+}
+
+/* starts timing all components known to IPC */
+int tb_bench_init(struct ipc *ipc, uint32_t periods)
+{
+	struct ipc_comp_dev *icd;
+	struct list_item *clist;
+	int ret;
+
+	bench.period_ns = calloc(periods, sizeof(*bench.period_ns));
+	if (!bench.period_ns)
+		return -ENOMEM;
+
+	bench.max_periods = periods;
+
+	list_for_item(clist, &ipc->shared_ctx->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->type != COMP_TYPE_COMPONENT)
+			continue;
+
+		if (bench.num_comps == TB_BENCH_MAX_COMPS)
+			return -ENOMEM;
+
+		ret = tb_bench_hook(icd->cd->drv);
+		if (ret < 0)
+			return ret;
+
+		bench.comp[bench.num_comps++].dev = icd->cd;
+	}
+
+	return 0;
+}
+
+/* schedules all pipelines for the given number of periods */
+void tb_bench_run(struct tb_pipelines *pipes, uint32_t periods)
+{
+	uint64_t start;
+	uint32_t i;
+
+	for (i = 0; i < periods && i < bench.max_periods; i++) {
+		start = tb_bench_ns();
+		tb_pipeline_copy(pipes);
+		bench.period_ns[i] = tb_bench_ns() - start;
+	}
+
+	bench.num_periods = i;
+}
+
+static int tb_bench_cmp(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a;
+	uint64_t y = *(const uint64_t *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+/* nearest rank percentile of sorted period times */
+static double tb_bench_percentile(const uint64_t *ns, uint32_t n, double pct)
+{
+	uint32_t rank = (uint32_t)(pct / 100 * n + 0.9999);
+
+	if (!n)
+		return 0;
+
+	if (rank < 1)
+		rank = 1;
+	if (rank > n)
+		rank = n;
+
+	return ns[rank - 1] / 1e3;
+}
+
+static void tb_bench_stats(struct tb_bench_stats *s, uint32_t period_us)
+{
+	uint64_t *ns = bench.period_ns;
+	uint32_t n = bench.num_periods;
+	uint64_t total = 0;
+	uint32_t i;
+
+	for (i = 0; i < n; i++)
+		total += ns[i];
+
+	qsort(ns, n, sizeof(*ns), tb_bench_cmp);
+
+	s->wall_s = total / 1e9;
+	s->audio_s = (double)n * period_us / 1e6;
+	s->min_us = n ? ns[0] / 1e3 : 0;
+	s->p50_us = tb_bench_percentile(ns, n, 50);
+	s->p90_us = tb_bench_percentile(ns, n, 90);
+	s->p99_us = tb_bench_percentile(ns, n, 99);
+	s->p999_us = tb_bench_percentile(ns, n, 99.9);
+	s->max_us = n ? ns[n - 1] / 1e3 : 0;
+}
+
+/* MCPS a component would need on a core running at the host clock */
+static double tb_bench_mcps(const struct tb_comp_perf *perf,
+			    const struct tb_bench_stats *s, double cpu_mhz)
+{
+	if (s->audio_s <= 0)
+		return 0;
+
+	return perf->ns_total / 1e9 / s->audio_s * cpu_mhz;
+}
+
+void tb_bench_report(FILE *out, struct testbench_prm *tp,
+		     uint32_t period_us)
+{
+	const struct tb_comp_perf *perf;
+	struct tb_bench_stats s;
+	int i;
+
+	tb_bench_stats(&s, period_us);
+
+	fprintf(out, "Benchmark: %u periods of %u us, %.2f s audio in %.3f s,",
+		bench.num_periods, period_us, s.audio_s, s.wall_s);
+	fprintf(out, " %.2f x realtime\n",
+		s.wall_s > 0 ? s.audio_s / s.wall_s : 0);
+	fprintf(out, "Period latency us: min %.2f p50 %.2f p90 %.2f",
+		s.min_us, s.p50_us, s.p90_us);
+	fprintf(out, " p99 %.2f p99.9 %.2f max %.2f\n",
+		s.p99_us, s.p999_us, s.max_us);
+	fprintf(out, "MCPS estimated at %.0f MHz host clock\n", tp->cpu_mhz);
+	fprintf(out, "%6s %-10s %10s %12s %10s %10s %8s %10s\n", "ID",
+		"TYPE", "COPIES", "TOTAL us", "AVG us", "PEAK us", "LOAD %",
+		"MCPS");
+
+	for (i = 0; i < bench.num_comps; i++) {
+		perf = &bench.comp[i];
+		fprintf(out, "%6u %-10s %10llu %12.1f %10.3f %10.3f %8.3f",
+			perf->dev->comp.id, tb_comp_name(perf->dev->comp.type),
+			(unsigned long long)perf->copies, perf->ns_total / 1e3,
+			perf->copies ? perf->ns_total / 1e3 / perf->copies : 0,
+			perf->ns_peak / 1e3,
+			s.audio_s > 0 ? perf->ns_total / 1e7 / s.audio_s : 0);
+		fprintf(out, " %10.3f\n", tb_bench_mcps(perf, &s, tp->cpu_mhz));
+	}
+}
+
+int tb_bench_json(const char *file, struct testbench_prm *tp,
+		  uint32_t period_us)
+{
+	const struct tb_comp_perf *perf;
+	struct tb_bench_stats s;
+	FILE *out;
+	int i;
+
+	out = strcmp(file, "-") ? fopen(file, "w") : stdout;
+	if (!out) {
+		fprintf(stderr, "error: opening file %s\n", file);
+		return -EINVAL;
+	}
+
+	tb_bench_stats(&s, period_us);
+
+	fprintf(out, "{\n");
+	fprintf(out, "\t\"topology\": \"%s\",\n", tp->tplg_file);
+	fprintf(out, "\t\"format\": \"%s\",\n", tp->bits_in);
+	fprintf(out, "\t\"rate_in\": %u,\n", tp->fs_in);
+	fprintf(out, "\t\"rate_out\": %u,\n", tp->fs_out);
+	fprintf(out, "\t\"period_us\": %u,\n", period_us);
+	fprintf(out, "\t\"periods\": %u,\n", bench.num_periods);
+	fprintf(out, "\t\"audio_s\": %.6f,\n", s.audio_s);
+	fprintf(out, "\t\"wall_s\": %.6f,\n", s.wall_s);
+	fprintf(out, "\t\"cpu_mhz\": %.1f,\n", tp->cpu_mhz);
+	fprintf(out, "\t\"period_latency_us\": {\"min\": %.3f, ", s.min_us);
+	fprintf(out, "\"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, ",
+		s.p50_us, s.p90_us, s.p99_us);
+	fprintf(out, "\"p99.9\": %.3f, \"max\": %.3f},\n",
+		s.p999_us, s.max_us);
+	fprintf(out, "\t\"components\": [");
+
+	for (i = 0; i < bench.num_comps; i++) {
+		perf = &bench.comp[i];
+		fprintf(out, "%s\n\t\t{\"id\": %u, \"type\": \"%s\", ",
+			i ? "," : "", perf->dev->comp.id,
+			tb_comp_name(perf->dev->comp.type));
+		fprintf(out, "\"copies\": %llu, \"total_us\": %.3f, ",
+			(unsigned long long)perf->copies, perf->ns_total / 1e3);
+		fprintf(out, "\"peak_us\": %.3f, \"mcps\": %.3f}",
+			perf->ns_peak / 1e3,
+			tb_bench_mcps(perf, &s, tp->cpu_mhz));
+	}
+
+	fprintf(out, "\n\t]\n}\n");
+
+	if (out != stdout)
+		fclose(out);
+
+	return 0;
+}
+
+/* restores component drivers and frees timing data */
+void tb_bench_free(void)
+{
+	int i;
+
+	for (i = 0; i < bench.num_hooks; i++)
+		bench.hook[i].drv->ops.copy = bench.hook[i].copy;
+
+	free(bench.period_ns);
+	memset(&bench, 0, sizeof(bench));
+}
@@ -2,11 +2,13 @@
 //
 // Copyright(c) 2018 Intel Corporation. All rights reserved.
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
 #include <time.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sof/string.h>
 #include <math.h>
 #include <sof/sof.h>
@@ -18,7 +20,10 @@
 #include <sof/schedule/edf_schedule.h>
 #include <sof/schedule/schedule.h>
 #include <sof/lib/wait.h>
+#include <sof/math/numbers.h>
+#include <sof/audio/buffer.h>
 #include <sof/audio/pipeline.h>
+#include <sof/list.h>
 #include "testbench/common_test.h"
 #include <tplg_parser/topology.h>
 
@@ -46,109 +51,210 @@ int tb_pipeline_setup(struct sof *sof)
 	return 0;
 }
 
-/* set up pcm params, prepare and trigger pipeline */
-int tb_pipeline_start(struct ipc *ipc, int nch,
-		      struct sof_ipc_pipe_new *ipc_pipe,
+/* true if a buffer brings data into p from a pipeline not yet ordered */
+static bool tb_pipeline_has_producer(struct ipc *ipc, struct pipeline *p,
+				     struct pipeline **pending, int num)
+{
+	struct ipc_comp_dev *icd;
+	struct list_item *clist;
+	struct comp_buffer *buffer;
+	int i;
+
+	list_for_item(clist, &ipc->shared_ctx->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->type != COMP_TYPE_BUFFER)
+			continue;
+
+		buffer = icd->cb;
+		if (!buffer->source || !buffer->sink ||
+		    buffer->sink->pipeline != p ||
+		    buffer->source->pipeline == p)
+			continue;
+
+		for (i = 0; i < num; i++) {
+			if (pending[i] == buffer->source->pipeline)
+				return true;
+		}
+	}
+
+	return false;
+}
+
+/* collect all topology pipelines in data flow order */
+int tb_pipelines_find(struct ipc *ipc, struct tb_pipelines *pipes)
+{
+	struct pipeline *pending[TB_MAX_PIPELINES];
+	struct ipc_comp_dev *icd;
+	struct list_item *clist;
+	struct pipeline *p;
+	int num = 0;
+	int i;
+
+	list_for_item(clist, &ipc->shared_ctx->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->type != COMP_TYPE_PIPELINE)
+			continue;
+
+		p = icd->pipeline;
+		if (!p->source_comp || !p->sink_comp || !p->ipc_pipe.period) {
+			fprintf(stderr, "error: pipeline %d not complete\n",
+				p->ipc_pipe.pipeline_id);
+			return -EINVAL;
+		}
+
+		if (num == TB_MAX_PIPELINES) {
+			fprintf(stderr, "error: more than %d pipelines\n",
+				TB_MAX_PIPELINES);
+			return -EINVAL;
+		}
+
+		pending[num++] = p;
+	}
+
+	if (!num) {
+		fprintf(stderr, "error: no pipelines in topology\n");
+		return -EINVAL;
+	}
+
+	pipes->num = 0;
+	pipes->period = UINT32_MAX;
+	pipes->ticks = 0;
+
+	/* producers go first, a feedback loop takes the next in line */
+	while (num) {
+		for (i = 0; i < num; i++) {
+			if (!tb_pipeline_has_producer(ipc, pending[i], pending,
+						      num))
+				break;
+		}
+
+		if (i == num)
+			i = 0;
+
+		p = pending[i];
+		pipes->p[pipes->num++] = p;
+		pipes->period = MIN(pipes->period, p->ipc_pipe.period);
+
+		num--;
+		memmove(&pending[i], &pending[i + 1],
+			(num - i) * sizeof(pending[0]));
+	}
+
+	return pipes->num;
+}
+
+/* set up pcm params, prepare and trigger all pipelines */
+int tb_pipeline_start(struct tb_pipelines *pipes, int nch,
 		      struct testbench_prm *tp)
 {
-	struct ipc_comp_dev *pcm_dev;
 	struct pipeline *p;
-	struct comp_dev *cd;
 	int ret;
+	int i;
 
-	/* set up pipeline params */
-	ret = tb_pipeline_params(ipc, nch, ipc_pipe, tp);
-	if (ret < 0) {
-		fprintf(stderr, "error: pipeline params\n");
-		return -EINVAL;
+	/*
+	 * Params go in data flow order so that a pipeline fed by another one
+	 * sees its format, all are set before any component is prepared.
+	 */
+	for (i = 0; i < pipes->num; i++) {
+		ret = tb_pipeline_params(pipes->p[i], nch, tp);
+		if (ret < 0) {
+			fprintf(stderr, "error: pipeline params\n");
+			return -EINVAL;
+		}
 	}
 
-	/* Get IPC component device for pipeline */
-	pcm_dev = ipc_get_comp_by_id(ipc, ipc_pipe->sched_id);
-	if (!pcm_dev) {
-		fprintf(stderr, "error: ipc get comp\n");
-		return -EINVAL;
+	for (i = 0; i < pipes->num; i++) {
+		p = pipes->p[i];
+
+		ret = pipeline_prepare(p, p->source_comp);
+		if (ret < 0) {
+			fprintf(stderr, "error: pipeline prepare\n");
+			return -EINVAL;
+		}
 	}
 
-	/* Point to pipeline */
-	cd = pcm_dev->cd;
-	p = pcm_dev->cd->pipeline;
+	for (i = 0; i < pipes->num; i++) {
+		p = pipes->p[i];
 
-	/* Component prepare */
-	ret = pipeline_prepare(p, cd);
+		/* already started with a pipeline sharing its schedule */
+		if (p->source_comp->state == COMP_STATE_ACTIVE)
+			continue;
 
-	/* Start the pipeline */
-	ret = pipeline_trigger(p, cd, COMP_TRIGGER_START);
-	if (ret < 0)
-		printf("Warning: Failed start pipeline command.\n");
+		ret = pipeline_trigger(p, p->source_comp, COMP_TRIGGER_START);
+		if (ret < 0) {
+			printf("Warning: Failed start pipeline command.\n");
+			return ret;
+		}
+	}
 
-	return ret;
+	return 0;
 }
 
 /* pipeline pcm params */
-int tb_pipeline_params(struct ipc *ipc, int nch,
-		       struct sof_ipc_pipe_new *ipc_pipe,
+int tb_pipeline_params(struct pipeline *p, int nch,
 		       struct testbench_prm *tp)
 {
-	struct ipc_comp_dev *pcm_dev;
-	struct pipeline *p;
-	struct comp_dev *cd;
+	struct comp_dev *cd = p->source_comp;
+	struct comp_dev *upstream = NULL;
+	struct comp_buffer *buffer;
 	struct sof_ipc_pcm_params params;
 	char message[DEBUG_MSG_LEN];
 	int fs_period;
-	int period = ipc_pipe->period;
+	int period = p->ipc_pipe.period;
 	int ret = 0;
 
-	/* Compute period from sample rates */
-	fs_period = (int)(0.9999 + tp->fs_in * period / 1e6);
-	sprintf(message, "period sample count %d\n", fs_period);
-	debug_print(message);
+	/* a pipeline fed by another one continues its stream */
+	if (!list_is_empty(&cd->bsource_list)) {
+		buffer = list_first_item(&cd->bsource_list,
+					 struct comp_buffer, sink_list);
+		if (buffer->source && buffer->source->params.rate)
+			upstream = buffer->source;
+	}
 
 	/* set pcm params */
-	params.comp_id = ipc_pipe->comp_id;
+	memset(&params, 0, sizeof(params));
+	params.comp_id = cd->comp.id;
 	params.params.buffer_fmt = SOF_IPC_BUFFER_INTERLEAVED;
-	params.params.frame_fmt = find_format(tp->bits_in);
+	if (upstream) {
+		/* format of the stream the producer writes to the buffer */
+		params.params.frame_fmt = comp_frame_fmt(upstream);
+		params.params.channels = upstream->params.channels;
+		params.params.rate = upstream->output_rate ?
+			upstream->output_rate : upstream->params.rate;
+	} else {
+		params.params.frame_fmt = find_format(tp->bits_in);
+		params.params.rate = tp->fs_in;
+		params.params.channels = nch;
+	}
+
 	params.params.direction = SOF_IPC_STREAM_PLAYBACK;
-	params.params.rate = tp->fs_in;
-	params.params.channels = nch;
+
+	/* Compute period from sample rates */
+	fs_period = (int)(0.9999 + params.params.rate * period / 1e6);
+	sprintf(message, "pipeline %d period sample count %d\n",
+		p->ipc_pipe.pipeline_id, fs_period);
+	debug_print(message);
+
 	switch (params.params.frame_fmt) {
 	case(SOF_IPC_FRAME_S16_LE):
 		params.params.sample_container_bytes = 2;
 		params.params.sample_valid_bytes = 2;
-		params.params.host_period_bytes = fs_period * nch *
-			params.params.sample_container_bytes;
 		break;
 	case(SOF_IPC_FRAME_S24_4LE):
 		params.params.sample_container_bytes = 4;
 		params.params.sample_valid_bytes = 3;
-		params.params.host_period_bytes = fs_period * nch *
-			params.params.sample_container_bytes;
 		break;
 	case(SOF_IPC_FRAME_S32_LE):
 		params.params.sample_container_bytes = 4;
 		params.params.sample_valid_bytes = 4;
-		params.params.host_period_bytes = fs_period * nch *
-			params.params.sample_container_bytes;
 		break;
 	default:
 		fprintf(stderr, "error: invalid frame format\n");
 		return -EINVAL;
 	}
 
-	/* get scheduling component device for pipeline*/
-	pcm_dev = ipc_get_comp_by_id(ipc, ipc_pipe->sched_id);
-	if (!pcm_dev) {
-		fprintf(stderr, "error: ipc get comp\n");
-		return -EINVAL;
-	}
-
-	/* point to pipeline */
-	cd = pcm_dev->cd;
-	p = pcm_dev->cd->pipeline;
-	if (!p) {
-		fprintf(stderr, "error: pipeline NULL\n");
-		return -EINVAL;
-	}
+	params.params.host_period_bytes = fs_period *
+		params.params.channels * params.params.sample_container_bytes;
 
 	/* pipeline params */
 	ret = pipeline_params(p, cd, &params);
@@ -158,6 +264,47 @@ int tb_pipeline_params(struct ipc *ipc, int nch,
 	return ret;
 }
 
+/*
+ * Run one period of the shortest pipeline period. Pipelines are copied in
+ * data flow order, each one as often as its own period allows, and only
+ * by the pipeline owning their scheduling component.
+ */
+void tb_pipeline_copy(struct tb_pipelines *pipes)
+{
+	struct pipeline *p;
+	uint32_t ratio;
+	int i;
+
+	for (i = 0; i < pipes->num; i++) {
+		p = pipes->p[i];
+		if (p->sched_comp->pipeline != p)
+			continue;
+
+		ratio = p->ipc_pipe.period / pipes->period;
+		if (pipes->ticks % ratio == 0)
+			pipeline_schedule_copy(p, 0);
+	}
+
+	pipes->ticks++;
+}
+
+/* reset all pipelines */
+int tb_pipeline_reset(struct tb_pipelines *pipes)
+{
+	struct pipeline *p;
+	int ret;
+	int i;
+
+	for (i = 0; i < pipes->num; i++) {
+		p = pipes->p[i];
+		ret = pipeline_reset(p, p->source_comp);
+		if (ret < 0)
+			return ret;
+	}
+
+	return 0;
+}
+
 /* getindex of shared library from table */
 int get_index_by_name(char *comp_type,
 		      struct shared_lib_table *lib_table)
@@ -172,14 +319,14 @@ int get_index_by_name(char *comp_type,
 	return -EINVAL;
 }
 
-/* getindex of shared library from table by widget type*/
+/* getindex of shared library from table by comp type */
 int get_index_by_type(uint32_t comp_type,
 		      struct shared_lib_table *lib_table)
 {
 	int i;
 
 	for (i = 0; i < NUM_WIDGETS_SUPPORTED; i++) {
-		if (comp_type == lib_table[i].widget_type)
+		if (comp_type == lib_table[i].comp_type)
 			return i;
 	}
 
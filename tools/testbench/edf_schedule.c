@@ -62,6 +62,10 @@ int scheduler_init_edf(void)
 
 	scheduler_init(SOF_SCHEDULE_EDF, &schedule_edf_ops, sch);
 
+	/* pipelines are LL tasks, run them synchronously as well */
+	scheduler_init(SOF_SCHEDULE_LL_TIMER, &schedule_edf_ops, sch);
+	scheduler_init(SOF_SCHEDULE_LL_DMA, &schedule_edf_ops, sch);
+
 	return 0;
 }
 
@@ -9,6 +9,7 @@
 #include <stddef.h>
 #include <errno.h>
 #include <inttypes.h>
+#include <math.h>
 #include <sof/sof.h>
 #include <sof/list.h>
 #include <sof/audio/stream.h>
@@ -35,9 +36,165 @@ static inline void buffer_check_wrap_16(int16_t **ptr, int16_t *end,
 		*ptr = (int16_t *)((size_t)*ptr - size);
 }
 
+/* RIFF chunk header */
+struct wav_chunk {
+	char id[4];
+	uint32_t size;
+};
+
+/* WAVE fmt chunk body */
+struct wav_fmt {
+	uint16_t format;
+	uint16_t channels;
+	uint32_t rate;
+	uint32_t byte_rate;
+	uint16_t block_align;
+	uint16_t bits;
+};
+
+/* canonical WAV header written before output samples */
+struct wav_header {
+	struct wav_chunk riff;
+	char wave[4];
+	struct wav_chunk fmt_chunk;
+	struct wav_fmt fmt;
+	struct wav_chunk data;
+};
+
+#define WAV_FORMAT_PCM		0x0001
+#define WAV_FORMAT_EXTENSIBLE	0xfffe
+
+/*
+ * Expand n S24_4LE samples in place, masking the top byte like text input.
+ * Packed 3 byte samples are read behind the destination so dst never
+ * overtakes src.
+ */
+static void file_s24_unpack(int32_t *dst, const uint8_t *src, int n,
+			    int file_bytes)
+{
+	int i;
+
+	if (file_bytes == 3) {
+		for (i = 0; i < n; i++, src += 3)
+			dst[i] = src[0] | src[1] << 8 | src[2] << 16;
+	} else {
+		for (i = 0; i < n; i++)
+			dst[i] &= 0x00ffffff;
+	}
+}
+
+/* sign extend n S24_4LE samples into 4 or packed 3 byte file samples */
+static void file_s24_pack(uint8_t *dst, const int32_t *src, int n,
+			  int file_bytes)
+{
+	int32_t *dst32 = (int32_t *)dst;
+	int i;
+
+	if (file_bytes == 3) {
+		for (i = 0; i < n; i++, dst += 3) {
+			dst[0] = src[i];
+			dst[1] = src[i] >> 8;
+			dst[2] = src[i] >> 16;
+		}
+	} else {
+		for (i = 0; i < n; i++)
+			dst32[i] = (src[i] << 8) >> 8;
+	}
+}
+
+/*
+ * Read binary samples a contiguous buffer span at a time. Only whole
+ * frames are produced, a trailing partial frame in the file is dropped.
+ */
+static int read_samples_block(struct comp_dev *dev, struct comp_buffer *sink,
+			      int n, int fmt, int nch)
+{
+	struct file_comp_data *cd = comp_get_drvdata(dev);
+	int bytes = dev->params.sample_container_bytes;
+	int file_bytes = cd->fs.sample_bytes;
+	uint8_t *dest = sink->w_ptr;
+	int n_samples = 0;
+	int offset;
+	int count;
+	int ret;
+
+	/* don't read past the WAV data chunk */
+	if (cd->fs.f_format == FILE_WAV)
+		n = MIN(n, cd->fs.data_bytes / file_bytes);
+	n -= n % nch;
+
+	while (n > 0) {
+		count = MIN(n, buffer_bytes_without_wrap(sink, dest) / bytes);
+
+		/* narrower file samples go to the end of the span */
+		offset = count * (bytes - file_bytes);
+		ret = fread(dest + offset, file_bytes, count, cd->fs.rfh);
+		if (fmt == SOF_IPC_FRAME_S24_4LE)
+			file_s24_unpack((int32_t *)dest, dest + offset, ret,
+					file_bytes);
+
+		n_samples += ret;
+		if (ret != count)
+			break;
+
+		n -= count;
+		dest = buffer_wrap(sink, dest + count * bytes);
+	}
+
+	if (cd->fs.f_format == FILE_WAV)
+		cd->fs.data_bytes -= n_samples * file_bytes;
+
+	if (n || (cd->fs.f_format == FILE_WAV &&
+		  cd->fs.data_bytes < nch * file_bytes))
+		cd->fs.reached_eof = 1;
+
+	return n_samples - n_samples % nch;
+}
+
+/*
+ * Write binary samples a contiguous buffer span at a time, S24_4LE
+ * samples are converted through the bounce buffer.
+ */
+static int write_samples_block(struct comp_dev *dev,
+			       struct comp_buffer *source, int n, int fmt)
+{
+	struct file_comp_data *cd = comp_get_drvdata(dev);
+	int bytes = dev->params.sample_container_bytes;
+	int file_bytes = cd->fs.sample_bytes;
+	uint8_t *src = source->r_ptr;
+	int n_samples = 0;
+	int count;
+	int ret;
+
+	while (n > 0) {
+		count = MIN(n, buffer_bytes_without_wrap(source, src) / bytes);
+
+		if (fmt == SOF_IPC_FRAME_S24_4LE) {
+			count = MIN(count, FILE_IO_BYTES / sizeof(int32_t));
+			file_s24_pack(cd->io_buf, (int32_t *)src, count,
+				      file_bytes);
+			ret = fwrite(cd->io_buf, file_bytes, count,
+				     cd->fs.wfh);
+		} else {
+			ret = fwrite(src, file_bytes, count, cd->fs.wfh);
+		}
+
+		n_samples += ret;
+		if (ret != count)
+			break;
+
+		n -= count;
+		src = buffer_wrap(source, src + count * bytes);
+	}
+
+	cd->fs.data_bytes += n_samples * file_bytes;
+
+	return n_samples;
+}
+
 /*
  * Read 32-bit samples from file
- * currently only supports txt files
+ * slow per sample path for txt files
  */
 static int read_samples_32(struct comp_dev *dev, struct comp_buffer *sink,
 			   int n, int fmt, int nch)
@@ -48,6 +205,9 @@ static int read_samples_32(struct comp_dev *dev, struct comp_buffer *sink,
 	int n_samples = 0;
 	int i, n_wrap, n_min, ret;
 
+	if (cd->fs.f_format != FILE_TEXT)
+		return read_samples_block(dev, sink, n, fmt, nch);
+
 	while (n > 0) {
 		n_wrap = (int32_t *)sink->end_addr - dest;
 
@@ -60,46 +220,18 @@ static int read_samples_32(struct comp_dev *dev, struct comp_buffer *sink,
 			/* copy sample per channel */
 			for (i = 0; i < nch; i++) {
 				/* read sample from file */
-				switch (cd->fs.f_format) {
-				/* text input file */
-				case FILE_TEXT:
-					if (fmt == SOF_IPC_FRAME_S32_LE)
-						ret = fscanf(cd->fs.rfh, "%d",
-							     dest);
-
-					/* mask bits if 24-bit samples */
-					if (fmt == SOF_IPC_FRAME_S24_4LE) {
-						ret = fscanf(cd->fs.rfh, "%d",
-							     &sample);
-						*dest = sample & 0x00ffffff;
-					}
-					/* quit if eof is reached */
-					if (ret == EOF) {
-						cd->fs.reached_eof = 1;
-						goto quit;
-					}
-					break;
-
-				/* raw input file */
-				default:
-					if (fmt == SOF_IPC_FRAME_S32_LE)
-						ret = fread(dest,
-							    sizeof(int32_t),
-							    1, cd->fs.rfh);
-
-					/* mask bits if 24-bit samples */
-					if (fmt == SOF_IPC_FRAME_S24_4LE) {
-						ret = fread(&sample,
-							    sizeof(int32_t),
-							    1, cd->fs.rfh);
-						*dest = sample & 0x00ffffff;
-					}
-					/* quit if eof is reached */
-					if (ret != 1) {
-						cd->fs.reached_eof = 1;
-						goto quit;
-					}
-					break;
+				if (fmt == SOF_IPC_FRAME_S32_LE)
+					ret = fscanf(cd->fs.rfh, "%d", dest);
+
+				/* mask bits if 24-bit samples */
+				if (fmt == SOF_IPC_FRAME_S24_4LE) {
+					ret = fscanf(cd->fs.rfh, "%d", &sample);
+					*dest = sample & 0x00ffffff;
+				}
+				/* quit if eof is reached */
+				if (ret == EOF) {
+					cd->fs.reached_eof = 1;
+					goto quit;
 				}
 				dest++;
 				n_samples++;
@@ -115,7 +247,7 @@ quit:
 
 /*
  * Read 16-bit samples from file
- * currently only supports txt files
+ * slow per sample path for txt files
  */
 static int read_samples_16(struct comp_dev *dev, struct comp_buffer *sink,
 			   int n, int nch)
@@ -125,6 +257,10 @@ static int read_samples_16(struct comp_dev *dev, struct comp_buffer *sink,
 	int i, n_wrap, n_min, ret;
 	int n_samples = 0;
 
+	if (cd->fs.f_format != FILE_TEXT)
+		return read_samples_block(dev, sink, n, SOF_IPC_FRAME_S16_LE,
+					  nch);
+
 	/* copy samples */
 	while (n > 0) {
 		n_wrap = (int16_t *)sink->end_addr - dest;
@@ -137,25 +273,10 @@ static int read_samples_16(struct comp_dev *dev, struct comp_buffer *sink,
 
 			/* copy sample per channel */
 			for (i = 0; i < nch; i++) {
-				switch (cd->fs.f_format) {
-				/* text input file */
-				case FILE_TEXT:
-					ret = fscanf(cd->fs.rfh, "%hd", dest);
-					if (ret == EOF) {
-						cd->fs.reached_eof = 1;
-						goto quit;
-					}
-					break;
-
-				/* rw pcm input file */
-				default:
-					ret = fread(dest, sizeof(int16_t), 1,
-						    cd->fs.rfh);
-					if (ret != 1) {
-						cd->fs.reached_eof = 1;
-						goto quit;
-					}
-					break;
+				ret = fscanf(cd->fs.rfh, "%hd", dest);
+				if (ret == EOF) {
+					cd->fs.reached_eof = 1;
+					goto quit;
 				}
 
 				dest++;
@@ -173,7 +294,7 @@ quit:
 
 /*
  * Write 16-bit samples from file
- * currently only supports txt files
+ * slow per sample path for txt files
  */
 static int write_samples_16(struct comp_dev *dev, struct comp_buffer *source,
 			    int n, int nch)
@@ -183,6 +304,10 @@ static int write_samples_16(struct comp_dev *dev, struct comp_buffer *source,
 	int i, n_wrap, n_min, ret;
 	int n_samples = 0;
 
+	if (cd->fs.f_format != FILE_TEXT)
+		return write_samples_block(dev, source, n,
+					   SOF_IPC_FRAME_S16_LE);
+
 	/* copy samples */
 	while (n > 0) {
 		n_wrap = (int16_t *)source->end_addr - src;
@@ -195,24 +320,9 @@ static int write_samples_16(struct comp_dev *dev, struct comp_buffer *source,
 
 			/* copy sample per channel */
 			for (i = 0; i < nch; i++) {
-				switch (cd->fs.f_format) {
-				/* text output file */
-				case FILE_TEXT:
-					ret = fprintf(cd->fs.wfh,
-						      "%d\n", *src);
-					if (ret < 0)
-						goto quit;
-					break;
-
-				/* raw pcm output file */
-				default:
-					ret = fwrite(src,
-						     sizeof(int16_t),
-						     1, cd->fs.wfh);
-					if (ret != 1)
-						goto quit;
-					break;
-				}
+				ret = fprintf(cd->fs.wfh, "%d\n", *src);
+				if (ret < 0)
+					goto quit;
 
 				src++;
 				n_samples++;
@@ -228,7 +338,7 @@ quit:
 
 /*
  * Write 32-bit samples from file
- * currently only supports txt files
+ * slow per sample path for txt files
  */
 static int write_samples_32(struct comp_dev *dev, struct comp_buffer *source,
 			    int n, int fmt, int nch)
@@ -239,6 +349,9 @@ static int write_samples_32(struct comp_dev *dev, struct comp_buffer *source,
 	int n_samples = 0;
 	int32_t sample;
 
+	if (cd->fs.f_format != FILE_TEXT)
+		return write_samples_block(dev, source, n, fmt);
+
 	/* copy samples */
 	while (n > 0) {
 		n_wrap = (int32_t *)source->end_addr - src;
@@ -251,39 +364,16 @@ static int write_samples_32(struct comp_dev *dev, struct comp_buffer *source,
 
 			/* copy sample per channel */
 			for (i = 0; i < nch; i++) {
-				switch (cd->fs.f_format) {
-				/* text output file */
-				case FILE_TEXT:
-					if (fmt == SOF_IPC_FRAME_S32_LE)
-						ret = fprintf(cd->fs.wfh,
-							      "%d\n", *src);
-					if (fmt == SOF_IPC_FRAME_S24_4LE) {
-						sample = *src << 8;
-						ret = fprintf(cd->fs.wfh,
-							      "%d\n",
-							      sample >> 8);
-					}
-					if (ret < 0)
-						goto quit;
-					break;
-
-				/* raw pcm output file */
-				default:
-					if (fmt == SOF_IPC_FRAME_S32_LE)
-						ret = fwrite(src,
-							     sizeof(int32_t),
-							     1, cd->fs.wfh);
-					if (fmt == SOF_IPC_FRAME_S24_4LE) {
-						sample = *src << 8;
-						sample >>= 8;
-						ret = fwrite(&sample,
-							     sizeof(int32_t),
-							     1, cd->fs.wfh);
-					}
-					if (ret != 1)
-						goto quit;
-					break;
+				if (fmt == SOF_IPC_FRAME_S32_LE)
+					ret = fprintf(cd->fs.wfh, "%d\n",
+						      *src);
+				if (fmt == SOF_IPC_FRAME_S24_4LE) {
+					sample = *src << 8;
+					ret = fprintf(cd->fs.wfh, "%d\n",
+						      sample >> 8);
 				}
+				if (ret < 0)
+					goto quit;
 
 				/* increment read pointer */
 				src++;
@@ -382,16 +472,228 @@ static int file_s24(struct comp_dev *dev, struct comp_buffer *sink,
 	return n_samples;
 }
 
+/*
+ * Synthetic input plays a loop of a sine wave at half full scale, output
+ * is discarded. Used for benchmarking without file I/O.
+ */
+static int file_synth(struct comp_dev *dev, struct comp_buffer *sink,
+		      struct comp_buffer *source, uint32_t frames)
+{
+	struct file_comp_data *cd = comp_get_drvdata(dev);
+	int n_samples = frames * dev->params.channels;
+	uint32_t bytes = n_samples * dev->params.sample_container_bytes;
+	void *dst;
+	uint32_t n;
+	int ret;
+
+	if (cd->fs.mode == FILE_READ) {
+		dst = sink->w_ptr;
+		while (bytes) {
+			n = MIN(bytes, buffer_bytes_without_wrap(sink, dst));
+			n = MIN(n, cd->synth_bytes - cd->synth_pos);
+			ret = memcpy_s(dst, n, (char *)cd->synth +
+				       cd->synth_pos, n);
+			if (ret) {
+				fprintf(stderr, "error: file_synth() copy\n");
+				return ret;
+			}
+			dst = buffer_wrap(sink, (char *)dst + n);
+			cd->synth_pos += n;
+			if (cd->synth_pos == cd->synth_bytes)
+				cd->synth_pos = 0;
+			bytes -= n;
+		}
+	}
+
+	cd->fs.n += n_samples;
+	return n_samples;
+}
+
+static int file_synth_init(struct comp_dev *dev)
+{
+	struct file_comp_data *cd = comp_get_drvdata(dev);
+	int nch = dev->params.channels;
+	int16_t *s16;
+	int32_t *s32;
+	double x;
+	int i;
+	int j;
+
+	cd->synth_bytes = FILE_SYNTH_FRAMES * nch *
+		dev->params.sample_container_bytes;
+	cd->synth_pos = 0;
+	cd->synth = rzalloc(RZONE_RUNTIME, SOF_MEM_CAPS_RAM, cd->synth_bytes);
+	if (!cd->synth)
+		return -ENOMEM;
+
+	s16 = cd->synth;
+	s32 = cd->synth;
+	for (i = 0; i < FILE_SYNTH_FRAMES; i++) {
+		x = 0.5 * sin(2 * M_PI * FILE_SYNTH_CYCLES * i /
+			      FILE_SYNTH_FRAMES);
+		for (j = 0; j < nch; j++) {
+			switch (dev->params.frame_fmt) {
+			case SOF_IPC_FRAME_S16_LE:
+				*s16++ = (int16_t)(x * INT16_MAX);
+				break;
+			case SOF_IPC_FRAME_S24_4LE:
+				*s32++ = (int32_t)(x * 0x7fffff);
+				break;
+			default:
+				*s32++ = (int32_t)(x * INT32_MAX);
+				break;
+			}
+		}
+	}
+
+	return 0;
+}
+
 static enum file_format get_file_format(char *filename)
 {
 	char *ext = strrchr(filename, '.');
 
+	if (!ext)
+		return FILE_RAW;
+
 	if (!strcmp(ext, ".txt"))
 		return FILE_TEXT;
 
+	if (!strcmp(ext, ".wav"))
+		return FILE_WAV;
+
 	return FILE_RAW;
 }
 
+/* parse WAV header, leaves the file at the start of sample data */
+static int file_wav_read_header(struct file_state *fs)
+{
+	struct wav_chunk chunk;
+	struct wav_fmt fmt;
+	char wave[4];
+	int have_fmt = 0;
+
+	if (fread(&chunk, sizeof(chunk), 1, fs->rfh) != 1 ||
+	    fread(wave, sizeof(wave), 1, fs->rfh) != 1 ||
+	    memcmp(chunk.id, "RIFF", 4) || memcmp(wave, "WAVE", 4))
+		goto err;
+
+	while (fread(&chunk, sizeof(chunk), 1, fs->rfh) == 1) {
+		if (!memcmp(chunk.id, "data", 4)) {
+			if (!have_fmt)
+				goto err;
+			fs->data_bytes = chunk.size;
+			return 0;
+		}
+
+		if (!memcmp(chunk.id, "fmt ", 4)) {
+			if (chunk.size < sizeof(fmt) ||
+			    fread(&fmt, sizeof(fmt), 1, fs->rfh) != 1)
+				goto err;
+			if (fmt.format != WAV_FORMAT_PCM &&
+			    fmt.format != WAV_FORMAT_EXTENSIBLE)
+				goto err;
+			fs->wav_channels = fmt.channels;
+			fs->wav_rate = fmt.rate;
+			fs->sample_bytes = fmt.bits / 8;
+			chunk.size -= sizeof(fmt);
+			have_fmt = 1;
+		}
+
+		/* skip rest of the chunk, chunks are word aligned */
+		if (fseek(fs->rfh, chunk.size + (chunk.size & 1), SEEK_CUR))
+			goto err;
+	}
+
+err:
+	fprintf(stderr, "error: %s is not a PCM WAV file\n", fs->fn);
+	return -EINVAL;
+}
+
+/* (re)write the WAV header with the current data size */
+static int file_wav_write_header(struct comp_dev *dev)
+{
+	struct file_comp_data *cd = comp_get_drvdata(dev);
+	uint32_t frame_bytes = dev->params.channels * cd->fs.sample_bytes;
+	uint32_t rate = cd->rate ? cd->rate : dev->params.rate;
+	struct wav_header hdr = {
+		.riff = { .id = "RIFF",
+			  .size = sizeof(hdr) - sizeof(hdr.riff) +
+				  cd->fs.data_bytes },
+		.wave = "WAVE",
+		.fmt_chunk = { .id = "fmt ", .size = sizeof(hdr.fmt) },
+		.fmt = {
+			.format = WAV_FORMAT_PCM,
+			.channels = dev->params.channels,
+			.rate = rate,
+			.byte_rate = rate * frame_bytes,
+			.block_align = frame_bytes,
+			.bits = cd->fs.sample_bytes * 8,
+		},
+		.data = { .id = "data", .size = cd->fs.data_bytes },
+	};
+	long pos = ftell(cd->fs.wfh);
+
+	if (fseek(cd->fs.wfh, 0, SEEK_SET) ||
+	    fwrite(&hdr, sizeof(hdr), 1, cd->fs.wfh) != 1) {
+		fprintf(stderr, "error: writing WAV header %s\n", cd->fs.fn);
+		return -EIO;
+	}
+
+	/* continue after the samples written so far */
+	if (pos > (long)sizeof(hdr))
+		fseek(cd->fs.wfh, pos, SEEK_SET);
+
+	return 0;
+}
+
+/* set up binary sample size and WAV header for the stream format */
+static int file_binary_prepare(struct comp_dev *dev, uint32_t frame_fmt)
+{
+	struct file_comp_data *cd = comp_get_drvdata(dev);
+	uint32_t bytes = dev->params.sample_container_bytes;
+	int ret;
+
+	if (cd->fs.f_format == FILE_RAW) {
+		cd->fs.sample_bytes = bytes;
+	} else if (cd->fs.mode == FILE_READ) {
+		/* S24_4LE is read from packed 24-bit WAV samples */
+		if (frame_fmt == SOF_IPC_FRAME_S24_4LE)
+			bytes = 3;
+		if (cd->fs.sample_bytes != bytes ||
+		    cd->fs.wav_channels != dev->params.channels) {
+			fprintf(stderr,
+				"error: %s has %u x %u bit, not %u x %u\n",
+				cd->fs.fn, cd->fs.wav_channels,
+				cd->fs.sample_bytes * 8, dev->params.channels,
+				bytes * 8);
+			return -EINVAL;
+		}
+		if (cd->rate && cd->fs.wav_rate != cd->rate)
+			fprintf(stderr, "warning: %s rate %u, input rate %u\n",
+				cd->fs.fn, cd->fs.wav_rate, cd->rate);
+	} else {
+		/* S24_4LE is written as packed 24-bit WAV samples */
+		if (frame_fmt == SOF_IPC_FRAME_S24_4LE)
+			bytes = 3;
+		cd->fs.sample_bytes = bytes;
+		cd->fs.data_bytes = 0;
+		ret = file_wav_write_header(dev);
+		if (ret < 0)
+			return ret;
+	}
+
+	if (cd->fs.mode == FILE_WRITE &&
+	    frame_fmt == SOF_IPC_FRAME_S24_4LE && !cd->io_buf) {
+		cd->io_buf = rzalloc(RZONE_RUNTIME, SOF_MEM_CAPS_RAM,
+				     FILE_IO_BYTES);
+		if (!cd->io_buf)
+			return -ENOMEM;
+	}
+
+	return 0;
+}
+
 static struct comp_dev *file_new(struct sof_ipc_comp *comp)
 {
 	struct comp_dev *dev;
@@ -411,8 +713,12 @@ static struct comp_dev *file_new(struct sof_ipc_comp *comp)
 		return NULL;
 
 	file = (struct sof_ipc_comp_file *)&dev->comp;
-	assert(!memcpy_s(file, sizeof(*file), ipc_file,
-		       sizeof(struct sof_ipc_comp_file)));
+	if (memcpy_s(file, sizeof(*file), ipc_file,
+		     sizeof(struct sof_ipc_comp_file))) {
+		fprintf(stderr, "error: file_new() IPC copy\n");
+		free(dev);
+		return NULL;
+	}
 
 	/* allocate  memory for file comp data */
 	cd = rzalloc(RZONE_RUNTIME, SOF_MEM_CAPS_RAM, sizeof(*cd));
@@ -426,15 +732,21 @@ static struct comp_dev *file_new(struct sof_ipc_comp *comp)
 	/* default function for processing samples */
 	cd->file_func = file_s32_default;
 
+	/* set file comp mode */
+	cd->fs.mode = ipc_file->mode;
+
+	/* no file name gives synthetic input or discarded output */
+	if (!ipc_file->fn) {
+		cd->fs.f_format = FILE_SYNTH;
+		goto out;
+	}
+
 	/* get filename from IPC and open file */
 	cd->fs.fn = strdup(ipc_file->fn);
 
 	/* set file format */
 	cd->fs.f_format = get_file_format(cd->fs.fn);
 
-	/* set file comp mode */
-	cd->fs.mode = ipc_file->mode;
-
 	/* open file handle(s) depending on mode */
 	switch (cd->fs.mode) {
 	case FILE_READ:
@@ -445,6 +757,14 @@ static struct comp_dev *file_new(struct sof_ipc_comp *comp)
 			free(dev);
 			return NULL;
 		}
+		if (cd->fs.f_format == FILE_WAV &&
+		    file_wav_read_header(&cd->fs) < 0) {
+			fclose(cd->fs.rfh);
+			free(cd->fs.fn);
+			free(cd);
+			free(dev);
+			return NULL;
+		}
 		break;
 	case FILE_WRITE:
 		cd->fs.wfh = fopen(cd->fs.fn, "w");
@@ -460,6 +780,7 @@ static struct comp_dev *file_new(struct sof_ipc_comp *comp)
 		break;
 	}
 
+out:
 	cd->fs.reached_eof = 0;
 	cd->fs.n = 0;
 
@@ -472,11 +793,17 @@ static void file_free(struct comp_dev *dev)
 {
 	struct file_comp_data *cd = comp_get_drvdata(dev);
 
-	if (cd->fs.mode == FILE_READ)
+	if (cd->fs.rfh)
 		fclose(cd->fs.rfh);
-	else
+	if (cd->fs.wfh) {
+		/* patch sizes now that all samples are written */
+		if (cd->fs.f_format == FILE_WAV)
+			file_wav_write_header(dev);
 		fclose(cd->fs.wfh);
+	}
 
+	rfree(cd->synth);
+	rfree(cd->io_buf);
 	free(cd->fs.fn);
 	free(cd);
 	free(dev);
@@ -540,6 +867,31 @@ static int file_cmd(struct comp_dev *dev, int cmd, void *data,
 	return ret;
 }
 
+/* Returns the frames of paced input for this period. The pace can differ
+ * from the nominal rate to simulate a drifting producer clock.
+ */
+static int file_pace(struct comp_dev *dev, struct comp_buffer *buffer,
+		     int free_frames)
+{
+	struct file_comp_data *cd = comp_get_drvdata(dev);
+	int level = buffer->avail / comp_frame_bytes(buffer->sink);
+	double frames = cd->pace + cd->pace_frac;
+	int n = (int)frames;
+
+	cd->pace_frac = frames - n;
+	if (++cd->pace_periods > FILE_PACE_SETTLE) {
+		cd->level_min = MIN(cd->level_min, level);
+		cd->level_max = MAX(cd->level_max, level);
+	}
+
+	if (n > free_frames) {
+		cd->pace_overruns++;
+		n = free_frames;
+	}
+
+	return n;
+}
+
 /*
  * copy and process stream samples
  * returns the number of bytes copied
@@ -560,6 +912,8 @@ static int file_copy(struct comp_dev *dev)
 
 		/* test sink has enough free frames */
 		snk_frames = buffer->free / comp_frame_bytes(buffer->sink);
+		if (cd->pace > 0)
+			snk_frames = file_pace(dev, buffer, snk_frames);
 		if (snk_frames > 0 && !cd->fs.reached_eof) {
 			/* read PCM samples from file */
 			ret = cd->file_func(dev, buffer, NULL, snk_frames);
@@ -665,6 +1019,19 @@ static int file_prepare(struct comp_dev *dev)
 		return -EINVAL;
 	}
 
+	if (cd->fs.f_format == FILE_SYNTH) {
+		if (cd->fs.mode == FILE_READ && !cd->synth) {
+			ret = file_synth_init(dev);
+			if (ret < 0)
+				return ret;
+		}
+		cd->file_func = file_synth;
+	} else if (cd->fs.f_format != FILE_TEXT) {
+		ret = file_binary_prepare(dev, config->frame_fmt);
+		if (ret < 0)
+			return ret;
+	}
+
 	dev->state = COMP_STATE_PREPARE;
 
 	return ret;
@@ -0,0 +1,39 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2019 Intel Corporation. All rights reserved.
+ */
+
+#ifndef _BENCHMARK_H
+#define _BENCHMARK_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <sof/audio/pipeline.h>
+#include <sof/drivers/ipc.h>
+#include "testbench/common_test.h"
+
+/* max components and component drivers timed in benchmark mode */
+#define TB_BENCH_MAX_COMPS	64
+#define TB_BENCH_MAX_DRIVERS	16
+
+/* copy timing of one component */
+struct tb_comp_perf {
+	struct comp_dev *dev;
+	uint64_t copies;
+	uint64_t ns_total;
+	uint64_t ns_peak;
+};
+
+int tb_bench_init(struct ipc *ipc, uint32_t periods);
+
+void tb_bench_run(struct tb_pipelines *pipes, uint32_t periods);
+
+void tb_bench_report(FILE *out, struct testbench_prm *tp,
+		     uint32_t period_us);
+
+int tb_bench_json(const char *file, struct testbench_prm *tp,
+		  uint32_t period_us);
+
+void tb_bench_free(void);
+
+#endif
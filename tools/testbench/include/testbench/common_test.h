@@ -13,17 +13,28 @@
 #include <sof/sof.h>
 #include <sof/audio/component.h>
 #include <sof/audio/format.h>
+#include <sof/audio/pipeline.h>
 
 #define DEBUG_MSG_LEN		256
 #define MAX_LIB_NAME_LEN	256
 
 /* number of widgets types supported in testbench */
-#define NUM_WIDGETS_SUPPORTED	3
+#define NUM_WIDGETS_SUPPORTED	12
+
+/* max pipelines run together and files per direction */
+#define TB_MAX_PIPELINES	16
+#define TB_MAX_FILES		8
 
 struct testbench_prm {
 	char *tplg_file; /* topology file to use */
-	char *input_file; /* input file name */
-	char *output_file; /* output file name */
+	/*
+	 * input and output file names, given to the filereads and
+	 * filewrites in topology order
+	 */
+	char *input_file[TB_MAX_FILES];
+	char *output_file[TB_MAX_FILES];
+	int input_file_num;
+	int output_file_num;
 	char *bits_in; /* input bit format */
 	/*
 	 * input and output sample rate parameters
@@ -33,16 +44,37 @@ struct testbench_prm {
 	 */
 	uint32_t fs_in;
 	uint32_t fs_out;
+	/*
+	 * benchmark mode runs bench_time seconds of synthetic audio and
+	 * reports component MCPS estimated at cpu_mhz
+	 */
+	double bench_time;
+	double cpu_mhz;
+	char *json_file; /* benchmark results file */
+	/*
+	 * asynchronous SRC test paces the input at fs_in with a simulated
+	 * producer clock drift of drift_ppm
+	 */
+	int asrc;
+	double drift_ppm;
 };
 
 struct shared_lib_table {
 	char *comp_name;
 	char library_name[MAX_LIB_NAME_LEN];
-	uint32_t widget_type;
+	uint32_t comp_type;
 	int register_drv;
 	void *handle;
 };
 
+/* topology pipelines scheduled together, producers first */
+struct tb_pipelines {
+	struct pipeline *p[TB_MAX_PIPELINES];
+	int num;
+	uint32_t period; /* shortest pipeline period in us */
+	uint32_t ticks; /* periods run so far */
+};
+
 extern int debug;
 
 int edf_scheduler_init(void);
@@ -53,14 +85,18 @@ void sys_comp_filewrite_init(void);
 
 int tb_pipeline_setup(struct sof *sof);
 
-int tb_pipeline_start(struct ipc *ipc, int nch,
-		      struct sof_ipc_pipe_new *ipc_pipe,
+int tb_pipelines_find(struct ipc *ipc, struct tb_pipelines *pipes);
+
+int tb_pipeline_start(struct tb_pipelines *pipes, int nch,
 		      struct testbench_prm *tp);
 
-int tb_pipeline_params(struct ipc *ipc, int nch,
-		       struct sof_ipc_pipe_new *ipc_pipe,
+int tb_pipeline_params(struct pipeline *p, int nch,
 		       struct testbench_prm *tp);
 
+void tb_pipeline_copy(struct tb_pipelines *pipes);
+
+int tb_pipeline_reset(struct tb_pipelines *pipes);
+
 void debug_print(char *message);
 
 int get_index_by_name(char *comp_name,
@@ -69,7 +105,8 @@ int get_index_by_name(char *comp_name,
 int get_index_by_type(uint32_t comp_type,
 		      struct shared_lib_table *lib_table);
 
+void register_comp(int comp_type);
+
 int parse_topology(struct sof *sof, struct shared_lib_table *library_table,
-		   struct testbench_prm *tp, int *fr_id, int *fw_id,
-		   int *sched_id, char *pipeline_msg);
+		   struct testbench_prm *tp, char *pipeline_msg);
 #endif
@@ -11,6 +11,16 @@
 #ifndef _FILE_H
 #define _FILE_H
 
+/* synthetic input loop length and sine cycles in it */
+#define FILE_SYNTH_FRAMES	1024
+#define FILE_SYNTH_CYCLES	23
+
+/* bounce buffer for binary output samples that need conversion */
+#define FILE_IO_BYTES		16384
+
+/* paced input periods before the sink fill level range is recorded */
+#define FILE_PACE_SETTLE	2000
+
 /* file component modes */
 enum file_mode {
 	FILE_READ = 0,
@@ -21,6 +31,8 @@ enum file_mode {
 enum file_format {
 	FILE_TEXT = 0,
 	FILE_RAW,
+	FILE_WAV,
+	FILE_SYNTH,	/* no file, generated input or discarded output */
 };
 
 /* file component state */
@@ -31,6 +43,10 @@ struct file_state {
 	int n;
 	enum file_mode mode;
 	enum file_format f_format;
+	uint32_t sample_bytes;	/* sample size in a binary file */
+	uint32_t data_bytes;	/* WAV data left to read or written */
+	uint32_t wav_channels;
+	uint32_t wav_rate;
 };
 
 /* file comp data */
@@ -40,6 +56,16 @@ struct file_comp_data {
 	uint32_t frame_bytes;
 	uint32_t rate;
 	struct file_state fs;
+	void *synth; /* one loop of generated input samples */
+	uint32_t synth_bytes;
+	uint32_t synth_pos;
+	void *io_buf; /* FILE_IO_BYTES of converted output samples */
+	double pace; /* frames per period of paced input, 0 reads at will */
+	double pace_frac; /* fractional frames carried to next period */
+	uint32_t pace_periods;
+	uint32_t pace_overruns; /* periods the sink had no room for input */
+	int level_min; /* sink fill level range in frames after settling */
+	int level_max;
 	int (*file_func)(struct comp_dev *dev, struct comp_buffer *sink,
 			 struct comp_buffer *source, uint32_t frames);
 
@@ -13,28 +13,34 @@
 #include <tplg_parser/topology.h>
 #include "testbench/trace.h"
 #include "testbench/file.h"
+#include "testbench/benchmark.h"
 
 #define TESTBENCH_NCH 2 /* Stereo */
 
 /* shared library look up table */
 struct shared_lib_table lib_table[NUM_WIDGETS_SUPPORTED] = {
-	{"file", "", SND_SOC_TPLG_DAPM_AIF_IN, 0, NULL},
-	{"vol", "libsof_volume.so", SND_SOC_TPLG_DAPM_PGA, 0, NULL},
-	{"src", "libsof_src.so", SND_SOC_TPLG_DAPM_SRC, 0, NULL},
+	{"file", "", SOF_COMP_FILEREAD, 0, NULL},
+	{"vol", "libsof_volume.so", SOF_COMP_VOLUME, 0, NULL},
+	{"src", "libsof_src.so", SOF_COMP_SRC, 0, NULL},
+	{"mixer", "libsof_mixer.so", SOF_COMP_MIXER, 0, NULL},
+	{"mux", "libsof_mux.so", SOF_COMP_MUX, 0, NULL},
+	{"demux", "libsof_mux.so", SOF_COMP_DEMUX, 0, NULL},
+	{"sel", "libsof_selector.so", SOF_COMP_SELECTOR, 0, NULL},
+	{"eqfir", "libsof_eq_fir.so", SOF_COMP_EQ_FIR, 0, NULL},
+	{"eqiir", "libsof_eq_iir.so", SOF_COMP_EQ_IIR, 0, NULL},
+	{"tone", "libsof_tone.so", SOF_COMP_TONE, 0, NULL},
+	{"kpb", "libsof_kpb.so", SOF_COMP_KPB, 0, NULL},
+	{"detect", "libsof_detect_test.so", SOF_COMP_KEYWORD_DETECT, 0, NULL},
 };
 
 /* main firmware context */
 static struct sof sof;
-static int fr_id; /* comp id for fileread */
-static int fw_id; /* comp id for filewrite */
-static int sched_id; /* comp id for scheduling comp */
 
 /* compatible variables, not used */
 intptr_t _comp_init_start, _comp_init_end;
 
 /*
  * Parse shared library from user input
- * Currently only handles volume and src comp
  * This function takes in the libraries to be used as an input in the format:
  * "vol=libsof_volume.so,src=libsof_src.so,..."
  * The function parses the above string to identify the following:
@@ -75,6 +81,18 @@ static void parse_libraries(char *libs)
 	}
 }
 
+/* split comma separated file names */
+static void parse_files(char *arg, char **files, int *num)
+{
+	char *file_token = NULL;
+	char *token = strtok_r(arg, ",", &file_token);
+
+	while (token && *num < TB_MAX_FILES) {
+		files[(*num)++] = strdup(token);
+		token = strtok_r(NULL, ",", &file_token);
+	}
+}
+
 /* print usage for testbench */
 static void print_usage(char *executable)
 {
@@ -82,10 +100,75 @@ static void print_usage(char *executable)
 	printf("-t <tplg_file> -b <input_format> ");
 	printf("-a <comp1=comp1_library,comp2=comp2_library>\n");
 	printf("input_format should be S16_LE, S32_LE, S24_LE or FLOAT_LE\n");
+	printf("Files ending .txt are text, .wav are WAV, others raw PCM\n");
 	printf("Example Usage:\n");
 	printf("%s -i in.txt -o out.txt -t test.tplg ", executable);
 	printf("-r 48000 -R 96000 ");
 	printf("-b S16_LE -a vol=libsof_volume.so\n");
+	printf("Benchmark with -T <seconds> of synthetic audio, ");
+	printf("-i and -o are then optional\n");
+	printf("-C <host_MHz> for MCPS estimate, -j <json_file> for results\n");
+	printf("-D <ppm> runs SRC in asynchronous mode with input paced at ");
+	printf("input rate with the given clock drift\n");
+	printf("Comma separated -i and -o files go to the file components ");
+	printf("of all pipelines in topology order\n");
+}
+
+/* host CPU clock from /proc/cpuinfo for MCPS estimates */
+static double get_cpu_mhz(void)
+{
+	char line[256];
+	double mhz = 0;
+	FILE *fh;
+
+	fh = fopen("/proc/cpuinfo", "r");
+	if (!fh)
+		return 0;
+
+	while (fgets(line, sizeof(line), fh)) {
+		if (sscanf(line, "cpu MHz : %lf", &mhz) == 1)
+			break;
+	}
+
+	fclose(fh);
+	return mhz;
+}
+
+/* switch control of all SRC components, num_elems values are returned */
+static int tb_src_switch(int cmd, int num_elems, uint32_t value,
+			 int32_t *drift_ppm)
+{
+	struct sof_ipc_ctrl_data *cdata;
+	struct ipc_comp_dev *icd;
+	struct list_item *clist;
+	size_t size = sizeof(*cdata) +
+		num_elems * sizeof(struct sof_ipc_ctrl_value_chan);
+	int ret = 0;
+
+	cdata = calloc(1, size);
+	if (!cdata)
+		return -ENOMEM;
+
+	list_for_item(clist, &sof.ipc->shared_ctx->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->type != COMP_TYPE_COMPONENT ||
+		    icd->cd->comp.type != SOF_COMP_SRC)
+			continue;
+
+		cdata->cmd = SOF_CTRL_CMD_SWITCH;
+		cdata->comp_id = icd->id;
+		cdata->num_elems = num_elems;
+		cdata->chanv[0].value = value;
+		ret = comp_cmd(icd->cd, cmd, cdata, size);
+		if (ret < 0)
+			break;
+
+		if (drift_ppm)
+			*drift_ppm = cdata->chanv[1].value;
+	}
+
+	free(cdata);
+	return ret;
 }
 
 /* free components */
@@ -104,12 +187,16 @@ static void free_comps(void)
 			rfree(icd);
 			break;
 		case COMP_TYPE_BUFFER:
-			rfree(icd->cb->addr);
+			/* arena memory is freed with the pipeline */
+			if (!icd->cb->arena)
+				rfree(icd->cb->addr);
 			rfree(icd->cb);
 			list_item_del(&icd->list);
 			rfree(icd);
 			break;
 		default:
+			rfree(icd->pipeline->sched_list);
+			rfree(icd->pipeline->arena);
 			rfree(icd->pipeline);
 			list_item_del(&icd->list);
 			rfree(icd);
@@ -122,16 +209,19 @@ static void parse_input_args(int argc, char **argv, struct testbench_prm *tp)
 {
 	int option = 0;
 
-	while ((option = getopt(argc, argv, "hdi:o:t:b:a:r:R:")) != -1) {
+	while ((option = getopt(argc, argv,
+				"hdi:o:t:b:a:r:R:T:C:j:D:")) != -1) {
 		switch (option) {
 		/* input sample file */
 		case 'i':
-			tp->input_file = strdup(optarg);
+			parse_files(optarg, tp->input_file,
+				    &tp->input_file_num);
 			break;
 
 		/* output sample file */
 		case 'o':
-			tp->output_file = strdup(optarg);
+			parse_files(optarg, tp->output_file,
+				    &tp->output_file_num);
 			break;
 
 		/* topology file */
@@ -159,6 +249,27 @@ static void parse_input_args(int argc, char **argv, struct testbench_prm *tp)
 			tp->fs_out = atoi(optarg);
 			break;
 
+		/* benchmark seconds of synthetic audio */
+		case 'T':
+			tp->bench_time = atof(optarg);
+			break;
+
+		/* host CPU clock for MCPS estimates */
+		case 'C':
+			tp->cpu_mhz = atof(optarg);
+			break;
+
+		/* benchmark results in JSON */
+		case 'j':
+			tp->json_file = strdup(optarg);
+			break;
+
+		/* asynchronous SRC with simulated clock drift */
+		case 'D':
+			tp->asrc = 1;
+			tp->drift_ppm = atof(optarg);
+			break;
+
 		/* enable debug prints */
 		case 'd':
 			debug = 1;
@@ -173,96 +284,219 @@ static void parse_input_args(int argc, char **argv, struct testbench_prm *tp)
 	}
 }
 
+/* filereads or filewrites in topology order */
+static int tb_find_files(enum file_mode mode, struct comp_dev **files)
+{
+	struct file_comp_data *cd;
+	struct ipc_comp_dev *icd;
+	struct list_item *clist;
+	int num = 0;
+
+	list_for_item(clist, &sof.ipc->shared_ctx->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->type != COMP_TYPE_COMPONENT ||
+		    icd->cd->comp.type != SOF_COMP_FILEREAD)
+			continue;
+
+		cd = comp_get_drvdata(icd->cd);
+		if (cd->fs.mode == mode && num < TB_MAX_PIPELINES)
+			files[num++] = icd->cd;
+	}
+
+	return num;
+}
+
+/* true once any fileread has reached the end of its file */
+static int tb_files_eof(struct comp_dev **files, int num)
+{
+	struct file_comp_data *cd;
+	int i;
+
+	for (i = 0; i < num; i++) {
+		cd = comp_get_drvdata(files[i]);
+		if (cd->fs.reached_eof)
+			return 1;
+	}
+
+	return 0;
+}
+
 int main(int argc, char **argv)
 {
 	struct testbench_prm tp;
-	struct ipc_comp_dev *pcm_dev;
-	struct pipeline *p;
+	struct tb_pipelines pipes;
+	struct comp_dev *fr[TB_MAX_PIPELINES];
+	struct comp_dev *fw[TB_MAX_PIPELINES];
 	struct sof_ipc_pipe_new *ipc_pipe;
-	struct comp_dev *cd;
 	struct file_comp_data *frcd, *fwcd;
-	char pipeline[DEBUG_MSG_LEN];
+	char pipeline[DEBUG_MSG_LEN * TB_MAX_PIPELINES];
 	clock_t tic, toc;
 	double c_realtime, t_exec;
-	int n_in, n_out, ret;
+	uint32_t periods = 0;
+	int32_t drift_est = 0;
+	int level_min = 0, level_max = 0;
+	uint32_t overruns = 0;
+	int n_in = 0, n_out = 0, ret;
+	int num_fr, num_fw;
 	int i;
 
 	/* initialize input and output sample rates, files, etc. */
 	tp.fs_in = 0;
 	tp.fs_out = 0;
 	tp.bits_in = 0;
-	tp.input_file = NULL;
-	tp.output_file = NULL;
+	tp.input_file_num = 0;
+	tp.output_file_num = 0;
+	tp.tplg_file = NULL;
+	tp.bench_time = 0;
+	tp.cpu_mhz = 0;
+	tp.json_file = NULL;
+	tp.asrc = 0;
+	tp.drift_ppm = 0;
 
 	/* command line arguments*/
 	parse_input_args(argc, argv, &tp);
 
-	/* check args */
-	if (!tp.tplg_file || !tp.input_file || !tp.output_file || !tp.bits_in) {
+	/* check args, benchmark can run without sample files */
+	if (!tp.tplg_file || !tp.bits_in ||
+	    (tp.bench_time <= 0 &&
+	     (!tp.input_file_num || !tp.output_file_num))) {
 		print_usage(argv[0]);
 		exit(EXIT_FAILURE);
 	}
 
+	if (tp.bench_time > 0 && tp.cpu_mhz <= 0)
+		tp.cpu_mhz = get_cpu_mhz();
+
 	/* initialize ipc and scheduler */
 	if (tb_pipeline_setup(&sof) < 0) {
 		fprintf(stderr, "error: pipeline init\n");
 		exit(EXIT_FAILURE);
 	}
 
-	/* parse topology file and create pipeline */
-	if (parse_topology(&sof, lib_table, &tp, &fr_id, &fw_id, &sched_id,
-			   pipeline) < 0) {
+	/* parse topology file and create pipelines */
+	if (parse_topology(&sof, lib_table, &tp, pipeline) < 0) {
 		fprintf(stderr, "error: parsing topology\n");
 		exit(EXIT_FAILURE);
 	}
 
-	/* Get pointers to fileread and filewrite */
-	pcm_dev = ipc_get_comp_by_id(sof.ipc, fw_id);
-	fwcd = comp_get_drvdata(pcm_dev->cd);
-	pcm_dev = ipc_get_comp_by_id(sof.ipc, fr_id);
-	frcd = comp_get_drvdata(pcm_dev->cd);
+	/* all pipelines are run, producers before their consumers */
+	if (tb_pipelines_find(sof.ipc, &pipes) < 0) {
+		fprintf(stderr, "error: topology pipelines\n");
+		exit(EXIT_FAILURE);
+	}
 
-	/* Run pipeline until EOF from fileread */
-	pcm_dev = ipc_get_comp_by_id(sof.ipc, sched_id);
-	p = pcm_dev->cd->pipeline;
-	ipc_pipe = &p->ipc_pipe;
+	/* Get pointers to filereads and filewrites */
+	num_fr = tb_find_files(FILE_READ, fr);
+	num_fw = tb_find_files(FILE_WRITE, fw);
+	if (tp.bench_time <= 0 && (!num_fr || !num_fw)) {
+		fprintf(stderr, "error: no file components in topology\n");
+		exit(EXIT_FAILURE);
+	}
 
 	/* input and output sample rate */
+	ipc_pipe = &pipes.p[0]->ipc_pipe;
 	if (!tp.fs_in)
 		tp.fs_in = ipc_pipe->period * ipc_pipe->frames_per_sched;
 
+	ipc_pipe = &pipes.p[pipes.num - 1]->ipc_pipe;
 	if (!tp.fs_out)
 		tp.fs_out = ipc_pipe->period * ipc_pipe->frames_per_sched;
 
+	/* file rates for WAV headers */
+	for (i = 0; i < num_fr; i++) {
+		frcd = comp_get_drvdata(fr[i]);
+		frcd->rate = tp.fs_in;
+	}
+
+	for (i = 0; i < num_fw; i++) {
+		fwcd = comp_get_drvdata(fw[i]);
+		fwcd->rate = tp.fs_out;
+	}
+
+	/* pace input at its nominal rate skewed by drift */
+	if (tp.asrc) {
+		if (tb_src_switch(COMP_CMD_SET_VALUE, 1, 1, NULL) < 0) {
+			fprintf(stderr, "error: SRC asynchronous mode\n");
+			exit(EXIT_FAILURE);
+		}
+
+		for (i = 0; i < num_fr; i++) {
+			frcd = comp_get_drvdata(fr[i]);
+			ipc_pipe = &fr[i]->pipeline->ipc_pipe;
+			frcd->pace = tp.fs_in * (1e-6 * ipc_pipe->period) *
+				(1 + 1e-6 * tp.drift_ppm);
+			frcd->level_min = INT32_MAX;
+			frcd->level_max = 0;
+		}
+	}
+
 	/* set pipeline params and trigger start */
-	if (tb_pipeline_start(sof.ipc, TESTBENCH_NCH, ipc_pipe, &tp) < 0) {
+	if (tb_pipeline_start(&pipes, TESTBENCH_NCH, &tp) < 0) {
 		fprintf(stderr, "error: pipeline params\n");
 		exit(EXIT_FAILURE);
 	}
 
-	cd = pcm_dev->cd;
+	/* time every component in benchmark mode */
+	if (tp.bench_time > 0) {
+		periods = tp.bench_time * 1e6 / pipes.period;
+		if (tb_bench_init(sof.ipc, periods) < 0) {
+			fprintf(stderr, "error: benchmark init\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+
 	tb_enable_trace(false); /* reduce trace output */
 	tic = clock();
 
-	while (frcd->fs.reached_eof == 0)
-		pipeline_schedule_copy(p, 0);
+	/* Run pipelines until EOF from a fileread */
+	if (periods)
+		tb_bench_run(&pipes, periods);
+	else
+		while (!tb_files_eof(fr, num_fr))
+			tb_pipeline_copy(&pipes);
 
-	if (!frcd->fs.reached_eof)
-		printf("warning: possible pipeline xrun\n");
+	if (tp.asrc && tb_src_switch(COMP_CMD_GET_VALUE, 2, 0,
+				     &drift_est) < 0)
+		fprintf(stderr, "error: SRC drift estimate\n");
 
-	/* reset and free pipeline */
+	/* reset and free pipelines */
 	toc = clock();
 	tb_enable_trace(true);
-	ret = pipeline_reset(p, cd);
+	ret = tb_pipeline_reset(&pipes);
 	if (ret < 0) {
 		fprintf(stderr, "error: pipeline reset\n");
 		exit(EXIT_FAILURE);
 	}
 
-	n_in = frcd->fs.n;
-	n_out = fwcd->fs.n;
+	for (i = 0; i < num_fr; i++) {
+		frcd = comp_get_drvdata(fr[i]);
+		n_in += frcd->fs.n;
+	}
+
+	for (i = 0; i < num_fw; i++) {
+		fwcd = comp_get_drvdata(fw[i]);
+		n_out += fwcd->fs.n;
+	}
+
+	if (num_fr) {
+		frcd = comp_get_drvdata(fr[0]);
+		level_min = frcd->level_min;
+		level_max = frcd->level_max;
+		overruns = frcd->pace_overruns;
+	}
+
 	t_exec = (double)(toc - tic) / CLOCKS_PER_SEC;
-	c_realtime = (double)n_out / TESTBENCH_NCH / tp.fs_out / t_exec;
+	c_realtime = num_fw ? (double)n_out / num_fw / TESTBENCH_NCH /
+		tp.fs_out / t_exec : 0;
+
+	/* report benchmark before components are gone */
+	if (periods) {
+		tb_bench_report(stdout, &tp, pipes.period);
+		if (tp.json_file &&
+		    tb_bench_json(tp.json_file, &tp, pipes.period) < 0)
+			exit(EXIT_FAILURE);
+		tb_bench_free();
+	}
 
 	/* free all components/buffers in pipeline */
 	free_comps();
@@ -273,20 +507,33 @@ int main(int argc, char **argv)
 	printf("==========================================================\n");
 	printf("Test Pipeline:\n");
 	printf("%s\n", pipeline);
+	printf("Pipelines: %d\n", pipes.num);
 	printf("Input bit format: %s\n", tp.bits_in);
 	printf("Input sample rate: %d\n", tp.fs_in);
 	printf("Output sample rate: %d\n", tp.fs_out);
-	printf("Output written to file: \"%s\"\n", tp.output_file);
+	for (i = 0; i < tp.output_file_num && i < num_fw; i++)
+		printf("Output written to file: \"%s\"\n",
+		       tp.output_file[i]);
 	printf("Input sample count: %d\n", n_in);
 	printf("Output sample count: %d\n", n_out);
 	printf("Total execution time: %.2f us, %.2f x realtime\n",
 	       1e3 * t_exec, c_realtime);
+	if (tp.asrc) {
+		printf("Simulated clock drift: %.1f ppm, estimate %d ppm\n",
+		       tp.drift_ppm, drift_est);
+		printf("SRC source level after settling: %d to %d frames, ",
+		       level_min, level_max);
+		printf("%u input overruns\n", overruns);
+	}
 
 	/* free all other data */
 	free(tp.bits_in);
-	free(tp.input_file);
+	for (i = 0; i < tp.input_file_num; i++)
+		free(tp.input_file[i]);
+	for (i = 0; i < tp.output_file_num; i++)
+		free(tp.output_file[i]);
 	free(tp.tplg_file);
-	free(tp.output_file);
+	free(tp.json_file);
 
 	/* close shared library objects */
 	for (i = 0; i < NUM_WIDGETS_SUPPORTED; i++) {
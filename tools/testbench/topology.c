@@ -37,7 +37,11 @@ enum sof_ipc_dai_type find_dai(const char *name)
 }
 
 FILE *file;
-char pipeline_string[DEBUG_MSG_LEN];
+char pipeline_string[DEBUG_MSG_LEN * TB_MAX_PIPELINES];
+
+/* filereads and filewrites loaded so far */
+static int fr_count;
+static int fw_count;
 
 struct shared_lib_table *lib_table;
 
@@ -51,8 +55,7 @@ void register_comp(int comp_type)
 	char message[DEBUG_MSG_LEN + MAX_LIB_NAME_LEN];
 
 	/* register file comp driver (no shared library needed) */
-	if (comp_type == SND_SOC_TPLG_DAPM_DAI_IN ||
-	    comp_type == SND_SOC_TPLG_DAPM_AIF_IN) {
+	if (comp_type == SOF_COMP_FILEREAD) {
 		if (!lib_table[0].register_drv) {
 			sys_comp_file_init();
 			lib_table[0].register_drv = 1;
@@ -92,7 +95,14 @@ void register_comp(int comp_type)
 
 int find_widget(struct comp_info *temp_comp_list, int count, char *name)
 {
-	return 0;
+	int i;
+
+	for (i = 0; i < count; i++) {
+		if (!strcmp(temp_comp_list[i].name, name))
+			return temp_comp_list[i].id;
+	}
+
+	return -EINVAL;
 }
 
 /* load pipeline graph DAPM widget*/
@@ -208,8 +218,7 @@ static int tplg_load_fileread(int comp_id, int pipeline_id, int size,
 
 /* load fileread component */
 static int load_fileread(void *dev, int comp_id, int pipeline_id,
-			 int size, int *fr_id, int *sched_id,
-			 struct testbench_prm *tp)
+			 int size, int *fr_id, struct testbench_prm *tp)
 {
 	struct sof *sof = (struct sof *)dev;
 	struct sof_ipc_comp_file fileread;
@@ -221,13 +230,14 @@ static int load_fileread(void *dev, int comp_id, int pipeline_id,
 	if (ret < 0)
 		return ret;
 
-	/* configure fileread */
-	fileread.fn = strdup(tp->input_file);
-
-	/* use fileread comp as scheduling comp */
-	*fr_id = *sched_id = comp_id;
+	/* configure fileread, no file gives synthetic input */
+	fileread.fn = fr_count < tp->input_file_num ?
+		strdup(tp->input_file[fr_count]) : NULL;
+	fr_count++;
+	*fr_id = comp_id;
 
 	/* create fileread component */
+	register_comp(fileread.comp.type);
 	if (ipc_comp_new(sof->ipc, (struct sof_ipc_comp *)&fileread) < 0) {
 		fprintf(stderr, "error: comp register\n");
 		return -EINVAL;
@@ -241,7 +251,7 @@ int load_aif_in_out(void *dev, int comp_id, int pipeline_id,
 		    int size, int *fr_id, int *sched_id, void *tp, int dir)
 {
 	return load_fileread(dev, comp_id, pipeline_id, size, fr_id,
-			     sched_id, (struct testbench_prm *)tp);
+			     (struct testbench_prm *)tp);
 }
 
 /* load filewrite component */
@@ -305,11 +315,14 @@ static int load_filewrite(struct sof *sof, int comp_id, int pipeline_id,
 	if (ret < 0)
 		return ret;
 
-	/* configure filewrite */
-	filewrite.fn = strdup(tp->output_file);
+	/* configure filewrite, no file discards output */
+	filewrite.fn = fw_count < tp->output_file_num ?
+		strdup(tp->output_file[fw_count]) : NULL;
+	fw_count++;
 	*fw_id = comp_id;
 
 	/* create filewrite component */
+	register_comp(filewrite.comp.type);
 	if (ipc_comp_new(sof->ipc, (struct sof_ipc_comp *)&filewrite) < 0) {
 		fprintf(stderr, "error: comp register\n");
 		return -EINVAL;
@@ -338,6 +351,7 @@ int load_pga(void *dev, int comp_id, int pipeline_id, int size)
 		return ret;
 
 	/* load volume component */
+	register_comp(volume.comp.type);
 	if (ipc_comp_new(sof->ipc, (struct sof_ipc_comp *)&volume) < 0) {
 		fprintf(stderr, "error: comp register\n");
 		return -EINVAL;
@@ -346,6 +360,22 @@ int load_pga(void *dev, int comp_id, int pipeline_id, int size)
 	return 0;
 }
 
+/* first component created in the pipeline */
+static int find_pipeline_comp(struct sof *sof, int pipeline_id)
+{
+	struct ipc_comp_dev *icd;
+	struct list_item *clist;
+
+	list_for_item(clist, &sof->ipc->shared_ctx->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->type == COMP_TYPE_COMPONENT &&
+		    icd->cd->comp.pipeline_id == pipeline_id)
+			return icd->id;
+	}
+
+	return -EINVAL;
+}
+
 /* load scheduler dapm widget */
 int load_pipeline(void *dev, int comp_id, int pipeline_id, int size,
 		  int *sched_id)
@@ -358,6 +388,10 @@ int load_pipeline(void *dev, int comp_id, int pipeline_id, int size,
 	if (ret < 0)
 		return ret;
 
+	/* without a loaded scheduling comp use the first one in pipeline */
+	if (*sched_id < 0 || !ipc_get_comp_by_id(sof->ipc, *sched_id))
+		*sched_id = find_pipeline_comp(sof, pipeline_id);
+
 	pipeline.sched_id = *sched_id;
 
 	/* Create pipeline */
@@ -395,6 +429,7 @@ int load_src(void *dev, int comp_id, int pipeline_id, int size,
 	}
 
 	/* load src component */
+	register_comp(src.comp.type);
 	if (ipc_comp_new(sof->ipc, (struct sof_ipc_comp *)&src) < 0) {
 		fprintf(stderr, "error: new src comp\n");
 		return -EINVAL;
@@ -406,6 +441,7 @@ int load_src(void *dev, int comp_id, int pipeline_id, int size,
 /* load mixer dapm widget */
 int load_mixer(void *dev, int comp_id, int pipeline_id, int size)
 {
+	struct sof *sof = (struct sof *)dev;
 	struct sof_ipc_comp_mixer mixer = {0};
 	int ret = 0;
 
@@ -413,15 +449,67 @@ int load_mixer(void *dev, int comp_id, int pipeline_id, int size)
 	if (ret < 0)
 		return ret;
 
+	/* load mixer component */
+	register_comp(mixer.comp.type);
+	if (ipc_comp_new(sof->ipc, (struct sof_ipc_comp *)&mixer) < 0) {
+		fprintf(stderr, "error: new mixer comp\n");
+		return -EINVAL;
+	}
+
+	return ret;
+}
+
+/* load tone dapm widget */
+int load_tone(void *dev, int comp_id, int pipeline_id, int size)
+{
+	struct sof *sof = (struct sof *)dev;
+	struct sof_ipc_comp_tone tone = {0};
+	int ret = 0;
+
+	ret = tplg_load_tone(comp_id, pipeline_id, size, &tone, file);
+	if (ret < 0)
+		return ret;
+
+	/* load tone component */
+	register_comp(tone.comp.type);
+	if (ipc_comp_new(sof->ipc, (struct sof_ipc_comp *)&tone) < 0) {
+		fprintf(stderr, "error: new tone comp\n");
+		return -EINVAL;
+	}
+
+	return ret;
+}
+
+/* load effect dapm widget, the process type selects the component */
+int load_process(void *dev, int comp_id, int pipeline_id, int size,
+		 int num_kcontrols)
+{
+	struct sof *sof = (struct sof *)dev;
+	struct sof_ipc_comp_process *process = NULL;
+	int ret = 0;
+
+	ret = tplg_load_process(comp_id, pipeline_id, size, num_kcontrols,
+				&process, file);
+	if (ret < 0)
+		return ret;
+
+	/* load process component */
+	register_comp(process->comp.type);
+	if (ipc_comp_new(sof->ipc, (struct sof_ipc_comp *)process) < 0) {
+		fprintf(stderr, "error: new process comp\n");
+		ret = -EINVAL;
+	}
+
+	free(process);
 	return ret;
 }
 
 /* parse topology file and set up pipeline */
 int parse_topology(struct sof *sof, struct shared_lib_table *library_table,
-		   struct testbench_prm *tp, int *fr_id, int *fw_id,
-		   int *sched_id, char *pipeline_msg)
+		   struct testbench_prm *tp, char *pipeline_msg)
 {
 	struct snd_soc_tplg_hdr *hdr;
+	int fr_id, fw_id, sched_id;
 
 	struct comp_info *temp_comp_list = NULL;
 	char message[DEBUG_MSG_LEN];
@@ -481,8 +569,8 @@ int parse_topology(struct sof *sof, struct shared_lib_table *library_table,
 				ret = load_widget(sof, SOF_DEV,
 						  temp_comp_list,
 						  next_comp_id++, i,
-						  hdr->index, tp, fr_id,
-						  fw_id, sched_id, file);
+						  hdr->index, tp, &fr_id,
+						  &fw_id, &sched_id, file);
 				if (ret < 0) {
 					printf("error: loading widget\n");
 					goto finish;
@@ -111,6 +111,37 @@ static const struct sof_topology_token src_tokens[] = {
 
 /* Tone */
 static const struct sof_topology_token tone_tokens[] = {
+	{SOF_TKN_TONE_SAMPLE_RATE, SND_SOC_TPLG_TUPLE_TYPE_WORD,
+		get_token_uint32_t,
+		offsetof(struct sof_ipc_comp_tone, sample_rate), 0},
+};
+
+/* Processing components */
+struct sof_process_types {
+	const char *name;
+	enum sof_comp_type type;
+};
+
+static const struct sof_process_types sof_process[] = {
+	{"EQFIR", SOF_COMP_EQ_FIR},
+	{"EQIIR", SOF_COMP_EQ_IIR},
+	{"KEYWORD_DETECT", SOF_COMP_KEYWORD_DETECT},
+	{"KPB", SOF_COMP_KPB},
+	{"CHAN_SELECTOR", SOF_COMP_SELECTOR},
+	{"MUX", SOF_COMP_MUX},
+	{"DEMUX", SOF_COMP_DEMUX},
+};
+
+enum sof_comp_type find_process_comp_type(const char *name);
+
+int get_token_process_type(void *elem, void *object, uint32_t offset,
+			   uint32_t size);
+
+/* process type selects the component driver */
+static const struct sof_topology_token process_tokens[] = {
+	{SOF_TKN_PROCESS_TYPE, SND_SOC_TPLG_TUPLE_TYPE_STRING,
+		get_token_process_type,
+		offsetof(struct sof_ipc_comp_process, comp.type), 0},
 };
 
 /* Generic components */
@@ -184,11 +215,17 @@ int tplg_load_pga(int comp_id, int pipeline_id, int size,
 		  struct sof_ipc_comp_volume *volume, FILE *file);
 int tplg_load_pipeline(int comp_id, int pipeline_id, int size,
 		       struct sof_ipc_pipe_new *pipeline, FILE *file);
-int tplg_load_controls(int num_kcontrols, FILE *file);
+int tplg_load_controls(int num_kcontrols, FILE *file, void **bytes,
+		       size_t *bytes_size);
 int tplg_load_src(int comp_id, int pipeline_id, int size,
 		  struct sof_ipc_comp_src *src, FILE *file);
 int tplg_load_mixer(int comp_id, int pipeline_id, int size,
 		    struct sof_ipc_comp_mixer *mixer, FILE *file);
+int tplg_load_tone(int comp_id, int pipeline_id, int size,
+		   struct sof_ipc_comp_tone *tone, FILE *file);
+int tplg_load_process(int comp_id, int pipeline_id, int size,
+		      int num_kcontrols, struct sof_ipc_comp_process **process,
+		      FILE *file);
 int tplg_load_graph(int num_comps, int pipeline_id,
 		    struct comp_info *temp_comp_list, char *pipeline_string,
 		    struct sof_ipc_pipe_comp_connect *connection, FILE *file,
@@ -204,9 +241,11 @@ int load_pipeline(void *dev, int comp_id, int pipeline_id, int size,
 		  int *sched_id);
 int load_src(void *dev, int comp_id, int pipeline_id, int size, void *params);
 int load_mixer(void *dev, int comp_id, int pipeline_id, int size);
+int load_tone(void *dev, int comp_id, int pipeline_id, int size);
+int load_process(void *dev, int comp_id, int pipeline_id, int size,
+		 int num_kcontrols);
 int load_widget(void *dev, int dev_type, struct comp_info *temp_comp_list,
 		int comp_id, int comp_index, int pipeline_id,
 		void *tp, int *fr_id, int *fw_id, int *sched_id, FILE *file);
-void register_comp(int comp_type);
 int find_widget(struct comp_info *temp_comp_list, int count, char *name);
 #endif
@@ -16,6 +16,7 @@
 #include <ipc/topology.h>
 #include <ipc/stream.h>
 #include <ipc/dai.h>
+#include <kernel/header.h>
 #include <sof/common.h>
 #include <tplg_parser/topology.h>
 
@@ -340,11 +341,48 @@ int tplg_load_pipeline(int comp_id, int pipeline_id, int size,
 	return 0;
 }
 
+/* append bytes control payload without its ABI header to the data */
+static int tplg_load_bytes_data(int priv_size, void **bytes,
+				size_t *bytes_size, FILE *file)
+{
+	struct sof_abi_hdr abi;
+	void *data;
+
+	if (priv_size < sizeof(abi) ||
+	    fread(&abi, sizeof(abi), 1, file) != 1 ||
+	    abi.size > priv_size - sizeof(abi)) {
+		fprintf(stderr, "error: invalid bytes control data\n");
+		return -EINVAL;
+	}
+
+	data = realloc(*bytes, *bytes_size + abi.size);
+	if (!data) {
+		fprintf(stderr, "error: mem alloc\n");
+		return -EINVAL;
+	}
+
+	*bytes = data;
+	if (abi.size &&
+	    fread(data + *bytes_size, abi.size, 1, file) != 1) {
+		fprintf(stderr, "error: invalid bytes control data\n");
+		return -EINVAL;
+	}
+
+	*bytes_size += abi.size;
+
+	/* skip any padding after the payload */
+	fseek(file, priv_size - sizeof(abi) - abi.size, SEEK_CUR);
+	return 0;
+}
+
 /* load dapm widget kcontrols
- * we don't use controls in the testbench or the fuzzer atm.
- * so just skip to the next dapm widget
+ * we don't use controls in the testbench or the fuzzer atm. so just skip
+ * to the next dapm widget, only the payload of bytes controls is returned
+ * in bytes when requested since processing components take it as their
+ * initial configuration
  */
-int tplg_load_controls(int num_kcontrols, FILE *file)
+int tplg_load_controls(int num_kcontrols, FILE *file, void **bytes,
+		       size_t *bytes_size)
 {
 	struct snd_soc_tplg_ctl_hdr *ctl_hdr;
 	struct snd_soc_tplg_mixer_control *mixer_ctl;
@@ -450,8 +488,16 @@ int tplg_load_controls(int num_kcontrols, FILE *file)
 				goto err;
 			}
 
-			/* skip bytes private data */
-			fseek(file, bytes_ctl->priv.size, SEEK_CUR);
+			/* skip bytes private data unless requested */
+			if (bytes) {
+				ret = tplg_load_bytes_data(bytes_ctl->priv.size,
+							   bytes, bytes_size,
+							   file);
+				if (ret < 0)
+					goto err;
+			} else {
+				fseek(file, bytes_ctl->priv.size, SEEK_CUR);
+			}
 			break;
 		default:
 			printf("info: control type not supported\n");
@@ -584,7 +630,7 @@ int tplg_load_mixer(int comp_id, int pipeline_id, int size,
 	/* configure src */
 	mixer->comp.hdr.cmd = SOF_IPC_GLB_TPLG_MSG | SOF_IPC_TPLG_COMP_NEW;
 	mixer->comp.id = comp_id;
-	mixer->comp.hdr.size = sizeof(struct sof_ipc_comp_src);
+	mixer->comp.hdr.size = sizeof(struct sof_ipc_comp_mixer);
 	mixer->comp.type = SOF_COMP_MIXER;
 	mixer->comp.pipeline_id = pipeline_id;
 	mixer->config.hdr.size = sizeof(struct sof_ipc_comp_config);
@@ -593,6 +639,173 @@ int tplg_load_mixer(int comp_id, int pipeline_id, int size,
 	return 0;
 }
 
+/* load tone dapm widget */
+int tplg_load_tone(int comp_id, int pipeline_id, int size,
+		   struct sof_ipc_comp_tone *tone, FILE *file)
+{
+	struct snd_soc_tplg_vendor_array *array = NULL;
+	size_t total_array_size = 0, read_size;
+	int ret = 0;
+
+	/* allocate memory for vendor tuple array */
+	array = (struct snd_soc_tplg_vendor_array *)malloc(size);
+	if (!array) {
+		fprintf(stderr, "error: mem alloc for tone vendor array\n");
+		return -EINVAL;
+	}
+
+	/* read vendor tokens */
+	while (total_array_size < size) {
+		read_size = sizeof(struct snd_soc_tplg_vendor_array);
+		ret = fread(array, read_size, 1, file);
+		if (ret != 1) {
+			free(array);
+			return -EINVAL;
+		}
+
+		tplg_read_array(array, file);
+
+		/* parse comp tokens */
+		ret = sof_parse_tokens(&tone->config, comp_tokens,
+				       ARRAY_SIZE(comp_tokens), array,
+				       array->size);
+		if (ret != 0) {
+			fprintf(stderr, "error: parse tone comp_tokens %d\n",
+				size);
+			free(array);
+			return -EINVAL;
+		}
+
+		/* parse tone tokens */
+		ret = sof_parse_tokens(tone, tone_tokens,
+				       ARRAY_SIZE(tone_tokens), array,
+				       array->size);
+		if (ret != 0) {
+			fprintf(stderr, "error: parse tone tokens %d\n", size);
+			free(array);
+			return -EINVAL;
+		}
+
+		total_array_size += array->size;
+
+		/* read next array */
+		array = (void *)array + array->size;
+	}
+
+	/* point to the start of array so it gets freed properly */
+	array = (void *)array - size;
+
+	/* configure tone */
+	tone->comp.hdr.cmd = SOF_IPC_GLB_TPLG_MSG | SOF_IPC_TPLG_COMP_NEW;
+	tone->comp.id = comp_id;
+	tone->comp.hdr.size = sizeof(struct sof_ipc_comp_tone);
+	tone->comp.type = SOF_COMP_TONE;
+	tone->comp.pipeline_id = pipeline_id;
+	tone->config.hdr.size = sizeof(struct sof_ipc_comp_config);
+
+	free(array);
+	return 0;
+}
+
+/*
+ * load effect dapm widget, the component type comes from the process type
+ * token and the bytes kcontrols that follow the widget are appended as the
+ * component configuration. The returned process must be freed by the caller.
+ */
+int tplg_load_process(int comp_id, int pipeline_id, int size,
+		      int num_kcontrols, struct sof_ipc_comp_process **process,
+		      FILE *file)
+{
+	struct snd_soc_tplg_vendor_array *array = NULL;
+	struct sof_ipc_comp_process config = {0};
+	size_t total_array_size = 0, read_size;
+	size_t data_size;
+	int ret = 0;
+
+	/* allocate memory for vendor tuple array */
+	array = (struct snd_soc_tplg_vendor_array *)malloc(size);
+	if (!array) {
+		fprintf(stderr, "error: mem alloc for process vendor array\n");
+		return -EINVAL;
+	}
+
+	/* read vendor tokens */
+	while (total_array_size < size) {
+		read_size = sizeof(struct snd_soc_tplg_vendor_array);
+		ret = fread(array, read_size, 1, file);
+		if (ret != 1) {
+			free(array);
+			return -EINVAL;
+		}
+
+		tplg_read_array(array, file);
+
+		/* parse comp tokens */
+		ret = sof_parse_tokens(&config.config, comp_tokens,
+				       ARRAY_SIZE(comp_tokens), array,
+				       array->size);
+		if (ret != 0) {
+			fprintf(stderr, "error: parse process comp_tokens %d\n",
+				size);
+			free(array);
+			return -EINVAL;
+		}
+
+		/* parse process tokens */
+		ret = sof_parse_tokens(&config, process_tokens,
+				       ARRAY_SIZE(process_tokens), array,
+				       array->size);
+		if (ret != 0) {
+			fprintf(stderr, "error: parse process tokens %d\n",
+				size);
+			free(array);
+			return -EINVAL;
+		}
+
+		total_array_size += array->size;
+
+		/* read next array */
+		array = (void *)array + array->size;
+	}
+
+	/* point to the start of array so it gets freed properly */
+	array = (void *)array - size;
+	free(array);
+
+	if (config.comp.type == SOF_COMP_NONE) {
+		fprintf(stderr, "error: unsupported process type\n");
+		return -EINVAL;
+	}
+
+	/* the process is allocated first so the bytes data is appended */
+	*process = calloc(1, sizeof(config));
+	if (!*process) {
+		fprintf(stderr, "error: mem alloc for process\n");
+		return -EINVAL;
+	}
+
+	/* bytes controls carry the initial configuration */
+	data_size = sizeof(config);
+	if (num_kcontrols > 0 &&
+	    tplg_load_controls(num_kcontrols, file, (void **)process,
+			       &data_size) < 0) {
+		free(*process);
+		*process = NULL;
+		return -EINVAL;
+	}
+
+	/* configure process */
+	config.comp.hdr.cmd = SOF_IPC_GLB_TPLG_MSG | SOF_IPC_TPLG_COMP_NEW;
+	config.comp.id = comp_id;
+	config.comp.hdr.size = data_size;
+	config.comp.pipeline_id = pipeline_id;
+	config.config.hdr.size = sizeof(struct sof_ipc_comp_config);
+	config.size = data_size - sizeof(config);
+
+	**process = config;
+	return 0;
+}
+
 /* load pipeline graph DAPM widget*/
 int tplg_load_graph(int num_comps, int pipeline_id,
 		    struct comp_info *temp_comp_list, char *pipeline_string,
@@ -696,9 +909,6 @@ int load_widget(void *dev, int dev_type, struct comp_info *temp_comp_list,
 	       temp_comp_list[comp_index].name,
 	       temp_comp_list[comp_index].id);
 
-	/* register comp driver */
-	register_comp(temp_comp_list[comp_index].type);
-
 	/* load widget based on type */
 	switch (temp_comp_list[comp_index].type) {
 
@@ -746,9 +956,8 @@ int load_widget(void *dev, int dev_type, struct comp_info *temp_comp_list,
 		break;
 	case(SND_SOC_TPLG_DAPM_SCHEDULER):
 		/* find comp id for scheduling comp */
-		if (dev_type == FUZZER_DEV)
-			*sched_id = find_widget(temp_comp_list, comp_id,
-						widget->sname);
+		*sched_id = find_widget(temp_comp_list, comp_id,
+					widget->sname);
 
 		if (load_pipeline(dev, temp_comp_list[comp_index].id,
 				  pipeline_id, widget->priv.size,
@@ -771,6 +980,24 @@ int load_widget(void *dev, int dev_type, struct comp_info *temp_comp_list,
 			return -EINVAL;
 		}
 		break;
+	case(SND_SOC_TPLG_DAPM_SIGGEN):
+		if (load_tone(dev, temp_comp_list[comp_index].id,
+			      pipeline_id, widget->priv.size) < 0) {
+			fprintf(stderr, "error: load tone\n");
+			return -EINVAL;
+		}
+		break;
+	case(SND_SOC_TPLG_DAPM_EFFECT):
+		if (load_process(dev, temp_comp_list[comp_index].id,
+				 pipeline_id, widget->priv.size,
+				 widget->num_kcontrols) < 0) {
+			fprintf(stderr, "error: load process\n");
+			return -EINVAL;
+		}
+
+		/* kcontrols were consumed as the process configuration */
+		widget->num_kcontrols = 0;
+		break;
 	/* unsupported widgets */
 	default:
 		fseek(file, widget->priv.size, SEEK_CUR);
@@ -781,7 +1008,8 @@ int load_widget(void *dev, int dev_type, struct comp_info *temp_comp_list,
 
 	/* load widget kcontrols */
 	if (widget->num_kcontrols > 0)
-		if (tplg_load_controls(widget->num_kcontrols, file) < 0) {
+		if (tplg_load_controls(widget->num_kcontrols, file, NULL,
+				       NULL) < 0) {
 			fprintf(stderr, "error: loading controls\n");
 			return -EINVAL;
 		}
@@ -945,6 +1173,18 @@ enum sof_ipc_frame find_format(const char *name)
 	return SOF_IPC_FRAME_S32_LE;
 }
 
+enum sof_comp_type find_process_comp_type(const char *name)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(sof_process); i++) {
+		if (strcmp(name, sof_process[i].name) == 0)
+			return sof_process[i].type;
+	}
+
+	return SOF_COMP_NONE;
+}
+
 /* helper functions to get tokens */
 int get_token_uint32_t(void *elem, void *object, uint32_t offset,
 		       uint32_t size)
@@ -974,3 +1214,13 @@ int get_token_dai_type(void *elem, void *object, uint32_t offset, uint32_t size)
 	*val = find_dai(velem->string);
 	return 0;
 }
+
+int get_token_process_type(void *elem, void *object, uint32_t offset,
+			   uint32_t size)
+{
+	struct snd_soc_tplg_vendor_string_elem *velem = elem;
+	uint32_t *val = (uint32_t *)((uint8_t *)object + offset);
+
+	*val = find_process_comp_type(velem->string);
+	return 0;
+}
@@ -0,0 +1,104 @@
+function asrc_generate(taps, phases, fc, beta)
+
+% asrc_generate - export ASRC fractional delay filter
+%
+% asrc_generate(<taps, phases, fc, beta>)
+%
+% taps   - filter length, default 32
+% phases - number of fractional delay phases, default 64
+% fc     - cutoff frequency relative to input rate, default 0.45
+% beta   - Kaiser window beta, default 7.0
+%
+% The filter is a Kaiser windowed sinc sampled at phases + 1 fractional
+% delays from 0 to 1. The C code interpolates linearly between adjacent
+% phases. The taps of each phase are in reverse time order to match the
+% oldest first history buffer and every phase is scaled to unity DC gain.
+%
+% Copyright (c) 2019, Intel Corporation
+% All rights reserved.
+%
+% Redistribution and use in source and binary forms, with or without
+% modification, are permitted provided that the following conditions are met:
+%   * Redistributions of source code must retain the above copyright
+%     notice, this list of conditions and the following disclaimer.
+%   * Redistributions in binary form must reproduce the above copyright
+%     notice, this list of conditions and the following disclaimer in the
+%     documentation and/or other materials provided with the distribution.
+%   * Neither the name of the Intel Corporation nor the
+%     names of its contributors may be used to endorse or promote products
+%     derived from this software without specific prior written permission.
+%
+% THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+% AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+% IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+% ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+% LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+% CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+% SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+% INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+% CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+% ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+% POSSIBILITY OF SUCH DAMAGE.
+%
+
+if nargin < 1
+	taps = 32;
+end
+if nargin < 2
+	phases = 64;
+end
+if nargin < 3
+	fc = 0.45;
+end
+if nargin < 4
+	beta = 7.0;
+end
+
+half = taps / 2;
+coef = zeros(phases + 1, taps);
+for j = 0:phases
+	t = half - 1 - (0:taps - 1) + j / phases;
+	w = besseli(0, beta * sqrt(max(0, 1 - (t / half).^2))) / ...
+		besseli(0, beta);
+	w(abs(t) >= half) = 0;
+	h = 2 * fc * sinc(2 * fc * t) .* w;
+	coef(j + 1, :) = h / sum(h);
+end
+
+% Q2.30 for accumulator headroom, the sum of absolute taps exceeds two
+qcoef = round(coef * 2^30);
+
+hdir = mkdir_check('include');
+fn = sprintf('%s/asrc_std_int32.h', hdir);
+fh = fopen(fn, 'w');
+fprintf(fh, '/* SPDX-License-Identifier: BSD-3-Clause\n');
+fprintf(fh, ' *\n');
+fprintf(fh, ' * Copyright(c) %s Intel Corporation. All rights reserved.\n', ...
+	datestr(now, 'yyyy'));
+fprintf(fh, ' */\n\n');
+fprintf(fh, '/* ASRC fractional delay filter, %d taps, %d phases, ', ...
+	taps, phases);
+fprintf(fh, 'cutoff %.2f fs_in,\n', fc);
+fprintf(fh, ' * Kaiser window beta %.1f, Q2.30. ', beta);
+fprintf(fh, 'Every phase has unity DC gain. Created\n');
+fprintf(fh, ' * with tools/tune/src/asrc_generate.m.\n');
+fprintf(fh, ' */\n\n');
+fprintf(fh, '#include <stdint.h>\n\n');
+fprintf(fh, 'const int32_t asrc_int32_fir[%d][%d] = {\n', phases + 1, taps);
+for j = 1:phases + 1
+	fprintf(fh, '\t{\n');
+	for i = 1:4:taps
+		fprintf(fh, '\t\t%d, %d, %d, %d,\n', qcoef(j, i:i + 3));
+	end
+	fprintf(fh, '\t},\n');
+end
+fprintf(fh, '};\n');
+fclose(fh);
+
+end
+
+function d = mkdir_check(d)
+if exist(d) ~= 7
+        mkdir(d);
+end
+end